@@ -0,0 +1,138 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CURAENGINE_BENCHMARK_COMB_BENCHMARK_H
+#define CURAENGINE_BENCHMARK_COMB_BENCHMARK_H
+
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "geometry/Shape.h"
+#include "pathPlanning/CombVisibilityGraph.h"
+#include "pathPlanning/LinePolygonsCrossings.h"
+#include "utils/polygonUtils.h"
+
+namespace cura
+{
+class CombTestFixture : public benchmark::Fixture
+{
+public:
+    static constexpr coord_t HOLE_PITCH = MM2INT(15);
+    static constexpr coord_t HOLE_SIZE = MM2INT(10);
+    static constexpr coord_t COMB_BOUNDARY_OFFSET = MM2INT(0.4);
+    static constexpr coord_t DIST_TO_MOVE_INSIDE = -40;
+
+    Shape part;
+    std::unique_ptr<LocToLineGrid> loc_to_line;
+    std::vector<std::pair<Point2LL, Point2LL>> travels;
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        // A square plate with a grid of square holes, so that most travels have to go around a few holes.
+        const size_t holes_per_side = static_cast<size_t>(state.range(0));
+        const coord_t size = HOLE_PITCH * static_cast<coord_t>(holes_per_side + 1);
+        part.clear();
+        part.emplace_back();
+        part.back().emplace_back(0, 0);
+        part.back().emplace_back(size, 0);
+        part.back().emplace_back(size, size);
+        part.back().emplace_back(0, size);
+        for (size_t x = 0; x < holes_per_side; ++x)
+        {
+            for (size_t y = 0; y < holes_per_side; ++y)
+            {
+                const Point2LL min(HOLE_PITCH * static_cast<coord_t>(x) + HOLE_PITCH / 3, HOLE_PITCH * static_cast<coord_t>(y) + HOLE_PITCH / 3);
+                const Point2LL max = min + Point2LL(HOLE_SIZE, HOLE_SIZE);
+                part.emplace_back(); // Holes are clockwise.
+                part.back().emplace_back(min.X, min.Y);
+                part.back().emplace_back(min.X, max.Y);
+                part.back().emplace_back(max.X, max.Y);
+                part.back().emplace_back(max.X, min.Y);
+            }
+        }
+        loc_to_line = PolygonUtils::createLocToLineGrid(part, COMB_BOUNDARY_OFFSET);
+
+        // Travel between the crossings of the corridors in between the holes, in a fixed pseudo-random order.
+        travels.clear();
+        const size_t corridor_count = holes_per_side + 1;
+        const auto corridor_crossing = [corridor_count](const size_t index)
+        {
+            return Point2LL(HOLE_PITCH * static_cast<coord_t>(index % corridor_count) + HOLE_PITCH / 6, HOLE_PITCH * static_cast<coord_t>(index / corridor_count) + HOLE_PITCH / 6);
+        };
+        size_t index = 0;
+        for (size_t travel_idx = 0; travel_idx < 1000; ++travel_idx)
+        {
+            const Point2LL from = corridor_crossing(index);
+            index = (index * 7 + 13) % (corridor_count * corridor_count);
+            travels.emplace_back(from, corridor_crossing(index));
+        }
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+    }
+
+    static coord_t pathLength(const CombPath& path)
+    {
+        coord_t length = 0;
+        for (size_t point_idx = 1; point_idx < path.size(); ++point_idx)
+        {
+            length += vSize(path[point_idx] - path[point_idx - 1]);
+        }
+        return length;
+    }
+};
+
+BENCHMARK_DEFINE_F(CombTestFixture, LinePolygonsCrossings_comb)(benchmark::State& st)
+{
+    coord_t total_length = 0;
+    for (auto _ : st)
+    {
+        total_length = 0;
+        for (const auto& [from, to] : travels)
+        {
+            CombPath path;
+            LinePolygonsCrossings::comb(part, *loc_to_line, from, to, path, DIST_TO_MOVE_INSIDE, 0, false);
+            total_length += pathLength(path);
+        }
+    }
+    st.SetItemsProcessed(st.iterations() * travels.size());
+    st.counters["travel_length_mm"] = INT2MM(total_length);
+}
+
+BENCHMARK_REGISTER_F(CombTestFixture, LinePolygonsCrossings_comb)->Arg(3)->Arg(5)->Arg(7)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(CombTestFixture, CombVisibilityGraph_route)(benchmark::State& st)
+{
+    const CombVisibilityGraph graph(part, *loc_to_line, DIST_TO_MOVE_INSIDE);
+    coord_t total_length = 0;
+    for (auto _ : st)
+    {
+        total_length = 0;
+        for (const auto& [from, to] : travels)
+        {
+            CombPath path;
+            graph.route(from, to, path);
+            total_length += pathLength(path);
+        }
+    }
+    st.SetItemsProcessed(st.iterations() * travels.size());
+    st.counters["travel_length_mm"] = INT2MM(total_length);
+}
+
+BENCHMARK_REGISTER_F(CombTestFixture, CombVisibilityGraph_route)->Arg(3)->Arg(5)->Arg(7)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(CombTestFixture, CombVisibilityGraph_construct)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        const CombVisibilityGraph graph(part, *loc_to_line, DIST_TO_MOVE_INSIDE);
+        benchmark::DoNotOptimize(graph.isValid());
+    }
+}
+
+BENCHMARK_REGISTER_F(CombTestFixture, CombVisibilityGraph_construct)->Arg(3)->Arg(5)->Arg(7)->Unit(benchmark::kMillisecond);
+
+} // namespace cura
+#endif // CURAENGINE_BENCHMARK_COMB_BENCHMARK_H
@@ -1,9 +1,12 @@
 
 // Copyright (c) 2023 UltiMaker
 // CuraEngine is released under the terms of the AGPLv3 or higher
+#include "comb_benchmark.h"
 #include "infill_benchmark.h"
 #include "wall_benchmark.h"
 #include "simplify_benchmark.h"
+#include "slicer_benchmark.h"
+#include "sparse_grid_benchmark.h"
 #include <benchmark/benchmark.h>
 
 // Run the benchmark
@@ -5,13 +5,17 @@
 #define CURAENGINE_BENCHMARK_SIMPLIFY_BENCHMARK_H
 
 #include "../tests/ReadTestPolygons.h"
+#include "geometry/OpenPolyline.h"
+#include "geometry/Polygon.h"
 #include "utils/Simplify.h"
 #include "utils/channel.h"
 
 #include <fmt/format.h>
 
 #include <benchmark/benchmark.h>
+#include <cmath>
 #include <filesystem>
+#include <numbers>
 
 #ifdef ENABLE_PLUGINS
 #include "plugins/slots.h"
@@ -61,6 +65,59 @@ BENCHMARK_DEFINE_F(SimplifyTestFixture, simplify_local)(benchmark::State& st)
 
 BENCHMARK_REGISTER_F(SimplifyTestFixture, simplify_local);
 
+/*
+ * Long chains of which most vertices get removed, like the output of the slicer for a finely tessellated model. Deleting a vertex must not get slower with the
+ * number of vertices around it that are already deleted.
+ */
+class SimplifyLongTestFixture : public benchmark::Fixture
+{
+public:
+    Polygon circle;
+    OpenPolyline wave;
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        const auto vertex_count = static_cast<size_t>(state.range(0));
+        circle.clear();
+        wave.clear();
+        for (size_t i = 0; i < vertex_count; ++i)
+        {
+            const double angle = 2.0 * std::numbers::pi * static_cast<double>(i) / static_cast<double>(vertex_count);
+            circle.emplace_back(std::llrint(MM2INT(100.0) * std::cos(angle)), std::llrint(MM2INT(100.0) * std::sin(angle)));
+            // A wave with an amplitude below the maximum deviation, so that it straightens out almost entirely.
+            wave.emplace_back(static_cast<coord_t>(i) * 10, std::llrint(10.0 * std::sin(static_cast<double>(i) / 7.0)));
+        }
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+    }
+};
+
+BENCHMARK_DEFINE_F(SimplifyLongTestFixture, simplify_circle)(benchmark::State& st)
+{
+    Simplify simplify(MM2INT(0.25), MM2INT(0.025), 50000);
+    for (auto _ : st)
+    {
+        Polygon simplified;
+        benchmark::DoNotOptimize(simplified = simplify.polygon(circle));
+    }
+}
+
+BENCHMARK_REGISTER_F(SimplifyLongTestFixture, simplify_circle)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(SimplifyLongTestFixture, simplify_wave)(benchmark::State& st)
+{
+    Simplify simplify(MM2INT(0.25), MM2INT(0.025), 50000);
+    for (auto _ : st)
+    {
+        OpenPolyline simplified;
+        benchmark::DoNotOptimize(simplified = simplify.polyline(wave));
+    }
+}
+
+BENCHMARK_REGISTER_F(SimplifyLongTestFixture, simplify_wave)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
 #ifdef ENABLE_PLUGINS
 BENCHMARK_DEFINE_F(SimplifyTestFixture, simplify_slot_noplugin)(benchmark::State& st)
 {
@@ -0,0 +1,166 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CURAENGINE_BENCHMARK_SLICER_BENCHMARK_H
+#define CURAENGINE_BENCHMARK_SLICER_BENCHMARK_H
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../tests/BrokenLayer.h"
+#include "geometry/OpenLinesSet.h"
+#include "mesh.h"
+#include "slicer.h"
+
+namespace cura
+{
+/*
+ * Exposes the stitching of a layer, which is otherwise only done as part of making its polygons.
+ */
+class StitchingSlicerLayer : public SlicerLayer
+{
+public:
+    using SlicerLayer::connectOpenPolylines;
+    using SlicerLayer::stitch;
+    using SlicerLayer::stitch_extensive;
+};
+
+class SlicerStitchTestFixture : public benchmark::Fixture
+{
+public:
+    static constexpr coord_t SIZE = MM2INT(200);
+
+    OpenLinesSet broken_polylines;
+    Shape intact_polygons;
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        // A fixed pseudo-random layer of a broken mesh, so that runs are comparable.
+        makeBrokenLayer(static_cast<size_t>(state.range(0)), SIZE, broken_polylines, intact_polygons);
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+    }
+};
+
+BENCHMARK_DEFINE_F(SlicerStitchTestFixture, SlicerLayer_stitch)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        StitchingSlicerLayer layer;
+        OpenLinesSet open_polylines = broken_polylines;
+        layer.connectOpenPolylines(open_polylines);
+        layer.stitch(open_polylines);
+        benchmark::DoNotOptimize(layer.polygons_);
+    }
+    st.SetItemsProcessed(st.iterations() * broken_polylines.size());
+}
+
+BENCHMARK_REGISTER_F(SlicerStitchTestFixture, SlicerLayer_stitch)->Arg(100)->Arg(1000);
+
+BENCHMARK_DEFINE_F(SlicerStitchTestFixture, SlicerLayer_stitch_extensive)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        StitchingSlicerLayer layer;
+        layer.polygons_ = intact_polygons;
+        OpenLinesSet open_polylines = broken_polylines;
+        layer.stitch_extensive(open_polylines);
+        benchmark::DoNotOptimize(layer.polygons_);
+    }
+    st.SetItemsProcessed(st.iterations() * broken_polylines.size());
+}
+
+BENCHMARK_REGISTER_F(SlicerStitchTestFixture, SlicerLayer_stitch_extensive)->Arg(100)->Arg(1000);
+
+/*
+ * Exposes the intersection of the triangles of a mesh with the layers, which is otherwise only done when constructing a Slicer.
+ */
+class SegmentsSlicer : public Slicer
+{
+public:
+    using Slicer::buildSegments;
+    using Slicer::buildTriangleBuffer;
+};
+
+class SlicerSegmentsTestFixture : public benchmark::Fixture
+{
+public:
+    static constexpr coord_t RADIUS = MM2INT(50);
+    static constexpr coord_t LAYER_HEIGHT = MM2INT(0.1);
+
+    Mesh mesh;
+    std::vector<coord_t> layer_z;
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        // A sphere tessellated into the given number of rings, each of twice as many triangles, optionally with UV coordinates.
+        const size_t ring_count = static_cast<size_t>(state.range(0));
+        const bool with_uv_coordinates = state.range(1) != 0;
+        const size_t segment_count = ring_count * 2;
+        const auto vertex = [ring_count, segment_count](const size_t ring, const size_t segment)
+        {
+            const double polar = std::numbers::pi * static_cast<double>(ring) / static_cast<double>(ring_count);
+            const double azimuth = 2.0 * std::numbers::pi * static_cast<double>(segment) / static_cast<double>(segment_count);
+            const double radius = static_cast<double>(RADIUS);
+            return Point3LL(
+                std::llrint(radius * std::sin(polar) * std::cos(azimuth)),
+                std::llrint(radius * std::sin(polar) * std::sin(azimuth)),
+                std::llrint(radius * (1.0 - std::cos(polar))));
+        };
+        const auto uv = [ring_count, segment_count, with_uv_coordinates](const size_t ring, const size_t segment) -> std::optional<Point2F>
+        {
+            if (! with_uv_coordinates)
+            {
+                return std::nullopt;
+            }
+            return Point2F(static_cast<float>(segment) / static_cast<float>(segment_count), static_cast<float>(ring) / static_cast<float>(ring_count));
+        };
+        mesh.clear();
+        for (size_t ring = 0; ring < ring_count; ++ring)
+        {
+            for (size_t segment = 0; segment < segment_count; ++segment)
+            {
+                const size_t next = segment + 1;
+                mesh.addFace(vertex(ring, segment), vertex(ring + 1, segment), vertex(ring + 1, next), uv(ring, segment), uv(ring + 1, segment), uv(ring + 1, next));
+                mesh.addFace(vertex(ring, segment), vertex(ring + 1, next), vertex(ring, next), uv(ring, segment), uv(ring + 1, next), uv(ring, next));
+            }
+        }
+        mesh.finish();
+
+        layer_z.clear();
+        for (coord_t z = LAYER_HEIGHT / 2; z < RADIUS * 2; z += LAYER_HEIGHT)
+        {
+            layer_z.push_back(z);
+        }
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+    }
+};
+
+BENCHMARK_DEFINE_F(SlicerSegmentsTestFixture, Slicer_buildSegments)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        std::vector<SlicerLayer> layers(layer_z.size());
+        for (size_t layer_idx = 0; layer_idx < layers.size(); ++layer_idx)
+        {
+            layers[layer_idx].z_ = static_cast<int>(layer_z[layer_idx]);
+        }
+        SegmentsSlicer::buildSegments(mesh, SegmentsSlicer::buildTriangleBuffer(mesh), SlicingTolerance::MIDDLE, layers);
+        benchmark::DoNotOptimize(layers);
+    }
+    // Triangles per second, for all layers together.
+    st.SetItemsProcessed(st.iterations() * mesh.faces_.size());
+}
+
+BENCHMARK_REGISTER_F(SlicerSegmentsTestFixture, Slicer_buildSegments)->Args({ 100, 0 })->Args({ 1000, 0 })->Args({ 1000, 1 });
+
+} // namespace cura
+#endif // CURAENGINE_BENCHMARK_SLICER_BENCHMARK_H
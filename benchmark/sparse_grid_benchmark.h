@@ -0,0 +1,222 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CURAENGINE_BENCHMARK_SPARSE_GRID_BENCHMARK_H
+#define CURAENGINE_BENCHMARK_SPARSE_GRID_BENCHMARK_H
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "geometry/Polygon.h"
+#include "geometry/Shape.h"
+#include "utils/FlatSparseGrid.h"
+#include "utils/SparseLineGrid.h"
+#include "utils/SparsePointGridInclusive.h"
+#include "utils/polygonUtils.h"
+
+namespace cura
+{
+class SparseGridTestFixture : public benchmark::Fixture
+{
+public:
+    static constexpr coord_t CELL_SIZE = MM2INT(1);
+    static constexpr coord_t SIZE = MM2INT(200);
+
+    std::vector<Point2LL> points;
+    std::vector<Point2LL> queries;
+    std::vector<std::pair<Point2LL, Point2LL>> segments;
+    Shape polygons;
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        // A fixed pseudo-random scattering, so that runs are comparable.
+        const size_t point_count = static_cast<size_t>(state.range(0));
+        uint64_t random = 12345;
+        const auto next_coord = [&random]()
+        {
+            random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<coord_t>((random >> 33) % SIZE);
+        };
+        points.clear();
+        for (size_t i = 0; i < point_count; ++i)
+        {
+            points.emplace_back(next_coord(), next_coord());
+        }
+        queries.clear();
+        segments.clear();
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            queries.emplace_back(next_coord(), next_coord());
+            const Point2LL from(next_coord(), next_coord());
+            segments.emplace_back(from, from + Point2LL(next_coord() / 20, next_coord() / 20));
+        }
+
+        // Polygons with the points as their vertices, to grid their line segments.
+        polygons.clear();
+        for (size_t start = 0; start + 8 <= points.size(); start += 8)
+        {
+            polygons.emplace_back(ClipperLib::Path(points.begin() + start, points.begin() + start + 8), false);
+        }
+    }
+
+    void TearDown(const ::benchmark::State& state)
+    {
+    }
+};
+
+BENCHMARK_DEFINE_F(SparseGridTestFixture, SparsePointGridInclusive_build)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        SparsePointGridInclusive<size_t> grid(CELL_SIZE);
+        for (size_t point_idx = 0; point_idx < points.size(); ++point_idx)
+        {
+            grid.insert(points[point_idx], point_idx);
+        }
+        benchmark::DoNotOptimize(grid);
+    }
+    st.SetItemsProcessed(st.iterations() * points.size());
+}
+
+BENCHMARK_REGISTER_F(SparseGridTestFixture, SparsePointGridInclusive_build)->Arg(10000)->Arg(100000);
+
+BENCHMARK_DEFINE_F(SparseGridTestFixture, FlatSparseGrid_build)(benchmark::State& st)
+{
+    for (auto _ : st)
+    {
+        FlatSparseGrid<size_t> grid(CELL_SIZE, points.size());
+        for (size_t point_idx = 0; point_idx < points.size(); ++point_idx)
+        {
+            grid.insertPoint(points[point_idx], point_idx);
+        }
+        grid.build();
+        benchmark::DoNotOptimize(grid);
+    }
+    st.SetItemsProcessed(st.iterations() * points.size());
+}
+
+BENCHMARK_REGISTER_F(SparseGridTestFixture, FlatSparseGrid_build)->Arg(10000)->Arg(100000);
+
+BENCHMARK_DEFINE_F(SparseGridTestFixture, SparsePointGridInclusive_processNearby)(benchmark::State& st)
+{
+    SparsePointGridInclusive<size_t> grid(CELL_SIZE);
+    for (size_t point_idx = 0; point_idx < points.size(); ++point_idx)
+    {
+        grid.insert(points[point_idx], point_idx);
+    }
+    for (auto _ : st)
+    {
+        size_t found = 0;
+        for (const Point2LL& query : queries)
+        {
+            grid.processNearby(
+                query,
+                CELL_SIZE * 2,
+                [&found](const auto&)
+                {
+                    ++found;
+                    return true;
+                });
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    st.SetItemsProcessed(st.iterations() * queries.size());
+}
+
+BENCHMARK_REGISTER_F(SparseGridTestFixture, SparsePointGridInclusive_processNearby)->Arg(10000)->Arg(100000);
+
+BENCHMARK_DEFINE_F(SparseGridTestFixture, FlatSparseGrid_processNearby)(benchmark::State& st)
+{
+    FlatSparseGrid<size_t> grid(CELL_SIZE, points.size());
+    for (size_t point_idx = 0; point_idx < points.size(); ++point_idx)
+    {
+        grid.insertPoint(points[point_idx], point_idx);
+    }
+    grid.build();
+    for (auto _ : st)
+    {
+        size_t found = 0;
+        for (const Point2LL& query : queries)
+        {
+            grid.processNearby(
+                query,
+                CELL_SIZE * 2,
+                [&found](const auto&)
+                {
+                    ++found;
+                    return true;
+                });
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    st.SetItemsProcessed(st.iterations() * queries.size());
+}
+
+BENCHMARK_REGISTER_F(SparseGridTestFixture, FlatSparseGrid_processNearby)->Arg(10000)->Arg(100000);
+
+BENCHMARK_DEFINE_F(SparseGridTestFixture, SparseLineGrid_processLine)(benchmark::State& st)
+{
+    SparseLineGrid<PolygonsPointIndex, PolygonsPointIndexSegmentLocator> grid(CELL_SIZE);
+    for (size_t poly_idx = 0; poly_idx < polygons.size(); ++poly_idx)
+    {
+        for (size_t point_idx = 0; point_idx < polygons[poly_idx].size(); ++point_idx)
+        {
+            grid.insert(PolygonsPointIndex(&polygons, poly_idx, point_idx));
+        }
+    }
+    for (auto _ : st)
+    {
+        size_t found = 0;
+        for (const std::pair<Point2LL, Point2LL>& segment : segments)
+        {
+            grid.processLine(
+                segment,
+                [&found](const PolygonsPointIndex&)
+                {
+                    ++found;
+                    return true;
+                });
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    st.SetItemsProcessed(st.iterations() * segments.size());
+}
+
+BENCHMARK_REGISTER_F(SparseGridTestFixture, SparseLineGrid_processLine)->Arg(10000)->Arg(100000);
+
+BENCHMARK_DEFINE_F(SparseGridTestFixture, FlatSparseGrid_processLine)(benchmark::State& st)
+{
+    FlatSparseGrid<PolygonsPointIndex> grid(CELL_SIZE);
+    const PolygonsPointIndexSegmentLocator locator;
+    for (size_t poly_idx = 0; poly_idx < polygons.size(); ++poly_idx)
+    {
+        for (size_t point_idx = 0; point_idx < polygons[poly_idx].size(); ++point_idx)
+        {
+            const PolygonsPointIndex segment(&polygons, poly_idx, point_idx);
+            grid.insertLine(locator(segment), segment);
+        }
+    }
+    grid.build();
+    for (auto _ : st)
+    {
+        size_t found = 0;
+        for (const std::pair<Point2LL, Point2LL>& segment : segments)
+        {
+            grid.processLine(
+                segment,
+                [&found](const PolygonsPointIndex&)
+                {
+                    ++found;
+                    return true;
+                });
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    st.SetItemsProcessed(st.iterations() * segments.size());
+}
+
+BENCHMARK_REGISTER_F(SparseGridTestFixture, FlatSparseGrid_processLine)->Arg(10000)->Arg(100000);
+
+} // namespace cura
+#endif // CURAENGINE_BENCHMARK_SPARSE_GRID_BENCHMARK_H
@@ -32,6 +32,7 @@ class CuraEngineConan(ConanFile):
         "enable_extensive_warnings": [True, False],
         "enable_plugins": [True, False],
         "enable_remote_plugins": [True, False],
+        "enable_tracing": [True, False],
         "with_cura_resources": [True, False],
     }
     default_options = {
@@ -40,6 +41,7 @@ class CuraEngineConan(ConanFile):
         "enable_extensive_warnings": False,
         "enable_plugins": True,
         "enable_remote_plugins": False,
+        "enable_tracing": False,
         "with_cura_resources": False,
     }
 
@@ -159,6 +161,7 @@ class CuraEngineConan(ConanFile):
         tc.variables["ENABLE_TESTING"] = not self.conf.get("tools.build:skip_test", False, check_type=bool)
         tc.variables["ENABLE_BENCHMARKS"] = self.options.enable_benchmarks
         tc.variables["EXTENSIVE_WARNINGS"] = self.options.enable_extensive_warnings
+        tc.variables["ENABLE_TRACING"] = self.options.enable_tracing
         tc.variables["OLDER_APPLE_CLANG"] = self.settings.compiler == "apple-clang" and Version(
             self.settings.compiler.version) < "14"
         tc.variables["ENABLE_THREADING"] = not (self.settings.arch == "wasm" and self.settings.os == "Emscripten")
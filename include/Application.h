@@ -130,6 +130,13 @@ protected:
      */
     void slice();
 
+#ifndef __EMSCRIPTEN__
+    /*!
+     * \brief Start a daemon that slices the jobs it reads from the standard input.
+     */
+    void daemon();
+#endif
+
 private:
     /*
      * \brief The number of arguments that the application was called with.
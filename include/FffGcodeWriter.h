@@ -111,6 +111,12 @@ public:
      */
     void setTargetStream(std::ostream* stream);
 
+    /*!
+     * Close the file that was set with setTargetFile, if any, and write further gcode to the standard output again.
+     * \return Whether all gcode could be written to the file.
+     */
+    bool closeTargetFile();
+
     /*!
      * Wether or not the extruder is actually used in the print, regardless of enablement.
      *
@@ -65,6 +65,8 @@ public:
      */
     void setTargetStream(std::ostream* stream);
 
+    bool closeTargetFile();
+
     /*!
      * Wether or not the extruder is actually used in the print, regardless of enablement.
      *
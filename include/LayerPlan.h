@@ -20,11 +20,13 @@
 #include "settings/PathConfigStorage.h"
 #include "settings/types/LayerIndex.h"
 #include "utils/ExtrusionJunction.h"
+#include "utils/ShapeSegmentGrid.h"
 
 #ifdef BUILD_TESTS
 #include <gtest/gtest_prod.h> //Friend tests, so that they can inspect the privates.
 #endif
 
+#include <array>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -148,14 +150,16 @@ private:
     std::optional<std::pair<Acceleration, Velocity>> next_layer_acc_jerk_; //!< If there is a next layer, the first acceleration and jerk it starts with.
     bool was_inside_; //!< Whether the last planned (extrusion) move was inside a layer part
     bool is_inside_; //!< Whether the destination of the next planned travel move is inside a layer part
-    Shape comb_boundary_minimum_; //!< The minimum boundary within which to comb, or to move into when performing a retraction.
-    Shape comb_boundary_preferred_; //!< The boundary preferably within which to comb, or to move into when performing a retraction.
+    mutable std::optional<Shape> comb_boundary_minimum_; //!< The minimum boundary within which to comb, or to move into when performing a retraction. Computed when first needed.
+    mutable std::optional<Shape> comb_boundary_preferred_; //!< The boundary preferably within which to comb, or to move into when performing a retraction. Computed when first needed.
+    mutable std::array<std::optional<Shape>, 3> infill_below_; //!< The union of the infill areas of all printed meshes 1, 2 and 3 layers below. Computed when first needed.
     Comb* comb_;
     coord_t comb_move_inside_distance_; //!< Whenever using the minimum boundary for combing it tries to move the coordinates inside by this distance after calculating the combing.
     Shape bridge_wall_mask_; //!< The regions of a layer part that are not supported, used for bridging
     AABB bridge_wall_mask_bb_; //!< Cached bounding box for the above value.
     std::vector<OverhangMask> overhang_masks_; //!< The regions of a layer part where the walls overhang, calculated for multiple overhang angles. The latter is the most
                                                //!< overhanging. For a visual explanation of the result, see doc/gradual_overhang_speed.svg
+    std::vector<ShapeSegmentGrid> overhang_mask_grids_; //!< Lookup grids for the supported regions of overhang_masks_, except for the last one which is unbounded
     Shape seam_overhang_mask_; //!< The regions of a layer part where the walls overhang, specifically as defined for the seam
 
     Shape roofing_mask_; //!< The regions of a layer part where the walls are exposed to the air above
@@ -169,6 +173,20 @@ private:
 
     std::map<const SliceMeshStorage*, MixedLinesSet> infill_lines_; //!< Infill lines generated for this layer
 
+    /*!
+     * The lines of the paths that are being written, to send to the layer view at once rather than point by point.
+     */
+    struct LayerViewLines
+    {
+        PrintFeatureType type{ PrintFeatureType::NoneType };
+        std::vector<Point3LL> to;
+        std::vector<coord_t> widths;
+        std::vector<coord_t> thicknesses;
+        std::vector<Velocity> velocities;
+    };
+    LayerViewLines layer_view_lines_;
+    bool send_layer_view_{ true }; //!< Whether the communication shows the lines in a layer view, so whether they need to be gathered at all.
+
     const std::vector<FanSpeedLayerTimeSettings> fan_speed_layer_time_settings_per_extruder_;
 
     enum CombBoundary
@@ -361,6 +379,14 @@ public:
      */
     const Shape& getSeamOverhangMask() const;
 
+    /*!
+     * Get the union of the infill areas of all printed meshes on a layer below this one, which bridge detection checks the skins against. Computed the first
+     * time it is requested, so that it is shared by all the skin parts of this layer.
+     *
+     * \param layers_below How many layers below this one: 1, 2 or 3.
+     */
+    const Shape& getInfillBelow(const size_t layers_below) const;
+
     /*!
      * Set roofing_mask.
      *
@@ -895,7 +921,16 @@ private:
      * \param boundary_type The boundary type to compute.
      * \return the combing boundary or an empty Shape if no combing is required
      */
-    Shape computeCombBoundary(const CombBoundary boundary_type);
+    Shape computeCombBoundary(const CombBoundary boundary_type) const;
+
+    /*!
+     * \brief Get the preferred or minimum combing boundary, computing it the
+     * first time it is requested.
+     *
+     * \param boundary_type The boundary type to get.
+     * \return the combing boundary or an empty Shape if no combing is required
+     */
+    const Shape& getCombBoundary(const CombBoundary boundary_type) const;
 
     /*!
      * Add order optimized lines to the gcode.
@@ -956,13 +991,19 @@ private:
         bool smooth_speed = false);
 
     /*!
-     *  @brief Send a GCodePath line to the communication object, applying proper Z offsets
+     *  @brief Queue a GCodePath line for the communication object, applying proper Z offsets
      *  @param path The path to be sent
      *  @param position The start position (which is not included in the path points)
      *  @param extrude_speed The actual used extrusion speed
+     *  @note The queued lines are only sent by flushLayerView, so that has to be called before anything else is sent to the communication object
      */
     void sendLineTo(const GCodePath& path, const Point3LL& position, const double extrude_speed, const std::optional<coord_t>& line_thickness = std::nullopt);
 
+    /*!
+     *  @brief Send the lines queued by sendLineTo to the communication object, in one call per print feature type
+     */
+    void flushLayerView();
+
     /*!
      *  @brief Write a travel move and properly apply the various Z offsets
      *  @param gcode The actual GCode exporter
@@ -68,8 +68,10 @@ public:
     /*
      * \brief Generate the 3D printing instructions to print a given mesh group.
      * \param mesh_group The mesh group to slice.
+     * \return Whether the mesh group could be sliced. A mesh group without
+     * any models to print is sliced into nothing.
      */
-    void processMeshGroup(MeshGroup& mesh_group);
+    bool processMeshGroup(MeshGroup& mesh_group);
 
 private:
     /*
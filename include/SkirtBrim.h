@@ -9,6 +9,7 @@
 #include "ExtruderTrain.h"
 #include "settings/EnumSettings.h"
 #include "sliceDataStorage.h"
+#include "utils/AABB.h"
 #include "utils/Coord_t.h"
 
 namespace cura
@@ -21,6 +22,9 @@ constexpr coord_t min_brim_line_length = 3000u; //!< open polyline brim lines sm
 
 class SkirtBrim
 {
+#ifdef BUILD_TESTS
+    friend class SkirtBrimClusterTest;
+#endif
 private:
     /*!
      * Store the various outlines that we want to create a brim around
@@ -83,6 +87,15 @@ private:
         coord_t gap_; //!< The gap between the part and the first brim/skirt line
     };
 
+    /*!
+     * The polygons of the starting outlines whose brims may touch each other, but can't reach the brims of any other polygons.
+     */
+    struct Cluster
+    {
+        AABB reach_; //!< The area which the brims of these polygons may cover.
+        std::vector<Outline> outlines_per_extruder_; //!< The polygons of the starting outline of each extruder that are part of this cluster.
+    };
+
     /*!
      * Defines an order on offsets (potentially from different extruders) based on how far the offset is from the original outline.
      */
@@ -148,6 +161,32 @@ private:
      */
     std::vector<coord_t> generatePrimaryBrim(std::vector<Offset>& all_brim_offsets, Shape& covered_area, std::vector<Shape>& allowed_areas_per_extruder);
 
+    /*!
+     * Group the polygons of the starting outlines into clusters whose brims can't reach each other.
+     *
+     * \param all_brim_offsets The planned offsets, which determine the starting outlines and how far the brims reach.
+     * \return The clusters, or a single cluster if the brims of all polygons may touch.
+     */
+    std::vector<Cluster> clusterStartingOutlines(const std::vector<Offset>& all_brim_offsets) const;
+
+    /*!
+     * Perform the planned offsets for every cluster separately, in parallel, and add the resulting brim lines to the storage.
+     *
+     * Within a cluster the offsets are performed in the same order as they would be for the whole layer. Since nothing outside of the reach of a cluster
+     * changes its brim, this gives the same brim lines.
+     *
+     * \param all_brim_offsets The planned offsets to perform.
+     * \param clusters The clusters to generate the brim of.
+     * \param[in,out] covered_area The area of the first layer covered by model or generated brim lines.
+     * \param[in,out] allowed_areas_per_extruder The difference between the machine bed area (offsetted by the nozzle offset) and the covered_area.
+     * \return The length of the brim lines added by each offset, for all clusters together.
+     */
+    std::vector<coord_t> generateClusteredBrim(
+        const std::vector<Offset>& all_brim_offsets,
+        std::vector<Cluster>& clusters,
+        Shape& covered_area,
+        std::vector<Shape>& allowed_areas_per_extruder);
+
     /*!
      * Generate the brim inside the ooze shield and draft shield
      *
@@ -190,12 +229,18 @@ private:
      * \warning Has side effects on \p covered_area, \p allowed_areas_per_extruder and \p total_length
      *
      * \param offset The parameters with which to perform the offset
+     * \param previous_lines The brim lines generated so far for the extruder of the offset, which an offset based on an earlier brim line refers to.
      * \param[in,out] covered_area The total area covered by the brims (and models) on the first layer.
      * \param[in,out] allowed_areas_per_extruder The difference between the machine areas and the \p covered_area
      * \param[out] result Where to store the resulting brim line
      * \return The length of the added lines
      */
-    coord_t generateOffset(const Offset& offset, Shape& covered_area, std::vector<Shape>& allowed_areas_per_extruder, MixedLinesSet& result);
+    coord_t generateOffset(
+        const Offset& offset,
+        const std::vector<MixedLinesSet>& previous_lines,
+        Shape& covered_area,
+        std::vector<Shape>& allowed_areas_per_extruder,
+        MixedLinesSet& result);
 
     /*!
      * Generate a skirt of extruders which don't yet comply with the minimum length requirement.
@@ -33,8 +33,9 @@ public:
      *
      * The g-code output is sent through the currently active communication
      * channel.
+     * \return Whether all mesh groups could be sliced.
      */
-    void compute();
+    bool compute();
 
     /*
      * \brief Empty out the slice instance, restoring it as if it were a new
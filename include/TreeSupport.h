@@ -121,6 +121,7 @@ private:
      *
      * Branches which do overlap have to be merged. This helper merges all elements in input with the elements into reduced_new_layer.
      * Elements in input_aabb are merged together if possible, while elements reduced_new_layer_aabb are not checked against each other.
+     * Only pairs of which the AABBs are in the same cell of a uniform grid are checked.
      *
      * \param reduced_aabb[in,out] The already processed elements.
      * \param input_aabb[in] Not yet processed elements
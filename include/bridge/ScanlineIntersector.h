@@ -0,0 +1,46 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#ifndef BRIDGE_SCANLINEINTERSECTOR_H
+#define BRIDGE_SCANLINEINTERSECTOR_H
+
+#include <vector>
+
+#include "utils/Coord_t.h"
+
+namespace cura
+{
+
+class TransformedSegment;
+class TransformedShape;
+
+/*!
+ * Finds the intersections of a transformed shape with horizontal lines, which are visited from the bottom up.
+ *
+ * Only the segments that reach the current line are tested, rather than all segments of the shape for every line. The intersections are the same as when
+ * testing all segments, but may be in a different order.
+ */
+class ScanlineIntersector
+{
+public:
+    /*!
+     * @param transformed_shape The shape to intersect with, which must outlive this intersector
+     */
+    explicit ScanlineIntersector(const TransformedShape& transformed_shape);
+
+    /*!
+     * Calculates all the intersections between a horizontal line and the shape
+     * @param line_y The horizontal line Y coordinate, which may not be lower than that of the previous call
+     * @return The list of X coordinates of the intersections, unsorted
+     */
+    std::vector<coord_t> intersections(const coord_t line_y);
+
+private:
+    std::vector<const TransformedSegment*> segments_by_min_y_; //!< All segments of the shape, from the lowest to the highest bottom.
+    size_t next_segment_ = 0; //!< The first segment in segments_by_min_y_ that hasn't reached any of the lines so far.
+    std::vector<const TransformedSegment*> active_segments_; //!< The segments that have reached the lines so far, except the ones that ended below the last line.
+};
+
+} // namespace cura
+
+#endif // BRIDGE_SCANLINEINTERSECTOR_H
@@ -29,6 +29,8 @@ class LayerPlan;
  * \param layer_nr The layer currently being printed.
  * \param bridge_layer The bridge layer number (1, 2 or 3).
  * \param support_layer Support that the bridge could rest on.
+ * \param layer_plan The plan of the layer currently being printed, which
+ * caches the infill below the skins of the layer.
  * \param supported_regions Pre-computed regions that the support layer would
  * support.
  */
@@ -39,6 +41,7 @@ std::optional<AngleDegrees> bridgeAngle(
     const unsigned layer_nr,
     const unsigned bridge_layer,
     const SupportLayer* support_layer,
+    const LayerPlan& layer_plan,
     Shape& supported_regions);
 
 /*!
@@ -134,6 +134,22 @@ public:
      */
     void sendLineTo(const PrintFeatureType& type, const Point3LL& to, const coord_t& line_width, const coord_t& line_thickness, const Velocity& velocity) override;
 
+    /*
+     * \brief Send a sequence of lines to the front-end to display in layer
+     * view, appending them to the current path at once.
+     * \param type The type of print feature the lines represent.
+     * \param to The destination coordinates of the lines.
+     * \param line_widths The width of each line.
+     * \param line_thicknesses The thickness (in the Z direction) of each line.
+     * \param velocities The velocity of printing each line.
+     */
+    void sendLinesTo(
+        const PrintFeatureType& type,
+        std::span<const Point3LL> to,
+        std::span<const coord_t> line_widths,
+        std::span<const coord_t> line_thicknesses,
+        std::span<const Velocity> velocities) override;
+
     /*
      * \brief Send the sliced layer data to the front-end after the optimisation
      * is done and the actual order in which to print has been set.
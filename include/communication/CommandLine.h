@@ -5,6 +5,7 @@
 #define COMMANDLINE_H
 
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <rapidjson/document.h> //Loading JSON documents to get settings from them.
 #include <string> //To store the command line arguments.
@@ -15,7 +16,10 @@
 
 namespace cura
 {
+class Matrix4x3D;
+class MeshGroup;
 class Settings;
+struct FlattenedDefinition;
 
 using setting_map = std::unordered_map<std::string, std::string>;
 using container_setting_map = std::unordered_map<std::string, setting_map>;
@@ -26,6 +30,10 @@ using container_setting_map = std::unordered_map<std::string, setting_map>;
  */
 class CommandLine : public Communication
 {
+#ifdef BUILD_TESTS
+    friend class DefinitionCacheTest;
+#endif
+
 public:
     CommandLine() = default;
 
@@ -102,6 +110,18 @@ public:
      */
     void sendLineTo(const PrintFeatureType&, const Point3LL&, const coord_t&, const coord_t&, const Velocity&) override;
 
+    /*
+     * \brief Send a sequence of lines for display.
+     *
+     * The command line doesn't show any layer view so this is ignored.
+     */
+    void sendLinesTo(const PrintFeatureType&, std::span<const Point3LL>, std::span<const coord_t>, std::span<const coord_t>, std::span<const Velocity>) override;
+
+    /*
+     * \brief The command line doesn't show any layer view.
+     */
+    bool hasLayerView() const override;
+
     /*
      * \brief Complete a layer to show it in layer view.
      *
@@ -149,9 +169,53 @@ protected:
      */
     std::vector<std::string> arguments_;
 
+    /*
+     * \brief Slice the scene that the command line arguments describe.
+     * \return Whether all mesh groups could be sliced.
+     */
+    bool sliceArguments();
+
+    /*
+     * \brief Load a model file given with -l into a mesh group.
+     * \param mesh_group The mesh group to add the mesh to.
+     * \param filename The model file to load.
+     * \param transformation The transformation to apply to all vertices.
+     * \param object_parent_settings The parent settings of the new mesh.
+     * \return Whether the file could be loaded.
+     */
+    virtual bool loadMesh(MeshGroup* mesh_group, const std::string& filename, const Matrix4x3D& transformation, Settings& object_parent_settings);
+
 private:
+    /*
+     * \brief A parsed JSON file, with the modification time of the file when it was parsed.
+     */
+    struct ParsedJSON
+    {
+        std::filesystem::file_time_type modified;
+        std::shared_ptr<const rapidjson::Document> document;
+    };
+
     std::vector<std::filesystem::path> search_directories_;
 
+    /*
+     * \brief The JSON files that were parsed before, by their path.
+     *
+     * Every -j argument loads its whole inheritance chain, so fdmprinter.def.json and the like are needed again for every extruder and every slice.
+     */
+    std::unordered_map<std::string, ParsedJSON> parsed_json_files_;
+
+    /*
+     * \brief The directory to cache flattened definition files in, or empty to parse the JSON files every time.
+     */
+    std::filesystem::path definition_cache_directory_;
+
+    /*
+     * \brief The flattened definitions that are being recorded while loading JSON files, innermost last.
+     *
+     * A null pointer suspends recording, while loading into other settings than the definition that is being recorded, such as the extruder trains.
+     */
+    std::vector<FlattenedDefinition*> definition_recordings_;
+
     /*
      * The last progress update that we output to stdcerr.
      */
@@ -169,6 +233,34 @@ private:
      */
     int loadJSON(const std::filesystem::path& json_filename, Settings& settings, bool force_read_parent = false, bool force_read_nondefault = false);
 
+    /*
+     * \brief Load a JSON file and store the settings inside it, without looking in the definition cache.
+     *
+     * The parameters and return value are the same as for loadJSON.
+     */
+    int loadJSONFile(const std::filesystem::path& json_filename, Settings& settings, bool force_read_parent, bool force_read_nondefault);
+
+    /*
+     * \brief Do what loading a definition file did when it was flattened.
+     * \param definition The flattened definition.
+     * \param settings The settings storage to store the settings in.
+     * \param force_read_parent Also read-in values of non-leaf settings, for the extruder definitions.
+     */
+    void loadFlattenedDefinition(const FlattenedDefinition& definition, Settings& settings, bool force_read_parent);
+
+    /*
+     * \brief The flattened definition that loading JSON files should be recorded in, if any.
+     */
+    FlattenedDefinition* recording() const;
+
+    /*
+     * \brief Parse a JSON file, or get it from the files that were parsed before if it didn't change since.
+     * \param json_filename The location of the JSON file to parse.
+     * \param document Output parameter: the parsed document.
+     * \return Error code, as for loadJSON.
+     */
+    int parseJSON(const std::filesystem::path& json_filename, std::shared_ptr<const rapidjson::Document>& document);
+
     /*
      * \brief Load a JSON document and store the settings inside it.
      * \param document The JSON document to load the settings from.
@@ -4,6 +4,8 @@
 #ifndef COMMUNICATION_H
 #define COMMUNICATION_H
 
+#include <span>
+
 #include "geometry/Point2LL.h"
 #include "settings/types/LayerIndex.h"
 #include "settings/types/Velocity.h"
@@ -78,6 +80,42 @@ public:
      */
     virtual void sendLineTo(const PrintFeatureType& type, const Point3LL& to, const coord_t& line_width, const coord_t& line_thickness, const Velocity& velocity) = 0;
 
+    /*
+     * \brief Send a sequence of lines to the user to visualise, as if
+     * ``sendLineTo`` was called for each of them.
+     *
+     * Protocols that show a layer view should override this to add the whole
+     * sequence at once, rather than point by point.
+     * \param type The type of print feature the lines represent.
+     * \param to The destination coordinates of the lines.
+     * \param line_widths The width of each line.
+     * \param line_thicknesses The thickness (in the Z direction) of each line.
+     * \param velocities The velocity of printing each line.
+     */
+    virtual void sendLinesTo(
+        const PrintFeatureType& type,
+        std::span<const Point3LL> to,
+        std::span<const coord_t> line_widths,
+        std::span<const coord_t> line_thicknesses,
+        std::span<const Velocity> velocities)
+    {
+        for (size_t line_idx = 0; line_idx < to.size(); ++line_idx)
+        {
+            sendLineTo(type, to[line_idx], line_widths[line_idx], line_thicknesses[line_idx], velocities[line_idx]);
+        }
+    }
+
+    /*
+     * \brief Whether the lines sent with ``sendLineTo`` and ``sendLinesTo``
+     * are shown to the user.
+     *
+     * If not, there is no need to gather them.
+     */
+    virtual bool hasLayerView() const
+    {
+        return true;
+    }
+
     /*
      * \brief Send the current position to visualise.
      *
@@ -0,0 +1,83 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef DAEMONCOMMUNICATION_H
+#define DAEMONCOMMUNICATION_H
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "communication/CommandLine.h"
+#include "mesh.h"
+#include "utils/gettime.h"
+
+namespace cura
+{
+
+/*
+ * \brief Slices one job after the other, read from an input stream, without starting a new engine for every job.
+ *
+ * Every line of the input is a job: a JSON array with the arguments that would follow "CuraEngine slice" on the command line, for instance
+ * ["-j", "printer.def.json", "-l", "part.stl", "-o", "part.gcode"]. Every job must write its g-code to a file with -o. When a job is done, a line with a JSON
+ * object describing it is written to the output.
+ *
+ * Between the jobs, the thread pool, the parsed definition files and the loaded models are kept. Models are recognised by the path, size and modification
+ * time of their files, so a model that was changed in between is loaded again. Only the models of the last job are kept.
+ */
+class DaemonCommunication : public CommandLine
+{
+public:
+    /*
+     * \brief Construct a daemon that reads jobs from \p input and reports on \p output.
+     */
+    DaemonCommunication(std::istream& input = std::cin, std::ostream& output = std::cout);
+
+    /*
+     * \brief Test whether the input may have another job.
+     */
+    bool hasSlice() const override;
+
+    /*
+     * \brief Read the next job from the input, slice it and report on it.
+     */
+    void sliceNext() override;
+
+protected:
+    /*
+     * \brief The models loaded before, just after loading, by the path, size and modification time of their files and the transformation applied to them.
+     */
+    std::unordered_map<std::string, Mesh> loaded_meshes_;
+
+    /*
+     * \brief Load a model, or copy it from the models loaded by earlier jobs.
+     */
+    bool loadMesh(MeshGroup* mesh_group, const std::string& filename, const Matrix4x3D& transformation, Settings& object_parent_settings) override;
+
+    /*
+     * \brief Forget the loaded models that the job which just ended didn't use, so that the memory doesn't grow with every new model.
+     */
+    void forgetUnusedMeshes();
+
+private:
+    std::istream& input_;
+    std::ostream& output_;
+
+    size_t job_count_ = 0; //!< The number of jobs received so far.
+    TimeKeeper uptime_; //!< Time since the daemon started.
+
+    std::unordered_set<std::string> used_meshes_; //!< The keys of the loaded models that the current job uses.
+
+    /*
+     * \brief Write a reply to the output.
+     * \param succeeded Whether the job was sliced.
+     * \param message What went wrong, or the output file if nothing did.
+     * \param duration How long the job took, in seconds.
+     */
+    void reply(bool succeeded, const std::string& message, double duration);
+};
+
+} // namespace cura
+
+#endif // DAEMONCOMMUNICATION_H
@@ -5,6 +5,8 @@
 #define GCODEEXPORT_H
 
 #include <deque> // for extrusionAmountAtPreviousRetractions
+#include <future> // For the time estimate of the last layer, calculated while the next one is written.
+#include <memory> // unique_ptr
 #ifdef BUILD_TESTS
 #include <gtest/gtest_prod.h> //To allow tests to use protected members.
 #endif
@@ -29,6 +31,7 @@ namespace cura
 
 class RetractionConfig;
 class SliceDataStorage;
+class ThreadPool;
 struct WipeScriptConfig;
 
 // The GCodeExport class writes the actual GCode. This is the only class that knows how GCode looks and feels.
@@ -178,6 +181,9 @@ private:
 
     std::vector<Duration> total_print_times_; //!< The total estimated print time in seconds for each feature
     TimeEstimateCalculator estimate_calculator_;
+    std::future<std::vector<Duration>> pending_time_estimate_; //!< Estimate of the last finished layer, still being calculated. Not yet part of total_print_times_.
+    std::unique_ptr<ThreadPool> time_estimate_worker_; //!< A single thread calculating the estimates, started with the first one. The workers of the global thread pool are
+                                                       //!< busy with the layer pipeline until slicing is done.
 
     LayerIndex layer_nr_; //!< for sending travel data
 
@@ -313,7 +319,25 @@ public:
      * \return total print time in seconds for the complete print
      */
     double getSumTotalPrintTimes();
+
+    /*!
+     * Start calculating the estimated print time of everything planned since
+     * the last call, in the background.
+     *
+     * The result is added to the total print time by writePendingTimeEstimate.
+     */
     void updateTotalPrintTime();
+
+    /*!
+     * Wait for the estimate started by updateTotalPrintTime, if any, add it to
+     * the total print time and write the elapsed time comment.
+     *
+     * Must be called before anything else is written after the layer, and
+     * before the g-code of the layer is sent, so that the comment ends up at
+     * the same place as if it was calculated directly.
+     */
+    void writePendingTimeEstimate();
+
     void resetTotalPrintTimeAndFilament();
 
     void writeComment(const std::string& comment);
@@ -511,7 +511,8 @@ private:
      * \param scanline_min_idx The lowest index of all scanlines crossing the polygon
      * \param line_distance The distance between two lines which are in the same direction
      * \param boundary The axis aligned boundary box within which the polygon is
-     * \param cut_list A mapping of each scanline to all y-coordinates (in the space transformed by rotation_matrix) where the polygons are crossing the scanline
+     * \param cut_list All y-coordinates (in the space transformed by rotation_matrix) where the polygons are crossing the scanlines, grouped by scanline
+     * \param cut_list_starts For each scanline, the index in \p cut_list of its first crossing, followed by the size of \p cut_list
      * \param total_shift total shift of the scanlines in the direction perpendicular to the fill_angle.
      */
     void addLineInfill(
@@ -520,7 +521,8 @@ private:
         const int scanline_min_idx,
         const int line_distance,
         const AABB boundary,
-        std::vector<std::vector<coord_t>>& cut_list,
+        std::vector<coord_t>& cut_list,
+        const std::vector<size_t>& cut_list_starts,
         coord_t total_shift);
 
     /*!
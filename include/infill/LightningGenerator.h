@@ -72,6 +72,44 @@ protected:
      */
     void generateTrees(const SliceMeshStorage& mesh);
 
+    /*!
+     * A set of parts that trees can grow through, but that no tree can reach
+     * from outside of the set.
+     *
+     * Trees only grow downwards within the infill areas, so parts that don't
+     * touch any parts of other regions in the layer above or below can be
+     * filled independently.
+     */
+    struct Region
+    {
+        size_t top_layer; //!< The highest layer with a part in this region. There are parts in all layers below it, down to the bottom of the region.
+        std::vector<std::vector<size_t>> parts_per_layer; //!< The indices of the parts in each layer, from the top layer down.
+        size_t point_count = 0; //!< The number of vertices of all the infill areas, as an estimate of how much work the region is.
+
+        std::vector<Shape> outlines; //!< For each layer, the infill area of the region.
+        std::vector<Shape> overhangs; //!< For each layer, the overhang of the region that needs to be supported.
+        std::vector<std::unique_ptr<LocToLineGrid>> outline_locators; //!< For each layer, a grid to quickly find the lines of the outlines.
+    };
+
+    /*!
+     * Group the parts of all layers into regions that can be filled
+     * independently.
+     * \param infill_outlines_per_part For each layer, the infill area of each
+     * part.
+     * \param connection_distance How far apart parts in adjacent layers may be
+     * while still being connected by trees.
+     * \return The regions, in the order of their highest part.
+     */
+    static std::vector<Region> findRegions(const std::vector<std::vector<Shape>>& infill_outlines_per_part, const coord_t connection_distance);
+
+    /*!
+     * Calculate the tree structure of one region, from its top layer down.
+     * \param region The region to fill, with its outlines, overhangs and
+     * locators.
+     * \return For each layer of the region, from the top down, the trees.
+     */
+    std::vector<LightningLayer> generateTrees(Region& region) const;
+
     /*!
      * How far each piece of infill can support skin in the layer above.
      */
@@ -106,11 +144,19 @@ protected:
     coord_t straightening_max_distance;
 
     /*!
-     * For each layer, the overhang that needs to be supported by the pattern.
+     * For each layer, the area of each part that is filled with infill.
+     *
+     * This is generated by \ref generateInitialInternalOverhangs.
+     */
+    std::vector<std::vector<Shape>> infill_outlines_per_part;
+
+    /*!
+     * For each layer, the overhang of each part that needs to be supported by
+     * the pattern.
      *
      * This is generated by \ref generateInitialInternalOverhangs.
      */
-    std::vector<Shape> overhang_per_layer;
+    std::vector<std::vector<Shape>> overhang_per_part;
 
     /*!
      * For each layer, the generated lightning paths.
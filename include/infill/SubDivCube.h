@@ -4,6 +4,13 @@
 #ifndef INFILL_SUBDIVCUBE_H
 #define INFILL_SUBDIVCUBE_H
 
+#include <array>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #include "geometry/OpenLinesSet.h"
 #include "geometry/Point2LL.h"
 #include "geometry/Point3LL.h"
@@ -20,14 +27,43 @@ class SliceMeshStorage;
 
 class SubDivCube
 {
+#ifdef BUILD_TESTS
+    friend class SubDivCubeTest;
+#endif
 public:
     /*!
-     * Constructor for SubDivCube. Recursively calls itself eight times to flesh out the octree.
-     * \param mesh contains infill layer data and settings
-     * \param my_center the center of the cube
+     * Precomputed data to decide which cubes to subdivide, only used while the octree is built.
+     */
+    class Builder;
+
+    /*!
+     * The properties of an octree of subdivided cubes, which depend on the settings of its mesh. They are shared by all cubes of the octree, so that the
+     * octrees of different meshes don't interfere.
+     */
+    struct OctreeProperties
+    {
+        struct CubeProperties
+        {
+            coord_t side_length; //!< side length of cubes
+            coord_t height; //!< height of cubes based. This is the distance from one point of a cube to its 3d opposite.
+            coord_t square_height; //!< square cut across lengths. This is the diagonal distance across a face of the cube.
+            coord_t max_draw_z_diff; //!< maximum draw z differences. This is the maximum difference in z at which lines need to be drawn.
+            coord_t max_line_offset; //!< maximum line offsets. This is the maximum distance at which subdivision lines should be drawn from the 2d cube center.
+        };
+
+        std::vector<CubeProperties> cube_properties_per_recursion_step; //!< precomputed array of basic properties of cubes based on recursion depth.
+        coord_t radius_addition{ 0 }; //!< addition to the bounding radius when determining if a cube should be subdivided
+        Point3Matrix rotation_matrix; //!< The rotation matrix to get from axis aligned cubes to cubes standing on a corner point aligned with the infill_angle
+        PointMatrix infill_rotation_matrix; //!< Horizontal rotation applied to infill
+    };
+
+    /*!
+     * Constructor for SubDivCube. The children are added by \ref subdivide.
+     * \param properties the properties of the octree that the cube is part of
+     * \param center the center of the cube
      * \param depth the recursion depth of the cube (0 is most recursed)
      */
-    SubDivCube(SliceMeshStorage& mesh, Point3LL& center, size_t depth);
+    SubDivCube(std::shared_ptr<const OctreeProperties> properties, const Point3LL& center, size_t depth);
 
     /*!
      * Precompute the octree of subdivided cubes
@@ -37,28 +73,43 @@ public:
 
     /*!
      * Generates the lines of subdivision of the specific cube at the specific layer. It recursively calls itself, so it ends up drawing all the subdivision lines of sub-cubes too.
+     *
+     * The lines of the root of an octree are cached for the most recent layers, since every part of a layer uses the same lines.
      * \param z the specified layer height
      * \param result (output) The resulting lines
      */
-    void generateSubdivisionLines(const coord_t z, OpenLinesSet& result);
+    void generateSubdivisionLines(const coord_t z, OpenLinesSet& result) const;
 
 private:
+    /*!
+     * The subdivision lines of the layers that were requested most recently, shared by all parts of those layers.
+     */
+    struct LineCache
+    {
+        std::mutex mutex;
+        std::deque<std::pair<coord_t, std::shared_ptr<const OpenLinesSet>>> lines_per_z; //!< the most recently generated layer last
+    };
+
+    /*!
+     * Generates the lines of subdivision of this cube and its children at the specific layer, without using the cache.
+     * \param z the specified layer height
+     * \param result (output) The resulting lines
+     */
+    void generateUncachedSubdivisionLines(const coord_t z, OpenLinesSet& result) const;
+
     /*!
      * Generates the lines of subdivision of the specific cube at the specific layer. It recursively calls itself, so it ends up drawing all the subdivision lines of sub-cubes too.
      * \param z the specified layer height
      * \param result (output) The resulting lines
      * \param directional_line_groups Array of 3 times a polylines. Used to keep track of line segments that are all pointing the same direction for line segment combining
      */
-    void generateSubdivisionLines(const coord_t z, OpenLinesSet (&directional_line_groups)[3]);
+    void generateSubdivisionLines(const coord_t z, OpenLinesSet (&directional_line_groups)[3]) const;
 
-    struct CubeProperties
-    {
-        coord_t side_length; //!< side length of cubes
-        coord_t height; //!< height of cubes based. This is the distance from one point of a cube to its 3d opposite.
-        coord_t square_height; //!< square cut across lengths. This is the diagonal distance across a face of the cube.
-        coord_t max_draw_z_diff; //!< maximum draw z differences. This is the maximum difference in z at which lines need to be drawn.
-        coord_t max_line_offset; //!< maximum line offsets. This is the maximum distance at which subdivision lines should be drawn from the 2d cube center.
-    };
+    /*!
+     * Adds the children of this cube that should be subdivided, without subdividing those any further.
+     * \param builder the data to decide which cubes to subdivide
+     */
+    void subdivide(const Builder& builder);
 
     /*!
      * Rotates a point 120 degrees about the origin.
@@ -70,41 +121,19 @@ private:
      * Rotates a point to align it with the orientation of the infill.
      * \param target the point to rotate.
      */
-    static void rotatePointInitial(Point2LL& target);
-
-    /*!
-     * Determines if a described theoretical cube should be subdivided based on if a sphere that encloses the cube touches the infill mesh.
-     * \param mesh contains infill layer data and settings
-     * \param center the center of the described cube
-     * \param radius the radius of the enclosing sphere
-     * \return the described cube should be subdivided
-     */
-    static bool isValidSubdivision(SliceMeshStorage& mesh, Point3LL& center, coord_t radius);
-
-    /*!
-     * Finds the distance to the infill border at the specified layer from the specified point.
-     * \param mesh contains infill layer data and settings
-     * \param layer_nr the number of the specified layer
-     * \param location the location of the specified point
-     * \param[out] distance2 the squared distance to the infill border
-     * \return Code 0: outside, 1: inside, 2: boundary does not exist at specified layer
-     */
-    static coord_t distanceFromPointToMesh(SliceMeshStorage& mesh, const LayerIndex layer_nr, Point2LL& location, coord_t* distance2);
+    void rotatePointInitial(Point2LL& target) const;
 
     /*!
      * Adds the defined line to the specified polygons. It assumes that the specified polygons are all parallel lines. Combines line segments with touching ends closer than
      * epsilon. \param[out] group the polygons to add the line to \param from the first endpoint of the line \param to the second endpoint of the line
      */
-    void addLineAndCombine(OpenLinesSet& group, Point2LL from, Point2LL to);
+    static void addLineAndCombine(OpenLinesSet& group, Point2LL from, Point2LL to);
 
+    std::shared_ptr<const OctreeProperties> properties_; //!< the properties of the octree, shared by all of its cubes
     size_t depth_; //!< the recursion depth of the cube (0 is most recursed)
     Point3LL center_; //!< center location of the cube in absolute coordinates
     std::array<std::shared_ptr<SubDivCube>, 8> children_; //!< pointers to this cube's eight octree children
-    static std::vector<CubeProperties> cube_properties_per_recursion_step_; //!< precomputed array of basic properties of cubes based on recursion depth.
-    static Ratio radius_multiplier_; //!< multiplier for the bounding radius when determining if a cube should be subdivided
-    static Point3Matrix rotation_matrix_; //!< The rotation matrix to get from axis aligned cubes to cubes standing on a corner point aligned with the infill_angle
-    static PointMatrix infill_rotation_matrix_; //!< Horizontal rotation applied to infill
-    static coord_t radius_addition_; //!< addition to the bounding radius when determining if a cube should be subdivided
+    std::unique_ptr<LineCache> line_cache_; //!< the lines of recent layers, only for the root of the octree
 };
 
 } // namespace cura
@@ -16,6 +16,8 @@ And all every bit inside a single part can be printed without the nozzle leaving
 It's also the first step that stores the result in the "data storage" so all other steps can access it.
 */
 
+#include <vector>
+
 namespace cura
 {
 
@@ -41,6 +43,17 @@ void createLayerWithParts(const Settings& settings, SliceLayer& storageLayer, Sl
  */
 void createLayerParts(SliceMeshStorage& mesh, Slicer* slicer);
 
+/*!
+ * \brief Split all layers of several meshes into parts.
+ *
+ * The layers of all meshes are processed in parallel together, which keeps
+ * the workers busy when there are many small meshes. The progress of the
+ * parts stage is messaged as the layers are done.
+ * \param meshes The meshes of which to split the layers into parts.
+ * \param slicers The slicer to get the layers from, for each mesh.
+ */
+void createLayerParts(const std::vector<SliceMeshStorage*>& meshes, const std::vector<Slicer*>& slicers);
+
 }//namespace cura
 
 #endif//LAYERPART_H
@@ -4,12 +4,16 @@
 #ifndef PATH_PLANNING_COMB_H
 #define PATH_PLANNING_COMB_H
 
+#include <atomic>
+#include <functional> // function
 #include <limits> // To find the maximum for coord_t.
 #include <memory> // shared_ptr
 
 #include "geometry/PartsView.h"
 #include "geometry/Polygon.h"
 #include "geometry/SingleShape.h"
+#include "pathPlanning/CombVisibilityGraph.h"
+#include "settings/EnumSettings.h"
 #include "settings/types/LayerIndex.h" // To store the layer on which we comb.
 #include "utils/polygonUtils.h"
 
@@ -41,12 +45,49 @@ class SliceDataStorage;
  * those SingleShapes within which to comb, while the boundary_outside isn't
  * split into outside parts, because generally there is only one outside part;
  * encapsulated holes occur less often.
+ *
+ * The inside boundaries and their LocToLineGrids are only built when a travel
+ * move actually needs them, since many layers have few or no combing moves.
  */
 class Comb
 {
     friend class LinePolygonsCrossings;
+#ifdef BUILD_TESTS
+    friend class CombVisibilityGraphTest;
+#endif
+
+public:
+    /*!
+     * Callback providing one of the inside comb boundaries. It is only called
+     * the first time the boundary is needed.
+     */
+    using BoundaryProvider = std::function<const Shape&()>;
+
+    /*!
+     * Counters on how many inside boundary grids were built over all layers,
+     * compared to how many would have been built eagerly.
+     */
+    struct GridStatistics
+    {
+        size_t inside_grids_built; //!< The number of inside LocToLineGrids actually built.
+        size_t inside_grids_available; //!< The number of inside LocToLineGrids which could have been built (two per Comb).
+    };
 
 private:
+    /*!
+     * An inside boundary together with its division into parts and the grid
+     * to look up its line segments, built on first use.
+     */
+    struct InsideBoundary
+    {
+        Shape boundary_; //!< The boundary within which to comb. (Will be reordered by the parts_view_)
+        const PartsView parts_view_; //!< Structured indices onto boundary_ which shows which polygons belong to which part.
+        std::unique_ptr<LocToLineGrid> loc_to_line_; //!< The SparsePointGridInclusive mapping locations to line segments of the boundary, or nullptr if not built yet.
+        std::unordered_map<size_t, std::unique_ptr<CombVisibilityGraph>> visibility_graphs_; //!< The routing graph per part index, for the parts which have been combed in.
+
+        explicit InsideBoundary(const Shape& boundary);
+    };
+
     /*!
      * A crossing from the inside boundary to the outside boundary.
      *
@@ -139,18 +180,19 @@ private:
     static constexpr coord_t offset_dist_to_get_from_on_the_polygon_to_outside_ = 40; //!< in order to prevent on-boundary vs crossing boundary confusions (precision thing)
     static constexpr coord_t offset_extra_start_end_ = 100; //!< Distance to move start point and end point toward eachother to extra avoid collision with the boundaries.
 
-    Shape boundary_inside_minimum_; //!< The boundary within which to comb. (Will be reordered by the partsView_inside_minimum)
-    Shape boundary_inside_optimal_; //!< The boundary within which to comb. (Will be reordered by the partsView_inside_optimal)
-    const PartsView parts_view_inside_minimum_; //!< Structured indices onto boundary_inside_minimum which shows which polygons belong to which part.
-    const PartsView parts_view_inside_optimal_; //!< Structured indices onto boundary_inside_optimal which shows which polygons belong to which part.
-    std::unique_ptr<LocToLineGrid> inside_loc_to_line_minimum_; //!< The SparsePointGridInclusive mapping locations to line segments of the inner boundary.
-    std::unique_ptr<LocToLineGrid> inside_loc_to_line_optimal_; //!< The SparsePointGridInclusive mapping locations to line segments of the inner boundary.
+    BoundaryProvider boundary_inside_minimum_provider_; //!< Provides the minimum boundary within which to comb, when it is first needed.
+    BoundaryProvider boundary_inside_optimal_provider_; //!< Provides the optimal boundary within which to comb, when it is first needed.
+    std::unique_ptr<InsideBoundary> inside_minimum_; //!< The minimum inside boundary, or nullptr when it hasn't been needed yet.
+    std::unique_ptr<InsideBoundary> inside_optimal_; //!< The optimal inside boundary, or nullptr when it hasn't been needed yet.
+    static inline std::atomic<size_t> inside_grids_built_{ 0 }; //!< Over all layers, the number of inside grids that were built.
+    static inline std::atomic<size_t> inside_grids_available_{ 0 }; //!< Over all layers, the number of inside grids that could have been built.
     std::unordered_map<size_t, Shape> boundary_outside_; //!< The boundary outside of which to stay to avoid collision with other layer parts. This is a pointer cause we only
                                                          //!< compute it when we move outside the boundary (so not when there is only a single part in the layer)
     std::unordered_map<size_t, Shape> model_boundary_; //!< The boundary of the model itself
     std::unordered_map<size_t, std::unique_ptr<LocToLineGrid>> outside_loc_to_line_; //!< The SparsePointGridInclusive mapping locations to line segments of the outside boundary.
     std::unordered_map<size_t, std::unique_ptr<LocToLineGrid>>
         model_boundary_loc_to_line_; //!< The SparsePointGridInclusive mapping locations to line segments of the model boundary
+    CombingEngine combing_engine_; //!< How to compute combing moves within a single part.
     coord_t move_inside_distance_; //!< When using comb_boundary_inside_minimum for combing it tries to move points inside by this amount after calculating the path to move it from
                                    //!< the border a bit.
 
@@ -174,6 +216,45 @@ private:
      */
     Shape& getModelBoundary(const ExtruderTrain& train);
 
+    /*!
+     * Get the minimum inside boundary and its parts. Copy and split it when it hasn't been needed yet.
+     */
+    InsideBoundary& getInsideMinimum();
+
+    /*!
+     * Get the optimal inside boundary and its parts. Copy and split it when it hasn't been needed yet.
+     */
+    InsideBoundary& getInsideOptimal();
+
+    /*!
+     * Get the SparsePointGridInclusive mapping locations to line segments of an inside boundary. Calculate it when it hasn't been calculated yet.
+     */
+    LocToLineGrid& getInsideLocToLine(InsideBoundary& inside);
+
+    /*!
+     * Get the visibility graph of a part of an inside boundary. Calculate it when it hasn't been calculated yet.
+     */
+    const CombVisibilityGraph& getVisibilityGraph(InsideBoundary& inside, const size_t part_idx);
+
+    /*!
+     * Comb from \p start_point to \p end_point within a single part of an inside boundary, using the configured combing engine.
+     *
+     * \param inside The inside boundary to which the part belongs.
+     * \param part_idx The index of the part in the parts view of \p inside.
+     * \param part The assembled part.
+     * \param comb_path Output parameter: the combing path generated.
+     * \return Whether combing succeeded.
+     */
+    bool combWithinPart(
+        InsideBoundary& inside,
+        const size_t part_idx,
+        const SingleShape& part,
+        Point2LL start_point,
+        Point2LL end_point,
+        CombPath& comb_path,
+        coord_t max_comb_distance_ignored,
+        bool fail_on_unavoidable_obstacles);
+
     /*!
      * Move the startPoint or endPoint inside when it should be inside
      * \param is_inside[in] Whether the \p dest_point should be inside
@@ -218,12 +299,32 @@ public:
     Comb(
         const SliceDataStorage& storage,
         const LayerIndex layer_nr,
-        const Shape& comb_boundary_inside_minimum,
-        const Shape& comb_boundary_inside_optimal,
+        BoundaryProvider comb_boundary_inside_minimum,
+        BoundaryProvider comb_boundary_inside_optimal,
         coord_t offset_from_outlines,
         coord_t travel_avoid_distance,
         coord_t move_inside_distance);
 
+    /*!
+     * Initialises the combing areas from boundaries which have already been
+     * computed.
+     *
+     * The boundaries are kept by this Comb, so they may be temporaries.
+     */
+    Comb(
+        const SliceDataStorage& storage,
+        const LayerIndex layer_nr,
+        Shape comb_boundary_inside_minimum,
+        Shape comb_boundary_inside_optimal,
+        coord_t offset_from_outlines,
+        coord_t travel_avoid_distance,
+        coord_t move_inside_distance);
+
+    /*!
+     * Get the counters on inside grid construction over all Comb instances so far.
+     */
+    static GridStatistics getGridStatistics();
+
     /*!
      * \brief Calculate the comb paths (if any), one for each polygon combed
      * alternated with travel paths.
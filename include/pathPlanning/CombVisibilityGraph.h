@@ -0,0 +1,97 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#ifndef PATH_PLANNING_COMB_VISIBILITY_GRAPH_H
+#define PATH_PLANNING_COMB_VISIBILITY_GRAPH_H
+
+#include <limits>
+#include <vector>
+
+#include "CombPath.h"
+#include "geometry/Shape.h"
+#include "utils/polygonUtils.h"
+
+namespace cura
+{
+
+/*!
+ * \brief Precomputed routing structure for combing within a single part.
+ *
+ * The nodes of the graph are the reflex corners of the part (seen from the
+ * inside), moved slightly inside. Two nodes are connected when the straight
+ * line between them doesn't cross the boundary. The shortest paths between
+ * all pairs of nodes are computed once, so that a travel query only has to
+ * find which nodes are visible from its start and end point.
+ *
+ * This is an alternative to LinePolygonsCrossings::comb, which walks the
+ * boundary crossings of every travel move anew. It pays off on layers with
+ * many travel moves within the same part.
+ */
+class CombVisibilityGraph
+{
+public:
+    /*!
+     * Build the visibility graph for a single part.
+     *
+     * \param part The part within which to comb. Must be a single outline with
+     * its holes.
+     * \param loc_to_line_grid A sparse grid mapping cells to all line segments
+     * of (at least) \p part, used to test visibility.
+     * \param dist_to_move_boundary_point_outside The distance by which to move
+     * the corners off the boundary. Use a negative value to move inside.
+     */
+    CombVisibilityGraph(const Shape& part, const LocToLineGrid& loc_to_line_grid, const coord_t dist_to_move_boundary_point_outside);
+
+    /*!
+     * Whether the graph could be built. For very detailed parts the graph is
+     * not built at all, in which case every query fails.
+     */
+    [[nodiscard]] bool isValid() const;
+
+    /*!
+     * Find the shortest combing path between two points within the part.
+     *
+     * \param start_point Where to start the combing move.
+     * \param end_point Where to end the combing move.
+     * \param comb_path Output parameter: the combing path, including the start
+     * and end point.
+     * \return Whether a path was found. When not, \p comb_path is untouched.
+     */
+    bool route(const Point2LL& start_point, const Point2LL& end_point, CombPath& comb_path) const;
+
+    /*!
+     * The maximum number of corners for which a graph is built. The memory and
+     * construction time grow quadratically resp. cubically with this number.
+     */
+    static constexpr size_t max_nodes_ = 256;
+
+private:
+    static constexpr coord_t no_route_ = std::numeric_limits<coord_t>::max(); //!< Distance between nodes which can't reach each other.
+    static constexpr size_t no_node_ = std::numeric_limits<size_t>::max(); //!< Marks the absence of a next node in a route.
+
+    const LocToLineGrid& loc_to_line_grid_; //!< Sparse grid of the boundary line segments, for visibility tests.
+    std::vector<Point2LL> nodes_; //!< The reflex corners of the part, moved off the boundary.
+    std::vector<coord_t> distances_; //!< Row-major matrix of the shortest distance from each node to each other node.
+    std::vector<size_t> next_; //!< Row-major matrix of the next node on the shortest route from each node to each other node.
+    bool valid_; //!< Whether the graph was built.
+
+    /*!
+     * Whether the straight line between two points doesn't cross the boundary.
+     */
+    bool isVisible(const Point2LL& from, const Point2LL& to) const;
+
+    /*!
+     * Get the indices of all nodes visible from \p point.
+     */
+    std::vector<size_t> getVisibleNodes(const Point2LL& point) const;
+
+    /*!
+     * Connect all mutually visible nodes and compute the shortest routes
+     * between all pairs of nodes.
+     */
+    void computeRoutes();
+};
+
+} // namespace cura
+
+#endif // PATH_PLANNING_COMB_VISIBILITY_GRAPH_H
@@ -158,6 +158,21 @@ public:
         LinePolygonsCrossings linePolygonsCrossings(boundary, loc_to_line_grid, startPoint, endPoint, dist_to_move_boundary_point_outside);
         return linePolygonsCrossings.generateCombingPath(combPath, max_comb_distance_ignored, fail_on_unavoidable_obstacles);
     };
+
+    /*!
+     * Whether combing from \p startPoint to \p endPoint within the boundary is
+     * impossible without crossing it, i.e. whether \ref comb would fail when
+     * failing on unavoidable obstacles.
+     * \param boundary The polygons not to cross.
+     * \param loc_to_line_grid A sparse grid mapping cells to all line segments of (at least) \p boundary in those cells
+     * \param startPoint From where to start the combing move.
+     * \param endPoint Where to end the combing move.
+     */
+    static bool hasUnavoidableObstacles(const Shape& boundary, LocToLineGrid& loc_to_line_grid, Point2LL startPoint, Point2LL endPoint)
+    {
+        LinePolygonsCrossings linePolygonsCrossings(boundary, loc_to_line_grid, startPoint, endPoint, 0);
+        return linePolygonsCrossings.lineSegmentCollidesWithBoundary() && ! linePolygonsCrossings.calcScanlineCrossings(true);
+    }
 };
 
 } // namespace cura
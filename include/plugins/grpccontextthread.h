@@ -0,0 +1,96 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef PLUGINS_GRPCCONTEXTTHREAD_H
+#define PLUGINS_GRPCCONTEXTTHREAD_H
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include <agrpc/grpc_context.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+
+namespace cura::plugins
+{
+
+/**
+ * @brief A gRPC context which lives as long as the plugin connection and runs on its own thread.
+ *
+ * Creating a completion queue and running it for a single request is expensive compared to the
+ * requests made by most slots. Instead, all requests to a plugin are spawned on this context, so
+ * that the requests of all threads that call the plugin are in flight at the same time and share
+ * one completion queue.
+ */
+class GrpcContextThread
+{
+public:
+    GrpcContextThread()
+        : work_guard_{ grpc_context_.get_executor() }
+        , thread_{ [this]()
+                   {
+                       grpc_context_.run();
+                   } }
+    {
+    }
+
+    GrpcContextThread(const GrpcContextThread&) = delete;
+    GrpcContextThread& operator=(const GrpcContextThread&) = delete;
+
+    ~GrpcContextThread()
+    {
+        work_guard_.reset();
+        thread_.join();
+    }
+
+    /**
+     * @brief Start a call on the context thread.
+     *
+     * @param make_call Callable which takes the gRPC context and returns the awaitable doing the call.
+     *  It, and everything it refers to, must stay alive until the returned future is ready.
+     * @return A future which becomes ready when the call is done, holding any exception it threw.
+     */
+    std::future<void> spawn(auto& make_call)
+    {
+        auto done = std::make_shared<std::promise<void>>();
+        std::future<void> result = done->get_future();
+        boost::asio::co_spawn(
+            grpc_context_,
+            [this, &make_call]() -> boost::asio::awaitable<void>
+            {
+                return make_call(grpc_context_);
+            },
+            [done](std::exception_ptr exception)
+            {
+                if (exception)
+                {
+                    done->set_exception(exception);
+                    return;
+                }
+                done->set_value();
+            });
+        return result;
+    }
+
+    /**
+     * @brief Do a call on the context thread and wait for it to finish.
+     *
+     * @throws Any exception thrown by the call.
+     */
+    void run(auto&& make_call)
+    {
+        spawn(make_call).get();
+    }
+
+private:
+    agrpc::GrpcContext grpc_context_; ///< Has to be constructed before the work guard and the thread.
+    boost::asio::executor_work_guard<agrpc::GrpcContext::executor_type> work_guard_; ///< Keeps the context running while it has no requests.
+    std::thread thread_;
+};
+
+} // namespace cura::plugins
+
+#endif // PLUGINS_GRPCCONTEXTTHREAD_H
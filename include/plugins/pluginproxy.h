@@ -13,7 +13,6 @@
 #include <agrpc/use_awaitable.hpp>
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/co_spawn.hpp>
-#include <boost/asio/detached.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
@@ -28,6 +27,7 @@
 #include "cura/plugins/v0/slot_id.pb.h"
 #include "plugins/broadcasts.h"
 #include "plugins/exception.h"
+#include "plugins/grpccontextthread.h"
 #include "plugins/metadata.h"
 #include "utils/format/thread_id.h"
 #include "utils/types/char_range_literal.h"
@@ -73,6 +73,7 @@ class PluginProxy
 
     ranges::semiregular_box<invoke_stub_t> invoke_stub_; ///< The gRPC Invoke stub for communication.
     ranges::semiregular_box<broadcast_stub_t> broadcast_stub_; ///< The gRPC Broadcast stub for communication.
+    std::shared_ptr<GrpcContextThread> grpc_context_; ///< Runs the requests to the plugin, shared by copies of this proxy.
 public:
     /**
      * @brief Constructs a PluginProxy object.
@@ -90,16 +91,15 @@ public:
     PluginProxy(const std::string& name, const std::string& version, std::shared_ptr<grpc::Channel> channel)
         : invoke_stub_{ channel }
         , broadcast_stub_{ channel }
+        , grpc_context_{ std::make_shared<GrpcContextThread>() }
     {
         // Connect to the plugin and exchange a handshake
-        agrpc::GrpcContext grpc_context;
         grpc::Status status;
         slots::handshake::v0::HandshakeService::Stub handshake_stub(channel);
         plugin_metadata plugin_info;
 
-        boost::asio::co_spawn(
-            grpc_context,
-            [this, &grpc_context, &status, &plugin_info, &handshake_stub, &name, &version]() -> boost::asio::awaitable<void>
+        grpc_context_->run(
+            [this, &status, &plugin_info, &handshake_stub, &name, &version](agrpc::GrpcContext& grpc_context) -> boost::asio::awaitable<void>
             {
                 using RPC = agrpc::ClientRPC<&slots::handshake::v0::HandshakeService::Stub::PrepareAsyncCall>;
                 grpc::ClientContext client_context{};
@@ -123,9 +123,7 @@ public:
                         spdlog::info("Subscribing plugin '{}' to the following broadcasts {}", plugin_info.plugin_name, plugin_info.broadcast_subscriptions);
                     }
                 }
-            },
-            boost::asio::detached);
-        grpc_context.run();
+            });
 
         if (! status.ok()) // TODO: handle different kind of status codes
         {
@@ -146,6 +144,7 @@ public:
         {
             invoke_stub_ = other.invoke_stub_;
             broadcast_stub_ = other.broadcast_stub_;
+            grpc_context_ = other.grpc_context_;
             valid_ = other.valid_;
             plugin_info_ = other.plugin_info_;
             slot_info_ = other.slot_info_;
@@ -158,6 +157,7 @@ public:
         {
             invoke_stub_ = std::move(other.invoke_stub_);
             broadcast_stub_ = std::move(other.broadcast_stub_);
+            grpc_context_ = std::move(other.grpc_context_);
             valid_ = std::move(other.valid_);
             plugin_info_ = std::move(other.plugin_info_);
             slot_info_ = std::move(other.slot_info_);
@@ -168,18 +168,19 @@ public:
 
     value_type generate(auto&&... args)
     {
-        agrpc::GrpcContext grpc_context;
-        value_type ret_value{};
+        grpc::ClientContext client_context{};
+        prep_client_context(client_context, slot_info_);
+
+        // Construct the request on the calling thread, so that the requests of all threads are converted in parallel.
+        const auto request{ req_(std::forward<decltype(args)>(args)...) };
+        rsp_msg_type response;
         grpc::Status status;
 
-        boost::asio::co_spawn(
-            grpc_context,
-            [this, &grpc_context, &status, &ret_value, &args...]()
+        grpc_context_->run(
+            [this, &status, &client_context, &request, &response](agrpc::GrpcContext& grpc_context)
             {
-                return this->generateCall(grpc_context, status, ret_value, std::forward<decltype(args)>(args)...);
-            },
-            boost::asio::detached);
-        grpc_context.run();
+                return this->invokeCall(grpc_context, status, client_context, request, response);
+            });
 
         if (! status.ok()) // TODO: handle different kind of status codes
         {
@@ -196,23 +197,24 @@ public:
             spdlog::error("Plugin for slot {} failed with error: {}", slot_info_.slot_id, status.error_message());
             throw exceptions::RemoteException(slot_info_, status.error_message());
         }
-        return ret_value;
+        return rsp_(response);
     }
 
     value_type modify(auto& original_value, auto&&... args)
     {
-        agrpc::GrpcContext grpc_context;
-        value_type ret_value{};
+        grpc::ClientContext client_context{};
+        prep_client_context(client_context, slot_info_);
+
+        // Construct the request on the calling thread, so that the requests of all threads are converted in parallel.
+        const auto request{ req_(original_value, std::forward<decltype(args)>(args)...) };
+        rsp_msg_type response;
         grpc::Status status;
 
-        boost::asio::co_spawn(
-            grpc_context,
-            [this, &grpc_context, &status, &ret_value, &original_value, &args...]()
+        grpc_context_->run(
+            [this, &status, &client_context, &request, &response](agrpc::GrpcContext& grpc_context)
             {
-                return this->modifyCall(grpc_context, status, ret_value, original_value, std::forward<decltype(args)>(args)...);
-            },
-            boost::asio::detached);
-        grpc_context.run();
+                return this->invokeCall(grpc_context, status, client_context, request, response);
+            });
 
         if (! status.ok()) // TODO: handle different kind of status codes
         {
@@ -229,7 +231,7 @@ public:
             spdlog::error("Plugin for slot {} failed with error: {}", slot_info_.slot_id, status.error_message());
             throw exceptions::RemoteException(slot_info_, status.error_message());
         }
-        return ret_value;
+        return rsp_(original_value, response);
     }
 
     template<plugins::v0::SlotID Subscription>
@@ -239,17 +241,18 @@ public:
         {
             return;
         }
-        agrpc::GrpcContext grpc_context;
+        grpc::ClientContext client_context{};
+        prep_client_context(client_context, slot_info_);
+
+        details::broadcast_rpc<Subscription, broadcast_stub_t> requester{};
+        const auto request = requester(std::forward<decltype(args)>(args)...);
         grpc::Status status;
 
-        boost::asio::co_spawn(
-            grpc_context,
-            [this, &grpc_context, &status, &args...]()
+        grpc_context_->run(
+            [this, &status, &client_context, &request](agrpc::GrpcContext& grpc_context)
             {
-                return this->broadcastCall<Subscription>(grpc_context, status, std::forward<decltype(args)>(args)...);
-            },
-            boost::asio::detached);
-        grpc_context.run();
+                return this->broadcastCall(grpc_context, status, client_context, request);
+            });
 
         if (! status.ok()) // TODO: handle different kind of status codes
         {
@@ -284,56 +287,26 @@ private:
     /**
      * @brief Executes the invokeCall operation with the plugin.
      *
-     * Sends a request to the plugin and saves the response.
+     * Sends a request to the plugin and saves the response. Only the request itself runs on the gRPC context; the request
+     * and response are converted by the calling thread.
      *
      * @param grpc_context - The gRPC context to use for the call
      * @param status - Status of the gRPC call which gets updated in this method
-     * @param ret_value - Reference to the value in which response to be stored
-     * @param args - Request arguments
+     * @param client_context - The client context of the call, prepared by the calling thread
+     * @param request - The request message to send
+     * @param response - Reference to the message in which the response is to be stored
      * @return A boost::asio::awaitable<void> indicating completion of the operation
      */
-    boost::asio::awaitable<void> generateCall(agrpc::GrpcContext& grpc_context, grpc::Status& status, value_type& ret_value, auto&&... args)
-    {
-        using RPC = agrpc::ClientRPC<&invoke_stub_t::PrepareAsyncCall>;
-        grpc::ClientContext client_context{};
-        prep_client_context(client_context, slot_info_);
-
-        // Construct request
-        auto request{ req_(std::forward<decltype(args)>(args)...) };
-
-        // Make unary request
-        rsp_msg_type response;
-        status = co_await RPC::request(grpc_context, invoke_stub_, client_context, request, response, boost::asio::use_awaitable);
-        ret_value = rsp_(response);
-        co_return;
-    }
-
-    boost::asio::awaitable<void> modifyCall(agrpc::GrpcContext& grpc_context, grpc::Status& status, value_type& ret_value, auto& original_value, auto&&... args)
+    boost::asio::awaitable<void> invokeCall(agrpc::GrpcContext& grpc_context, grpc::Status& status, grpc::ClientContext& client_context, const auto& request, rsp_msg_type& response)
     {
         using RPC = agrpc::ClientRPC<&invoke_stub_t::PrepareAsyncCall>;
-        grpc::ClientContext client_context{};
-        prep_client_context(client_context, slot_info_);
-
-        // Construct request
-        auto request{ req_(original_value, std::forward<decltype(args)>(args)...) };
-
-        // Make unary request
-        rsp_msg_type response;
         status = co_await RPC::request(grpc_context, invoke_stub_, client_context, request, response, boost::asio::use_awaitable);
-        ret_value = std::move(rsp_(original_value, response));
         co_return;
     }
 
-    template<plugins::v0::SlotID Subscription>
-    boost::asio::awaitable<void> broadcastCall(agrpc::GrpcContext& grpc_context, grpc::Status& status, auto&&... args)
+    boost::asio::awaitable<void> broadcastCall(agrpc::GrpcContext& grpc_context, grpc::Status& status, grpc::ClientContext& client_context, const auto& request)
     {
-        grpc::ClientContext client_context{};
-        prep_client_context(client_context, slot_info_);
         using RPC = agrpc::ClientRPC<&broadcast_stub_t::PrepareAsyncBroadcastSettings>;
-
-        details::broadcast_rpc<Subscription, broadcast_stub_t> requester{};
-        auto request = requester(std::forward<decltype(args)>(args)...);
-
         auto response = google::protobuf::Empty{};
         status = co_await RPC::request(grpc_context, broadcast_stub_, client_context, request, response, boost::asio::use_awaitable);
         co_return;
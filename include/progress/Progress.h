@@ -5,9 +5,11 @@
 #define PROGRESS_H
 
 #include <array>
+#include <map>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "utils/gettime.h"
 
@@ -42,6 +44,16 @@ public:
         FINISH = 7
     };
 
+    /*!
+     * The time it took to accomplish a stage.
+     */
+    struct StageTime
+    {
+        std::string_view stage;
+        double wall_time; //!< In seconds
+        double cpu_time; //!< Processor time of all threads together, in seconds
+    };
+
 private:
     static constexpr std::array<double, N_PROGRESS_STAGES> times{
         0.0, // START   = 0,
@@ -54,10 +66,12 @@ private:
         0.1 // FINISH  = 6
     };
 
-    static constexpr std::array<std::string_view, N_PROGRESS_STAGES> names{ "start", "slice", "layerparts", "inset+skin", "support", "export", "process" };
+    static constexpr std::array<std::string_view, N_PROGRESS_STAGES> names{ "start", "split multimaterial", "slice", "layerparts", "inset+skin", "support", "export", "process" };
     static std::array<double, N_PROGRESS_STAGES> accumulated_times; //!< Time past before each stage
     static double total_timing; //!< An estimate of the total time
     static std::optional<LayerIndex> first_skipped_layer; //!< The index of the layer for which we skipped time reporting
+    static std::vector<StageTime> stage_times; //!< The times of all stages accomplished since init(), in order
+    static std::map<std::string, double> layer_stage_times; //!< The times registered while generating the layers, summed over all layers per registered stage
     /*!
      * Give an estimate between 0 and 1 of how far the process is.
      *
@@ -97,6 +111,18 @@ public:
      *                       because it is not relevant
      */
     static void messageProgressLayer(LayerIndex layer_nr, size_t total_layers, double total_time, const TimeKeeper::RegisteredTimes& stages, double skip_threshold = 0.1);
+
+    /*!
+     * Get the times of all stages accomplished since init(), in order. Only stages reported with a time keeper are included.
+     */
+    static const std::vector<StageTime>& getStageTimes();
+
+    /*!
+     * Get the times registered while generating the layers, summed over all layers per registered stage.
+     *
+     * Layers are generated in parallel, so these add up to more than the wall time of the export stage.
+     */
+    static const std::map<std::string, double>& getLayerStageTimes();
 };
 
 
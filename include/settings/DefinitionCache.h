@@ -0,0 +1,118 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef SETTINGS_DEFINITIONCACHE_H
+#define SETTINGS_DEFINITIONCACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cura
+{
+
+/*!
+ * \brief A definition file together with everything it inherits, reduced to what loading it does to the settings.
+ *
+ * Loading a definition file means parsing it and every file it inherits from, and walking the trees of setting definitions for their default values. The
+ * result is a list of values to add to the settings that the file is loaded into, interleaved with extruder definitions to load into the extruder trains.
+ * That list is much smaller than the files, since most defaults are overridden further down the inheritance chain.
+ */
+struct FlattenedDefinition
+{
+    /*!
+     * A file that the flattened definition was made from.
+     */
+    struct Dependency
+    {
+        std::string path;
+        int64_t modified; //!< Modification time of the file, as a count of file clock ticks.
+        uint64_t size; //!< Size of the file, in bytes.
+    };
+
+    /*!
+     * Either a block of settings to add, or an extruder definition to load, in the order in which the JSON files did so.
+     */
+    struct Step
+    {
+        std::vector<std::pair<std::string, std::string>> settings; //!< Values to add to the settings the definition is loaded into.
+        std::optional<size_t> extruder_nr; //!< If set, this step loads an extruder definition instead of adding settings.
+        std::string extruder_file; //!< The definition file to load into that extruder train.
+    };
+
+    std::vector<Dependency> dependencies; //!< The files that were parsed, which must be unchanged for the flattened definition to be valid.
+    std::vector<std::string> search_directories; //!< The directories that loading the files added to the definition search path, in order.
+    std::vector<Step> steps;
+    bool complete = true; //!< Whether every file could be found. Incomplete definitions are not cached, so that the missing files are looked for again.
+
+    /*!
+     * Record that a file was parsed, and that its directory was added to the search path.
+     */
+    void addFile(const std::filesystem::path& file);
+
+    /*!
+     * Record that a value was added to the settings.
+     */
+    void addSetting(const std::string& key, const std::string& value);
+
+    /*!
+     * Record that an extruder definition was loaded into an extruder train.
+     */
+    void addExtruder(size_t extruder_nr, const std::string& extruder_file);
+
+    /*!
+     * Record everything that another flattened definition does, after what this one does.
+     */
+    void append(const FlattenedDefinition& other);
+};
+
+/*!
+ * \brief Stores flattened definitions in binary files, so that later slices don't have to parse the JSON files again.
+ *
+ * The binary files are memory mapped when read. A flattened definition is only returned if none of the files it was made from has changed, and if no other user
+ * could have changed the cache file.
+ */
+namespace DefinitionCache
+{
+
+/*!
+ * The directory to store the flattened definitions in: the CURA_ENGINE_DEFINITION_CACHE environment variable if set, or else a directory in the cache
+ * directory of the user. Without a home directory, a directory for the user in the temporary directory is used.
+ *
+ * Cache files are only read from and written to a directory that only the current user can change.
+ * \return The directory, or an empty path if the environment variable is "none" to disable the cache.
+ */
+std::filesystem::path defaultDirectory();
+
+/*!
+ * Get the cache file for a definition file.
+ *
+ * The definition files that it inherits from are looked up in the search directories, so those are part of the key as well.
+ * \param directory The directory of the cache.
+ * \param definition_file The definition file that is loaded.
+ * \param search_directories The search directories when the file is loaded.
+ * \param force_read_parent Whether the values of non-leaf settings are read as well.
+ */
+std::filesystem::path
+    cacheFile(const std::filesystem::path& directory, const std::filesystem::path& definition_file, const std::vector<std::filesystem::path>& search_directories, bool force_read_parent);
+
+/*!
+ * Read a flattened definition.
+ * \return The flattened definition, or nothing if there is no cache file, it is damaged or any of the files it was made from has changed.
+ */
+std::optional<FlattenedDefinition> read(const std::filesystem::path& cache_file);
+
+/*!
+ * Write a flattened definition, replacing the cache file at once so that other processes never read half of it.
+ * \return Whether the cache file could be written.
+ */
+bool write(const std::filesystem::path& cache_file, const FlattenedDefinition& definition);
+
+} // namespace DefinitionCache
+
+} // namespace cura
+
+#endif // SETTINGS_DEFINITIONCACHE_H
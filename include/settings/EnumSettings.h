@@ -121,6 +121,15 @@ enum class CombingMode
     PLUGIN,
 };
 
+/*!
+ * How combing moves within a part are computed.
+ */
+enum class CombingEngine
+{
+    CROSSINGS, // Walk along the boundary crossings of every travel move.
+    VISIBILITY_GRAPH, // Look up the route in a visibility graph precomputed per part.
+};
+
 /*!
  * How the draft shield height is limited.
  */
@@ -16,6 +16,7 @@
 #include <map>
 #include <sstream>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace cura
@@ -46,6 +47,12 @@ public:
      */
     void add(const std::string& key, const std::string& value);
 
+    /*!
+     * \brief Adds a list of settings at once, as if add() was called for each.
+     * \param key_values The names and serialised values of the settings.
+     */
+    void add(const std::vector<std::pair<std::string, std::string>>& key_values);
+
     /*!
      * @brief Removes a setting, if existing
      * @param key The name of the setting to be removed
@@ -203,6 +203,11 @@ public:
      */
     void getOutlines(Shape& result, bool external_polys_only = false) const;
 
+    /*!
+     * Get the number of vertices of the outlines of all layer parts in this layer, as an estimate of how much work it is to process the layer.
+     */
+    size_t pointCount() const;
+
     ~SliceLayer();
 };
 
@@ -415,6 +420,8 @@ public:
      * \param include_models Whether to include the models in the outline
      * \param external_polys_only Whether to disregard all hole polygons.
      * \param extruder_nr (optional) only give back outlines for this extruder (where the walls are printed with this extruder)
+     *
+     * The outlines of all models, with their holes, are united. Otherwise the outlines of the meshes are given one after the other, and may overlap.
      */
     Shape getLayerOutlines(
         const LayerIndex layer_nr,
@@ -424,6 +431,14 @@ public:
         const int extruder_nr = -1,
         const bool include_models = true) const;
 
+    /*!
+     * Compute the union of the outlines of all models on every layer, so that getLayerOutlines doesn't have to collect and unite them again.
+     *
+     * Shields, skirt, brim and support all ask for the same outlines, many layers more than once. Call this once the outlines of the layer parts are final,
+     * i.e. after the walls are generated and the empty first layers are removed.
+     */
+    void cacheModelOutlines();
+
     /*!
      * Get the axis-aligned bounding-box of the complete model (all meshes).
      */
@@ -473,6 +488,17 @@ private:
      * Construct the retraction_wipe_config_per_extruder
      */
     std::vector<RetractionAndWipeConfig> initializeRetractionAndWipeConfigs();
+
+    /*!
+     * Collect the outlines of the models on a layer from the meshes.
+     *
+     * \param layer_nr The index of the layer, which must not be a raft layer.
+     * \param external_polys_only Whether to disregard all hole polygons.
+     * \param extruder_nr Only give back outlines of meshes whose walls are printed with this extruder, or -1 for all meshes.
+     */
+    Shape collectModelOutlines(const LayerIndex layer_nr, const bool external_polys_only, const int extruder_nr) const;
+
+    std::vector<Shape> model_outlines_per_layer_; //!< The union of the outlines of all models per layer, once cacheModelOutlines is called.
 };
 
 } // namespace cura
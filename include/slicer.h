@@ -4,12 +4,14 @@
 #ifndef SLICER_H
 #define SLICER_H
 
+#include <array>
 #include <optional>
-#include <queue>
 #include <unordered_map>
+#include <vector>
 
 #include "geometry/LinesSet.h"
 #include "geometry/OpenLinesSet.h"
+#include "geometry/Point3LL.h"
 #include "geometry/Shape.h"
 #include "settings/EnumSettings.h"
 #include "utils/Point2F.h"
@@ -114,7 +116,7 @@ protected:
     void connectOpenPolylines(OpenLinesSet& open_polylines);
 
     /*!
-     * Link up all the missing ends, closing up the smallest gaps first. This is an inefficient implementation which can run in O(n*n*n) time.
+     * Link up all the missing ends, closing up the smallest gaps first.
      *
      * Clears all open polylines which are used up in the process
      *
@@ -122,9 +124,26 @@ protected:
      */
     void stitch(OpenLinesSet& open_polylines);
 
-    std::optional<GapCloserResult> findPolygonGapCloser(Point2LL ip0, Point2LL ip1);
+    /*!
+     * Find the shortest way along a polygon between two points that lie on it.
+     *
+     * \param ip0 The point to start from.
+     * \param ip1 The point to end at.
+     * \param close_0 Where \p ip0 lies on the polygon, as found by \ref findPolygonPointClosestTo.
+     * \param close_1 Where \p ip1 lies on the same polygon.
+     * \param cumulative_length The length along the polygon up to each of
+     * its vertices, followed by the length of the whole polygon.
+     */
+    GapCloserResult findPolygonGapCloser(Point2LL ip0, Point2LL ip1, const ClosePolygonResult& close_0, const ClosePolygonResult& close_1, const std::vector<coord_t>& cumulative_length)
+        const;
 
-    std::optional<ClosePolygonResult> findPolygonPointClosestTo(Point2LL input);
+    /*!
+     * Find the first polygon that passes close to a point.
+     *
+     * \param input The point to look for.
+     * \param first_polygon_idx The polygons before this one are skipped.
+     */
+    std::optional<ClosePolygonResult> findPolygonPointClosestTo(Point2LL input, size_t first_polygon_idx = 0) const;
 
     /*!
      * Try to close up polylines into polygons while they have large gaps in them.
@@ -292,112 +311,14 @@ private:
 
         /*! Orders PossibleStitch by goodness.
          *
-         * Better PossibleStitch are > then worse PossibleStitch.
-         * priority_queue will give greatest first so greatest
-         * must be most desirable stitch
+         * Better PossibleStitch are > then worse PossibleStitch, so
+         * the greatest is the most desirable stitch.  This is a
+         * strict total order, so the stitches are always made in the
+         * same order.
          */
         bool operator<(const PossibleStitch& other) const;
     };
 
-    /*!
-     * \brief Tracks movements of polyline end point locations (Terminus).
-     *
-     * Tracks the movement of polyline end point locations within the
-     * polyline vector as polylines are joined, reversed, and used to
-     * form polygons.
-     */
-    class TerminusTrackingMap
-    {
-    public:
-        /*! Initializes the TerminusTrackingMap with the size indicated.
-         *
-         * \param end_idx The first invalid Terminus::Index.  This usually
-         *    comes from \ref Terminus::endIndexFromPolylineEndIndex().
-         */
-        TerminusTrackingMap(Terminus::Index end_idx);
-
-        /*! Given the old Terminus location returns the current location.
-         *
-         * If the old location is no longer the endpoint of a polyline
-         * in the polyline vector, then this returns
-         * Terminus::INVALID_TERMINUS.  As long as the old location is
-         * still an endpoint in the polyline vector, then
-         * getCurFromOld(old) will always refer to the same point.
-         * Endpoints are removed from the polyline vector as polylines
-         * are merged or converted to Polygons.
-         *
-         * \param old The old Terminus location.  Must not be
-         *     INVALID_TERMINUS.
-         * \return The current Terminus location or INVALID_TERMINUS
-         *     if the old endpoint is no longer an endpoint.
-         */
-        Terminus getCurFromOld(const Terminus& old) const
-        {
-            return m_terminus_old_to_cur_map[old.asIndex()];
-        }
-
-        /*! Given the current Terminus location returns the old location.
-         *
-         * \param cur The current Terminus location.  Must not be
-         *     INVALID_TERMINUS.
-         * \return The old Terminus location.  Returns
-         *     INVALID_TERMINUS if the old Terminus location was
-         *     removed (used to form a Polygon).
-         */
-        Terminus getOldFromCur(const Terminus& cur) const
-        {
-            return m_terminus_cur_to_old_map[cur.asIndex()];
-        }
-
-        /*! Mark the current Terminus as being removed.
-         *
-         * This marks the current Terminus as being removed from the
-         * polyline vector.
-         */
-        void markRemoved(const Terminus& cur)
-        {
-            Terminus old = getOldFromCur(cur);
-            m_terminus_old_to_cur_map[old.asIndex()] = Terminus::INVALID_TERMINUS;
-            m_terminus_cur_to_old_map[cur.asIndex()] = Terminus::INVALID_TERMINUS;
-        }
-
-        /*! Update the map for movement of Terminus.
-         *
-         * This updates the map for the movement / removal of Terminus
-         * locations.  next_terms[i] should refer to the same point as
-         * cur_terms[i] for i < num_terms, unless the Terminus was
-         * removed.  If the Terminus was removed, next_terms[i] should
-         * be INVALID_TERMINUS.
-         *
-         * removed_cur_terms should refer to those Terminus that are
-         * no longer present after the update.  removed_cur_terms
-         * should be the set of terminus values that are in cur_terms
-         * but not in next_terms, i.e. viewing the inputs as sets:
-         * removed_cur_terms = next_terms - cur_terms.  It is passed
-         * separately to avoid calculating the set difference since
-         * the caller generally has this information readily
-         * available.
-         *
-         * \param num_terms The number of Terminus that changed.
-         * \param cur_terms The current Terminus locations.  Must be
-         *     of size num_terms.  Must not contain INVALID_TERMINUS.
-         * \param next_terms The Terminus locations after the update.
-         *     Must be of size num_terms.  A value of INVALID_TERMINUS
-         *     indicates that the Terminus was removed.
-         * \param num_removed_terms The number of Terminus locations
-         *     that are being removed by the update.
-         * \param removed_cur_terms The Terminus locations that will
-         *     be removed after the update.
-         */
-        void updateMap(size_t num_terms, const Terminus* cur_terms, const Terminus* next_terms, size_t num_removed_terms, const Terminus* removed_cur_terms);
-
-    private:
-        /*! map from old terminus location to current terminus location */
-        std::vector<Terminus> m_terminus_old_to_cur_map;
-        /*! map from current terminus location to old terminus location */
-        std::vector<Terminus> m_terminus_cur_to_old_map;
-    };
-
     /*!
      * Try to find a segment from face \p face_idx to continue \p segment.
      *
@@ -411,8 +332,8 @@ private:
      * Find possible allowed stitches in goodness order.
      *
      * This finds all stitches that are allowed by the parameters.
-     * The stitches are returned in a priority_queue that returns them
-     * in order from best to worst stitch.
+     * The end points of the polylines are put in a grid once, which
+     * is then only queried.
      *
      * \param open_polylines The polylines to try to stitch together.
      * \param max_dist The maximum distance between end points for an
@@ -424,12 +345,12 @@ private:
      *     the order of a polyline.
      * \return The stitches that are allowed in order from best to worst.
      */
-    std::priority_queue<PossibleStitch> findPossibleStitches(const OpenLinesSet& open_polylines, coord_t max_dist, coord_t cell_size, bool allow_reverse) const;
+    std::vector<PossibleStitch> findPossibleStitches(const OpenLinesSet& open_polylines, coord_t max_dist, coord_t cell_size, bool allow_reverse) const;
 
     /*! Plans the best way to perform a stitch.
      *
-     * Let polyline_0 be open_polylines[terminus_0.getPolylineIdx()] and
-     *     polyline_1 be open_polylines[terminus_1.getPolylineIdx()].
+     * Let polyline_0 be the polyline of terminus_0 and polyline_1 be
+     *     the polyline of terminus_1.
      *
      * The plan consists of appending polyline_1 to polyline_0.  If
      * reverse[0] is true, then polyline_0 should be reversed before
@@ -437,30 +358,13 @@ private:
      * reversed before appending.  Note that terminus_0 and terminus_1
      * may be swapped by this function.
      *
-     * \param[in] open_polylines The polyline storage vector.
+     * \param[in] size_0 The number of vertices of polyline_0, as passed in.
+     * \param[in] size_1 The number of vertices of polyline_1, as passed in.
      * \param[in,out] terminus_0 the Terminus on polyline_0 to join at.
      * \param[in,out] terminus_1 the Terminus on polyline_1 to join at.
      * \param[out] reverse Whether the polylines need to be reversed.
      */
-    void planPolylineStitch(const OpenLinesSet& open_polylines, Terminus& terminus_0, Terminus& terminus_1, bool reverse[2]) const;
-
-    /*! Joins polyline_1 onto polyline_0.
-     *
-     * Appends polyline_1 to polyline_0.  It reverses the polylines first if either
-     * reverse[i] is true.  Clears polyline_1.
-     *
-     * \param[in,out] polyline_0 On input, the polyline that will form
-     *     the first part of the joined polyline.  On output, the
-     *     joined polyline.
-     * \param[in,out] polyline_1 On input, the polyline that will form
-     *     the second of the joined polyline.  On output, an empty
-     *     polyline.
-     * \param[in] reverse Whether to reverse the polylines before
-     *     joining.  reverse[0] indicates whether to reverse
-     *     polyline_0 and reverse[1] indicates whether to reverse
-     *     polyline_1
-     */
-    static void joinPolylines(OpenPolyline& polyline_0, OpenPolyline& polyline_1, const bool reverse[2]);
+    static void planPolylineStitch(size_t size_0, size_t size_1, Terminus& terminus_0, Terminus& terminus_1, bool reverse[2]);
 
     /*!
      * Connecting polylines that are not closed yet.
@@ -485,6 +389,11 @@ private:
 
 class Slicer
 {
+    friend class SegmentsSlicer; // Because the benchmark intersects the triangles with the layers on their own.
+#ifdef BUILD_TESTS
+    friend class SlicerSegmentsTest;
+#endif
+
 public:
     std::vector<SlicerLayer> layers;
 
@@ -556,11 +465,33 @@ private:
         const std::optional<Point2F>& uv2,
         const coord_t z);
 
-    /*! Creates an array of "z bounding boxes" for each face.
+    /*!
+     * \brief Project a triangle without UV coordinates onto a 2D layer.
+     *
+     * \see project2D
+     */
+    static SlicerSegment project2D(const Point3LL& p0, const Point3LL& p1, const Point3LL& p2, const coord_t z);
+
+    /*!
+     * \brief The triangles of a mesh, laid out for intersecting them with the layers.
+     *
+     * The faces of a mesh only refer to their vertices, so their corners are
+     * copied next to each other once instead of being looked up for every
+     * layer. The Z extents are packed in an array of their own, since those
+     * are all that is needed to find the triangles that cross a layer.
+     */
+    struct TriangleBuffer
+    {
+        std::vector<std::pair<int32_t, int32_t>> z_extents; //!< The lowest and highest Z of each triangle.
+        std::vector<std::array<Point3LL, 3>> corners; //!< The corners of each triangle, in the order of its face.
+        std::vector<std::array<std::optional<Point2F>, 3>> uv_coordinates; //!< The UV coordinates of the corners, or empty if no face has any.
+    };
+
+    /*! Copies the triangles of a mesh into a buffer to intersect with the layers.
      * \param[in] mesh The mesh which is analyzed.
-     * \return z heights aka z bounding boxes of the faces.
+     * \return The corners and z bounding boxes of the faces.
      */
-    static std::vector<std::pair<int32_t, int32_t>> buildZHeightsForFaces(const Mesh& mesh);
+    static TriangleBuffer buildTriangleBuffer(const Mesh& mesh);
 
     /*! Creates the polygons in layers.
      * \param[in] mesh The mesh which is analyzed.
@@ -589,12 +520,11 @@ private:
 
     /*! Creates the segments and write them into the layers.
      * \param[in] mesh The mesh which is analyzed.
-     * \param[in] zbboxes The z part of the bounding boxes of the faces of the mesh.
+     * \param[in] triangles The triangles of the faces of the mesh, from \ref buildTriangleBuffer.
      * \param[in] slicing_tolderance Slicing tolerance in order to figure out what happens when vertices are exactly on the slicing boundary.
      * \param[in, out] layers The segments are created here.
      */
-    static void
-        buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t, int32_t>>& zbboxes, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers);
+    static void buildSegments(const Mesh& mesh, const TriangleBuffer& triangles, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers);
 };
 
 } // namespace cura
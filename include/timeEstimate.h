@@ -111,6 +111,18 @@ public:
 
     void reset();
 
+    /*!
+     * \brief Move the moves and extra time planned so far into a separate
+     * calculator, leaving this one as if it had been reset.
+     *
+     * The position and the junction speeds of the last move are kept, so that
+     * planning can continue here while the detached plan is calculated
+     * elsewhere (e.g. on another thread). Calculating the detached plan gives
+     * the same result as calling calculate() on this calculator would have.
+     * \return A calculator holding only the moves planned so far.
+     */
+    TimeEstimateCalculator detachPlan();
+
     std::vector<Duration> calculate();
 
 private:
@@ -0,0 +1,213 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#ifndef UTILS_FLAT_SPARSE_GRID_H
+#define UTILS_FLAT_SPARSE_GRID_H
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "SquareGrid.h"
+#include "geometry/Point2LL.h"
+
+namespace cura
+{
+
+/*! \brief Sparse grid which is built once and then only queried.
+ *
+ * This is an alternative to SparseGrid for grids that are filled completely
+ * before they are used. Instead of a hash map, the occupied cells are kept
+ * sorted by row and the elements of all cells are stored in a single array,
+ * each cell referring to a consecutive range of it (a compressed sparse row
+ * layout). Queries then walk over contiguous memory, find the cells of a row
+ * with a single binary search and call the visitor without indirection.
+ *
+ * Elements are first inserted, then build() has to be called once before
+ * querying. Nothing can be inserted after that: grids that are queried and
+ * inserted into alternately should use SparseGrid.
+ *
+ * The query functions have the same signature as their SparseGrid
+ * counterparts, so that users can switch by changing the grid type.
+ *
+ * \tparam ElemT The element type to store.
+ */
+template<class ElemT>
+class FlatSparseGrid : public SquareGrid
+{
+public:
+    using Elem = ElemT;
+    using GridPoint = SquareGrid::GridPoint;
+
+    /*! \brief Constructs an empty grid with the specified cell size.
+     *
+     * \param[in] cell_size The size to use for a cell (square) in the grid.
+     *    Typical values would be around 0.5-2x of expected query radius.
+     * \param[in] elem_reserve Number of elements to reserve space for.
+     */
+    FlatSparseGrid(coord_t cell_size, size_t elem_reserve = 0U)
+        : SquareGrid(cell_size)
+    {
+        pending_.reserve(elem_reserve);
+    }
+
+    /*! \brief Add an element to a cell. Only allowed before build().
+     */
+    void insert(const GridPoint& grid_pt, const Elem& elem)
+    {
+        assert(cell_starts_.empty() && "Elements can't be inserted after build().");
+        pending_.emplace_back(grid_pt, elem);
+    }
+
+    /*! \brief Add an element to the cell which contains \p location.
+     */
+    void insertPoint(const Point2LL& location, const Elem& elem)
+    {
+        insert(toGridPoint(location), elem);
+    }
+
+    /*! \brief Add an element to all cells crossed by \p line, like SparseLineGrid does.
+     */
+    void insertLine(const std::pair<Point2LL, Point2LL>& line, const Elem& elem)
+    {
+        processLineCells(
+            line,
+            [this, &elem](const GridPoint grid_pt)
+            {
+                insert(grid_pt, elem);
+                return true;
+            });
+    }
+
+    /*! \brief Move all inserted elements into the compressed layout.
+     *
+     * Elements within a cell keep the order in which they were inserted.
+     */
+    void build()
+    {
+        assert(cell_starts_.empty() && "build() can only be called once.");
+        std::stable_sort(
+            pending_.begin(),
+            pending_.end(),
+            [](const std::pair<GridPoint, Elem>& a, const std::pair<GridPoint, Elem>& b)
+            {
+                return rowMajorLess(a.first, b.first);
+            });
+
+        elements_.reserve(pending_.size());
+        for (std::pair<GridPoint, Elem>& cell_elem : pending_)
+        {
+            if (cells_.empty() || cells_.back() != cell_elem.first)
+            {
+                cells_.push_back(cell_elem.first);
+                cell_starts_.push_back(elements_.size());
+            }
+            elements_.push_back(std::move(cell_elem.second));
+        }
+        cell_starts_.push_back(elements_.size());
+        pending_.clear();
+        pending_.shrink_to_fit();
+    }
+
+    /*! \brief The amount of elements in the grid, counting an element once for each cell it is in.
+     */
+    size_t size() const
+    {
+        return elements_.size();
+    }
+
+    /*! \brief Process elements from cells that might contain sought after points.
+     *
+     * \see SparseGrid::processNearby
+     */
+    template<typename F>
+    bool processNearby(const Point2LL& query_pt, coord_t radius, F&& process_func) const
+    {
+        assert(! cell_starts_.empty() && "build() must be called before querying.");
+        const GridPoint min_grid = toGridPoint(Point2LL(query_pt.X - radius, query_pt.Y - radius));
+        const GridPoint max_grid = toGridPoint(Point2LL(query_pt.X + radius, query_pt.Y + radius));
+        for (coord_t grid_y = min_grid.Y; grid_y <= max_grid.Y; ++grid_y)
+        {
+            // All cells of this row within the range are consecutive.
+            auto cell = std::lower_bound(cells_.begin(), cells_.end(), GridPoint(min_grid.X, grid_y), rowMajorLess);
+            for (; cell != cells_.end() && cell->Y == grid_y && cell->X <= max_grid.X; ++cell)
+            {
+                if (! processCell(static_cast<size_t>(cell - cells_.begin()), process_func))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /*! \brief Process elements from cells that cross the line \p query_line.
+     *
+     * \see SparseGrid::processLine
+     */
+    template<typename F>
+    bool processLine(const std::pair<Point2LL, Point2LL> query_line, F&& process_elem_func) const
+    {
+        assert(! cell_starts_.empty() && "build() must be called before querying.");
+        return processLineCells(
+            query_line,
+            [this, &process_elem_func](const GridPoint grid_pt)
+            {
+                const auto cell = std::lower_bound(cells_.begin(), cells_.end(), grid_pt, rowMajorLess);
+                if (cell == cells_.end() || *cell != grid_pt)
+                {
+                    return true;
+                }
+                return processCell(static_cast<size_t>(cell - cells_.begin()), process_elem_func);
+            });
+    }
+
+    /*! \brief Returns all data within radius of query_pt.
+     *
+     * \see SparseGrid::getNearby
+     */
+    std::vector<Elem> getNearby(const Point2LL& query_pt, coord_t radius) const
+    {
+        std::vector<Elem> ret;
+        processNearby(
+            query_pt,
+            radius,
+            [&ret](const Elem& elem)
+            {
+                ret.push_back(elem);
+                return true;
+            });
+        return ret;
+    }
+
+private:
+    /*! \brief Order of the cells: By row, then by column.
+     */
+    static bool rowMajorLess(const GridPoint& a, const GridPoint& b)
+    {
+        return a.Y < b.Y || (a.Y == b.Y && a.X < b.X);
+    }
+
+    template<typename F>
+    bool processCell(const size_t cell_idx, F& process_func) const
+    {
+        for (size_t elem_idx = cell_starts_[cell_idx]; elem_idx < cell_starts_[cell_idx + 1]; ++elem_idx)
+        {
+            if (! process_func(elements_[elem_idx]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<std::pair<GridPoint, Elem>> pending_; //!< Inserted elements, until build() moves them into the compressed layout.
+    std::vector<GridPoint> cells_; //!< All cells that contain elements, sorted by rowMajorLess.
+    std::vector<size_t> cell_starts_; //!< For each cell the index of its first element in elements_, followed by the total number of elements. Empty until build().
+    std::vector<Elem> elements_; //!< The elements of all cells, grouped per cell.
+};
+
+} // namespace cura
+
+#endif // UTILS_FLAT_SPARSE_GRID_H
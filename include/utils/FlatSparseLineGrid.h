@@ -0,0 +1,58 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#ifndef UTILS_FLAT_SPARSE_LINE_GRID_H
+#define UTILS_FLAT_SPARSE_LINE_GRID_H
+
+#include <utility>
+
+#include "FlatSparseGrid.h"
+#include "geometry/Point2LL.h"
+
+namespace cura
+{
+
+/*! \brief Build-once grid of line segments, the FlatSparseGrid counterpart of SparseLineGrid.
+ *
+ * Each element is stored in all cells which its line segment crosses. Call
+ * build() after inserting all elements and before querying.
+ *
+ * \tparam ElemT The element type to store.
+ * \tparam Locator The functor to get the start and end locations from ElemT.
+ *    must have: std::pair<Point, Point> operator()(const ElemT &elem) const
+ *    which returns the location associated with val.
+ */
+template<class ElemT, class Locator>
+class FlatSparseLineGrid : public FlatSparseGrid<ElemT>
+{
+public:
+    using Elem = ElemT;
+
+    /*! \brief Constructs an empty grid with the specified cell size.
+     *
+     * \param[in] cell_size The size to use for a cell (square) in the grid.
+     *    Typical values would be around 0.5-2x of expected query radius.
+     * \param[in] elem_reserve Number of elements to reserve space for.
+     */
+    FlatSparseLineGrid(coord_t cell_size, size_t elem_reserve = 0U)
+        : FlatSparseGrid<ElemT>(cell_size, elem_reserve)
+    {
+    }
+
+    /*! \brief Inserts elem into all cells crossed by its line segment.
+     *
+     * \param[in] elem The element to be inserted.
+     */
+    void insert(const Elem& elem)
+    {
+        FlatSparseGrid<ElemT>::insertLine(locator_(elem), elem);
+    }
+
+private:
+    /*! \brief Accessor for getting locations from elements. */
+    Locator locator_;
+};
+
+} // namespace cura
+
+#endif // UTILS_FLAT_SPARSE_LINE_GRID_H
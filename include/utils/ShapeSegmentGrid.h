@@ -0,0 +1,75 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_SHAPESEGMENTGRID_H
+#define UTILS_SHAPESEGMENTGRID_H
+
+#include <vector>
+
+#include "geometry/Point2LL.h"
+#include "utils/AABB.h"
+#include "utils/Coord_t.h"
+
+namespace cura
+{
+
+class Shape;
+
+/*!
+ * Buckets the segments of a shape in a grid, for fast repeated point location and segment intersection queries.
+ *
+ * The queries give the same results as Shape::inside and Shape::intersectionsWithSegment (apart from the order of the intersections), but only look at the segments
+ * close to the query instead of at all segments of the shape. The cell size is chosen so that there are about as many cells as segments. Like those functions,
+ * point location ignores polygons with fewer than 3 vertices, but segment intersections include their segments.
+ *
+ * Two bucketings are kept: per row of cells the segments that overlap that row vertically, for point location with a horizontal ray like ClipperLib does, and per
+ * cell the segments whose bounding box overlaps that cell, for segment intersections.
+ */
+class ShapeSegmentGrid
+{
+public:
+    ShapeSegmentGrid() = default;
+
+    /*!
+     * Build the grid for a shape. The shape is copied, so it doesn't need to outlive the grid.
+     */
+    explicit ShapeSegmentGrid(const Shape& shape);
+
+    /*!
+     * Check if a point is inside the shape, with the same result as Shape::inside.
+     * \param p The point to check.
+     * \param border_result What to return when the point is exactly on the border.
+     */
+    bool inside(const Point2LL& p, bool border_result = false) const;
+
+    /*!
+     * Find the intersections of a segment with the shape, like Shape::intersectionsWithSegment.
+     * \return The parameters along the segment of the intersections, in no particular order.
+     */
+    std::vector<float> intersectionsWithSegment(const Point2LL& start, const Point2LL& end) const;
+
+private:
+    struct Segment
+    {
+        Point2LL start;
+        Point2LL end;
+        bool encloses; //!< Whether the segment is part of a polygon with at least 3 vertices, which are the only ones that point location looks at.
+    };
+
+    coord_t toRow(const coord_t y) const;
+    coord_t toColumn(const coord_t x) const;
+
+    std::vector<Segment> segments_;
+    AABB bounding_box_; //!< Bounding box of all segments, slightly grown so that rounding errors in intersections don't fall outside of it.
+    coord_t cell_size_{ 1 };
+    coord_t columns_{ 0 };
+    coord_t rows_{ 0 };
+    std::vector<size_t> row_starts_; //!< For each row the index of its first segment in row_segments_, followed by the size of row_segments_.
+    std::vector<size_t> row_segments_; //!< Indices in segments_, grouped per row.
+    std::vector<size_t> cell_starts_; //!< For each cell, in row-major order, the index of its first segment in cell_segments_, followed by the size of cell_segments_.
+    std::vector<size_t> cell_segments_; //!< Indices in segments_, grouped per cell.
+};
+
+} // namespace cura
+
+#endif // UTILS_SHAPESEGMENTGRID_H
@@ -4,6 +4,8 @@
 #ifndef UTILS_SIMPLIFY_H
 #define UTILS_SIMPLIFY_H
 
+#include <vector>
+
 #include "geometry/Point2LL.h"
 #include "utils/Coord_t.h"
 
@@ -50,6 +52,10 @@ class Polyline;
  */
 class Simplify
 {
+#ifdef BUILD_TESTS
+    friend class SimplifyRemainingVerticesTest;
+#endif
+
 public:
     /*!
      * Line segments shorter than this size should be considered for removal.
@@ -162,6 +168,50 @@ protected:
      */
     constexpr static coord_t min_resolution = 5; // 5 units, regardless of how big those are, to allow for rounding errors.
 
+    /*!
+     * The vertices of a polygon that are not deleted, as a circular doubly
+     * linked list of their indices.
+     *
+     * Finding the neighbours of a vertex takes constant time this way, no
+     * matter how many of the vertices around it have been deleted already.
+     */
+    class RemainingVertices
+    {
+    public:
+        /*!
+         * Create the list with all vertices of a polygon.
+         * \param size The number of vertices of the polygon.
+         */
+        explicit RemainingVertices(const size_t size);
+
+        /*!
+         * Whether a vertex is deleted.
+         */
+        bool isDeleted(const size_t index) const;
+
+        /*!
+         * Delete a vertex, linking its neighbours to each other.
+         */
+        void remove(const size_t index);
+
+        /*!
+         * The index of the nearest vertex after the given one that is not
+         * deleted. The given vertex itself may be deleted.
+         */
+        size_t next(size_t index) const;
+
+        /*!
+         * The index of the nearest vertex before the given one that is not
+         * deleted. The given vertex itself may be deleted.
+         */
+        size_t previous(size_t index) const;
+
+    private:
+        std::vector<size_t> next_; //!< For each vertex, the next vertex that wasn't deleted when it was deleted itself.
+        std::vector<size_t> previous_; //!< For each vertex, the previous vertex that wasn't deleted when it was deleted itself.
+        std::vector<bool> deleted_;
+    };
+
     /*!
      * Helper method to find the index of the next vertex that is not about to
      * get deleted.
@@ -170,10 +220,10 @@ protected:
      * endpoints of the polyline may never be deleted so it should never be an
      * issue.
      * \param index The index of the current vertex.
-     * \param to_delete For each vertex, whether it is to be deleted.
+     * \param to_delete The vertices that are not deleted.
      * \return The index of the vertex afterwards.
      */
-    size_t nextNotDeleted(size_t index, const std::vector<bool>& to_delete) const;
+    size_t nextNotDeleted(size_t index, const RemainingVertices& to_delete) const;
 
     /*!
      * Helper method to find the index of the previous vertex that is not about
@@ -183,10 +233,10 @@ protected:
      * endpoints of the polyline may never be deleted so it should never be an
      * issue.
      * \param index The index of the current vertex.
-     * \param to_delete For each vertex, whether it is to be deleted.
+     * \param to_delete The vertices that are not deleted.
      * \return The index of the vertex before it.
      */
-    size_t previousNotDeleted(size_t index, const std::vector<bool>& to_delete) const;
+    size_t previousNotDeleted(size_t index, const RemainingVertices& to_delete) const;
 
     /*!
      * Append a vertex to this polygon.
@@ -295,7 +345,7 @@ private:
      * A measure of the importance of a vertex.
      * \tparam Polygonal A polygonal object, which is a list of vertices.
      * \param polygon The polygon or polyline the vertex is part of.
-     * \param to_delete For each vertex, whether it is set to be deleted.
+     * \param to_delete The vertices that are not deleted.
      * \param index The vertex index to compute the importance of.
      * \param is_closed Whether the polygon is closed (a polygon) or open
      * (a polyline).
@@ -303,7 +353,7 @@ private:
      * that the vertex should probably be retained in the output.
      */
     template<typename Polygonal>
-    coord_t importance(const Polygonal& polygon, const std::vector<bool>& to_delete, const size_t index, const bool is_closed) const;
+    coord_t importance(const Polygonal& polygon, const RemainingVertices& to_delete, const size_t index, const bool is_closed) const;
 
     /*!
      * Mark a vertex for removal.
@@ -322,7 +372,7 @@ private:
      * polyline.
      */
     template<typename Polygonal>
-    bool remove(Polygonal& polygon, std::vector<bool>& to_delete, const size_t vertex, const coord_t deviation2, const bool is_closed) const;
+    bool remove(Polygonal& polygon, RemainingVertices& to_delete, const size_t vertex, const coord_t deviation2, const bool is_closed) const;
 };
 
 } // namespace cura
@@ -107,9 +107,11 @@ public:
      * \param[in] radius The search radius.
      * \param[in] process_func Processes each element.  process_func(elem) is
      *    called for each element in the cell. Processing stops if function returns false.
+     *    Any callable is accepted, so that it can be inlined.
      * \return Whether we need to continue processing after this function
      */
-    bool processNearby(const Point2LL& query_pt, coord_t radius, const std::function<bool(const ElemT&)>& process_func) const;
+    template<typename F>
+    bool processNearby(const Point2LL& query_pt, coord_t radius, F&& process_func) const;
 
     /*! \brief Process elements from cells that might contain sought after points along a line.
      *
@@ -119,9 +121,11 @@ public:
      * \param[in] query_line The line along which to check each cell
      * \param[in] process_func Processes each element.  process_func(elem) is
      *    called for each element in the cells. Processing stops if function returns false.
+     *    Any callable is accepted, so that it can be inlined.
      * \return Whether we need to continue processing after this function
      */
-    bool processLine(const std::pair<Point2LL, Point2LL> query_line, const std::function<bool(const Elem&)>& process_elem_func) const;
+    template<typename F>
+    bool processLine(const std::pair<Point2LL, Point2LL> query_line, F&& process_elem_func) const;
 
 protected:
     /*! \brief Process elements from the cell indicated by \p grid_pt.
@@ -131,7 +135,8 @@ protected:
      *    called for each element in the cell. Processing stops if function returns false.
      * \return Whether we need to continue processing a next cell.
      */
-    bool processFromCell(const GridPoint& grid_pt, const std::function<bool(const Elem&)>& process_func) const;
+    template<typename F>
+    bool processFromCell(const GridPoint& grid_pt, F& process_func) const;
 
     /*! \brief Map from grid locations (GridPoint) to elements (Elem). */
     GridMap grid_;
@@ -154,7 +159,8 @@ SGI_THIS::SparseGrid(coord_t cell_size, size_t elem_reserve, double max_load_fac
 }
 
 SGI_TEMPLATE
-bool SGI_THIS::processFromCell(const GridPoint& grid_pt, const std::function<bool(const Elem&)>& process_func) const
+template<typename F>
+bool SGI_THIS::processFromCell(const GridPoint& grid_pt, F& process_func) const
 {
     auto grid_range = grid_.equal_range(grid_pt);
     for (auto iter = grid_range.first; iter != grid_range.second; ++iter)
@@ -168,7 +174,8 @@ bool SGI_THIS::processFromCell(const GridPoint& grid_pt, const std::function<boo
 }
 
 SGI_TEMPLATE
-bool SGI_THIS::processNearby(const Point2LL& query_pt, coord_t radius, const std::function<bool(const Elem&)>& process_func) const
+template<typename F>
+bool SGI_THIS::processNearby(const Point2LL& query_pt, coord_t radius, F&& process_func) const
 {
     return SquareGrid::processNearby(
         query_pt,
@@ -180,25 +187,29 @@ bool SGI_THIS::processNearby(const Point2LL& query_pt, coord_t radius, const std
 }
 
 SGI_TEMPLATE
-bool SGI_THIS::processLine(const std::pair<Point2LL, Point2LL> query_line, const std::function<bool(const Elem&)>& process_elem_func) const
+template<typename F>
+bool SGI_THIS::processLine(const std::pair<Point2LL, Point2LL> query_line, F&& process_elem_func) const
 {
-    const std::function<bool(const GridPoint&)> process_cell_func = [&process_elem_func, this](GridPoint grid_loc)
-    {
-        return processFromCell(grid_loc, process_elem_func);
-    };
-    return processLineCells(query_line, process_cell_func);
+    return processLineCells(
+        query_line,
+        [&process_elem_func, this](GridPoint grid_loc)
+        {
+            return processFromCell(grid_loc, process_elem_func);
+        });
 }
 
 SGI_TEMPLATE
 std::vector<typename SGI_THIS::Elem> SGI_THIS::getNearby(const Point2LL& query_pt, coord_t radius) const
 {
     std::vector<Elem> ret;
-    const std::function<bool(const Elem&)> process_func = [&ret](const Elem& elem)
-    {
-        ret.push_back(elem);
-        return true;
-    };
-    processNearby(query_pt, radius, process_func);
+    processNearby(
+        query_pt,
+        radius,
+        [&ret](const Elem& elem)
+        {
+            ret.push_back(elem);
+            return true;
+        });
     return ret;
 }
 
@@ -213,7 +224,7 @@ bool SGI_THIS::getNearest(const Point2LL& query_pt, coord_t radius, Elem& elem_n
 {
     bool found = false;
     int64_t best_dist2 = static_cast<int64_t>(radius) * radius;
-    const std::function<bool(const Elem&)> process_func = [&query_pt, &elem_nearest, &found, &best_dist2, &precondition](const Elem& elem)
+    const auto process_func = [&query_pt, &elem_nearest, &found, &best_dist2, &precondition](const Elem& elem)
     {
         if (! precondition(elem))
         {
@@ -7,6 +7,7 @@
 #include <cassert>
 #include <functional>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "geometry/Point2LL.h"
@@ -39,15 +40,6 @@ public:
     using GridPoint = Point2LL;
     using grid_coord_t = coord_t;
 
-    /*! \brief Process cells along a line indicated by \p line.
-     *
-     * \param line The line along which to process cells.
-     * \param process_func Processes each cell. ``process_func(elem)`` is called
-     * for each cell. Processing stops if function returns false.
-     * \return Whether we need to continue processing after this function.
-     */
-    bool processLineCells(const std::pair<Point2LL, Point2LL> line, const std::function<bool(GridPoint)>& process_cell_func);
-
     /*! \brief Process cells along a line indicated by \p line.
      *
      * \param line The line along which to process cells
@@ -55,7 +47,8 @@ public:
      * for each cell. Processing stops if function returns false.
      * \return Whether we need to continue processing after this function.
      */
-    bool processLineCells(const std::pair<Point2LL, Point2LL> line, const std::function<bool(GridPoint)>& process_cell_func) const;
+    template<typename F>
+    bool processLineCells(const std::pair<Point2LL, Point2LL> line, F&& process_cell_func) const;
 
     /*!
      * Process all cells in an axis-aligned right triangle.
@@ -90,8 +83,10 @@ public:
      * good candidate has been found.
      * \return Whether we need to continue processing after this function.
      */
-    bool processAxisAlignedTriangle(const Point2LL from, const Point2LL to, const std::function<bool(GridPoint)>& process_cell_func) const;
-    bool processAxisAlignedTriangle(const Point2LL from, const Point2LL to, bool to_the_right, const std::function<bool(GridPoint)>& process_cell_func) const;
+    template<typename F>
+    bool processAxisAlignedTriangle(const Point2LL from, const Point2LL to, F&& process_cell_func) const;
+    template<typename F>
+    bool processAxisAlignedTriangle(const Point2LL from, const Point2LL to, bool to_the_right, F&& process_cell_func) const;
 
     /*! \brief Process cells that might contain sought after points.
      *
@@ -105,7 +100,8 @@ public:
      * ``false``.
      * \return Whether we need to continue processing after this function.
      */
-    bool processNearby(const Point2LL& query_pt, coord_t radius, const std::function<bool(const GridPoint&)>& process_func) const;
+    template<typename F>
+    bool processNearby(const Point2LL& query_pt, coord_t radius, F&& process_func) const;
 
     /*! \brief Compute the grid coordinates of a point.
      * \param point The actual location.
@@ -150,6 +146,135 @@ protected:
     grid_coord_t nonzeroSign(const grid_coord_t z) const;
 };
 
+template<typename F>
+bool SquareGrid::processLineCells(const std::pair<Point2LL, Point2LL> line, F&& process_cell_func) const
+{
+    Point2LL start = line.first;
+    Point2LL end = line.second;
+    if (end.X < start.X)
+    { // make sure X increases between start and end
+        std::swap(start, end);
+    }
+
+    const GridPoint start_cell = toGridPoint(start);
+    const GridPoint end_cell = toGridPoint(end);
+    const coord_t y_diff = end.Y - start.Y;
+    const grid_coord_t y_dir = nonzeroSign(y_diff);
+
+    /* This line drawing algorithm iterates over the range of Y coordinates, and
+    for each Y coordinate computes the range of X coordinates crossed in one
+    unit of Y. These ranges are rounded to be inclusive, so effectively this
+    creates a "fat" line, marking more cells than a strict one-cell-wide path.*/
+    grid_coord_t x_cell_start = start_cell.X;
+    for (grid_coord_t cell_y = start_cell.Y; cell_y * y_dir <= end_cell.Y * y_dir; cell_y += y_dir)
+    { // for all Y from start to end
+        // nearest y coordinate of the cells in the next row
+        const coord_t nearest_next_y = toLowerCoord(cell_y + ((nonzeroSign(cell_y) == y_dir || cell_y == 0) ? y_dir : coord_t(0)));
+        grid_coord_t x_cell_end; // the X coord of the last cell to include from this row
+        if (y_diff == 0)
+        {
+            x_cell_end = end_cell.X;
+        }
+        else
+        {
+            const coord_t area = (end.X - start.X) * (nearest_next_y - start.Y);
+            // corresponding_x: the x coordinate corresponding to nearest_next_y
+            coord_t corresponding_x = start.X + area / y_diff;
+            x_cell_end = toGridCoord(corresponding_x + ((corresponding_x < 0) && ((area % y_diff) != 0)));
+            if (x_cell_end < start_cell.X)
+            { // process at least one cell!
+                x_cell_end = x_cell_start;
+            }
+        }
+
+        for (grid_coord_t cell_x = x_cell_start; cell_x <= x_cell_end; ++cell_x)
+        {
+            GridPoint grid_loc(cell_x, cell_y);
+            if (! process_cell_func(grid_loc))
+            {
+                return false;
+            }
+            if (grid_loc == end_cell)
+            {
+                return true;
+            }
+        }
+        // TODO: this causes at least a one cell overlap for each row, which
+        // includes extra cells when crossing precisely on the corners
+        // where positive slope where x > 0 and negative slope where x < 0
+        x_cell_start = x_cell_end;
+    }
+    assert(false && "We should have returned already before here!");
+    return false;
+}
+
+template<typename F>
+bool SquareGrid::processAxisAlignedTriangle(const Point2LL from, const Point2LL to, bool to_the_right, F&& process_cell_func) const
+{
+    Point2LL a = from;
+    Point2LL b = to;
+    if ((a.X < b.X == a.Y < b.Y) != to_the_right)
+    {
+        std::swap(a, b);
+    }
+    return processAxisAlignedTriangle(a, b, process_cell_func);
+}
+
+template<typename F>
+bool SquareGrid::processAxisAlignedTriangle(const Point2LL from, const Point2LL to, F&& process_cell_func) const
+{
+    GridPoint last;
+    GridPoint grid_to = toGridPoint(to);
+    return processLineCells(
+        std::make_pair(from, to),
+        [grid_to, &last, &process_cell_func, this](const GridPoint grid_loc)
+        {
+            if (grid_loc.Y != last.Y)
+            {
+                const coord_t sign = nonzeroSign(grid_to.X - grid_loc.X);
+                for (grid_coord_t x = grid_loc.X; x * sign <= grid_to.X * sign; x += sign)
+                {
+                    if (! process_cell_func(GridPoint(x, grid_loc.Y)))
+                    {
+                        return false;
+                    }
+                }
+            }
+            else
+            {
+                if (! process_cell_func(grid_loc)) // make sure the whole line is processed
+                {
+                    return false;
+                }
+            }
+            last = grid_loc;
+            return true;
+        });
+}
+
+template<typename F>
+bool SquareGrid::processNearby(const Point2LL& query_pt, coord_t radius, F&& process_func) const
+{
+    const Point2LL min_loc(query_pt.X - radius, query_pt.Y - radius);
+    const Point2LL max_loc(query_pt.X + radius, query_pt.Y + radius);
+
+    GridPoint min_grid = toGridPoint(min_loc);
+    GridPoint max_grid = toGridPoint(max_loc);
+
+    for (coord_t grid_y = min_grid.Y; grid_y <= max_grid.Y; ++grid_y)
+    {
+        for (coord_t grid_x = min_grid.X; grid_x <= max_grid.X; ++grid_x)
+        {
+            GridPoint grid_pt(grid_x, grid_y);
+            if (! process_func(grid_pt))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 } // namespace cura
 
 #endif // UTILS_SQUARE_GRID_H
@@ -4,15 +4,21 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <concepts>
 #include <condition_variable>
 #include <deque>
 #include <functional> // std::function<>
 #include <mutex>
+#include <source_location>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 #include "../Application.h" // accessing singleton's Application::thread_pool
+#include "../utils/Tracing.h" // CURA_TRACE_SPAN
 #include "../utils/math.h" // round_up_divide
 
 namespace cura
@@ -118,9 +124,16 @@ inline Signed distance(const Int& first, const Int& last)
  * \param body The loop-body, as a closure. Receives the index on invocation.
  * \param chunk_size_factor Chunk size will be a multiple of this number.
  * \param chunks_per_worker Maximum number of tasks that are queue at once (defaults to 4 times the number of workers).
+ * \param call_site Where parallel_for is called from, to which the load imbalance is attributed when tracing.
  */
 template<typename T, typename F>
-void parallel_for(T first, T last, F&& loop_body, size_t chunk_size_factor = 1, const size_t chunks_per_worker = 8)
+void parallel_for(
+    T first,
+    T last,
+    F&& loop_body,
+    size_t chunk_size_factor = 1,
+    const size_t chunks_per_worker = 8,
+    const std::source_location call_site = std::source_location::current())
 {
     using lock_t = ThreadPool::lock_t;
 
@@ -161,7 +174,11 @@ void parallel_for(T first, T last, F&& loop_body, size_t chunk_size_factor = 1,
         std::decay_t<F> loop_body; // User's closure data
         size_t chunks_remaining;
         std::condition_variable work_done = {};
+        std::chrono::steady_clock::duration busy_time = {}; // Summed time spent in the chunks, only measured when tracing is built in
     } shared_state = { std::forward<F>(loop_body), chunks };
+#ifdef ENABLE_TRACING
+    const auto call_start = std::chrono::steady_clock::now();
+#endif
 
     // Schedules a task per chunk on the thread pool
     lock_t lock = thread_pool->get_lock();
@@ -182,11 +199,20 @@ void parallel_for(T first, T last, F&& loop_body, size_t chunk_size_factor = 1,
             [&shared_state, chunk_first, chunk_last](lock_t& th_lock)
             {
                 th_lock.unlock(); // Enter unsynchronized region
-                for (T i = chunk_first; i < chunk_last; ++i)
+#ifdef ENABLE_TRACING
+                const auto chunk_start = std::chrono::steady_clock::now();
+#endif
                 {
-                    shared_state.loop_body(i);
+                    CURA_TRACE_SPAN_ARG("parallel_for chunk", distance(chunk_first, chunk_last));
+                    for (T i = chunk_first; i < chunk_last; ++i)
+                    {
+                        shared_state.loop_body(i);
+                    }
                 }
                 th_lock.lock();
+#ifdef ENABLE_TRACING
+                shared_state.busy_time += std::chrono::steady_clock::now() - chunk_start;
+#endif
                 if (--shared_state.chunks_remaining == 0)
                 {
                     shared_state.work_done.notify_one();
@@ -205,6 +231,82 @@ void parallel_for(T first, T last, F&& loop_body, size_t chunk_size_factor = 1,
     {
         shared_state.work_done.wait(lock);
     }
+#ifdef ENABLE_TRACING
+    if (tracing::enabled.load(std::memory_order_relaxed))
+    {
+        tracing::recordParallelFor(call_site, shared_state.busy_time, std::chrono::steady_clock::now() - call_start, nworkers);
+    }
+#endif
+}
+
+/*!
+ * \brief An implementation of parallel for, for items of which the cost differs a lot.
+ *
+ * For example layers, of which the ones at the top may be empty while others are full of support. With equally sized chunks, the workers would wait for the
+ * chunk that happens to contain the expensive layers. Instead the range is divided in chunks of decreasing estimated cost (guided self-scheduling): every
+ * chunk takes a share of the cost that is left, so the chunks at the end are small enough to fill up the gaps between the workers.
+ *
+ * \param first, last The [inclusive, exclusive) range of iteration. Integers or random access iterators
+ * \param cost Estimate of the cost of an item, as a closure that receives the index, like the number of vertices of a layer. Only relative values matter. It's
+ * called once for every item on the calling thread before any work starts, so it should be cheap.
+ * \param loop_body The loop-body, as a closure. Receives the index on invocation.
+ * \param chunks_per_worker The cost of the smallest chunks is the total cost divided by this number times the number of workers.
+ * \param call_site Where parallel_for is called from, to which the load imbalance is attributed when tracing.
+ */
+template<typename T, typename C, typename F>
+requires std::invocable<C&, T> && std::invocable<F&, T>
+void parallel_for(
+    T first,
+    T last,
+    C&& cost,
+    F&& loop_body,
+    const size_t chunks_per_worker = 8,
+    const std::source_location call_site = std::source_location::current())
+{
+    const auto dist = distance(first, last);
+    if (dist <= 0)
+    {
+        return;
+    }
+    const size_t nitems = dist;
+
+    // Every item costs at least one, for the overhead of visiting it.
+    std::vector<double> cumulative_cost(nitems + 1, 0.0);
+    for (size_t item_idx = 0; item_idx < nitems; ++item_idx)
+    {
+        const auto item = first + static_cast<decltype(dist)>(item_idx);
+        cumulative_cost[item_idx + 1] = cumulative_cost[item_idx] + 1.0 + std::max(0.0, static_cast<double>(cost(item)));
+    }
+
+    const size_t nworkers = Application::getInstance().thread_pool_->thread_count() + 1; // One task per std::thread + 1 for main thread
+    const double total_cost = cumulative_cost.back();
+    const double min_chunk_cost = total_cost / static_cast<double>(std::max(size_t(1), chunks_per_worker * nworkers));
+    std::vector<size_t> chunk_starts{ 0 };
+    while (chunk_starts.back() < nitems)
+    {
+        const size_t chunk_first = chunk_starts.back();
+        const double chunk_cost = std::max((total_cost - cumulative_cost[chunk_first]) / static_cast<double>(2 * nworkers), min_chunk_cost);
+        // The chunk ends at the first item that brings it to its cost. It always contains at least one item.
+        const auto chunk_end = std::lower_bound(cumulative_cost.begin() + chunk_first + 1, cumulative_cost.end(), cumulative_cost[chunk_first] + chunk_cost);
+        chunk_starts.push_back(std::min(static_cast<size_t>(chunk_end - cumulative_cost.begin()), nitems));
+    }
+
+    // Chunks are queued in order, so the big ones are started first.
+    const size_t chunks = chunk_starts.size() - 1;
+    parallel_for<size_t>(
+        0,
+        chunks,
+        [&first, &chunk_starts, &loop_body](const size_t chunk_idx)
+        {
+            const T chunk_last = first + static_cast<decltype(dist)>(chunk_starts[chunk_idx + 1]);
+            for (T i = first + static_cast<decltype(dist)>(chunk_starts[chunk_idx]); i < chunk_last; ++i)
+            {
+                loop_body(i);
+            }
+        },
+        1,
+        chunks, // One task per chunk.
+        call_site);
 }
 
 /*!
@@ -212,9 +314,79 @@ void parallel_for(T first, T last, F&& loop_body, size_t chunk_size_factor = 1,
  *  Overload for iterating over containers with random access iterators.
  */
 template<typename Container, typename F>
-auto parallel_for(Container& container, F&& loop_body, size_t chunk_size_factor = 1, size_t chunks_per_worker = 8) -> std::void_t<decltype(container.end() - container.begin())>
+auto parallel_for(
+    Container& container,
+    F&& loop_body,
+    size_t chunk_size_factor = 1,
+    size_t chunks_per_worker = 8,
+    const std::source_location call_site = std::source_location::current()) -> std::void_t<decltype(container.end() - container.begin())>
+{
+    parallel_for(container.begin(), container.end(), std::forward<F>(loop_body), chunk_size_factor, chunks_per_worker, call_site);
+}
+
+//! \private Gets the keys of all elements of a boost concurrent container, so that they can be divided over the workers.
+template<typename ConcurrentContainer>
+std::vector<typename ConcurrentContainer::key_type> concurrent_container_keys(const ConcurrentContainer& container)
+{
+    using key_t = typename ConcurrentContainer::key_type;
+    std::vector<key_t> keys;
+    keys.reserve(container.size());
+    container.cvisit_all(
+        [&keys](const typename ConcurrentContainer::value_type& element)
+        {
+            if constexpr (std::is_same_v<key_t, typename ConcurrentContainer::value_type>)
+            { // Set
+                keys.push_back(element);
+            }
+            else
+            { // Map
+                keys.push_back(element.first);
+            }
+        });
+    return keys;
+}
+
+/*!
+ * \brief Visits all elements of a boost concurrent container (e.g. `concurrent_flat_map`) in parallel on the thread pool.
+ *
+ * To be used instead of `visit_all(std::execution::par, ...)`, which would run on a separate scheduler and thus ignore the number of threads we are allowed to use.
+ * The elements are visited like with `visit(key, visitor)`, so the visitor has exclusive access to the element but must not access the container itself.
+ * The container must not be modified by anything else while it is being visited.
+ */
+template<typename ConcurrentContainer, typename F>
+void parallel_visit_all(ConcurrentContainer& container, F&& visitor, const std::source_location call_site = std::source_location::current())
+{
+    const auto keys = concurrent_container_keys(container);
+    parallel_for<size_t>(
+        0,
+        keys.size(),
+        [&container, &keys, &visitor](const size_t key_idx)
+        {
+            container.visit(keys[key_idx], std::ref(visitor));
+        },
+        1,
+        8,
+        call_site);
+}
+
+/*!
+ * \brief Erases all elements of a boost concurrent container for which \p predicate holds, evaluating it in parallel on the thread pool.
+ * \see parallel_visit_all
+ */
+template<typename ConcurrentContainer, typename F>
+void parallel_erase_if(ConcurrentContainer& container, F&& predicate, const std::source_location call_site = std::source_location::current())
 {
-    parallel_for(container.begin(), container.end(), std::forward<F>(loop_body), chunk_size_factor, chunks_per_worker);
+    const auto keys = concurrent_container_keys(container);
+    parallel_for<size_t>(
+        0,
+        keys.size(),
+        [&container, &keys, &predicate](const size_t key_idx)
+        {
+            container.erase_if(keys[key_idx], std::ref(predicate));
+        },
+        1,
+        8,
+        call_site);
 }
 
 
@@ -316,6 +488,11 @@ protected:
             { // Continue as a producer
                 return true;
             }
+            else if (producing_ > 0)
+            { // Queue is full and this worker was picked up by a parallel_for nested in a producer further up the stack, which may be the one the consumer
+              // waits for: stop instead of waiting on it
+                return false;
+            }
             else
             { // Queue is full, wait for consumer signal
                 free_slot_cond_.wait(lock); // Signaled by consume_many() and worker() completion
@@ -332,7 +509,9 @@ protected:
 
         // Unlocks global mutex while producing an item
         lock.unlock();
+        producing_++;
         item_t item = producer_(produced_idx);
+        producing_--;
         lock.lock();
 
         assert(! *slot);
@@ -402,6 +581,7 @@ protected:
     ptrdiff_t read_idx_; // Next slot to consume
     ptrdiff_t consumer_wait_idx_; // First slot that is waited for by the consumer
     std::condition_variable free_slot_cond_; // Condition to wait for available space in the buffer
+    static inline thread_local size_t producing_ = 0; // Number of producers running on the stack of this thread
 };
 
 //! \private Template deduction guide: defaults to inlining closures into the class layout
@@ -0,0 +1,107 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_TRACING_H
+#define UTILS_TRACING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <source_location>
+
+namespace cura::tracing
+{
+
+/*!
+ * Tracing of which thread did what when, to be inspected in a Chrome trace viewer (chrome://tracing or ui.perfetto.dev).
+ *
+ * Code marks the work to trace with the CURA_TRACE_SPAN macros below. These compile to nothing unless the engine is built with ENABLE_TRACING. When built in,
+ * spans are only recorded after start() has been called (with the --trace command line option), so that the cost of an idle span is a single atomic load.
+ *
+ * Every thread records its spans in its own fixed size ring buffer, so recording never waits on other threads. When a buffer is full, the oldest spans of that
+ * thread are overwritten.
+ */
+
+extern std::atomic<bool> enabled; //!< Whether spans are being recorded.
+
+/*!
+ * Start recording spans, dropping any spans recorded before.
+ * \param trace_file Where finish() will write the trace.
+ */
+void start(const std::filesystem::path& trace_file);
+
+/*!
+ * Stop recording spans and write the recorded ones to the trace file, if recording was started. Also logs the load imbalance of the parallel_for call sites.
+ */
+void finish();
+
+/*!
+ * Record a span on the buffer of the calling thread.
+ * \param name The name of the span. Must be a string literal, only the pointer is stored.
+ * \param argument A value to show with the span, like the layer number. Negative values are not shown.
+ * \param begin, end When the span began and ended.
+ */
+void record(const char* name, int64_t argument, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+
+/*!
+ * Add a parallel_for call to the load statistics of its call site.
+ *
+ * The time that the workers were available for the call but had nothing to do is the wall time times the number of workers, minus the busy time. When that is
+ * a large share, the items of the call site are too few or too uneven for its chunks.
+ * \param call_site Where parallel_for was called from.
+ * \param busy_time The summed time that the workers spent on the chunks.
+ * \param wall_time The time from scheduling the first chunk until the last one was done.
+ * \param workers The number of threads that could work on the chunks.
+ */
+void recordParallelFor(const std::source_location& call_site, std::chrono::steady_clock::duration busy_time, std::chrono::steady_clock::duration wall_time, size_t workers);
+
+/*!
+ * Records the time from its construction until its destruction as a span.
+ */
+class Span
+{
+public:
+    explicit Span(const char* name, const int64_t argument = -1)
+        : name_(enabled.load(std::memory_order_relaxed) ? name : nullptr)
+        , argument_(argument)
+    {
+        if (name_ != nullptr)
+        {
+            begin_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    ~Span()
+    {
+        if (name_ != nullptr)
+        {
+            record(name_, argument_, begin_, std::chrono::steady_clock::now());
+        }
+    }
+
+private:
+    const char* name_; //!< Null if tracing was disabled when the span started.
+    int64_t argument_;
+    std::chrono::steady_clock::time_point begin_;
+};
+
+} // namespace cura::tracing
+
+#define CURA_TRACE_CONCAT_IMPL(a, b) a##b
+#define CURA_TRACE_CONCAT(a, b) CURA_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef ENABLE_TRACING
+//! Trace the rest of the current scope as a span with the given name.
+#define CURA_TRACE_SPAN(name) const cura::tracing::Span CURA_TRACE_CONCAT(trace_span_, __LINE__)(name)
+//! Trace the rest of the current scope as a span with the given name and a number, like the layer number.
+#define CURA_TRACE_SPAN_ARG(name, argument) const cura::tracing::Span CURA_TRACE_CONCAT(trace_span_, __LINE__)(name, static_cast<int64_t>(argument))
+#else
+#define CURA_TRACE_SPAN(name)
+#define CURA_TRACE_SPAN_ARG(name, argument)
+#endif
+
+#endif // UTILS_TRACING_H
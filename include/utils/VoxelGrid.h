@@ -4,13 +4,12 @@
 #ifndef UTILS_VOXELGRID_H
 #define UTILS_VOXELGRID_H
 
-#include <execution>
-
 #include <boost/unordered/concurrent_flat_map.hpp>
 
 #include "Coord_t.h"
 #include "geometry/Triangle3D.h"
 #include "utils/Point3D.h"
+#include "utils/ThreadPool.h"
 
 
 namespace cura
@@ -102,11 +101,7 @@ public:
     template<class... Args>
     void visitOccupiedVoxels(Args&&... args)
     {
-        occupied_voxels_.visit_all(
-#ifdef __cpp_lib_execution
-            std::execution::par,
-#endif
-            args...);
+        parallel_visit_all(occupied_voxels_, args...);
     }
 
     /*!
@@ -118,11 +113,7 @@ public:
     template<class... Args>
     void visitOccupiedVoxels(Args&&... args) const
     {
-        occupied_voxels_.cvisit_all(
-#ifdef __cpp_lib_execution
-            std::execution::par,
-#endif
-            args...);
+        parallel_visit_all(occupied_voxels_, args...);
     }
 
     std::vector<LocalCoordinates> getVoxelsAround(const LocalCoordinates& point) const;
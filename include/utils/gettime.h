@@ -5,6 +5,7 @@
 #define GETTIME_H
 
 #include <chrono>
+#include <ctime>
 #include <string>
 #include <vector>
 
@@ -27,6 +28,7 @@ public:
 private:
     spdlog::stopwatch watch;
     double start_time;
+    std::clock_t cpu_start;
     RegisteredTimes registered_times;
 
 public:
@@ -34,6 +36,11 @@ public:
 
     double restart();
 
+    /*!
+     * Processor time used by all threads of the process since the last restart, in seconds.
+     */
+    double cpuTime() const;
+
     void registerTime(const std::string& stage, double threshold = 0.01);
 
     const RegisteredTimes& getRegisteredTimes() const
@@ -10,6 +10,7 @@
 #include <numbers>
 #include <optional>
 
+#include "FlatSparseLineGrid.h"
 #include "PolygonsPointIndex.h"
 #include "SparseLineGrid.h"
 #include "SparsePointGridInclusive.h"
@@ -88,7 +89,8 @@ struct GivenDistPoint
     int pos; //!< Index to the first point in the polygon of the line segment on which the result was found
 };
 
-typedef SparseLineGrid<PolygonsPointIndex, PolygonsPointIndexSegmentLocator> LocToLineGrid;
+// Boundary grids are built once and then only queried, so they are flat rather than hashed.
+typedef FlatSparseLineGrid<PolygonsPointIndex, PolygonsPointIndexSegmentLocator> LocToLineGrid;
 
 class PolygonUtils
 {
@@ -0,0 +1,369 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include <algorithm>
+#include <chrono>
+#include <docopt/docopt.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "Application.h"
+#include "communication/DaemonCommunication.h"
+#include "progress/Progress.h"
+#include "rapidjson/document.h"
+#include "rapidjson/istreamwrapper.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+
+constexpr std::string_view USAGE = R"(Slice Benchmark.
+
+Slices every model of a corpus from STL to g-code and reports the time spent in each stage.
+
+Every <name>.stl in the corpus directory is sliced with the settings of <name>.json next to it, which is
+loaded like the -j argument of CuraEngine. Every model is sliced in its own process, so that the peak
+memory use can be measured per model.
+
+Afterwards the whole corpus is sliced a number of rounds by a single daemon process, like
+"CuraEngine daemon" does, to compare the jobs per minute with a warm engine to those with a new process
+per job.
+
+Usage:
+  slice_benchmark -d DIR -o FILE [-m THREADS] [-r ROUNDS]
+  slice_benchmark (-h | --help)
+  slice_benchmark --version
+
+Options:
+  -h --help                      Show this screen.
+  --version                      Show version.
+  -d DIR                         Specify the corpus directory.
+  -o FILE                        Specify the output Json file.
+  -m THREADS                     Specify the number of threads to slice with [default: 4].
+  -r ROUNDS                      Specify how often the daemon slices the corpus [default: 3].
+)";
+
+struct Resource
+{
+    std::filesystem::path stl_file;
+    std::filesystem::path settings_file;
+
+    std::string stem() const
+    {
+        return stl_file.stem().string();
+    }
+
+    std::filesystem::path gcodeFile() const
+    {
+        return std::filesystem::temp_directory_path() / fmt::format("slice_benchmark_{}_{}.gcode", getpid(), stem());
+    }
+
+    std::filesystem::path stagesFile() const
+    {
+        return std::filesystem::temp_directory_path() / fmt::format("slice_benchmark_{}_{}.json", getpid(), stem());
+    }
+};
+
+std::vector<Resource> getResources(const std::filesystem::path& corpus_path)
+{
+    std::vector<Resource> resources;
+    for (const auto& p : std::filesystem::recursive_directory_iterator(corpus_path))
+    {
+        if (p.path().extension() == ".stl")
+        {
+            auto settings = p.path();
+            settings.replace_extension(".json");
+            if (! std::filesystem::exists(settings))
+            {
+                spdlog::warn("Skipping {}, it has no settings file", p.path().filename().string());
+                continue;
+            }
+            spdlog::info("Adding resources for: {}", p.path().filename().stem().string());
+            resources.emplace_back(Resource{ .stl_file = p, .settings_file = settings });
+        }
+    }
+    std::sort(
+        resources.begin(),
+        resources.end(),
+        [](const Resource& a, const Resource& b)
+        {
+            return a.stem() < b.stem();
+        });
+    return resources;
+}
+
+/*!
+ * Slice the model like the command line would, then write the stage times, as recorded by Progress, to the stages file of the resource.
+ */
+void handleChildProcess(const Resource& resource, const size_t threads, const std::filesystem::path& gcode_file, const std::filesystem::path& stages_file)
+{
+    std::vector<std::string> arguments{ "CuraEngine",
+                                        "slice",
+                                        fmt::format("-m{}", threads),
+                                        "-j",
+                                        resource.settings_file.string(),
+                                        "-l",
+                                        resource.stl_file.string(),
+                                        "-o",
+                                        gcode_file.string() };
+    std::vector<char*> argv;
+    for (std::string& argument : arguments)
+    {
+        argv.push_back(argument.data());
+    }
+    cura::Application::getInstance().run(argv.size(), argv.data());
+
+    rapidjson::Document doc;
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    rapidjson::Value stages(rapidjson::kArrayType);
+    for (const cura::Progress::StageTime& stage_time : cura::Progress::getStageTimes())
+    {
+        rapidjson::Value stage(rapidjson::kObjectType);
+        stage.AddMember("name", rapidjson::Value(stage_time.stage.data(), stage_time.stage.size(), allocator), allocator);
+        stage.AddMember("wall_time_s", stage_time.wall_time, allocator);
+        stage.AddMember("cpu_time_s", stage_time.cpu_time, allocator);
+        stages.PushBack(stage, allocator);
+    }
+    doc.AddMember("stages", stages, allocator);
+    rapidjson::Value layer_stages(rapidjson::kArrayType);
+    for (const auto& [name, summed_time] : cura::Progress::getLayerStageTimes())
+    {
+        rapidjson::Value stage(rapidjson::kObjectType);
+        stage.AddMember("name", rapidjson::Value(name.c_str(), name.size(), allocator), allocator);
+        stage.AddMember("summed_time_s", summed_time, allocator);
+        layer_stages.PushBack(stage, allocator);
+    }
+    doc.AddMember("layer_stages", layer_stages, allocator);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+    std::ofstream file{ stages_file };
+    file.write(buffer.GetString(), buffer.GetSize());
+    exit(EXIT_SUCCESS);
+}
+
+/*!
+ * Slice all resources a number of rounds with a single daemon, then exit. The replies of the daemon are written to \p replies_file.
+ */
+void handleDaemonProcess(const std::vector<Resource>& resources, const size_t threads, const size_t rounds, const std::filesystem::path& replies_file)
+{
+    std::stringstream jobs;
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        for (const Resource& resource : resources)
+        {
+            const std::vector<std::string> arguments{
+                fmt::format("-m{}", threads), "-j", resource.settings_file.string(), "-l", resource.stl_file.string(), "-o", resource.gcodeFile().string()
+            };
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            writer.StartArray();
+            for (const std::string& argument : arguments)
+            {
+                writer.String(argument.c_str(), argument.size());
+            }
+            writer.EndArray();
+            jobs << buffer.GetString() << '\n';
+        }
+    }
+
+    std::ofstream replies{ replies_file };
+    cura::Application& application = cura::Application::getInstance();
+    application.startThreadPool(threads);
+    application.communication_ = std::make_shared<cura::DaemonCommunication>(jobs, replies);
+    while (application.communication_->hasSlice())
+    {
+        application.communication_->sliceNext();
+    }
+    exit(EXIT_SUCCESS);
+}
+
+/*!
+ * Slice all resources with a single daemon and measure the throughput.
+ */
+rapidjson::Value runDaemon(rapidjson::Document::AllocatorType& allocator, const std::vector<Resource>& resources, const size_t threads, const size_t rounds)
+{
+    const std::filesystem::path replies_file = std::filesystem::temp_directory_path() / fmt::format("slice_benchmark_{}_daemon.jsonl", getpid());
+    const auto start = std::chrono::steady_clock::now();
+    pid_t engine_pid = fork();
+    if (engine_pid == -1)
+    {
+        spdlog::critical("Unable to fork - daemon");
+        exit(EXIT_FAILURE);
+    }
+    if (engine_pid == 0)
+    {
+        handleDaemonProcess(resources, threads, rounds, replies_file);
+    }
+
+    int status;
+    rusage usage{};
+    wait4(engine_pid, &status, 0, &usage);
+    const double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t succeeded_jobs = 0;
+    std::ifstream replies{ replies_file };
+    std::string line;
+    while (std::getline(replies, line))
+    {
+        rapidjson::Document reply;
+        reply.Parse(line.c_str());
+        if (! reply.HasParseError() && reply.IsObject() && reply.HasMember("succeeded") && reply["succeeded"].GetBool())
+        {
+            succeeded_jobs++;
+        }
+    }
+    replies.close();
+    std::filesystem::remove(replies_file);
+    for (const Resource& resource : resources)
+    {
+        std::filesystem::remove(resource.gcodeFile());
+    }
+
+    const bool succeeded = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS && succeeded_jobs == rounds * resources.size();
+    if (! succeeded)
+    {
+        spdlog::critical("# The daemon sliced {} of {} jobs", succeeded_jobs, rounds * resources.size());
+    }
+    const double jobs_per_minute = wall_time > 0.0 ? 60.0 * static_cast<double>(succeeded_jobs) / wall_time : 0.0;
+    spdlog::info("+ The daemon sliced {} jobs in {:03.3f}s, {:.1f} jobs per minute", succeeded_jobs, wall_time, jobs_per_minute);
+
+    rapidjson::Value result(rapidjson::kObjectType);
+    result.AddMember("succeeded", succeeded, allocator);
+    result.AddMember("jobs", static_cast<uint64_t>(succeeded_jobs), allocator);
+    result.AddMember("wall_time_s", wall_time, allocator);
+    result.AddMember("jobs_per_minute", jobs_per_minute, allocator);
+    result.AddMember("peak_rss_kib", static_cast<int64_t>(usage.ru_maxrss), allocator);
+    return result;
+}
+
+/*!
+ * Run one resource in a child process and measure it.
+ */
+rapidjson::Value runResource(rapidjson::Document::AllocatorType& allocator, const Resource& resource, const size_t threads)
+{
+    rapidjson::Value result(rapidjson::kObjectType);
+    const std::string name = resource.stem();
+    result.AddMember("name", rapidjson::Value(name.c_str(), name.size(), allocator), allocator);
+
+    const std::filesystem::path gcode_file = resource.gcodeFile();
+    const std::filesystem::path stages_file = resource.stagesFile();
+    const auto start = std::chrono::steady_clock::now();
+    pid_t engine_pid = fork();
+    if (engine_pid == -1)
+    {
+        spdlog::critical("Unable to fork - engine");
+        exit(EXIT_FAILURE);
+    }
+    if (engine_pid == 0)
+    {
+        handleChildProcess(resource, threads, gcode_file, stages_file);
+    }
+
+    int status;
+    rusage usage{};
+    wait4(engine_pid, &status, 0, &usage);
+    const double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const bool succeeded = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS && std::filesystem::exists(stages_file);
+    if (! succeeded)
+    {
+        spdlog::critical("# Slicing failed for: {}", name);
+    }
+    else
+    {
+        spdlog::info("+ Sliced {} in {:03.3f}s", name, wall_time);
+    }
+
+    const auto to_seconds = [](const timeval& time)
+    {
+        return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_usec) / 1e6;
+    };
+    result.AddMember("succeeded", succeeded, allocator);
+    result.AddMember("wall_time_s", wall_time, allocator);
+    result.AddMember("cpu_time_s", to_seconds(usage.ru_utime) + to_seconds(usage.ru_stime), allocator);
+    result.AddMember("peak_rss_kib", static_cast<int64_t>(usage.ru_maxrss), allocator);
+    result.AddMember("gcode_bytes", static_cast<uint64_t>(std::filesystem::exists(gcode_file) ? std::filesystem::file_size(gcode_file) : 0), allocator);
+
+    if (succeeded)
+    {
+        std::ifstream file{ stages_file };
+        rapidjson::IStreamWrapper stream{ file };
+        rapidjson::Document stages;
+        stages.ParseStream(stream);
+        if (! stages.HasParseError() && stages.IsObject())
+        {
+            result.AddMember("stages", rapidjson::Value(stages["stages"], allocator), allocator);
+            result.AddMember("layer_stages", rapidjson::Value(stages["layer_stages"], allocator), allocator);
+        }
+    }
+    std::filesystem::remove(gcode_file);
+    std::filesystem::remove(stages_file);
+    return result;
+}
+
+int main(int argc, const char** argv)
+{
+    constexpr bool show_help = true;
+    constexpr std::string_view version = "0.1.0";
+    const std::map<std::string, docopt::value> args = docopt::docopt(fmt::format("{}", USAGE), { argv + 1, argv + argc }, show_help, fmt::format("{}", version));
+
+    const size_t threads = static_cast<size_t>(args.at("-m").asLong());
+    const size_t rounds = static_cast<size_t>(args.at("-r").asLong());
+    const auto resources = getResources(std::filesystem::path{ args.at("-d").asString() });
+
+    rapidjson::Document doc;
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    doc.AddMember("threads", static_cast<uint64_t>(threads), allocator);
+    rapidjson::Value cases(rapidjson::kArrayType);
+    size_t failure_count = 0;
+    double cold_wall_time = 0.0;
+    for (const auto& resource : resources)
+    {
+        spdlog::info("Starting test case {}", resource.stem());
+        rapidjson::Value result = runResource(allocator, resource, threads);
+        failure_count += result["succeeded"].GetBool() ? 0 : 1;
+        cold_wall_time += result["wall_time_s"].GetDouble();
+        cases.PushBack(result, allocator);
+    }
+    doc.AddMember("cases", cases, allocator);
+    doc.AddMember("jobs_per_minute", cold_wall_time > 0.0 ? 60.0 * static_cast<double>(resources.size() - failure_count) / cold_wall_time : 0.0, allocator);
+
+    if (rounds > 0 && ! resources.empty())
+    {
+        spdlog::info("Starting the daemon for {} rounds", rounds);
+        rapidjson::Value daemon = runDaemon(allocator, resources, threads, rounds);
+        failure_count += daemon["succeeded"].GetBool() ? 0 : 1;
+        doc.AddMember("daemon", daemon, allocator);
+    }
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+
+    const std::filesystem::path out_file{ args.at("-o").asString() };
+    spdlog::info("Writing Json results: {}", std::filesystem::absolute(out_file).string());
+    std::ofstream file{ out_file };
+    if (! file)
+    {
+        spdlog::critical("Failed to open the file: {}", out_file.string());
+        return EXIT_FAILURE;
+    }
+    file.write(buffer.GetString(), buffer.GetSize());
+    file.close();
+    return failure_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
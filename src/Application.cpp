@@ -21,6 +21,7 @@
 #include "Slice.h"
 #include "communication/ArcusCommunication.h" //To connect via Arcus to the front-end.
 #include "communication/CommandLine.h" //To use the command line to slice stuff.
+#include "communication/DaemonCommunication.h" //To slice many jobs in a row.
 #include "communication/EmscriptenCommunication.h" // To use Emscripten to slice stuff.
 #include "progress/Progress.h"
 #include "utils/ThreadPool.h"
@@ -129,6 +130,16 @@ void Application::printHelp() const
     fmt::print("  -m<thread_count>\n\tSet the desired number of threads. Supports only a single digit.\n");
     fmt::print("\n");
 #endif // ARCUS
+#ifndef __EMSCRIPTEN__
+    fmt::print("CuraEngine daemon [-v] [-m<thread_count>]\n");
+    fmt::print("  Slice the jobs read from the standard input, one per line, keeping the thread pool, definition files and models loaded between them.\n");
+    fmt::print("  Every job is a JSON array with the arguments of a slice command, and must write to a file with -o.\n");
+    fmt::print("  A line with a JSON object is written to the standard output for every job. Log messages go to the standard error.\n");
+    fmt::print("  A job that fails to load ends the daemon, just like it ends the slice command.\n");
+    fmt::print("  -v\n\tIncrease the verbose level (show log messages).\n");
+    fmt::print("  -m<thread_count>\n\tSet the desired number of threads.\n");
+    fmt::print("\n");
+#endif
     fmt::print("CuraEngine slice [-v] [-p] [-j <settings.json>] [-s <settingkey>=<value>] [-g] [-e<extruder_nr>] [-o <output.gcode>] [-l <model.stl>] [--next]\n");
     fmt::print("  -v\n\tIncrease the verbose level (show log messages).\n");
     fmt::print("  -m<thread_count>\n\tSet the desired number of threads.\n");
@@ -142,6 +153,7 @@ void Application::printHelp() const
     fmt::print("  -e<extruder_nr>\n\tSwitch setting focus to the extruder train with the given number.\n");
     fmt::print("  --next\n\tGenerate gcode for the previously supplied mesh group and append that to \n\tthe gcode of further models for one-at-a-time printing.\n");
     fmt::print("  -o <output_file>\n\tSpecify a file to which to write the generated gcode.\n");
+    fmt::print("  --trace <trace_file>\n\tWrite a Chrome trace of the slice to the given file. Requires a build with ENABLE_TRACING.\n");
     fmt::print("\n");
     fmt::print("The settings are appended to the last supplied object:\n");
     fmt::print("CuraEngine slice [general settings] \n\t-g [current group settings] \n\t-e0 [extruder train 0 settings] \n\t-l obj_inheriting_from_last_extruder_train.stl [object "
@@ -149,6 +161,9 @@ void Application::printHelp() const
     fmt::print("\n");
     fmt::print("In order to load machine definitions from custom locations, you need to create the environment variable CURA_ENGINE_SEARCH_PATH, which should contain all search "
                "paths delimited by a (semi-)colon.\n");
+    fmt::print("Machine definitions are cached in the directory given by the environment variable CURA_ENGINE_DEFINITION_CACHE. If it is not set, they are cached in "
+               "$XDG_CACHE_HOME/cura_engine/definitions, or else in ~/.cache/cura_engine/definitions, or on Windows in the temporary directory. Set it to \"none\" to "
+               "disable the cache.\n");
     fmt::print("\n");
 }
 
@@ -225,13 +240,48 @@ void Application::slice()
 #endif
 }
 
+#ifndef __EMSCRIPTEN__
+void Application::daemon()
+{
+    // The replies go to the standard output, so the log messages have to go elsewhere.
+    auto dup_sink = std::make_shared<spdlog::sinks::dup_filter_sink_mt>(std::chrono::seconds{ 10 });
+    dup_sink->add_sink(std::make_shared<spdlog::sinks::stderr_color_sink_mt>());
+    spdlog::default_logger()->sinks() = std::vector<std::shared_ptr<spdlog::sinks::sink>>{ dup_sink };
+
+    for (size_t argument_index = 2; argument_index < argc_; argument_index++)
+    {
+        const std::string argument(argv_[argument_index]);
+        if (argument == "-v")
+        {
+            spdlog::set_level(spdlog::level::debug);
+        }
+        else if (argument.starts_with("-m"))
+        {
+            startThreadPool(std::stoi(argument.substr(2)));
+        }
+        else
+        {
+            spdlog::error("Unknown option: {}", argument);
+            printCall();
+            printHelp();
+            exit(1);
+        }
+    }
+    communication_ = std::make_shared<DaemonCommunication>();
+}
+#endif
+
 void Application::run(const size_t argc, char** argv)
 {
     argc_ = argc;
     argv_ = argv;
 
-    printHeader();
-    printLicense();
+    const bool is_daemon = argc >= 2 && stringcasecompare(argv[1], "daemon") == 0;
+    if (! is_daemon) // The daemon replies on the standard output, so nothing else may be printed there.
+    {
+        printHeader();
+        printLicense();
+    }
     Progress::init();
 
     if (argc < 2)
@@ -251,6 +301,12 @@ void Application::run(const size_t argc, char** argv)
         {
             slice();
         }
+#ifndef __EMSCRIPTEN__
+        else if (is_daemon)
+        {
+            daemon();
+        }
+#endif
         else if (stringcasecompare(argv[1], "help") == 0)
         {
             printHelp();
@@ -294,7 +350,7 @@ void Application::startThreadPool(int nworkers)
         nthreads = nworkers - 1; // Minus one for the main thread
     }
 
-    // Set the new OneTBB settings controller
+    // Set the new OneTBB settings controller. Our own parallel code only runs on the ThreadPool, this only caps what libraries may still run on OneTBB.
 #ifndef __EMSCRIPTEN__
     delete tbb_controller_;
     tbb_controller_ = new tbb::global_control(tbb::global_control::max_allowed_parallelism, nthreads + 1);
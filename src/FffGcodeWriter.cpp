@@ -30,10 +30,12 @@
 #include "geometry/OpenPolyline.h"
 #include "geometry/PointMatrix.h"
 #include "infill.h"
+#include "pathPlanning/Comb.h"
 #include "progress/Progress.h"
 #include "raft.h"
 #include "utils/Simplify.h" //Removing micro-segments created by offsetting.
 #include "utils/ThreadPool.h"
+#include "utils/Tracing.h"
 #include "utils/linearAlg2D.h"
 #include "utils/math.h"
 #include "utils/orderOptimizer.h"
@@ -61,6 +63,17 @@ void FffGcodeWriter::setTargetStream(std::ostream* stream)
     gcode.setOutputStream(stream);
 }
 
+bool FffGcodeWriter::closeTargetFile()
+{
+    if (! output_file.is_open())
+    {
+        return true;
+    }
+    gcode.setOutputStream(&std::cout);
+    output_file.close();
+    return ! output_file.fail();
+}
+
 bool FffGcodeWriter::getExtruderActualUse(int extruder_nr)
 {
     return gcode.getExtruderIsUsed(extruder_nr);
@@ -78,6 +91,10 @@ std::vector<Duration> FffGcodeWriter::getTotalPrintTimePerFeature()
 
 bool FffGcodeWriter::setTargetFile(const char* filename)
 {
+    if (output_file.is_open()) // Opening an open file stream fails, so close the file of the previous slice first.
+    {
+        output_file.close();
+    }
     output_file.open(filename);
     if (output_file.is_open())
     {
@@ -196,12 +213,16 @@ void FffGcodeWriter::writeGCode(SliceDataStorage& storage, TimeKeeper& time_keep
         [this, total_layers](std::optional<ProcessLayerResult> result_opt)
         {
             const ProcessLayerResult& result = result_opt.value();
+            CURA_TRACE_SPAN_ARG("write layer", result.layer_plan->getLayerNr());
             Progress::messageProgressLayer(result.layer_plan->getLayerNr(), total_layers, result.total_elapsed_time, result.stages_times);
             layer_plan_buffer.handle(*result.layer_plan, gcode);
         });
 
     layer_plan_buffer.flush();
 
+    const Comb::GridStatistics comb_grid_statistics = Comb::getGridStatistics();
+    spdlog::debug("Combing built {} of {} inside boundary grids", comb_grid_statistics.inside_grids_built, comb_grid_statistics.inside_grids_available);
+
     Progress::messageProgressStage(Progress::Stage::FINISH, &time_keeper);
 
     // Store the object height for when we are printing multiple objects, as we need to clear every one of them when moving to the next position.
@@ -1164,6 +1185,7 @@ void FffGcodeWriter::endRaftLayer(const SliceDataStorage& storage, LayerPlan& gc
 
 FffGcodeWriter::ProcessLayerResult FffGcodeWriter::processLayer(const SliceDataStorage& storage, LayerIndex layer_nr, const size_t total_layers) const
 {
+    CURA_TRACE_SPAN_ARG("processLayer", layer_nr);
     spdlog::debug("GcodeWriter processing layer {} of {}", layer_nr, total_layers);
     TimeKeeper time_keeper;
     spdlog::stopwatch timer_total;
@@ -3261,7 +3283,15 @@ void FffGcodeWriter::processTopBottom(
 
         Shape supported_skin_part_regions;
 
-        const std::optional<AngleDegrees> bridge_angle = bridgeAngle(mesh, skin_part.skin_fill, storage, layer_nr, bridge_layer, support_layer, supported_skin_part_regions);
+        const std::optional<AngleDegrees> bridge_angle = bridgeAngle(
+            mesh,
+            skin_part.skin_fill,
+            storage,
+            layer_nr,
+            bridge_layer,
+            support_layer,
+            gcode_layer,
+            supported_skin_part_regions);
 
         if (bridge_angle.has_value() || (support_threshold > 0 && (supported_skin_part_regions.area() / (skin_part.skin_fill.area() + 1) < support_threshold)))
         {
@@ -49,6 +49,7 @@
 #include "settings/types/LayerIndex.h"
 #include "utils/algorithm.h"
 #include "utils/ThreadPool.h"
+#include "utils/Tracing.h"
 #include "utils/gettime.h"
 #include "utils/math.h"
 #include "PrimeTower/PrimeTower.h"
@@ -97,6 +98,7 @@ size_t FffPolygonGenerator::getDraftShieldLayerCount(const size_t total_layers)
 
 bool FffPolygonGenerator::sliceModel(MeshGroup* meshgroup, TimeKeeper& timeKeeper, SliceDataStorage& storage) /// slices the model
 {
+    CURA_TRACE_SPAN("sliceModel");
     Progress::messageProgressStage(Progress::Stage::SLICING, &timeKeeper);
 
     storage.model_min = meshgroup->min();
@@ -270,6 +272,8 @@ bool FffPolygonGenerator::sliceModel(MeshGroup* meshgroup, TimeKeeper& timeKeepe
 
     storage.meshes.reserve(
         slicerList.size()); // causes there to be no resize in meshes so that the pointers in sliceMeshStorage._config to retraction_config don't get invalidated.
+    std::vector<SliceMeshStorage*> part_meshes;
+    std::vector<Slicer*> part_slicers;
     for (unsigned int meshIdx = 0; meshIdx < slicerList.size(); meshIdx++)
     {
         Slicer* slicer = slicerList[meshIdx];
@@ -283,7 +287,9 @@ bool FffPolygonGenerator::sliceModel(MeshGroup* meshgroup, TimeKeeper& timeKeepe
         const bool is_support_modifier = AreaSupport::handleSupportModifierMesh(storage, mesh.settings_, slicer);
         if (! is_support_modifier)
         {
-            createLayerParts(meshStorage, slicer);
+            // The parts of all meshes are created together below.
+            part_meshes.push_back(&meshStorage);
+            part_slicers.push_back(slicer);
         }
 
         // Do not add and process support _modifier_ meshes further, and ONLY skip support _modifiers_. They have been
@@ -340,16 +346,20 @@ bool FffPolygonGenerator::sliceModel(MeshGroup* meshgroup, TimeKeeper& timeKeepe
                 }
             }
         }
+    }
 
-        delete slicerList[meshIdx];
-
-        Progress::messageProgress(Progress::Stage::PARTS, meshIdx + 1, slicerList.size());
+    createLayerParts(part_meshes, part_slicers);
+    for (Slicer* slicer : slicerList)
+    {
+        delete slicer;
     }
+    Progress::messageProgress(Progress::Stage::PARTS, slicerList.size(), slicerList.size());
     return true;
 }
 
 void FffPolygonGenerator::slices2polygons(SliceDataStorage& storage, TimeKeeper& time_keeper)
 {
+    CURA_TRACE_SPAN("slices2polygons");
     // compute layer count and remove first empty layers
     // there is no separate progress stage for removeEmptyFirstLayer (TODO)
     unsigned int slice_layer_count = 0;
@@ -408,12 +418,18 @@ void FffPolygonGenerator::slices2polygons(SliceDataStorage& storage, TimeKeeper&
         return;
     }
 
+    // From here on the outlines of the models don't change anymore, while support, shields, skirt and brim all need them.
+    storage.cacheModelOutlines();
+
     Progress::messageProgressStage(Progress::Stage::SUPPORT, &time_keeper);
 
-    AreaSupport::generateOverhangAreas(storage);
-    AreaSupport::generateSupportAreas(storage);
-    TreeSupport tree_support_generator(storage);
-    tree_support_generator.generateSupportAreas(storage);
+    {
+        CURA_TRACE_SPAN("support areas");
+        AreaSupport::generateOverhangAreas(storage);
+        AreaSupport::generateSupportAreas(storage);
+        TreeSupport tree_support_generator(storage);
+        tree_support_generator.generateSupportAreas(storage);
+    }
 
     computePrintHeightStatistics(storage);
 
@@ -443,7 +459,10 @@ void FffPolygonGenerator::slices2polygons(SliceDataStorage& storage, TimeKeeper&
 
     spdlog::debug("Processing gradual support");
     // generate gradual support
-    AreaSupport::generateSupportInfillFeatures(storage);
+    {
+        CURA_TRACE_SPAN("support infill features");
+        AreaSupport::generateSupportInfillFeatures(storage);
+    }
 }
 
 void FffPolygonGenerator::processBasicWallsSkinInfill(
@@ -452,6 +471,7 @@ void FffPolygonGenerator::processBasicWallsSkinInfill(
     const std::vector<size_t>& mesh_order,
     ProgressStageEstimator& inset_skin_progress_estimate)
 {
+    CURA_TRACE_SPAN_ARG("processBasicWallsSkinInfill", mesh_order_idx);
     size_t mesh_idx = mesh_order[mesh_order_idx];
     SliceMeshStorage& mesh = *storage.meshes[mesh_idx];
     size_t mesh_layer_count = mesh.layers.size();
@@ -496,10 +516,17 @@ void FffPolygonGenerator::processBasicWallsSkinInfill(
         }
     } guarded_progress = { inset_skin_progress_estimate };
 
+    // Layers differ a lot in how much work they are, for example the layers above the model are empty.
+    const auto layer_cost = [&mesh](const size_t layer_number)
+    {
+        return mesh.layers[layer_number].pointCount();
+    };
+
     // walls
     cura::parallel_for<size_t>(
         0,
         mesh_layer_count,
+        layer_cost,
         [&](size_t layer_number)
         {
             spdlog::debug("Processing insets for layer {} of {}", layer_number, mesh.layers.size());
@@ -543,6 +570,7 @@ void FffPolygonGenerator::processBasicWallsSkinInfill(
     cura::parallel_for<size_t>(
         0,
         mesh_layer_count,
+        layer_cost,
         [&](size_t layer_number)
         {
             spdlog::debug("Processing skins and infill layer {} of {}", layer_number, mesh.layers.size());
@@ -667,6 +695,7 @@ void FffPolygonGenerator::processInfillMesh(SliceDataStorage& storage, const siz
 
 void FffPolygonGenerator::processDerivedWallsSkinInfill(SliceMeshStorage& mesh)
 {
+    CURA_TRACE_SPAN("processDerivedWallsSkinInfill");
     if (mesh.settings.get<bool>("infill_support_enabled"))
     { // create gradual infill areas
         SkinInfillAreaComputation::generateInfillSupport(mesh);
@@ -958,12 +987,17 @@ void FffPolygonGenerator::processOozeShield(SliceDataStorage& storage)
 
     const coord_t ooze_shield_dist = mesh_group_settings.get<coord_t>("ooze_shield_dist");
 
-    for (int layer_nr = 0; layer_nr <= storage.max_print_height_second_to_last_extruder; layer_nr++)
-    {
-        constexpr bool around_support = true;
-        constexpr bool around_prime_tower = false;
-        storage.ooze_shield.push_back(storage.getLayerOutlines(layer_nr, around_support, around_prime_tower).offset(ooze_shield_dist, ClipperLib::jtRound).getOutsidePolygons());
-    }
+    storage.ooze_shield.resize(std::max(storage.max_print_height_second_to_last_extruder + 1, 0));
+    cura::parallel_for<size_t>(
+        0,
+        storage.ooze_shield.size(),
+        [&](const size_t layer_nr)
+        {
+            constexpr bool around_support = true;
+            constexpr bool around_prime_tower = false;
+            storage.ooze_shield[layer_nr]
+                = storage.getLayerOutlines(layer_nr, around_support, around_prime_tower).offset(ooze_shield_dist, ClipperLib::jtRound).getOutsidePolygons();
+        });
 
     const AngleDegrees angle = mesh_group_settings.get<AngleDegrees>("ooze_shield_angle");
     if (angle <= 89)
@@ -980,29 +1014,30 @@ void FffPolygonGenerator::processOozeShield(SliceDataStorage& storage)
         }
     }
 
-    const double largest_printed_area = 1.0; // TODO: make var a parameter, and perhaps even a setting?
-    for (LayerIndex layer_nr = 0; layer_nr <= storage.max_print_height_second_to_last_extruder; layer_nr++)
-    {
-        storage.ooze_shield[layer_nr].removeSmallAreas(largest_printed_area);
-    }
+    coord_t max_line_width = 0;
     if (storage.prime_tower_)
-    {
-        coord_t max_line_width = 0;
-        { // compute max_line_width
-            const std::vector<bool> extruder_is_used = storage.getExtrudersUsed();
-            const auto& extruders = Application::getInstance().current_slice_->scene.extruders;
-            for (int extruder_nr = 0; extruder_nr < int(extruders.size()); extruder_nr++)
-            {
-                if (! extruder_is_used[extruder_nr])
-                    continue;
-                max_line_width = std::max(max_line_width, extruders[extruder_nr].settings_.get<coord_t>("skirt_brim_line_width"));
-            }
-        }
-        for (LayerIndex layer_nr = 0; layer_nr <= storage.max_print_height_second_to_last_extruder; layer_nr++)
+    { // compute max_line_width
+        const std::vector<bool> extruder_is_used = storage.getExtrudersUsed();
+        const auto& extruders = Application::getInstance().current_slice_->scene.extruders;
+        for (int extruder_nr = 0; extruder_nr < int(extruders.size()); extruder_nr++)
         {
-            storage.ooze_shield[layer_nr] = storage.ooze_shield[layer_nr].difference(storage.prime_tower_->getOccupiedOutline(layer_nr).offset(max_line_width / 2));
+            if (! extruder_is_used[extruder_nr])
+                continue;
+            max_line_width = std::max(max_line_width, extruders[extruder_nr].settings_.get<coord_t>("skirt_brim_line_width"));
         }
     }
+    const double largest_printed_area = 1.0; // TODO: make var a parameter, and perhaps even a setting?
+    cura::parallel_for<size_t>(
+        0,
+        storage.ooze_shield.size(),
+        [&](const size_t layer_nr)
+        {
+            storage.ooze_shield[layer_nr].removeSmallAreas(largest_printed_area);
+            if (storage.prime_tower_)
+            {
+                storage.ooze_shield[layer_nr] = storage.ooze_shield[layer_nr].difference(storage.prime_tower_->getOccupiedOutline(layer_nr).offset(max_line_width / 2));
+            }
+        });
 }
 
 void FffPolygonGenerator::processDraftShield(SliceDataStorage& storage)
@@ -1017,13 +1052,15 @@ void FffPolygonGenerator::processDraftShield(SliceDataStorage& storage)
 
     const LayerIndex layer_skip{ 500 / layer_height + 1 };
 
-    Shape& draft_shield = storage.draft_protection_shield;
+    // Union all sampled layers at once, rather than growing the shield one layer at a time.
+    Shape draft_shield;
     for (LayerIndex layer_nr = 0; layer_nr < storage.print_layer_count && layer_nr < draft_shield_layers; layer_nr += layer_skip)
     {
         constexpr bool around_support = true;
         constexpr bool around_prime_tower = false;
-        draft_shield = draft_shield.unionPolygons(storage.getLayerOutlines(layer_nr, around_support, around_prime_tower));
+        draft_shield.push_back(storage.getLayerOutlines(layer_nr, around_support, around_prime_tower));
     }
+    draft_shield = draft_shield.unionPolygons();
 
     const coord_t draft_shield_dist = mesh_group_settings.get<coord_t>("draft_shield_dist");
     storage.draft_protection_shield = draft_shield.approxConvexHull(draft_shield_dist);
@@ -1056,6 +1093,7 @@ void FffPolygonGenerator::processDraftShield(SliceDataStorage& storage)
 
 void FffPolygonGenerator::processPlatformAdhesion(SliceDataStorage& storage)
 {
+    CURA_TRACE_SPAN("processPlatformAdhesion");
     const Settings& mesh_group_settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
     EPlatformAdhesion adhesion_type = mesh_group_settings.get<EPlatformAdhesion>("adhesion_type");
 
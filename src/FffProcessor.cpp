@@ -18,6 +18,11 @@ void FffProcessor::setTargetStream(std::ostream* stream)
     return gcode_writer.setTargetStream(stream);
 }
 
+bool FffProcessor::closeTargetFile()
+{
+    return gcode_writer.closeTargetFile();
+}
+
 bool FffProcessor::getExtruderActualUse(int extruder_nr)
 {
     return gcode_writer.getExtruderActualUse(extruder_nr);
@@ -79,7 +79,7 @@ GCodePath* LayerPlan::getLatestPathWithConfig(
 
 const Shape* LayerPlan::getCombBoundaryInside() const
 {
-    return &comb_boundary_preferred_;
+    return &getCombBoundary(CombBoundary::PREFERRED);
 }
 
 void LayerPlan::forceNewPathStart()
@@ -113,9 +113,7 @@ LayerPlan::LayerPlan(
     , last_planned_extruder_(&Application::getInstance().current_slice_->scene.extruders[start_extruder])
     , first_travel_destination_is_inside_(false)
     , // set properly when addTravel is called for the first time (otherwise not set properly)
-    comb_boundary_minimum_(computeCombBoundary(CombBoundary::MINIMUM))
-    , comb_boundary_preferred_(computeCombBoundary(CombBoundary::PREFERRED))
-    , comb_move_inside_distance_(comb_move_inside_distance)
+    comb_move_inside_distance_(comb_move_inside_distance)
     , fan_speed_layer_time_settings_per_extruder_(fan_speed_layer_time_settings_per_extruder)
 {
     size_t current_extruder = start_extruder;
@@ -124,7 +122,20 @@ LayerPlan::LayerPlan(
     const auto& local_settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
     if (local_settings.get<CombingMode>("retraction_combing") != CombingMode::OFF && local_settings.get<coord_t>("retraction_combing_avoid_distance") > 0)
     {
-        comb_ = new Comb(storage, layer_nr, comb_boundary_minimum_, comb_boundary_preferred_, comb_boundary_offset, travel_avoid_distance, comb_move_inside_distance);
+        comb_ = new Comb(
+            storage,
+            layer_nr,
+            [this]() -> const Shape&
+            {
+                return getCombBoundary(CombBoundary::MINIMUM);
+            },
+            [this]() -> const Shape&
+            {
+                return getCombBoundary(CombBoundary::PREFERRED);
+            },
+            comb_boundary_offset,
+            travel_avoid_distance,
+            comb_move_inside_distance);
     }
     else
     {
@@ -162,7 +173,7 @@ ExtruderTrain* LayerPlan::getLastPlannedExtruderTrain()
     return last_planned_extruder_;
 }
 
-Shape LayerPlan::computeCombBoundary(const CombBoundary boundary_type)
+Shape LayerPlan::computeCombBoundary(const CombBoundary boundary_type) const
 {
     Shape comb_boundary;
     const CombingMode mesh_combing_mode = Application::getInstance().current_slice_->scene.current_mesh_group->settings.get<CombingMode>("retraction_combing");
@@ -250,6 +261,16 @@ Shape LayerPlan::computeCombBoundary(const CombBoundary boundary_type)
     return comb_boundary;
 }
 
+const Shape& LayerPlan::getCombBoundary(const CombBoundary boundary_type) const
+{
+    std::optional<Shape>& comb_boundary = boundary_type == CombBoundary::MINIMUM ? comb_boundary_minimum_ : comb_boundary_preferred_;
+    if (! comb_boundary.has_value())
+    {
+        comb_boundary = computeCombBoundary(boundary_type);
+    }
+    return *comb_boundary;
+}
+
 void LayerPlan::setIsInside(bool _is_inside)
 {
     is_inside_ = _is_inside;
@@ -328,11 +349,12 @@ void LayerPlan::moveInsideCombBoundary(const coord_t distance, const std::option
     constexpr coord_t max_dist2 = MM2INT(2.0) * MM2INT(2.0); // if we are further than this distance, we conclude we are not inside even though we thought we were.
     // this function is to be used to move from the boundary of a part to inside the part
     Point2LL p = getLastPlannedPositionOrStartingPosition(); // copy, since we are going to move p
-    if (PolygonUtils::moveInside(comb_boundary_preferred_, p, distance, max_dist2) != NO_INDEX)
+    const Shape& comb_boundary_preferred = getCombBoundary(CombBoundary::PREFERRED);
+    if (PolygonUtils::moveInside(comb_boundary_preferred, p, distance, max_dist2) != NO_INDEX)
     {
         // Move inside again, so we move out of tight 90deg corners
-        PolygonUtils::moveInside(comb_boundary_preferred_, p, distance, max_dist2);
-        if (comb_boundary_preferred_.inside(p) && (part == std::nullopt || part->outline.inside(p)))
+        PolygonUtils::moveInside(comb_boundary_preferred, p, distance, max_dist2);
+        if (comb_boundary_preferred.inside(p) && (part == std::nullopt || part->outline.inside(p)))
         {
             addTravel_simple(p, path);
             // Make sure the that any retraction happens after this move, not before it by starting a new move path.
@@ -626,9 +648,9 @@ void LayerPlan::addExtrusionMoveWithGradualOverhang(
     const Point3LL start = last_planned_position_.value();
     const Point2LL start_flat = start.toPoint2LL();
     size_t actual_speed_region_index = overhang_masks_.size() - 1; // Default to last region, which is infinity and beyond
-    for (const auto& [index, overhang_region] : overhang_masks_ | ranges::views::drop_last(1) | ranges::views::enumerate)
+    for (const auto& [index, overhang_region_grid] : overhang_mask_grids_ | ranges::views::enumerate)
     {
-        if (overhang_region.supported_region.inside(start_flat, true))
+        if (overhang_region_grid.inside(start_flat, true))
         {
             actual_speed_region_index = index;
             break;
@@ -641,9 +663,9 @@ void LayerPlan::addExtrusionMoveWithGradualOverhang(
     const Point3LL vector = end - start;
     std::vector<std::vector<float>> speed_regions_intersections;
     speed_regions_intersections.reserve(overhang_masks_.size() - 1);
-    for (const OverhangMask& overhang_region : overhang_masks_ | ranges::views::drop_last(1))
+    for (const ShapeSegmentGrid& overhang_region_grid : overhang_mask_grids_)
     {
-        std::vector<float> intersections = overhang_region.supported_region.intersectionsWithSegment(start_flat, end_flat);
+        std::vector<float> intersections = overhang_region_grid.intersectionsWithSegment(start_flat, end_flat);
         ranges::stable_sort(intersections);
         speed_regions_intersections.push_back(intersections);
     }
@@ -2229,7 +2251,7 @@ void LayerPlan::addLinesByOptimizer(
     const Shape& extra_inwards_move_contour)
 {
     Shape boundary;
-    if (enable_travel_optimization && ! comb_boundary_minimum_.empty())
+    if (enable_travel_optimization && ! getCombBoundary(CombBoundary::MINIMUM).empty())
     {
         // use the combing boundary inflated so that all infill lines are inside the boundary
         int dist = 0;
@@ -2246,7 +2268,7 @@ void LayerPlan::addLinesByOptimizer(
             }
             dist += 100; // ensure boundary is slightly outside all skin/infill lines
         }
-        boundary.push_back(comb_boundary_minimum_.offset(dist));
+        boundary.push_back(getCombBoundary(CombBoundary::MINIMUM).offset(dist));
         // simplify boundary to cut down processing time
         boundary = Simplify(MM2INT(0.1), MM2INT(0.1), 0).polygon(boundary);
     }
@@ -2299,7 +2321,7 @@ void LayerPlan::addLinesByOptimizer(
     const std::unordered_multimap<const Polyline*, const Polyline*>& order_requirements)
 {
     Shape boundary;
-    if (enable_travel_optimization && ! comb_boundary_minimum_.empty())
+    if (enable_travel_optimization && ! getCombBoundary(CombBoundary::MINIMUM).empty())
     {
         // use the combing boundary inflated so that all infill lines are inside the boundary
         int dist = 0;
@@ -2316,7 +2338,7 @@ void LayerPlan::addLinesByOptimizer(
             }
             dist += 100; // ensure boundary is slightly outside all skin/infill lines
         }
-        boundary.push_back(comb_boundary_minimum_.offset(dist));
+        boundary.push_back(getCombBoundary(CombBoundary::MINIMUM).offset(dist));
         // simplify boundary to cut down processing time
         boundary = Simplify(MM2INT(0.1), MM2INT(0.1), 0).polygon(boundary);
     }
@@ -2847,12 +2869,37 @@ void LayerPlan::writeTravelSegment(
 
 void LayerPlan::sendLineTo(const GCodePath& path, const Point3LL& position, const double extrude_speed, const std::optional<coord_t>& line_thickness)
 {
-    Application::getInstance().communication_->sendLineTo(
-        path.config.type,
-        position + Point3LL(0, 0, z_ + path.z_offset),
-        path.getLineWidthForLayerView(),
-        line_thickness.value_or(path.config.getLayerThickness() + path.z_offset + position.z_),
-        extrude_speed);
+    if (! send_layer_view_)
+    {
+        return;
+    }
+    if (layer_view_lines_.type != path.config.type)
+    {
+        flushLayerView();
+        layer_view_lines_.type = path.config.type;
+    }
+    layer_view_lines_.to.push_back(position + Point3LL(0, 0, z_ + path.z_offset));
+    layer_view_lines_.widths.push_back(path.getLineWidthForLayerView());
+    layer_view_lines_.thicknesses.push_back(line_thickness.value_or(path.config.getLayerThickness() + path.z_offset + position.z_));
+    layer_view_lines_.velocities.push_back(extrude_speed);
+}
+
+void LayerPlan::flushLayerView()
+{
+    if (layer_view_lines_.to.empty())
+    {
+        return;
+    }
+    Application::getInstance().communication_->sendLinesTo(
+        layer_view_lines_.type,
+        layer_view_lines_.to,
+        layer_view_lines_.widths,
+        layer_view_lines_.thicknesses,
+        layer_view_lines_.velocities);
+    layer_view_lines_.to.clear();
+    layer_view_lines_.widths.clear();
+    layer_view_lines_.thicknesses.clear();
+    layer_view_lines_.velocities.clear();
 }
 
 void LayerPlan::writeTravelRelativeZ(GCodeExport& gcode, const Point3LL& position, const Velocity& speed, const coord_t path_z_offset, const std::optional<double> retract_distance)
@@ -3372,7 +3419,10 @@ void LayerPlan::processFanSpeedAndMinimalLayerTime(Point2LL starting_position)
 
 void LayerPlan::writeGCode(GCodeExport& gcode)
 {
+    gcode.writePendingTimeEstimate(); // Finish off the previous layer first.
+
     auto communication = Application::getInstance().communication_;
+    send_layer_view_ = communication->hasLayerView();
     communication->setLayerForSend(layer_nr_);
     communication->sendCurrentPosition(gcode.getPosition());
     gcode.setLayerNr(layer_nr_);
@@ -3783,6 +3833,7 @@ void LayerPlan::writeGCode(GCodeExport& gcode)
 
                         prev_point = pt;
                     }
+                    flushLayerView();
                 }
             }
             else
@@ -3823,6 +3874,7 @@ void LayerPlan::writeGCode(GCodeExport& gcode)
                             update_extrusion_offset);
                         sendLineTo(spiral_path, Point3LL(p1.x_, p1.y_, z_offset), extrude_speed, layer_thickness_);
                     }
+                    flushLayerView();
                 };
 
                 for (; path_idx < paths.size() && paths[path_idx].spiralize; path_idx++)
@@ -3879,6 +3931,7 @@ void LayerPlan::writeGCode(GCodeExport& gcode)
             scripta::CellVDI{ "extrusion_mm3_per_mm", &GCodePath::getExtrusionMM3perMM });
     } // extruder plans /\  .
 
+    flushLayerView();
     communication->sendLayerComplete(layer_nr_, z_, layer_thickness_);
     gcode.updateTotalPrintTime();
 }
@@ -3960,6 +4013,7 @@ bool LayerPlan::writePathWithCoasting(
 
         writeExtrusionRelativeZ(gcode, path_coasting.coasting_start_pos, extrude_speed, path.z_offset, path.getExtrusionMM3perMM(), path.config.type);
         sendLineTo(path, path_coasting.coasting_start_pos, extrude_speed);
+        flushLayerView(); // The coasting moves are sent as travels.
     }
 
     // write coasting path
@@ -4130,6 +4184,13 @@ void LayerPlan::setBridgeWallMask(const Shape& polys)
 void LayerPlan::setOverhangMasks(const std::vector<OverhangMask>& masks)
 {
     overhang_masks_ = masks;
+
+    // The extrusion moves are tested against every region, so prepare for fast lookups once per layer part.
+    overhang_mask_grids_.clear();
+    for (const OverhangMask& overhang_region : overhang_masks_ | ranges::views::drop_last(1))
+    {
+        overhang_mask_grids_.emplace_back(overhang_region.supported_region);
+    }
 }
 
 void LayerPlan::setSeamOverhangMask(const Shape& polys)
@@ -4142,6 +4203,32 @@ const Shape& LayerPlan::getSeamOverhangMask() const
     return seam_overhang_mask_;
 }
 
+const Shape& LayerPlan::getInfillBelow(const size_t layers_below) const
+{
+    assert(layers_below >= 1 && layers_below <= infill_below_.size());
+    std::optional<Shape>& infill_below = infill_below_[layers_below - 1];
+    if (! infill_below.has_value())
+    {
+        Shape infill;
+        const LayerIndex layer_below = layer_nr_ - static_cast<LayerIndex::value_type>(layers_below);
+        if (layer_below >= 0)
+        {
+            for (const std::shared_ptr<SliceMeshStorage>& mesh : storage_.meshes)
+            {
+                if (mesh->isPrinted())
+                {
+                    for (const SliceLayerPart& part : mesh->layers[layer_below].parts)
+                    {
+                        infill.push_back(part.getOwnInfillArea());
+                    }
+                }
+            }
+        }
+        infill_below = infill.unionPolygons();
+    }
+    return *infill_below;
+}
+
 void LayerPlan::setRoofingMask(const Shape& polys)
 {
     roofing_mask_ = polys;
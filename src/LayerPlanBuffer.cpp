@@ -13,6 +13,7 @@
 #include "Slice.h"
 #include "communication/Communication.h" //To flush g-code through the communication channel.
 #include "gcodeExport.h"
+#include "utils/Tracing.h"
 
 namespace cura
 {
@@ -22,6 +23,7 @@ constexpr Duration LayerPlanBuffer::extra_preheat_time_;
 
 void LayerPlanBuffer::handle(LayerPlan& layer_plan, GCodeExport& gcode)
 {
+    CURA_TRACE_SPAN_ARG("LayerPlanBuffer::handle", layer_plan.getLayerNr());
     std::lock_guard mutex_locker(buffer_mutex_);
 
     buffer_.push_back(&layer_plan);
@@ -54,6 +56,7 @@ LayerPlan* LayerPlanBuffer::processBuffer()
     if (buffer_.size() > buffer_size_)
     {
         LayerPlan* ret = buffer_.front();
+        gcode_.writePendingTimeEstimate(); // The elapsed time comment belongs to the g-code of the layer that is sent now.
         Application::getInstance().communication_->flushGCode();
         buffer_.pop_front();
         return ret;
@@ -63,6 +66,8 @@ LayerPlan* LayerPlanBuffer::processBuffer()
 
 void LayerPlanBuffer::flush()
 {
+    CURA_TRACE_SPAN("LayerPlanBuffer::flush");
+    gcode_.writePendingTimeEstimate();
     Application::getInstance()
         .communication_->flushGCode(); // If there was still g-code in a layer, flush that as a separate layer. Don't want to group them together accidentally.
     if (buffer_.size() > 0)
@@ -72,6 +77,7 @@ void LayerPlanBuffer::flush()
     while (! buffer_.empty())
     {
         buffer_.front()->writeGCode(gcode_);
+        gcode_.writePendingTimeEstimate(); // Each layer is sent right away, so its elapsed time comment can't wait for the next layer.
         Application::getInstance().communication_->flushGCode();
         delete buffer_.front();
         buffer_.pop_front();
@@ -1,7 +1,6 @@
 // Copyright (c) 2025 UltiMaker
 // CuraEngine is released under the terms of the AGPLv3 or higher
 
-#include <execution>
 #include <unordered_set>
 
 #include <boost/unordered/concurrent_flat_map.hpp>
@@ -216,10 +215,8 @@ std::vector<Mesh> makeMeshesFromVoxelsGrid(const VoxelGrid& voxel_grid, const ui
 
     const Point3D position_delta_center(half_res_x, half_res_y, 0);
     boost::concurrent_flat_map<ContourKey, Contour> raw_contours;
-    marching_squares.visit_all(
-#ifdef __cpp_lib_execution
-        std::execution::par,
-#endif
+    parallel_visit_all(
+        marching_squares,
         [&voxel_grid, &raw_contours, &position_delta_center, &marching_segments, &mesh_extruder_nr](const VoxelGrid::LocalCoordinates square_start)
         {
             const int32_t x_plus1 = static_cast<int32_t>(square_start.position.x) + 1;
@@ -300,10 +297,8 @@ std::vector<Mesh> makeMeshesFromVoxelsGrid(const VoxelGrid& voxel_grid, const ui
         });
 
     // Now we have added separate segments, stitch them to proper closed polygons
-    raw_contours.visit_all(
-#ifdef __cpp_lib_execution
-        std::execution::par,
-#endif
+    parallel_visit_all(
+        raw_contours,
         [](auto& raw_contour)
         {
             OpenLinesSet result_lines;
@@ -316,10 +311,8 @@ std::vector<Mesh> makeMeshesFromVoxelsGrid(const VoxelGrid& voxel_grid, const ui
 
     std::map<uint8_t, Mesh> meshes;
     std::mutex mutex;
-    raw_contours.visit_all(
-#ifdef __cpp_lib_execution
-        std::execution::par,
-#endif
+    parallel_visit_all(
+        raw_contours,
         [&simplifier, &voxel_grid, &meshes, &mutex](const auto& contour)
         {
             const uint16_t z = contour.first.definition.z;
@@ -433,10 +426,8 @@ boost::concurrent_flat_set<VoxelGrid::LocalCoordinates>
     boost::concurrent_flat_set<VoxelGrid::LocalCoordinates> voxels_to_evaluate;
     boost::concurrent_flat_set<VoxelGrid::LocalCoordinates> voxels_considered;
 
-    previously_evaluated_voxels.visit_all(
-#ifdef __cpp_lib_execution
-        std::execution::par,
-#endif
+    parallel_visit_all(
+        previously_evaluated_voxels,
         [&](const VoxelGrid::LocalCoordinates& previously_evaluated_voxel)
         {
             for (const VoxelGrid::LocalCoordinates& voxel_around : voxel_grid.getVoxelsAround(previously_evaluated_voxel))
@@ -469,10 +460,8 @@ void evaluateVoxels(
     const coord_t depth_squared,
     const uint8_t mesh_extruder_nr)
 {
-    voxels_to_evaluate.visit_all(
-#ifdef __cpp_lib_execution
-        std::execution::par,
-#endif
+    parallel_visit_all(
+        voxels_to_evaluate,
         [&voxel_grid, &texture_data, &sliced_mesh, &depth_squared, &mesh_extruder_nr](const VoxelGrid::LocalCoordinates& voxel_to_evaluate)
         {
             const Point3D position = voxel_grid.toGlobalCoordinates(voxel_to_evaluate);
@@ -507,10 +496,8 @@ void evaluateVoxels(
  */
 void findBoundaryVoxels(boost::concurrent_flat_set<VoxelGrid::LocalCoordinates>& evaluated_voxels, const VoxelGrid& voxel_grid)
 {
-    evaluated_voxels.erase_if(
-#ifdef __cpp_lib_execution
-        std::execution::par,
-#endif
+    parallel_erase_if(
+        evaluated_voxels,
         [&voxel_grid](const VoxelGrid::LocalCoordinates& evaluated_voxel)
         {
             bool has_various_voxels_around = false;
@@ -62,7 +62,7 @@ const std::string Scene::getAllSettingsString() const
     return output.str();
 }
 
-void Scene::processMeshGroup(MeshGroup& mesh_group)
+bool Scene::processMeshGroup(MeshGroup& mesh_group)
 {
     FffProcessor* fff_processor = FffProcessor::getInstance();
     fff_processor->time_keeper.restart();
@@ -82,13 +82,13 @@ void Scene::processMeshGroup(MeshGroup& mesh_group)
     {
         Progress::messageProgress(Progress::Stage::FINISH, 1, 1); // 100% on this meshgroup
         spdlog::info("Total time elapsed {:03.3f}s", time_keeper_total.restart());
-        return;
+        return true;
     }
 
     SliceDataStorage storage;
     if (! fff_processor->polygon_generator.generateAreas(storage, &mesh_group, fff_processor->time_keeper))
     {
-        return;
+        return false;
     }
 
     Progress::messageProgressStage(Progress::Stage::EXPORT, &fff_processor->time_keeper);
@@ -98,6 +98,7 @@ void Scene::processMeshGroup(MeshGroup& mesh_group)
     Application::getInstance().communication_->flushGCode();
     Application::getInstance().communication_->sendOptimizedLayerData();
     spdlog::info("Total time elapsed {:03.3f}s\n", time_keeper_total.restart());
+    return true;
 }
 
 } // namespace cura
@@ -3,6 +3,10 @@
 
 #include "SkirtBrim.h"
 
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
 #include <spdlog/spdlog.h>
 
 #include "Application.h"
@@ -16,6 +20,8 @@
 #include "support.h"
 #include "utils/MixedPolylineStitcher.h"
 #include "utils/Simplify.h"
+#include "utils/ThreadPool.h"
+#include "utils/UnionFind.h"
 
 namespace cura
 {
@@ -192,15 +198,32 @@ std::vector<coord_t> SkirtBrim::generatePrimaryBrim(std::vector<Offset>& all_bri
 {
     std::vector<coord_t> total_length(extruder_count_, 0U);
 
+    // The brims of parts far apart from each other can be generated separately, which is both parallel and cheaper, since every offset only has to deal
+    // with the areas around the parts of its own cluster. Offsets added to satisfy the minimal length are still performed for the whole layer afterwards.
+    std::vector<Cluster> clusters = clusterStartingOutlines(all_brim_offsets);
+    std::vector<coord_t> clustered_lengths;
+    if (clusters.size() > 1)
+    {
+        clustered_lengths = generateClusteredBrim(all_brim_offsets, clusters, covered_area, allowed_areas_per_extruder);
+    }
+
     for (size_t offset_idx = 0; offset_idx < all_brim_offsets.size(); offset_idx++)
     {
         Offset& offset = all_brim_offsets[offset_idx];
-        if (storage_.skirt_brim[offset.extruder_nr_].size() <= offset.inset_idx_)
+        coord_t added_length;
+        if (offset_idx < clustered_lengths.size())
         {
-            storage_.skirt_brim[offset.extruder_nr_].resize(offset.inset_idx_ + 1);
+            added_length = clustered_lengths[offset_idx];
+        }
+        else
+        {
+            if (storage_.skirt_brim[offset.extruder_nr_].size() <= offset.inset_idx_)
+            {
+                storage_.skirt_brim[offset.extruder_nr_].resize(offset.inset_idx_ + 1);
+            }
+            MixedLinesSet& output_location = storage_.skirt_brim[offset.extruder_nr_][offset.inset_idx_];
+            added_length = generateOffset(offset, storage_.skirt_brim[offset.extruder_nr_], covered_area, allowed_areas_per_extruder, output_location);
         }
-        MixedLinesSet& output_location = storage_.skirt_brim[offset.extruder_nr_][offset.inset_idx_];
-        const coord_t added_length = generateOffset(offset, covered_area, allowed_areas_per_extruder, output_location);
 
         if (added_length == 0)
         { // no more place for more brim. Trying to satisfy minimum length constraint with generateSecondarySkirtBrim
@@ -227,13 +250,197 @@ std::vector<coord_t> SkirtBrim::generatePrimaryBrim(std::vector<Offset>& all_bri
                 offset.inset_idx_ + 1,
                 offset.extruder_nr_,
                 is_last);
-            std::stable_sort(all_brim_offsets.begin() + offset_idx + 1, all_brim_offsets.end(), OffsetSorter); // reorder remaining offsets
+            // reorder remaining offsets, except for those which were already performed per cluster
+            std::stable_sort(all_brim_offsets.begin() + std::max(offset_idx + 1, clustered_lengths.size()), all_brim_offsets.end(), OffsetSorter);
         }
     }
     return total_length;
 }
 
-coord_t SkirtBrim::generateOffset(const Offset& offset, Shape& covered_area, std::vector<Shape>& allowed_areas_per_extruder, MixedLinesSet& result)
+std::vector<SkirtBrim::Cluster> SkirtBrim::clusterStartingOutlines(const std::vector<Offset>& all_brim_offsets) const
+{
+    // The brim lines of a polygon are at most as far from it as the farthest planned offset, and cover half a line width around that.
+    coord_t reach = 0;
+    std::vector<Outline*> outline_per_extruder(extruder_count_, nullptr);
+    for (const Offset& offset : all_brim_offsets)
+    {
+        reach = std::max(reach, offset.total_offset_ + extruders_configs_[offset.extruder_nr_].line_width_);
+        if (std::holds_alternative<Outline*>(offset.reference_outline_or_index_))
+        {
+            outline_per_extruder[offset.extruder_nr_] = std::get<Outline*>(offset.reference_outline_or_index_);
+        }
+    }
+
+    struct Element
+    {
+        size_t extruder_nr;
+        bool touching;
+        const Polygon* polygon;
+        AABB reach;
+    };
+    std::vector<Element> elements;
+    for (size_t extruder_nr = 0; extruder_nr < extruder_count_; extruder_nr++)
+    {
+        if (outline_per_extruder[extruder_nr] == nullptr)
+        {
+            continue;
+        }
+        for (const bool touching : { false, true })
+        {
+            for (const Polygon& polygon : touching ? outline_per_extruder[extruder_nr]->touching : outline_per_extruder[extruder_nr]->gapped)
+            {
+                AABB polygon_reach(polygon);
+                polygon_reach.expand(reach);
+                elements.push_back(Element{ .extruder_nr = extruder_nr, .touching = touching, .polygon = &polygon, .reach = polygon_reach });
+            }
+        }
+    }
+
+    // Sweep over the elements from left to right, so that only elements which overlap in X are compared.
+    std::vector<size_t> order(elements.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(
+        order.begin(),
+        order.end(),
+        [&elements](const size_t a, const size_t b)
+        {
+            return elements[a].reach.min_.X < elements[b].reach.min_.X;
+        });
+    UnionFind<size_t> groups;
+    for (size_t element_idx = 0; element_idx < elements.size(); element_idx++)
+    {
+        groups.add(element_idx); // The handle of each element is its index, because they are added in order.
+    }
+    for (size_t order_idx = 0; order_idx < order.size(); order_idx++)
+    {
+        const AABB& element_reach = elements[order[order_idx]].reach;
+        for (size_t other_idx = order_idx + 1; other_idx < order.size() && elements[order[other_idx]].reach.min_.X <= element_reach.max_.X; other_idx++)
+        {
+            if (! element_reach.hit(elements[order[other_idx]].reach))
+            {
+                continue;
+            }
+            const size_t group = groups.findByHandle(order[order_idx]);
+            const size_t other_group = groups.findByHandle(order[other_idx]);
+            if (group != other_group)
+            {
+                groups.unite(group, other_group);
+            }
+        }
+    }
+
+    std::vector<Cluster> clusters;
+    std::unordered_map<size_t, size_t> cluster_per_group;
+    for (size_t element_idx = 0; element_idx < elements.size(); element_idx++)
+    {
+        const Element& element = elements[element_idx];
+        const auto [cluster_it, is_new_cluster] = cluster_per_group.emplace(groups.findByHandle(element_idx), clusters.size());
+        if (is_new_cluster)
+        {
+            clusters.emplace_back().outlines_per_extruder_.resize(extruder_count_);
+        }
+        Cluster& cluster = clusters[cluster_it->second];
+        cluster.reach_.include(element.reach);
+        Outline& outline = cluster.outlines_per_extruder_[element.extruder_nr];
+        (element.touching ? outline.touching : outline.gapped).push_back(*element.polygon);
+    }
+    return clusters;
+}
+
+std::vector<coord_t> SkirtBrim::generateClusteredBrim(
+    const std::vector<Offset>& all_brim_offsets,
+    std::vector<Cluster>& clusters,
+    Shape& covered_area,
+    std::vector<Shape>& allowed_areas_per_extruder)
+{
+    struct ClusterBrim
+    {
+        Shape covered_area;
+        std::vector<Shape> allowed_areas_per_extruder;
+        std::vector<std::vector<MixedLinesSet>> lines_per_extruder;
+        std::vector<coord_t> length_per_offset;
+    };
+    std::vector<ClusterBrim> cluster_brims(clusters.size());
+
+    cura::parallel_for<size_t>(
+        0,
+        clusters.size(),
+        [&](const size_t cluster_idx)
+        {
+            Cluster& cluster = clusters[cluster_idx];
+            ClusterBrim& brim = cluster_brims[cluster_idx];
+
+            // Only what is within reach of the cluster can affect its brim.
+            const Shape reach(cluster.reach_.toPolygon());
+            brim.covered_area = covered_area.intersection(reach);
+            brim.allowed_areas_per_extruder.resize(extruder_count_);
+            for (size_t extruder_nr = 0; extruder_nr < extruder_count_; extruder_nr++)
+            {
+                if (extruders_configs_[extruder_nr].extruder_is_used_)
+                {
+                    brim.allowed_areas_per_extruder[extruder_nr] = allowed_areas_per_extruder[extruder_nr].intersection(reach);
+                }
+            }
+            brim.lines_per_extruder.resize(extruder_count_);
+            brim.length_per_offset.resize(all_brim_offsets.size(), 0);
+
+            for (size_t offset_idx = 0; offset_idx < all_brim_offsets.size(); offset_idx++)
+            {
+                Offset offset = all_brim_offsets[offset_idx];
+                if (std::holds_alternative<Outline*>(offset.reference_outline_or_index_))
+                {
+                    offset.reference_outline_or_index_ = &cluster.outlines_per_extruder_[offset.extruder_nr_];
+                }
+                std::vector<MixedLinesSet>& lines = brim.lines_per_extruder[offset.extruder_nr_];
+                if (lines.size() <= offset.inset_idx_)
+                {
+                    lines.resize(offset.inset_idx_ + 1);
+                }
+                brim.length_per_offset[offset_idx] = generateOffset(offset, lines, brim.covered_area, brim.allowed_areas_per_extruder, lines[offset.inset_idx_]);
+            }
+        });
+
+    std::vector<coord_t> length_per_offset(all_brim_offsets.size(), 0);
+    Shape covered_by_clusters;
+    for (ClusterBrim& brim : cluster_brims)
+    {
+        covered_by_clusters.push_back(brim.covered_area);
+        for (size_t extruder_nr = 0; extruder_nr < extruder_count_; extruder_nr++)
+        {
+            std::vector<MixedLinesSet>& lines = storage_.skirt_brim[extruder_nr];
+            if (lines.size() < brim.lines_per_extruder[extruder_nr].size())
+            {
+                lines.resize(brim.lines_per_extruder[extruder_nr].size());
+            }
+            for (size_t inset_idx = 0; inset_idx < brim.lines_per_extruder[extruder_nr].size(); inset_idx++)
+            {
+                MixedLinesSet& cluster_lines = brim.lines_per_extruder[extruder_nr][inset_idx];
+                lines[inset_idx].insert(lines[inset_idx].end(), std::make_move_iterator(cluster_lines.begin()), std::make_move_iterator(cluster_lines.end()));
+            }
+        }
+        for (size_t offset_idx = 0; offset_idx < all_brim_offsets.size(); offset_idx++)
+        {
+            length_per_offset[offset_idx] += brim.length_per_offset[offset_idx];
+        }
+    }
+
+    covered_area = covered_area.unionPolygons(covered_by_clusters);
+    for (size_t extruder_nr = 0; extruder_nr < extruder_count_; extruder_nr++)
+    {
+        if (extruders_configs_[extruder_nr].extruder_is_used_)
+        {
+            allowed_areas_per_extruder[extruder_nr] = allowed_areas_per_extruder[extruder_nr].difference(covered_area);
+        }
+    }
+    return length_per_offset;
+}
+
+coord_t SkirtBrim::generateOffset(
+    const Offset& offset,
+    const std::vector<MixedLinesSet>& previous_lines,
+    Shape& covered_area,
+    std::vector<Shape>& allowed_areas_per_extruder,
+    MixedLinesSet& result)
 {
     coord_t length_added;
     Shape brim;
@@ -264,7 +471,7 @@ coord_t SkirtBrim::generateOffset(const Offset& offset, Shape& covered_area, std
         const int reference_idx = std::get<int>(offset.reference_outline_or_index_);
         const coord_t offset_dist = extruder_config.line_width_;
 
-        brim.push_back(storage_.skirt_brim[offset.extruder_nr_][reference_idx].offset(offset_dist, ClipperLib::jtRound));
+        brim.push_back(previous_lines[reference_idx].offset(offset_dist, ClipperLib::jtRound));
     }
 
     // limit brim lines to allowed areas, stitch them and store them in the result
@@ -331,12 +538,14 @@ SkirtBrim::Outline SkirtBrim::getFirstLayerOutline(const int extruder_nr /* = -1
         }
         skirt_height = std::min(skirt_height, static_cast<int>(storage_.print_layer_count));
 
+        Shape skirt_layer_outlines;
         for (int i_layer = layer_nr; i_layer < skirt_height; ++i_layer)
         {
             constexpr bool include_support = true;
             constexpr bool include_prime_tower = true;
-            first_layer_outline.gapped = first_layer_outline.gapped.unionPolygons(storage_.getLayerOutlines(i_layer, include_support, include_prime_tower, true));
+            skirt_layer_outlines.push_back(storage_.getLayerOutlines(i_layer, include_support, include_prime_tower, true));
         }
+        first_layer_outline.gapped = first_layer_outline.gapped.unionPolygons(skirt_layer_outlines);
 
         Shape shields;
         if (has_ooze_shield_)
@@ -363,8 +572,11 @@ SkirtBrim::Outline SkirtBrim::getFirstLayerOutline(const int extruder_nr /* = -1
             constexpr bool include_prime_tower = false; // Not included, has its own brim
             constexpr bool external_polys_only = false; // Gather all polygons and treat them separately.
             first_layer_outline.gapped = storage_.getLayerOutlines(layer_nr, include_support, include_prime_tower, external_polys_only, extruder_nr);
-            first_layer_outline.gapped
-                = first_layer_outline.gapped.unionPolygons(); // To guard against overlapping outlines, which would produce holes according to the even-odd rule.
+            if (extruder_nr != -1) // The outlines of all models are united already.
+            {
+                first_layer_outline.gapped
+                    = first_layer_outline.gapped.unionPolygons(); // To guard against overlapping outlines, which would produce holes according to the even-odd rule.
+            }
         }
 
         if (storage_.support.generated && primary_line_count > 0 && ! storage_.support.supportLayers.empty()
@@ -547,7 +759,7 @@ void SkirtBrim::generateSecondarySkirtBrim(Shape& covered_area, std::vector<Shap
 
             storage_.skirt_brim[extruder_nr].emplace_back();
             MixedLinesSet& output_location = storage_.skirt_brim[extruder_nr].back();
-            coord_t added_length = generateOffset(extra_offset, covered_area, allowed_areas_per_extruder, output_location);
+            coord_t added_length = generateOffset(extra_offset, storage_.skirt_brim[extruder_nr], covered_area, allowed_areas_per_extruder, output_location);
 
             if (! added_length)
             {
@@ -18,7 +18,7 @@ Slice::Slice(const size_t num_mesh_groups)
 {
 }
 
-void Slice::compute()
+bool Slice::compute()
 {
     spdlog::info("All settings: {}", scene.getAllSettingsString());
 #ifdef SENTRY_URL
@@ -27,6 +27,7 @@ void Slice::compute()
     }
 #endif
 
+    bool succeeded = true;
     for (std::vector<MeshGroup>::iterator mesh_group = scene.mesh_groups.begin(); mesh_group != scene.mesh_groups.end(); mesh_group++)
     {
         scene.current_mesh_group = mesh_group;
@@ -34,8 +35,12 @@ void Slice::compute()
         {
             extruder.settings_.setParent(&scene.current_mesh_group->settings);
         }
-        scene.processMeshGroup(*mesh_group);
+        if (! scene.processMeshGroup(*mesh_group))
+        {
+            succeeded = false;
+        }
     }
+    return succeeded;
 }
 
 void Slice::reset()
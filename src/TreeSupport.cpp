@@ -3,12 +3,14 @@
 
 #include "TreeSupport.h"
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <optional>
 #include <stdio.h>
 #include <string>
 #include <thread>
+#include <unordered_map>
 
 #include <range/v3/view/drop_last.hpp>
 #include <range/v3/view/enumerate.hpp>
@@ -26,7 +28,9 @@
 #include "settings/EnumSettings.h"
 #include "support.h" //For precomputeCrossInfillTree
 #include "utils/Simplify.h"
+#include "utils/SquareGrid.h"
 #include "utils/ThreadPool.h"
+#include "utils/Tracing.h"
 #include "utils/algorithm.h"
 #include "utils/math.h" //For round_up_divide and PI.
 #include "utils/polygonUtils.h" //For moveInside.
@@ -112,6 +116,7 @@ void TreeSupport::generateSupportAreas(SliceDataStorage& storage)
     // Process every mesh group. These groups can not be processed parallel, as the processing in each group is parallelized, and nested parallelization is disables and slow.
     for (auto [counter, processing] : grouped_meshes | ranges::views::enumerate)
     {
+        CURA_TRACE_SPAN_ARG("tree support mesh group", counter);
         // process each combination of meshes
         std::vector<std::set<TreeSupportElement*>> move_bounds(
             storage.support.supportLayers
@@ -215,6 +220,7 @@ void TreeSupport::generateSupportAreas(SliceDataStorage& storage)
 
 LayerIndex TreeSupport::precalculate(const SliceDataStorage& storage, std::vector<size_t> currently_processing_meshes)
 {
+    CURA_TRACE_SPAN("tree support precalculate");
     // Calculate top most layer that is relevant for support.
     LayerIndex max_layer = -1;
     for (size_t mesh_idx : currently_processing_meshes)
@@ -255,6 +261,7 @@ LayerIndex TreeSupport::precalculate(const SliceDataStorage& storage, std::vecto
 
 void TreeSupport::generateInitialAreas(const SliceMeshStorage& mesh, std::vector<std::set<TreeSupportElement*>>& move_bounds, SliceDataStorage& storage)
 {
+    CURA_TRACE_SPAN("tree support initial areas");
     TreeSupportTipGenerator tip_gen(mesh, volumes_);
     tip_gen.generateTips(storage, mesh, move_bounds, additional_required_support_area, fake_roof_areas);
 }
@@ -276,12 +283,97 @@ void TreeSupport::mergeHelper(
     {
         return config.getRadius(distance_to_top, buildplate_radius_increases);
     };
+
+    // Broad phase: The reduced areas are kept in a uniform grid over their AABBs, so that every input area is only checked against the reduced areas near it.
+    // The candidates are visited in the order of reduced_aabb, so that the result is identical to checking all of them.
+    using ReducedIterator = std::map<TreeSupportElement, AABB>::iterator;
+    coord_t extent_sum = 0;
+    coord_t extent_max = 0;
+    size_t extent_count = 0;
+    for (const std::map<TreeSupportElement, AABB>* aabbs : { &reduced_aabb, &input_aabb })
+    {
+        for (const auto& [element, aabb] : *aabbs)
+        {
+            if (aabb.min_.X <= aabb.max_.X && aabb.min_.Y <= aabb.max_.Y)
+            {
+                const coord_t extent = std::max(aabb.max_.X - aabb.min_.X, aabb.max_.Y - aabb.min_.Y);
+                extent_sum += extent;
+                extent_max = std::max(extent_max, extent);
+                extent_count++;
+            }
+        }
+    }
+    // A few very large areas should not make every area cover a huge amount of cells.
+    const SquareGrid grid(std::max({ extent_count > 0 ? extent_sum / static_cast<coord_t>(extent_count) : 0, extent_max / 16, static_cast<coord_t>(1) }));
+    std::unordered_map<SquareGrid::GridPoint, std::vector<ReducedIterator>> reduced_grid;
+    const auto processCells = [&grid](const AABB& aabb, const auto& process_cell_func)
+    {
+        if (aabb.min_.X > aabb.max_.X || aabb.min_.Y > aabb.max_.Y)
+        {
+            return; // Empty, can not hit anything.
+        }
+        const SquareGrid::GridPoint lower = grid.toGridPoint(aabb.min_);
+        const SquareGrid::GridPoint upper = grid.toGridPoint(aabb.max_);
+        for (coord_t x = lower.X; x <= upper.X; x++)
+        {
+            for (coord_t y = lower.Y; y <= upper.Y; y++)
+            {
+                process_cell_func(SquareGrid::GridPoint(x, y));
+            }
+        }
+    };
+    const auto addToGrid = [&](const ReducedIterator reduced)
+    {
+        processCells(
+            reduced->second,
+            [&](const SquareGrid::GridPoint& cell)
+            {
+                reduced_grid[cell].emplace_back(reduced);
+            });
+    };
+    const auto removeFromGrid = [&](const ReducedIterator reduced)
+    {
+        processCells(
+            reduced->second,
+            [&](const SquareGrid::GridPoint& cell)
+            {
+                std::erase(reduced_grid[cell], reduced);
+            });
+    };
+    for (ReducedIterator reduced = reduced_aabb.begin(); reduced != reduced_aabb.end(); ++reduced)
+    {
+        addToGrid(reduced);
+    }
+
+    std::vector<ReducedIterator> candidates;
     for (auto& influence : input_aabb)
     {
         bool merged = false;
         AABB influence_aabb = influence.second;
-        for (const auto& reduced_check : reduced_aabb)
+
+        candidates.clear();
+        processCells(
+            influence_aabb,
+            [&](const SquareGrid::GridPoint& cell)
+            {
+                const auto in_cell = reduced_grid.find(cell);
+                if (in_cell != reduced_grid.end())
+                {
+                    candidates.insert(candidates.end(), in_cell->second.begin(), in_cell->second.end());
+                }
+            });
+        std::sort(
+            candidates.begin(),
+            candidates.end(),
+            [&reduced_aabb](const ReducedIterator& a, const ReducedIterator& b)
+            {
+                return reduced_aabb.key_comp()(a->first, b->first);
+            });
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for (const ReducedIterator reduced : candidates)
         {
+            const auto& reduced_check = *reduced;
             // As every area has to be checked for overlaps with other areas, some fast heuristic is needed to abort early if clearly possible
             // This is so performance critical that using a map lookup instead of the direct access of the cached AABBs can have a surprisingly large performance impact
             AABB aabb = reduced_check.second;
@@ -478,8 +570,13 @@ void TreeSupport::mergeHelper(
                     // negative area.).
                     //     And if this area disappears because of rounding errors, the only downside is that it can not merge again on this layer.
 
-                    reduced_aabb.erase(reduced_check.first); // This invalidates reduced_check.
-                    reduced_aabb.emplace(key, AABB(merge));
+                    removeFromGrid(reduced);
+                    reduced_aabb.erase(reduced); // This invalidates reduced_check.
+                    const auto [merged_reduced, inserted] = reduced_aabb.emplace(key, AABB(merge));
+                    if (inserted)
+                    {
+                        addToGrid(merged_reduced);
+                    }
 
                     merged = true;
                     break;
@@ -489,7 +586,13 @@ void TreeSupport::mergeHelper(
 
         if (! merged)
         {
-            reduced_aabb[influence.first] = influence_aabb;
+            const auto [unmerged_reduced, inserted] = reduced_aabb.try_emplace(influence.first, influence_aabb);
+            if (! inserted)
+            {
+                removeFromGrid(unmerged_reduced);
+                unmerged_reduced->second = influence_aabb;
+            }
+            addToGrid(unmerged_reduced);
         }
     }
 }
@@ -1280,6 +1383,7 @@ void TreeSupport::increaseAreas(
 
 void TreeSupport::createLayerPathing(std::vector<std::set<TreeSupportElement*>>& move_bounds)
 {
+    CURA_TRACE_SPAN("tree support layer pathing");
     const double data_size_inverse = 1 / double(move_bounds.size());
     double progress_total = TREE_PROGRESS_PRECALC_AVO + TREE_PROGRESS_PRECALC_COLL + TREE_PROGRESS_GENERATE_NODES;
 
@@ -1547,6 +1651,7 @@ bool TreeSupport::setToModelContact(std::vector<std::set<TreeSupportElement*>>&
 
 void TreeSupport::createNodesFromArea(std::vector<std::set<TreeSupportElement*>>& move_bounds)
 {
+    CURA_TRACE_SPAN("tree support nodes from area");
     // Initialize points on layer 0, with a "random" point in the influence area. Point is chosen based on an inaccurate estimate where the branches will split into two, but every
     // point inside the influence area would produce a valid result.
     std::unordered_set<TreeSupportElement*> remove;
@@ -1965,10 +2070,14 @@ void TreeSupport::filterFloatingLines(std::vector<Shape>& support_layer_storage)
 
 
     std::vector<Shape> support_holes(support_layer_storage.size(), Shape());
-    // Extract all holes as polygon objects
+    // Extract all holes as polygon objects. Layers with many branches take much longer than the ones with few.
     cura::parallel_for<coord_t>(
         0,
         support_layer_storage.size(),
+        [&support_layer_storage](const LayerIndex layer_idx)
+        {
+            return support_layer_storage[layer_idx].pointCount();
+        },
         [&](const LayerIndex layer_idx)
         {
             support_layer_storage[layer_idx] = config.simplifier.polygon(PolygonUtils::unionManySmall(support_layer_storage[layer_idx].smooth(FUDGE_LENGTH)))
@@ -2307,6 +2416,7 @@ void TreeSupport::finalizeInterfaceAndSupportAreas(
 
 void TreeSupport::drawAreas(std::vector<std::set<TreeSupportElement*>>& move_bounds, SliceDataStorage& storage)
 {
+    CURA_TRACE_SPAN("tree support draw areas");
     std::vector<Shape> support_layer_storage(move_bounds.size());
     std::vector<Shape> support_layer_storage_fractional(move_bounds.size());
     std::vector<Shape> support_roof_storage_fractional(move_bounds.size());
@@ -0,0 +1,61 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "bridge/ScanlineIntersector.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "bridge/TransformedSegment.h"
+#include "bridge/TransformedShape.h"
+#include "utils/linearAlg2D.h"
+
+
+namespace cura
+{
+
+ScanlineIntersector::ScanlineIntersector(const TransformedShape& transformed_shape)
+{
+    segments_by_min_y_.reserve(transformed_shape.getSegments().size());
+    for (const TransformedSegment& transformed_segment : transformed_shape.getSegments())
+    {
+        segments_by_min_y_.push_back(&transformed_segment);
+    }
+    std::sort(
+        segments_by_min_y_.begin(),
+        segments_by_min_y_.end(),
+        [](const TransformedSegment* a, const TransformedSegment* b)
+        {
+            return a->minY() < b->minY();
+        });
+}
+
+std::vector<coord_t> ScanlineIntersector::intersections(const coord_t line_y)
+{
+    while (next_segment_ < segments_by_min_y_.size() && segments_by_min_y_[next_segment_]->minY() <= line_y)
+    {
+        active_segments_.push_back(segments_by_min_y_[next_segment_]);
+        next_segment_++;
+    }
+
+    // Segments that are fully under the line are also under all the next lines.
+    std::erase_if(
+        active_segments_,
+        [line_y](const TransformedSegment* transformed_segment)
+        {
+            return transformed_segment->maxY() < line_y;
+        });
+
+    std::vector<coord_t> intersections;
+    for (const TransformedSegment* transformed_segment : active_segments_)
+    {
+        const std::optional<coord_t> intersection = LinearAlg2D::lineHorizontalLineIntersection(transformed_segment->getStart(), transformed_segment->getEnd(), line_y);
+        if (intersection.has_value())
+        {
+            intersections.push_back(intersection.value());
+        }
+    }
+    return intersections;
+}
+
+} // namespace cura
@@ -3,11 +3,17 @@
 
 #include "bridge/bridge.h"
 
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
 #include <range/v3/action/stable_sort.hpp>
 #include <range/v3/algorithm/reverse.hpp>
 
 #include "LayerPlan.h"
 #include "bridge/ExpansionRange.h"
+#include "bridge/ScanlineIntersector.h"
 #include "bridge/SegmentOverlapping.h"
 #include "bridge/TransformedShape.h"
 #include "geometry/PointMatrix.h"
@@ -16,6 +22,7 @@
 #include "settings/types/Ratio.h"
 #include "sliceDataStorage.h"
 #include "utils/AABB.h"
+#include "utils/ThreadPool.h"
 #include "utils/linearAlg2D.h"
 #include "utils/math.h"
 #include "utils/types/geometry.h"
@@ -24,49 +31,20 @@
 namespace cura
 {
 
-/*!
- * Calculates all the intersections between a horizontal line and the given transformed shape
- * @param line_y The horizontal line Y coordinate
- * @param transformed_shape The shape to intersect with
- * @return The list of X coordinates of the intersections, unsorted
- */
-std::vector<coord_t> shapeLineIntersections(const coord_t line_y, const TransformedShape& transformed_shape)
-{
-    std::vector<coord_t> intersections;
-
-    for (const TransformedSegment& transformed_segment : transformed_shape.getSegments())
-    {
-        if (transformed_segment.minY() > line_y || transformed_segment.maxY() < line_y)
-        {
-            // Segment is fully over or under the line, skip
-            continue;
-        }
-
-        const std::optional<coord_t> intersection = LinearAlg2D::lineHorizontalLineIntersection(transformed_segment.getStart(), transformed_segment.getEnd(), line_y);
-        if (intersection.has_value())
-        {
-            intersections.push_back(intersection.value());
-        }
-    }
-
-    return intersections;
-}
-
 /*!
  * Evaluates a potential bridging line to see if it can actually bridge between two supported regions
- * @param line_y The Y coordinate of the horizontal line
- * @param transformed_skin_area The skin outline, transformed so that the bridging line is horizontal
- * @param transformed_supported_area The supported regions, transformed so that the bridging line is horizontal
+ * @param skin_outline_intersections The X coordinates where the horizontal line intersects the skin outline, transformed so that the bridging line is
+ *                                   horizontal
+ * @param supported_regions_intersections The X coordinates where the horizontal line intersects the supported regions, transformed likewise
  * @return The score of the line regarding bridging, which can be positive if it is mostly bridging, or negative if it is mostly hanging
  *
  * The score is based on the following criteria:
  *   - Properly bridging segments, i.e. between two supported areas, add their length to the score
  *   - Hanging segments, i.e. supported on one side but not the other (or not at all), subtract their length from the score
  *   - Segments that lie on a supported area substract part of their length from the score  */
-coord_t evaluateBridgeLine(const coord_t line_y, const TransformedShape& transformed_skin_area, const TransformedShape& transformed_supported_area)
+coord_t evaluateBridgeLine(std::vector<coord_t> skin_outline_intersections, std::vector<coord_t> supported_regions_intersections)
 {
-    // Calculate intersections with skin outline to see which segments should actually be printed
-    std::vector<coord_t> skin_outline_intersections = shapeLineIntersections(line_y, transformed_skin_area);
+    // The intersections with skin outline show which segments should actually be printed
     if (skin_outline_intersections.size() < 2)
     {
         // We need to enter the skin at some point to bridge inside
@@ -74,8 +52,7 @@ coord_t evaluateBridgeLine(const coord_t line_y, const TransformedShape& transfo
     }
     ranges::stable_sort(skin_outline_intersections);
 
-    // Calculate intersections with supported regions to see which segments are anchored
-    std::vector<coord_t> supported_regions_intersections = shapeLineIntersections(line_y, transformed_supported_area);
+    // The intersections with supported regions show which segments are anchored
     ranges::stable_sort(supported_regions_intersections);
 
     enum class BridgeStatus
@@ -229,19 +206,52 @@ coord_t evaluateBridgeLines(const Shape& skin_outline, const Shape& supported_re
 
     const coord_t line_min = transformed_skin_area.minY() + line_width * 0.5;
 
-    // Evaluated lines that could be properly bridging
+    // Evaluated lines that could be properly bridging. The lines go up, so only the segments that reach the current line need to be intersected.
     coord_t line_score = 0;
-    const TransformedShape empty_transformed_shape;
+    ScanlineIntersector skin_area_intersector(transformed_skin_area);
+    ScanlineIntersector supported_area_intersector(transformed_supported_area);
     for (size_t i = 0; i < bridge_lines_count; ++i)
     {
         const coord_t line_y = line_min + i * line_width;
-        const bool has_supports = line_y >= transformed_supported_area.minY() && line_y <= transformed_supported_area.maxY();
-        line_score += evaluateBridgeLine(line_y, transformed_skin_area, has_supports ? transformed_supported_area : empty_transformed_shape);
+        line_score += evaluateBridgeLine(skin_area_intersector.intersections(line_y), supported_area_intersector.intersections(line_y));
     }
 
     return line_score;
 }
 
+/*!
+ * Find the angle of the lines that bridge the skin best, from 0 up to 180 degrees in steps of one degree. The lowest angle wins a tie.
+ * @param skin_outline The skin outline to be filled
+ * @param supported_regions The supported regions areas
+ * @param line_width The bridging line width
+ * @return The best angle, or nothing if lines don't fit at any angle
+ */
+std::optional<AngleDegrees> bestBridgeLinesAngle(const Shape& skin_outline, const Shape& supported_regions, const coord_t line_width)
+{
+    constexpr size_t angles_count = 180;
+    std::vector<coord_t> scores(angles_count);
+    cura::parallel_for<size_t>(
+        0,
+        angles_count,
+        [&](const size_t angle)
+        {
+            scores[angle] = evaluateBridgeLines(skin_outline, supported_regions, line_width, AngleDegrees(static_cast<double>(angle)));
+        });
+
+    coord_t best_score = std::numeric_limits<coord_t>::lowest();
+    std::optional<AngleDegrees> best_angle;
+    for (size_t angle = 0; angle < angles_count; ++angle)
+    {
+        if (scores[angle] > best_score)
+        {
+            best_score = scores[angle];
+            best_angle = AngleDegrees(static_cast<double>(angle));
+        }
+    }
+
+    return best_angle;
+}
+
 /*!
  * Gets the proper angle when bridging over infill
  * @param mesh The mesh being processed, which contains the actual infill angles
@@ -306,6 +316,7 @@ std::optional<AngleDegrees> bridgeAngle(
     const unsigned layer_nr,
     const unsigned bridge_layer,
     const SupportLayer* support_layer,
+    const LayerPlan& layer_plan,
     Shape& supported_regions)
 {
     const Settings& settings = mesh.settings;
@@ -323,9 +334,6 @@ std::optional<AngleDegrees> bridgeAngle(
     //  This gives us the islands that the layer rests on.
     Shape islands;
 
-    Shape prev_layer_outline; // we also want the complete outline of the previous layer
-    Shape prev_layer_infill;
-
     // include parts from all meshes
     for (const std::shared_ptr<SliceMeshStorage>& mesh_ptr : storage.meshes)
     {
@@ -337,18 +345,15 @@ std::optional<AngleDegrees> bridgeAngle(
 
             for (const SliceLayerPart& prev_layer_part : mesh.layers[layer_nr - bridge_layer].parts)
             {
-                Shape prev_layer_part_infill = prev_layer_part.getOwnInfillArea();
-                prev_layer_infill = prev_layer_infill.unionPolygons(prev_layer_part_infill);
+                // Parts that don't touch the skin can't support it.
+                if (! boundary_box.hit(prev_layer_part.boundaryBox))
+                    continue;
 
                 Shape solid_below(prev_layer_part.outline);
                 if (bridge_layer == 1 && part_has_sparse_infill)
                 {
-                    solid_below = solid_below.difference(prev_layer_part_infill);
+                    solid_below = solid_below.difference(prev_layer_part.getOwnInfillArea());
                 }
-                prev_layer_outline.push_back(solid_below); // not intersected with skin
-
-                if (! boundary_box.hit(prev_layer_part.boundaryBox))
-                    continue;
 
                 islands.push_back(skin_outline.intersection(solid_below));
             }
@@ -369,8 +374,6 @@ std::optional<AngleDegrees> bridgeAngle(
             AABB support_roof_bb(support_layer->support_roof);
             if (boundary_box.hit(support_roof_bb))
             {
-                prev_layer_outline.push_back(support_layer->support_roof); // not intersected with skin
-
                 Shape supported_skin(skin_outline.intersection(support_layer->support_roof));
                 if (! supported_skin.empty())
                 {
@@ -385,8 +388,6 @@ std::optional<AngleDegrees> bridgeAngle(
                 AABB support_part_bb(support_part.getInfillArea());
                 if (boundary_box.hit(support_part_bb))
                 {
-                    prev_layer_outline.push_back(support_part.getInfillArea()); // not intersected with skin
-
                     Shape supported_skin(skin_outline.intersection(support_part.getInfillArea()));
                     if (! supported_skin.empty())
                     {
@@ -405,31 +406,19 @@ std::optional<AngleDegrees> bridgeAngle(
         return std::nullopt;
     }
 
-    prev_layer_infill = skin_outline.intersection(prev_layer_infill);
-    const Ratio infill_ratio = prev_layer_infill.area() / (skin_outline.area() + 1);
+    const Ratio infill_ratio = skin_outline.intersection(layer_plan.getInfillBelow(bridge_layer)).area() / (skin_outline.area() + 1);
     if (infill_ratio > 0.5) // In practice, the ratio should always be close to 0 or 1, so 0.5 should be good enough
     {
         // We are doing bridging over infill, so use the infill angle instead of trying to calculate a proper angle
         return bridgeOverInfillAngle(mesh, layer_nr);
     }
 
-    struct FitAngle
+    const std::optional<AngleDegrees> best_angle = bestBridgeLinesAngle(skin_outline, supported_regions, line_width);
+    if (! best_angle.has_value())
     {
-        coord_t score;
-        std::optional<AngleDegrees> angle;
-    };
-
-    FitAngle best_angle{ std::numeric_limits<coord_t>::lowest(), std::nullopt };
-    for (AngleDegrees angle = 0; angle < 180; angle += 1)
-    {
-        const coord_t score = evaluateBridgeLines(skin_outline, supported_regions, line_width, angle);
-        if (score > best_angle.score)
-        {
-            best_angle = { score, angle + 90 };
-        }
+        return std::nullopt;
     }
-
-    return best_angle.angle;
+    return best_angle.value() + 90;
 }
 
 /*!
@@ -226,6 +226,42 @@ public:
         }
     }
 
+    /*!
+     * \brief Adds a sequence of line segments to the current path.
+     *
+     * Equivalent to calling sendLineTo for each line, but the buffers grow only
+     * once.
+     * \param print_feature_type The type of print feature the lines represent.
+     * \param to The destination coordinates of the lines.
+     * \param widths The width of each line.
+     * \param thicknesses The thickness (in the Z direction) of each line.
+     * \param feedrates The velocity of printing each line.
+     */
+    void sendLinesTo(
+        const PrintFeatureType& print_feature_type,
+        std::span<const Point3LL> to,
+        std::span<const coord_t> widths,
+        std::span<const coord_t> thicknesses,
+        std::span<const Velocity> feedrates)
+    {
+        assert(! points.empty() && "A point must already be in the buffer for sendLinesTo(.) to function properly.");
+        assert(widths.size() == to.size() && thicknesses.size() == to.size() && feedrates.size() == to.size());
+
+        const size_t line_count = line_types.size() + to.size();
+        line_types.reserve(line_count);
+        line_widths.reserve(line_count);
+        line_thicknesses.reserve(line_count);
+        line_velocities.reserve(line_count);
+        points.reserve(points.size() + 3 * to.size());
+        for (size_t line_idx = 0; line_idx < to.size(); ++line_idx)
+        {
+            if (to[line_idx] != last_point)
+            {
+                addLineSegment(print_feature_type, to[line_idx], widths[line_idx], thicknesses[line_idx], feedrates[line_idx]);
+            }
+        }
+    }
+
 private:
     /*!
      * \brief Convert and add a point to the points buffer.
@@ -384,6 +420,16 @@ void ArcusCommunication::sendLineTo(const PrintFeatureType& type, const Point3LL
     path_compiler->sendLineTo(type, to, line_width, line_thickness, velocity);
 }
 
+void ArcusCommunication::sendLinesTo(
+    const PrintFeatureType& type,
+    std::span<const Point3LL> to,
+    std::span<const coord_t> line_widths,
+    std::span<const coord_t> line_thicknesses,
+    std::span<const Velocity> velocities)
+{
+    path_compiler->sendLinesTo(type, to, line_widths, line_thicknesses, velocities);
+}
+
 void ArcusCommunication::sendOptimizedLayerData()
 {
     path_compiler->flushPathSegments(); // Make sure the last path segment has been flushed from the compiler.
@@ -3,6 +3,7 @@
 
 #include "communication/CommandLine.h"
 
+#include <algorithm>
 #include <cerrno> // error number when trying to read file
 #include <cstring> //For strtok and strcopy.
 #include <filesystem>
@@ -28,7 +29,9 @@
 #include "FffProcessor.h" //To start a slice and get time estimates.
 #include "MeshGroup.h"
 #include "Slice.h"
+#include "settings/DefinitionCache.h"
 #include "utils/Matrix4x3D.h" //For the mesh_rotation_matrix setting.
+#include "utils/Tracing.h"
 #include "utils/format/filesystem_path.h"
 #include "utils/views/split_paths.h"
 
@@ -37,6 +40,7 @@ namespace cura
 
 CommandLine::CommandLine(const std::vector<std::string>& arguments)
     : arguments_{ arguments }
+    , definition_cache_directory_{ DefinitionCache::defaultDirectory() }
     , last_shown_progress_{ 0 }
 {
     if (auto search_paths = spdlog::details::os::getenv("CURA_ENGINE_SEARCH_PATH"); ! search_paths.empty())
@@ -64,6 +68,13 @@ void CommandLine::sendLayerComplete(const LayerIndex::value_type&, const coord_t
 void CommandLine::sendLineTo(const PrintFeatureType&, const Point3LL&, const coord_t&, const coord_t&, const Velocity&)
 {
 }
+void CommandLine::sendLinesTo(const PrintFeatureType&, std::span<const Point3LL>, std::span<const coord_t>, std::span<const coord_t>, std::span<const Velocity>)
+{
+}
+bool CommandLine::hasLayerView() const
+{
+    return false;
+}
 void CommandLine::sendOptimizedLayerData()
 {
 }
@@ -116,7 +127,17 @@ void CommandLine::sendProgress(double progress) const
     }
 }
 
+bool CommandLine::loadMesh(MeshGroup* mesh_group, const std::string& filename, const Matrix4x3D& transformation, Settings& object_parent_settings)
+{
+    return loadMeshIntoMeshGroup(mesh_group, filename.c_str(), transformation, object_parent_settings);
+}
+
 void CommandLine::sliceNext()
+{
+    sliceArguments();
+}
+
+bool CommandLine::sliceArguments()
 {
     FffProcessor::getInstance()->time_keeper.restart();
 
@@ -186,6 +207,16 @@ void CommandLine::sliceNext()
                     force_read_parent = false;
                     force_read_nondefault = false;
                 }
+                else if (argument.starts_with("--trace"))
+                {
+                    argument_index++;
+                    if (argument_index >= arguments_.size())
+                    {
+                        spdlog::error("Missing trace file with --trace argument.");
+                        exit(1);
+                    }
+                    tracing::start(arguments_[argument_index]);
+                }
                 else if (
                     argument.starts_with("--progress_cb") || argument.starts_with("--slice_info_cb") || argument.starts_with("--gcode_header_cb")
                     || argument.starts_with("--engine_info_cb"))
@@ -287,7 +318,7 @@ void CommandLine::sliceNext()
 
                     const auto transformation = last_settings->get<Matrix4x3D>("mesh_rotation_matrix"); // The transformation applied to the model when loaded.
 
-                    if (! loadMeshIntoMeshGroup(&slice->scene.mesh_groups[mesh_group_index], argument.c_str(), transformation, last_extruder->settings_))
+                    if (! loadMesh(&slice->scene.mesh_groups[mesh_group_index], argument, transformation, last_extruder->settings_))
                     {
                         spdlog::error("Failed to load model: {}. (error number {})", argument, errno);
                         exit(1);
@@ -441,7 +472,7 @@ void CommandLine::sliceNext()
                         const auto transformation = slice->scene.mesh_groups[mesh_group_index].settings.get<Matrix4x3D>("mesh_rotation_matrix");
                         const auto extruder_nr = slice->scene.mesh_groups[mesh_group_index].settings.get<size_t>("extruder_nr");
 
-                        if (! loadMeshIntoMeshGroup(&slice->scene.mesh_groups[mesh_group_index], model_name.c_str(), transformation, slice->scene.extruders[extruder_nr].settings_))
+                        if (! loadMesh(&slice->scene.mesh_groups[mesh_group_index], model_name, transformation, slice->scene.extruders[extruder_nr].settings_))
                         {
                             spdlog::error("Failed to load model: {}. (error number {})", model_name, errno);
                             exit(1);
@@ -479,6 +510,7 @@ void CommandLine::sliceNext()
 
     arguments_.clear(); // We've processed all arguments now.
 
+    bool succeeded = false;
 #ifndef DEBUG
     try
     {
@@ -487,7 +519,7 @@ void CommandLine::sliceNext()
         spdlog::info("Loaded from disk in {:3}s\n", FffProcessor::getInstance()->time_keeper.restart());
 
         // Start slicing.
-        slice->compute();
+        succeeded = slice->compute();
 #ifndef DEBUG
     }
     catch (...)
@@ -502,10 +534,123 @@ void CommandLine::sliceNext()
 
     // Finalize the processor. This adds the end g-code and reports statistics.
     FffProcessor::getInstance()->finalize();
+    tracing::finish();
+    return succeeded;
 }
 
 int CommandLine::loadJSON(const std::filesystem::path& json_filename, Settings& settings, bool force_read_parent, bool force_read_nondefault)
 {
+    // With force_read_nondefault, which values are read depends on the settings that are there already, so the result can't be reused.
+    if (definition_cache_directory_.empty() || force_read_nondefault)
+    {
+        return loadJSONFile(json_filename, settings, force_read_parent, force_read_nondefault);
+    }
+
+    const std::filesystem::path cache_file = DefinitionCache::cacheFile(definition_cache_directory_, json_filename, search_directories_, force_read_parent);
+    if (const std::optional<FlattenedDefinition> definition = DefinitionCache::read(cache_file))
+    {
+        spdlog::debug("Loading {} from the definition cache", json_filename);
+        loadFlattenedDefinition(*definition, settings, force_read_parent);
+        return 0;
+    }
+
+    FlattenedDefinition definition;
+    definition_recordings_.push_back(&definition);
+    const int error_code = loadJSONFile(json_filename, settings, force_read_parent, force_read_nondefault);
+    definition_recordings_.pop_back();
+    if (error_code != 0)
+    {
+        return error_code;
+    }
+    if (definition.complete && ! DefinitionCache::write(cache_file, definition))
+    {
+        spdlog::debug("Couldn't cache the definition {}", json_filename);
+    }
+    if (recording() != nullptr)
+    {
+        recording()->append(definition);
+    }
+    return 0;
+}
+
+int CommandLine::loadJSONFile(const std::filesystem::path& json_filename, Settings& settings, bool force_read_parent, bool force_read_nondefault)
+{
+    std::shared_ptr<const rapidjson::Document> json_document;
+    if (const int error_code = parseJSON(json_filename, json_document); error_code != 0)
+    {
+        return error_code;
+    }
+    if (recording() != nullptr)
+    {
+        recording()->addFile(json_filename);
+    }
+
+    const std::filesystem::path directory = json_filename.parent_path();
+    if (std::find(search_directories_.begin(), search_directories_.end(), directory) == search_directories_.end())
+    {
+        search_directories_.push_back(directory);
+    }
+    return loadJSON(*json_document, search_directories_, settings, force_read_parent, force_read_nondefault);
+}
+
+void CommandLine::loadFlattenedDefinition(const FlattenedDefinition& definition, Settings& settings, bool force_read_parent)
+{
+    for (const std::string& directory : definition.search_directories)
+    {
+        const std::filesystem::path search_directory{ directory };
+        if (std::find(search_directories_.begin(), search_directories_.end(), search_directory) == search_directories_.end())
+        {
+            search_directories_.push_back(search_directory);
+        }
+    }
+
+    Scene& scene = Application::getInstance().current_slice_->scene;
+    for (const FlattenedDefinition::Step& step : definition.steps)
+    {
+        if (! step.extruder_nr.has_value())
+        {
+            settings.add(step.settings);
+            continue;
+        }
+        while (scene.extruders.size() <= step.extruder_nr.value())
+        {
+            scene.extruders.emplace_back(scene.extruders.size(), &scene.settings);
+        }
+        if (step.extruder_file.empty())
+        {
+            continue;
+        }
+        // The extruder definition goes into other settings, so it is cached on its own.
+        definition_recordings_.push_back(nullptr);
+        loadJSON(step.extruder_file, scene.extruders[step.extruder_nr.value()].settings_, force_read_parent, false);
+        definition_recordings_.pop_back();
+    }
+
+    if (recording() != nullptr)
+    {
+        recording()->append(definition);
+    }
+}
+
+FlattenedDefinition* CommandLine::recording() const
+{
+    return definition_recordings_.empty() ? nullptr : definition_recordings_.back();
+}
+
+int CommandLine::parseJSON(const std::filesystem::path& json_filename, std::shared_ptr<const rapidjson::Document>& document)
+{
+    std::error_code error;
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(json_filename, error);
+    const std::string key = json_filename.generic_string();
+    if (! error)
+    {
+        if (const auto parsed = parsed_json_files_.find(key); parsed != parsed_json_files_.end() && parsed->second.modified == modified)
+        {
+            document = parsed->second.document;
+            return 0;
+        }
+    }
+
     std::ifstream file(json_filename, std::ios::binary);
     if (! file)
     {
@@ -516,16 +661,20 @@ int CommandLine::loadJSON(const std::filesystem::path& json_filename, Settings&
     std::vector<char> read_buffer(std::istreambuf_iterator<char>(file), {});
     rapidjson::MemoryStream memory_stream(read_buffer.data(), read_buffer.size());
 
-    rapidjson::Document json_document;
-    json_document.ParseStream(memory_stream);
-    if (json_document.HasParseError())
+    auto json_document = std::make_shared<rapidjson::Document>();
+    json_document->ParseStream(memory_stream);
+    if (json_document->HasParseError())
     {
-        spdlog::error("Error parsing JSON (offset {}): {}", json_document.GetErrorOffset(), GetParseError_En(json_document.GetParseError()));
+        spdlog::error("Error parsing JSON (offset {}): {}", json_document->GetErrorOffset(), GetParseError_En(json_document->GetParseError()));
         return 2;
     }
 
-    search_directories_.push_back(std::filesystem::path(json_filename).parent_path());
-    return loadJSON(json_document, search_directories_, settings, force_read_parent, force_read_nondefault);
+    document = json_document;
+    if (! error)
+    {
+        parsed_json_files_[key] = ParsedJSON{ modified, document };
+    }
+    return 0;
 }
 
 int CommandLine::loadJSON(
@@ -575,11 +724,22 @@ int CommandLine::loadJSON(
                 const rapidjson::Value& extruder_id = extruder_train->value;
                 if (! extruder_id.IsString())
                 {
+                    if (recording() != nullptr)
+                    {
+                        recording()->addExtruder(static_cast<size_t>(extruder_nr), "");
+                    }
                     continue;
                 }
                 const std::string extruder_definition_id(extruder_id.GetString());
                 const std::string extruder_file = findDefinitionFile(extruder_definition_id, search_directories);
+                if (recording() != nullptr)
+                {
+                    recording()->addExtruder(static_cast<size_t>(extruder_nr), extruder_file);
+                    recording()->complete = recording()->complete && ! extruder_file.empty();
+                }
+                definition_recordings_.push_back(nullptr);
                 loadJSON(extruder_file, scene.extruders[extruder_nr].settings_, force_read_parent, force_read_nondefault);
+                definition_recordings_.pop_back();
             }
         }
     }
@@ -687,6 +847,10 @@ void CommandLine::loadJSONSettings(const rapidjson::Value& element, Settings& se
             continue;
         }
         settings.add(name, value_string);
+        if (recording() != nullptr)
+        {
+            recording()->addSetting(name, value_string);
+        }
     }
 }
 
@@ -0,0 +1,177 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "communication/DaemonCommunication.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <system_error>
+
+#include <fmt/format.h>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <spdlog/spdlog.h>
+
+#include "FffProcessor.h"
+#include "MeshGroup.h"
+#include "progress/Progress.h"
+#include "utils/Matrix4x3D.h"
+
+namespace cura
+{
+
+/*!
+ * Describe everything that determines how a model is loaded: the path, size and modification time of the model file and of the UV and texture files next to
+ * it, and the transformation.
+ */
+static std::string meshKey(const std::string& filename, const Matrix4x3D& transformation)
+{
+    std::string key;
+    const std::string base_filename = filename.substr(0, filename.find_last_of('.'));
+    for (const std::string& file_path : { filename, base_filename + ".uv", base_filename + ".png" })
+    {
+        std::error_code error;
+        const std::filesystem::path path = std::filesystem::weakly_canonical(file_path, error);
+        const std::uintmax_t size = std::filesystem::file_size(path, error);
+        if (error) // Files that are missing can't change.
+        {
+            key += fmt::format("{}:none;", path.string());
+            continue;
+        }
+        const std::filesystem::file_time_type modified = std::filesystem::last_write_time(path, error);
+        key += fmt::format("{}:{}:{};", path.string(), size, modified.time_since_epoch().count());
+    }
+    for (const auto& row : transformation.m)
+    {
+        key += fmt::format("{},{},{};", row[0], row[1], row[2]);
+    }
+    return key;
+}
+
+DaemonCommunication::DaemonCommunication(std::istream& input, std::ostream& output)
+    : CommandLine(std::vector<std::string>{})
+    , input_(input)
+    , output_(output)
+{
+}
+
+bool DaemonCommunication::hasSlice() const
+{
+    return input_.good();
+}
+
+void DaemonCommunication::sliceNext()
+{
+    std::string line;
+    if (! std::getline(input_, line))
+    {
+        const double uptime = uptime_.restart();
+        spdlog::info("Handled {} jobs in {:03.3f}s, {:.1f} jobs per minute", job_count_, uptime, uptime > 0.0 ? 60.0 * static_cast<double>(job_count_) / uptime : 0.0);
+        return;
+    }
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+    {
+        return; // Empty lines separate nothing, so they are ignored.
+    }
+
+    job_count_++;
+    TimeKeeper job_time;
+    rapidjson::Document job;
+    job.Parse(line.c_str());
+    if (job.HasParseError() || ! job.IsArray())
+    {
+        reply(false, "A job must be a JSON array with the arguments of a slice command.", job_time.restart());
+        return;
+    }
+    std::vector<std::string> arguments{ "CuraEngine", "slice" };
+    for (const rapidjson::Value& argument : job.GetArray())
+    {
+        if (! argument.IsString())
+        {
+            reply(false, "The arguments of a job must be strings.", job_time.restart());
+            return;
+        }
+        arguments.emplace_back(argument.GetString(), argument.GetStringLength());
+    }
+    // Writing to the output would mix the g-code with the replies.
+    const auto output_flag = std::find(arguments.begin(), arguments.end(), "-o");
+    if (output_flag == arguments.end() || std::next(output_flag) == arguments.end())
+    {
+        reply(false, "A job must write its g-code to a file with -o.", job_time.restart());
+        return;
+    }
+    const std::string output_file = *std::next(output_flag);
+
+    arguments_ = std::move(arguments);
+    Progress::init();
+    const bool sliced = sliceArguments();
+    const bool written = FffProcessor::getInstance()->closeTargetFile();
+    forgetUnusedMeshes();
+    if (! sliced)
+    {
+        reply(false, "The job could not be sliced.", job_time.restart());
+        return;
+    }
+    if (! written)
+    {
+        reply(false, fmt::format("Could not write the g-code to {}.", output_file), job_time.restart());
+        return;
+    }
+    reply(true, output_file, job_time.restart());
+}
+
+bool DaemonCommunication::loadMesh(MeshGroup* mesh_group, const std::string& filename, const Matrix4x3D& transformation, Settings& object_parent_settings)
+{
+    const std::string key = meshKey(filename, transformation);
+    used_meshes_.insert(key);
+    if (const auto loaded = loaded_meshes_.find(key); loaded != loaded_meshes_.end())
+    {
+        mesh_group->meshes.push_back(loaded->second);
+        mesh_group->meshes.back().settings_.setParent(&object_parent_settings);
+        spdlog::info("Reusing '{}' as loaded by an earlier job", filename);
+        return true;
+    }
+    if (! CommandLine::loadMesh(mesh_group, filename, transformation, object_parent_settings))
+    {
+        return false;
+    }
+    loaded_meshes_.emplace(key, mesh_group->meshes.back());
+    return true;
+}
+
+void DaemonCommunication::forgetUnusedMeshes()
+{
+    std::erase_if(
+        loaded_meshes_,
+        [this](const auto& loaded)
+        {
+            return ! used_meshes_.contains(loaded.first);
+        });
+    used_meshes_.clear();
+}
+
+void DaemonCommunication::reply(const bool succeeded, const std::string& message, const double duration)
+{
+    if (! succeeded)
+    {
+        spdlog::error("{}", message);
+    }
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("job");
+    writer.Uint64(job_count_);
+    writer.Key("succeeded");
+    writer.Bool(succeeded);
+    writer.Key(succeeded ? "output" : "error");
+    writer.String(message.c_str(), message.size());
+    writer.Key("time_s");
+    writer.Double(duration);
+    writer.EndObject();
+    output_ << buffer.GetString() << std::endl;
+}
+
+} // namespace cura
@@ -21,6 +21,7 @@
 #include "settings/types/LayerIndex.h"
 #include "sliceDataStorage.h"
 #include "utils/Date.h"
+#include "utils/ThreadPool.h"
 #include "utils/string.h" // MMtoStream, PrecisionedDouble
 
 namespace cura
@@ -559,17 +560,51 @@ void GCodeExport::resetTotalPrintTimeAndFilament()
         extruder_attr_[e].waited_for_temperature_ = false;
     }
     current_e_value_ = 0.0;
+    if (pending_time_estimate_.valid())
+    {
+        pending_time_estimate_.wait();
+        pending_time_estimate_ = {};
+    }
     estimate_calculator_.reset();
 }
 
 void GCodeExport::updateTotalPrintTime()
 {
-    std::vector<Duration> estimates = estimate_calculator_.calculate();
+    writePendingTimeEstimate();
+
+    // The planner passes only need the moves of this layer. The junction speeds stay behind, so the next layer is planned exactly as before.
+    auto task = std::make_shared<std::packaged_task<std::vector<Duration>()>>(
+        [layer_calculator = estimate_calculator_.detachPlan()]() mutable
+        {
+            return layer_calculator.calculate();
+        });
+    pending_time_estimate_ = task->get_future();
+    if (time_estimate_worker_ == nullptr)
+    {
+        time_estimate_worker_ = std::make_unique<ThreadPool>(1);
+    }
+    ThreadPool::lock_t lock = time_estimate_worker_->get_lock();
+    time_estimate_worker_->push(
+        lock,
+        [task](ThreadPool::lock_t& worker_lock)
+        {
+            worker_lock.unlock();
+            (*task)();
+            worker_lock.lock();
+        });
+}
+
+void GCodeExport::writePendingTimeEstimate()
+{
+    if (! pending_time_estimate_.valid())
+    {
+        return;
+    }
+    const std::vector<Duration> estimates = pending_time_estimate_.get();
     for (size_t i = 0; i < estimates.size(); i++)
     {
         total_print_times_[i] += estimates[i];
     }
-    estimate_calculator_.reset();
     writeTimeComment(getSumTotalPrintTimes());
 }
 
@@ -1399,6 +1434,10 @@ PrintFeatureType
     {
         travel_move_type = extruder_attr.retraction_e_amount_current_ > 0.0 ? PrintFeatureType::MoveRetracted : PrintFeatureType::MoveUnretracted;
     }
+    if (! Application::getInstance().communication_->hasLayerView())
+    {
+        return travel_move_type;
+    }
     const int display_width = extruder_attr.retraction_e_amount_current_ ? MM2INT(0.2) : MM2INT(0.1);
     const double layer_height = Application::getInstance().current_slice_->scene.current_mesh_group->settings.get<double>("layer_height");
     Application::getInstance().communication_->sendLineTo(travel_move_type, p, display_width, layer_height, speed);
@@ -6,6 +6,7 @@
 #include <algorithm> //For std::sort.
 #include <functional>
 #include <numbers>
+#include <span>
 #include <unordered_set>
 
 #include <scripta/logger.h>
@@ -572,7 +573,8 @@ void Infill::addLineInfill(
     const int scanline_min_idx,
     const int line_distance,
     const AABB boundary,
-    std::vector<std::vector<coord_t>>& cut_list,
+    std::vector<coord_t>& cut_list,
+    const std::vector<size_t>& cut_list_starts,
     coord_t shift)
 {
     assert(! connect_lines_ && "connectLines() should add the infill lines, not addLineInfill");
@@ -580,12 +582,12 @@ void Infill::addLineInfill(
     unsigned int scanline_idx = 0;
     for (coord_t x = scanline_min_idx * line_distance + shift; x < boundary.max_.X; x += line_distance)
     {
-        if (scanline_idx >= cut_list.size())
+        if (scanline_idx + 1 >= cut_list_starts.size())
         {
             break;
         }
-        std::vector<coord_t>& crossings = cut_list[scanline_idx];
-        std::stable_sort(crossings.begin(), crossings.end()); // sort by increasing Y coordinates
+        const std::span<coord_t> crossings(cut_list.begin() + cut_list_starts[scanline_idx], cut_list.begin() + cut_list_starts[scanline_idx + 1]);
+        std::sort(crossings.begin(), crossings.end()); // sort by increasing Y coordinates
         for (unsigned int crossing_idx = 0; crossing_idx + 1 < crossings.size(); crossing_idx += 2)
         {
             if (crossings[crossing_idx + 1] - crossings[crossing_idx] < infill_line_width_ / 5)
@@ -663,8 +665,22 @@ void Infill::generateLinearBasedInfill(
         return;
     }
 
-    Shape outline = inner_contour_; // Make a copy. We'll be rotating this outline to make intersections always horizontal, for better performance.
-    outline.applyMatrix(rotation_matrix);
+    // Rotate the outline to make intersections always horizontal, for better performance. The points of all polygons are stored in one buffer, rather than
+    // in a copy of the polygons.
+    std::vector<Point2LL> outline;
+    outline.reserve(inner_contour_.pointCount());
+    std::vector<size_t> outline_starts{ 0 }; // For each polygon the index of its first point in the outline, followed by the size of the outline.
+    outline_starts.reserve(inner_contour_.size() + 1);
+    AABB boundary;
+    for (const Polygon& poly : inner_contour_)
+    {
+        for (const Point2LL& point : poly)
+        {
+            outline.push_back(rotation_matrix.apply(point));
+            boundary.include(outline.back());
+        }
+        outline_starts.push_back(outline.size());
+    }
 
     coord_t shift = extra_shift + this->shift_;
     if (shift < 0)
@@ -676,55 +692,107 @@ void Infill::generateLinearBasedInfill(
         shift = shift % line_distance;
     }
 
-    AABB boundary(outline);
-
     int scanline_min_idx = computeScanSegmentIdx(boundary.min_.X - shift, line_distance);
     int line_count = computeScanSegmentIdx(boundary.max_.X - shift, line_distance) + 1 - scanline_min_idx;
 
-    std::vector<std::vector<coord_t>> cut_list(line_count); // mapping from scanline to all intersections with polygon segments
+    // Calls the function for every scanline that the line segment from p0 to p1 crosses, in the order in which it crosses them.
+    const auto for_each_crossed_scanline = [line_distance, shift](const Point2LL& p0, const Point2LL& p1, auto&& function)
+    {
+        int scanline_idx0;
+        int scanline_idx1;
+        // this way of handling the indices takes care of the case where a boundary line segment ends exactly on a scanline:
+        // in case the next segment moves back from that scanline either 2 or 0 scanline-boundary intersections are created
+        // otherwise only 1 will be created, counting as an actual intersection
+        int direction = 1;
+        if (p0.X < p1.X)
+        {
+            scanline_idx0 = computeScanSegmentIdx(p0.X - shift, line_distance) + 1; // + 1 cause we don't cross the scanline of the first scan segment
+            scanline_idx1 = computeScanSegmentIdx(p1.X - shift, line_distance); // -1 cause the vertex point is handled in the next segment (or not in the case which looks like >)
+        }
+        else
+        {
+            direction = -1;
+            scanline_idx0 = computeScanSegmentIdx(p0.X - shift, line_distance); // -1 cause the vertex point is handled in the previous segment (or not in the case which looks like >)
+            scanline_idx1 = computeScanSegmentIdx(p1.X - shift, line_distance) + 1; // + 1 cause we don't cross the scanline of the first scan segment
+        }
+
+        for (int scanline_idx = scanline_idx0; scanline_idx != scanline_idx1 + direction; scanline_idx += direction)
+        {
+            function(scanline_idx);
+        }
+    };
+
+    // The crossings are bucketed by scanline in one buffer: first count the crossings of each scanline, then store them in the order in which they are found.
+    std::vector<size_t> cut_list_starts(line_count + 1, 0); // For each scanline the index of its first crossing, followed by the number of crossings.
+    for (size_t poly_idx = 0; poly_idx + 1 < outline_starts.size(); poly_idx++)
+    {
+        Point2LL p0 = outline[outline_starts[poly_idx + 1] - 1];
+        for (size_t point_idx = outline_starts[poly_idx]; point_idx < outline_starts[poly_idx + 1]; point_idx++)
+        {
+            const Point2LL& p1 = outline[point_idx];
+            if (p1.X != p0.X)
+            {
+                for_each_crossed_scanline(
+                    p0,
+                    p1,
+                    [&cut_list_starts, scanline_min_idx](const int scanline_idx)
+                    {
+                        cut_list_starts[scanline_idx - scanline_min_idx + 1]++;
+                    });
+            }
+            p0 = p1;
+        }
+    }
+    for (size_t scanline_idx = 0; scanline_idx < static_cast<size_t>(line_count); scanline_idx++)
+    {
+        cut_list_starts[scanline_idx + 1] += cut_list_starts[scanline_idx];
+    }
+    std::vector<size_t> cut_list_ends(cut_list_starts.begin(), cut_list_starts.end() - 1); // Where to store the next crossing of each scanline.
 
     // When we find crossings, keep track of which crossing belongs to which scanline and to which polygon line segment.
     // Then we can later join two crossings together to form lines and still know what polygon line segments that infill line connected to.
     struct Crossing
     {
         Point2LL coordinate_;
-        size_t polygon_index_;
-        size_t vertex_index_;
-
-        Crossing(Point2LL coordinate, size_t polygon_index, size_t vertex_index)
-            : coordinate_(coordinate)
-            , polygon_index_(polygon_index)
-            , vertex_index_(vertex_index)
-        {
-        }
+        size_t polygon_index_{ 0 };
+        size_t vertex_index_{ 0 };
 
         bool operator<(const Crossing& other) const // Crossings will be ordered by their Y coordinate so that they get ordered along the scanline.
         {
             return coordinate_.Y < other.coordinate_.Y;
         }
     };
-    std::vector<std::vector<Crossing>> crossings_per_scanline; // For each scanline, a list of crossings.
-    const int min_scanline_index = computeScanSegmentIdx(boundary.min_.X - shift, line_distance) + 1;
-    const int max_scanline_index = computeScanSegmentIdx(boundary.max_.X - shift, line_distance) + 1;
-    crossings_per_scanline.resize(max_scanline_index - min_scanline_index);
+    std::vector<coord_t> cut_list; // mapping from scanline to all intersections with polygon segments, if the lines aren't connected
+    std::vector<Crossing> crossings; // mapping from scanline to all crossings, if the lines are connected
     if (connect_lines_)
     {
-        crossings_on_line_.resize(outline.size()); // One for each polygon.
+        crossings.resize(cut_list_starts.back());
+        crossings_on_line_.resize(inner_contour_.size()); // One for each polygon.
+    }
+    else
+    {
+        cut_list.resize(cut_list_starts.back());
     }
 
-    for (size_t poly_idx = 0; poly_idx < outline.size(); poly_idx++)
+    for (size_t poly_idx = 0; poly_idx < inner_contour_.size(); poly_idx++)
     {
-        const Polygon& poly = outline[poly_idx];
+        const size_t poly_start = outline_starts[poly_idx];
+        const size_t poly_size = outline_starts[poly_idx + 1] - poly_start;
         if (connect_lines_)
         {
-            crossings_on_line_[poly_idx].resize(poly.size()); // One for each line in this polygon.
+            crossings_on_line_[poly_idx].resize(poly_size); // One for each line in this polygon.
         }
-        Point2LL p0 = poly.back();
+        if (poly_size == 0)
+        {
+            zigzag_connector_processor.registerPolyFinished();
+            continue;
+        }
+        Point2LL p0 = outline[poly_start + poly_size - 1];
         zigzag_connector_processor.registerVertex(p0); // always adds the first point to ZigzagConnectorProcessorEndPieces::first_zigzag_connector when using a zigzag infill type
 
-        for (size_t point_idx = 0; point_idx < poly.size(); point_idx++)
+        for (size_t point_idx = 0; point_idx < poly_size; point_idx++)
         {
-            Point2LL p1 = poly[point_idx];
+            Point2LL p1 = outline[poly_start + point_idx];
             if (p1.X == p0.X)
             {
                 zigzag_connector_processor.registerVertex(p1);
@@ -734,36 +802,26 @@ void Infill::generateLinearBasedInfill(
                 continue;
             }
 
-            int scanline_idx0;
-            int scanline_idx1;
-            // this way of handling the indices takes care of the case where a boundary line segment ends exactly on a scanline:
-            // in case the next segment moves back from that scanline either 2 or 0 scanline-boundary intersections are created
-            // otherwise only 1 will be created, counting as an actual intersection
-            int direction = 1;
-            if (p0.X < p1.X)
-            {
-                scanline_idx0 = computeScanSegmentIdx(p0.X - shift, line_distance) + 1; // + 1 cause we don't cross the scanline of the first scan segment
-                scanline_idx1
-                    = computeScanSegmentIdx(p1.X - shift, line_distance); // -1 cause the vertex point is handled in the next segment (or not in the case which looks like >)
-            }
-            else
-            {
-                direction = -1;
-                scanline_idx0
-                    = computeScanSegmentIdx(p0.X - shift, line_distance); // -1 cause the vertex point is handled in the previous segment (or not in the case which looks like >)
-                scanline_idx1 = computeScanSegmentIdx(p1.X - shift, line_distance) + 1; // + 1 cause we don't cross the scanline of the first scan segment
-            }
-
-            for (int scanline_idx = scanline_idx0; scanline_idx != scanline_idx1 + direction; scanline_idx += direction)
-            {
-                const int x = scanline_idx * line_distance + shift;
-                const int y = p1.Y + (p0.Y - p1.Y) * (x - p1.X) / (p0.X - p1.X);
-                assert(scanline_idx - scanline_min_idx >= 0 && scanline_idx - scanline_min_idx < int(cut_list.size()) && "reading infill cutlist index out of bounds!");
-                cut_list[scanline_idx - scanline_min_idx].push_back(y);
-                Point2LL scanline_linesegment_intersection(x, y);
-                zigzag_connector_processor.registerScanlineSegmentIntersection(scanline_linesegment_intersection, scanline_idx, line_distance / 4);
-                crossings_per_scanline[scanline_idx - min_scanline_index].emplace_back(scanline_linesegment_intersection, poly_idx, point_idx);
-            }
+            for_each_crossed_scanline(
+                p0,
+                p1,
+                [&](const int scanline_idx)
+                {
+                    const int x = scanline_idx * line_distance + shift;
+                    const int y = p1.Y + (p0.Y - p1.Y) * (x - p1.X) / (p0.X - p1.X);
+                    assert(scanline_idx - scanline_min_idx >= 0 && scanline_idx - scanline_min_idx < line_count && "reading infill cutlist index out of bounds!");
+                    const size_t crossing_idx = cut_list_ends[scanline_idx - scanline_min_idx]++;
+                    Point2LL scanline_linesegment_intersection(x, y);
+                    zigzag_connector_processor.registerScanlineSegmentIntersection(scanline_linesegment_intersection, scanline_idx, line_distance / 4);
+                    if (connect_lines_)
+                    {
+                        crossings[crossing_idx] = Crossing{ scanline_linesegment_intersection, poly_idx, point_idx };
+                    }
+                    else
+                    {
+                        cut_list[crossing_idx] = y;
+                    }
+                });
             zigzag_connector_processor.registerVertex(p1);
             p0 = p1;
         }
@@ -773,16 +831,16 @@ void Infill::generateLinearBasedInfill(
     if (connect_lines_)
     {
         // Gather all crossings per scanline and find out which crossings belong together, then store them in crossings_on_line.
-        for (int scanline_index = min_scanline_index; scanline_index < max_scanline_index; scanline_index++)
+        for (size_t scanline_idx = 0; scanline_idx < static_cast<size_t>(line_count); scanline_idx++)
         {
-            auto& crossings = crossings_per_scanline[scanline_index - min_scanline_index];
+            const std::span<Crossing> scanline_crossings(crossings.begin() + cut_list_starts[scanline_idx], crossings.begin() + cut_list_starts[scanline_idx + 1]);
             // Sorts them by Y coordinate.
-            std::stable_sort(crossings.begin(), crossings.end());
+            std::stable_sort(scanline_crossings.begin(), scanline_crossings.end());
             // Combine each 2 subsequent crossings together.
-            for (long crossing_index = 0; crossing_index < static_cast<long>(crossings.size()) - 1; crossing_index += 2)
+            for (long crossing_index = 0; crossing_index < static_cast<long>(scanline_crossings.size()) - 1; crossing_index += 2)
             {
-                const Crossing& first = crossings[crossing_index];
-                const Crossing& second = crossings[crossing_index + 1];
+                const Crossing& first = scanline_crossings[crossing_index];
+                const Crossing& second = scanline_crossings[crossing_index + 1];
                 // Avoid creating zero length crossing lines
                 const Point2LL unrotated_first = rotation_matrix.unapply(first.coordinate_);
                 const Point2LL unrotated_second = rotation_matrix.unapply(second.coordinate_);
@@ -800,17 +858,17 @@ void Infill::generateLinearBasedInfill(
     }
     else
     {
-        if (cut_list.size() == 0)
+        if (line_count == 0)
         {
             return;
         }
-        if (connected_zigzags && cut_list.size() == 1 && cut_list[0].size() <= 2)
+        if (connected_zigzags && line_count == 1 && cut_list_starts[1] <= 2)
         {
             return; // don't add connection if boundary already contains whole outline!
         }
 
         // We have to create our own lines when they are not created by the method connectLines.
-        addLineInfill(result, rotation_matrix, scanline_min_idx, line_distance, boundary, cut_list, shift);
+        addLineInfill(result, rotation_matrix, scanline_min_idx, line_distance, boundary, cut_list, cut_list_starts, shift);
     }
 }
 
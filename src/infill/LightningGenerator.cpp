@@ -3,11 +3,17 @@
 
 #include "infill/LightningGenerator.h"
 
+#include <iterator>
+#include <unordered_map>
+
 #include "ExtruderTrain.h"
 #include "infill/LightningLayer.h"
 #include "infill/LightningTreeNode.h"
 #include "sliceDataStorage.h"
+#include "utils/AABB.h"
 #include "utils/SparsePointGridInclusive.h"
+#include "utils/ThreadPool.h"
+#include "utils/UnionFind.h"
 #include "utils/linearAlg2D.h"
 
 /* Possible future tasks/optimizations,etc.:
@@ -43,28 +49,44 @@ LightningGenerator::LightningGenerator(const SliceMeshStorage& mesh)
 
 void LightningGenerator::generateInitialInternalOverhangs(const SliceMeshStorage& mesh)
 {
-    overhang_per_layer.resize(mesh.layers.size());
+    const size_t layer_count = mesh.layers.size();
+    infill_outlines_per_part.resize(layer_count);
+    overhang_per_part.resize(layer_count);
     const auto infill_wall_line_count = static_cast<coord_t>(mesh.settings.get<size_t>("infill_wall_line_count"));
     const auto infill_line_width = mesh.settings.get<coord_t>("infill_line_width");
     const coord_t infill_wall_offset = -infill_wall_line_count * infill_line_width;
 
-    Shape infill_area_above;
-    // Iterate from top to bottom, to subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
-    for (int layer_nr = mesh.layers.size() - 1; layer_nr >= 0; layer_nr--)
-    {
-        const SliceLayer& current_layer = mesh.layers[layer_nr];
-        Shape infill_area_here;
-        for (auto& part : current_layer.parts)
+    cura::parallel_for<size_t>(
+        0,
+        layer_count,
+        [&](const size_t layer_nr)
         {
-            infill_area_here.push_back(part.getOwnInfillArea().offset(infill_wall_offset));
-        }
+            for (const SliceLayerPart& part : mesh.layers[layer_nr].parts)
+            {
+                infill_outlines_per_part[layer_nr].push_back(part.getOwnInfillArea().offset(infill_wall_offset));
+            }
+        });
 
-        // Remove the part of the infill area that is already supported by the walls.
-        Shape overhang = infill_area_here.offset(-wall_supporting_radius).difference(infill_area_above);
-
-        overhang_per_layer[layer_nr] = overhang;
-        infill_area_above = std::move(infill_area_here);
-    }
+    // Subtract the infill areas of the layer above from the overhang areas, to get only overhang in the top layer where it is overhanging.
+    cura::parallel_for<size_t>(
+        0,
+        layer_count,
+        [&](const size_t layer_nr)
+        {
+            Shape infill_area_above;
+            if (layer_nr + 1 < layer_count)
+            {
+                for (const Shape& outline_above : infill_outlines_per_part[layer_nr + 1])
+                {
+                    infill_area_above.push_back(outline_above);
+                }
+            }
+            for (const Shape& outline : infill_outlines_per_part[layer_nr])
+            {
+                // Remove the part of the infill area that is already supported by the walls.
+                overhang_per_part[layer_nr].push_back(outline.offset(-wall_supporting_radius).difference(infill_area_above));
+            }
+        });
 }
 
 const LightningLayer& LightningGenerator::getTreesForLayer(const size_t& layer_id) const
@@ -76,53 +98,203 @@ const LightningLayer& LightningGenerator::getTreesForLayer(const size_t& layer_i
 void LightningGenerator::generateTrees(const SliceMeshStorage& mesh)
 {
     lightning_layers.resize(mesh.layers.size());
-    const auto infill_wall_line_count = static_cast<coord_t>(mesh.settings.get<size_t>("infill_wall_line_count"));
-    const auto infill_line_width = mesh.settings.get<coord_t>("infill_line_width");
-    const coord_t infill_wall_offset = -infill_wall_line_count * infill_line_width;
+    // Trees only continue in the layer below where it overlaps with the layer above. Straightening the branches moves them a bit, so parts that come close
+    // to each other are connected as well.
+    std::vector<Region> regions = findRegions(infill_outlines_per_part, std::max(supporting_radius, straightening_max_distance));
 
-    std::vector<Shape> infill_outlines;
-    infill_outlines.insert(infill_outlines.end(), mesh.layers.size(), Shape());
+    // For various operations its beneficial to quickly locate nearby features on the polygon.
+    // Compute the outlines and their locators of all layers of all regions up front, since the trees can only be grown one layer after the other.
+    std::vector<std::pair<size_t, size_t>> region_layers;
+    for (size_t region_idx = 0; region_idx < regions.size(); region_idx++)
+    {
+        Region& region = regions[region_idx];
+        const size_t region_layer_count = region.parts_per_layer.size();
+        region.outlines.resize(region_layer_count);
+        region.overhangs.resize(region_layer_count);
+        region.outline_locators.resize(region_layer_count);
+        for (size_t layer_idx = 0; layer_idx < region_layer_count; layer_idx++)
+        {
+            region_layers.emplace_back(region_idx, layer_idx);
+        }
+    }
+    cura::parallel_for<size_t>(
+        0,
+        region_layers.size(),
+        [&](const size_t region_layer_idx)
+        {
+            const auto [region_idx, layer_idx] = region_layers[region_layer_idx];
+            Region& region = regions[region_idx];
+            const size_t layer_nr = region.top_layer - layer_idx;
+            for (const size_t part_idx : region.parts_per_layer[layer_idx])
+            {
+                region.outlines[layer_idx].push_back(infill_outlines_per_part[layer_nr][part_idx]);
+                region.overhangs[layer_idx].push_back(overhang_per_part[layer_nr][part_idx]);
+            }
+            region.outline_locators[layer_idx] = PolygonUtils::createLocToLineGrid(region.outlines[layer_idx], locator_cell_size);
+        });
 
-    // For-each layer from top to bottom:
-    for (int layer_id = mesh.layers.size() - 1; layer_id >= 0; layer_id--)
+    // The regions don't share any trees, so they can be grown at the same time.
+    std::vector<std::vector<LightningLayer>> trees_per_region(regions.size());
+    cura::parallel_for<size_t>(
+        0,
+        regions.size(),
+        [&](const size_t region_idx)
+        {
+            return regions[region_idx].point_count;
+        },
+        [&](const size_t region_idx)
+        {
+            trees_per_region[region_idx] = generateTrees(regions[region_idx]);
+        });
+
+    for (size_t region_idx = 0; region_idx < regions.size(); region_idx++)
     {
-        for (const auto& part : mesh.layers[layer_id].parts)
+        for (size_t layer_idx = 0; layer_idx < trees_per_region[region_idx].size(); layer_idx++)
         {
-            infill_outlines[layer_id].push_back(part.getOwnInfillArea().offset(infill_wall_offset));
+            std::vector<LightningTreeNodeSPtr>& region_roots = trees_per_region[region_idx][layer_idx].tree_roots;
+            std::vector<LightningTreeNodeSPtr>& tree_roots = lightning_layers[regions[region_idx].top_layer - layer_idx].tree_roots;
+            tree_roots.insert(tree_roots.end(), std::make_move_iterator(region_roots.begin()), std::make_move_iterator(region_roots.end()));
         }
     }
+}
 
-    // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = mesh.layers.size() - 1;
-    auto outlines_locator_ptr = PolygonUtils::createLocToLineGrid(infill_outlines[top_layer_id], locator_cell_size);
+std::vector<LightningGenerator::Region> LightningGenerator::findRegions(const std::vector<std::vector<Shape>>& infill_outlines_per_part, const coord_t connection_distance)
+{
+    const size_t layer_count = infill_outlines_per_part.size();
+
+    // Number the parts of all layers, so that they can be grouped.
+    std::vector<size_t> first_part_of_layer(layer_count + 1, 0);
+    for (size_t layer_nr = 0; layer_nr < layer_count; layer_nr++)
+    {
+        first_part_of_layer[layer_nr + 1] = first_part_of_layer[layer_nr] + infill_outlines_per_part[layer_nr].size();
+    }
+
+    std::vector<std::vector<std::pair<size_t, size_t>>> connections_per_layer(layer_count);
+    cura::parallel_for<size_t>(
+        1,
+        layer_count,
+        [&](const size_t layer_nr)
+        {
+            const std::vector<Shape>& parts = infill_outlines_per_part[layer_nr];
+            const std::vector<Shape>& parts_below = infill_outlines_per_part[layer_nr - 1];
+            std::vector<AABB> boxes_below;
+            boxes_below.reserve(parts_below.size());
+            for (const Shape& part_below : parts_below)
+            {
+                boxes_below.emplace_back(part_below);
+            }
+            for (size_t part_idx = 0; part_idx < parts.size(); part_idx++)
+            {
+                if (parts[part_idx].empty())
+                {
+                    continue;
+                }
+                AABB box(parts[part_idx]);
+                box.expand(connection_distance);
+                Shape grown_part;
+                for (size_t part_below_idx = 0; part_below_idx < parts_below.size(); part_below_idx++)
+                {
+                    if (parts_below[part_below_idx].empty() || ! box.hit(boxes_below[part_below_idx]))
+                    {
+                        continue;
+                    }
+                    if (grown_part.empty())
+                    {
+                        grown_part = parts[part_idx].offset(connection_distance);
+                    }
+                    if (! grown_part.intersection(parts_below[part_below_idx]).empty())
+                    {
+                        connections_per_layer[layer_nr].emplace_back(part_idx, part_below_idx);
+                    }
+                }
+            }
+        });
+
+    UnionFind<size_t> part_groups;
+    for (size_t part_id = 0; part_id < first_part_of_layer.back(); part_id++)
+    {
+        part_groups.add(part_id); // The handle of each part is its ID, because they are added in order.
+    }
+    for (size_t layer_nr = 1; layer_nr < layer_count; layer_nr++)
+    {
+        for (const auto& [part_idx, part_below_idx] : connections_per_layer[layer_nr])
+        {
+            // Unite the sets rather than the parts themselves, or the rest of a set would be left behind.
+            const size_t group = part_groups.findByHandle(first_part_of_layer[layer_nr] + part_idx);
+            const size_t group_below = part_groups.findByHandle(first_part_of_layer[layer_nr - 1] + part_below_idx);
+            if (group != group_below)
+            {
+                part_groups.unite(group, group_below);
+            }
+        }
+    }
+
+    // Visit the parts from the top down, so that every region is found at its top layer and its layers can be added one after the other.
+    std::vector<Region> regions;
+    std::unordered_map<size_t, size_t> region_per_group;
+    for (size_t layer_nr = layer_count; layer_nr-- > 0;)
+    {
+        for (size_t part_idx = 0; part_idx < infill_outlines_per_part[layer_nr].size(); part_idx++)
+        {
+            const Shape& part = infill_outlines_per_part[layer_nr][part_idx];
+            if (part.empty())
+            {
+                continue;
+            }
+            const size_t group = part_groups.findByHandle(first_part_of_layer[layer_nr] + part_idx);
+            const auto [region_it, is_new_region] = region_per_group.emplace(group, regions.size());
+            if (is_new_region)
+            {
+                regions.emplace_back().top_layer = layer_nr;
+            }
+            Region& region = regions[region_it->second];
+            const size_t layer_idx = region.top_layer - layer_nr;
+            assert(layer_idx <= region.parts_per_layer.size() && "A region is connected through all layers in between its top and bottom.");
+            if (layer_idx == region.parts_per_layer.size())
+            {
+                region.parts_per_layer.emplace_back();
+            }
+            region.parts_per_layer[layer_idx].push_back(part_idx);
+            region.point_count += part.pointCount();
+        }
+    }
+    return regions;
+}
+
+std::vector<LightningLayer> LightningGenerator::generateTrees(Region& region) const
+{
+    std::vector<LightningLayer> layers(region.parts_per_layer.size());
 
     // For-each layer from top to bottom:
-    for (int layer_id = top_layer_id; layer_id >= 0; layer_id--)
+    for (size_t layer_idx = 0; layer_idx < layers.size(); layer_idx++)
     {
-        LightningLayer& current_lightning_layer = lightning_layers[layer_id];
-        Shape& current_outlines = infill_outlines[layer_id];
-        const auto& outlines_locator = *outlines_locator_ptr;
+        LightningLayer& current_lightning_layer = layers[layer_idx];
+        const Shape& current_outlines = region.outlines[layer_idx];
+        const LocToLineGrid& outlines_locator = *region.outline_locators[layer_idx];
 
         // register all trees propagated from the previous layer as to-be-reconnected
         std::vector<LightningTreeNodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
 
-        current_lightning_layer.generateNewTrees(overhang_per_layer[layer_id], current_outlines, outlines_locator, supporting_radius, wall_supporting_radius);
+        current_lightning_layer.generateNewTrees(region.overhangs[layer_idx], current_outlines, outlines_locator, supporting_radius, wall_supporting_radius);
 
         current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, outlines_locator, supporting_radius, wall_supporting_radius);
 
+        // The locator of this layer is not needed anymore.
+        region.outline_locators[layer_idx].reset();
+
         // Initialize trees for next lower layer from the current one.
-        if (layer_id == 0)
+        if (layer_idx + 1 == layers.size())
         {
-            return;
+            break;
         }
-        const Shape& below_outlines = infill_outlines[layer_id - 1];
-        outlines_locator_ptr = PolygonUtils::createLocToLineGrid(below_outlines, locator_cell_size);
-        const auto& below_outlines_locator = *outlines_locator_ptr;
+        const Shape& below_outlines = region.outlines[layer_idx + 1];
+        const LocToLineGrid& below_outlines_locator = *region.outline_locators[layer_idx + 1];
 
-        std::vector<LightningTreeNodeSPtr>& lower_trees = lightning_layers[layer_id - 1].tree_roots;
+        std::vector<LightningTreeNodeSPtr>& lower_trees = layers[layer_idx + 1].tree_roots;
         for (auto& tree : current_lightning_layer.tree_roots)
         {
             tree->propagateToNextLayer(lower_trees, below_outlines, below_outlines_locator, prune_length, straightening_max_distance, locator_cell_size / 2);
         }
     }
+    return layers;
 }
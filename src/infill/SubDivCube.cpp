@@ -3,13 +3,20 @@
 
 #include "infill/SubDivCube.h"
 
+#include <algorithm>
 #include <functional>
+#include <limits>
+#include <optional>
 
+#include "Application.h"
 #include "geometry/OpenPolyline.h"
 #include "geometry/Polygon.h"
 #include "geometry/Shape.h"
 #include "settings/types/Angle.h" //For the infill angle.
 #include "sliceDataStorage.h"
+#include "utils/AABB.h"
+#include "utils/SquareGrid.h"
+#include "utils/ThreadPool.h"
 #include "utils/math.h"
 #include "utils/polygonUtils.h"
 
@@ -21,14 +28,308 @@
 namespace cura
 {
 
-std::vector<SubDivCube::CubeProperties> SubDivCube::cube_properties_per_recursion_step_;
-coord_t SubDivCube::radius_addition_ = 0;
-Point3Matrix SubDivCube::rotation_matrix_;
-PointMatrix SubDivCube::infill_rotation_matrix_;
+/*!
+ * The infill areas of all layers of a mesh, with a coarse signed distance field per layer to decide quickly whether a cube needs to be subdivided.
+ *
+ * The distance fields only give a lower bound of the distance to the border of the infill area. If that isn't enough to decide, the distance is computed
+ * exactly, so that the octree is the same as when every distance is computed exactly.
+ */
+class SubDivCube::Builder
+{
+public:
+    /*!
+     * \param mesh contains infill layer data and settings
+     * \param min_cell_size the smallest size of the cells of the distance fields
+     */
+    Builder(const SliceMeshStorage& mesh, const coord_t min_cell_size)
+        : layer_height_(mesh.settings.get<coord_t>("layer_height"))
+        , collide_per_layer_(mesh.layers.size())
+        , distance_field_per_layer_(mesh.layers.size())
+    {
+        cura::parallel_for<size_t>(
+            0,
+            mesh.layers.size(),
+            [&mesh](const size_t layer_nr)
+            {
+                return mesh.layers[layer_nr].parts.size();
+            },
+            [this, &mesh, min_cell_size](const size_t layer_nr)
+            {
+                Shape& collide = collide_per_layer_[layer_nr];
+                for (const SliceLayerPart& part : mesh.layers[layer_nr].parts)
+                {
+                    collide.push_back(part.infill_area);
+                }
+                distance_field_per_layer_[layer_nr] = DistanceField(collide, min_cell_size);
+            });
+    }
+
+    /*!
+     * Determines if a described theoretical cube should be subdivided based on if a sphere that encloses the cube touches the infill mesh.
+     * \param center the center of the described cube
+     * \param radius the radius of the enclosing sphere
+     * \return the described cube should be subdivided
+     */
+    bool isValidSubdivision(const Point3LL& center, const coord_t radius) const
+    {
+        coord_t distance2 = 0;
+        coord_t sphere_slice_radius2; //!< squared radius of bounding sphere slice on target layer
+        bool inside_somewhere = false;
+        bool outside_somewhere = false;
+        int inside;
+        Ratio part_dist; // what percentage of the radius the target layer is away from the center along the z axis. 0 - 1
+        int bottom_layer = (center.z_ - radius) / layer_height_;
+        int top_layer = (center.z_ + radius) / layer_height_;
+        for (int test_layer = bottom_layer; test_layer <= top_layer; test_layer += 3) // steps of three. Low-hanging speed gain.
+        {
+            part_dist = Ratio{ static_cast<Ratio::value_type>(test_layer * layer_height_ - center.z_) } / radius;
+            sphere_slice_radius2 = radius * radius * (1.0 - (part_dist * part_dist));
+            Point2LL loc(center.x_, center.y_);
+
+            inside = distanceFromPointToMesh(test_layer, loc, sphere_slice_radius2, &distance2);
+            if (inside == 1)
+            {
+                inside_somewhere = true;
+            }
+            else
+            {
+                outside_somewhere = true;
+            }
+            if (outside_somewhere && inside_somewhere)
+            {
+                return true;
+            }
+            if ((inside != 2) && distance2 < sphere_slice_radius2)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    /*!
+     * A grid over the bounding box of a layer with the Chebyshev distance of every cell to the nearest cell that the border of the infill area passes
+     * through, in cells. The distance is negative for cells outside of the infill area.
+     */
+    class DistanceField
+    {
+    public:
+        DistanceField() = default;
+
+        DistanceField(const Shape& collide, const coord_t min_cell_size)
+        {
+            if (collide.empty())
+            {
+                return;
+            }
+            const AABB aabb(collide);
+            cell_size_ = std::max({ min_cell_size, std::max(aabb.max_.X - aabb.min_.X, aabb.max_.Y - aabb.min_.Y) / max_cells, coord_t(1) });
+            // A margin of one cell all around, so that the cells outside of the infill area are connected. The coordinates relative to the origin are
+            // positive, where the grid cells are all the same size.
+            origin_ = aabb.min_ - Point2LL(cell_size_, cell_size_);
+            width_ = (aabb.max_.X - origin_.X) / cell_size_ + 2;
+            height_ = (aabb.max_.Y - origin_.Y) / cell_size_ + 2;
+
+            // Mark the cells that the border passes through.
+            constexpr int8_t border = 0;
+            constexpr int8_t unknown = 1;
+            distances_.assign(width_ * height_, unknown);
+            const SquareGrid grid(cell_size_);
+            for (const Polygon& polygon : collide)
+            {
+                for (size_t point_idx = 0; point_idx < polygon.size(); ++point_idx)
+                {
+                    const Point2LL from = polygon[point_idx] - origin_;
+                    const Point2LL to = polygon[(point_idx + 1) % polygon.size()] - origin_;
+                    grid.processLineCells(
+                        std::make_pair(from, to),
+                        [this](const SquareGrid::GridPoint cell)
+                        {
+                            distances_[cell.Y * width_ + cell.X] = border;
+                            return true;
+                        });
+                }
+            }
+
+            // The cells between the borders are either all inside or all outside, so one point of each region is enough to tell which.
+            std::vector<size_t> stack;
+            for (size_t seed_idx = 0; seed_idx < distances_.size(); ++seed_idx)
+            {
+                if (distances_[seed_idx] != unknown)
+                {
+                    continue;
+                }
+                const Point2LL seed_center = origin_ + Point2LL((seed_idx % width_) * cell_size_ + cell_size_ / 2, (seed_idx / width_) * cell_size_ + cell_size_ / 2);
+                const int8_t side = collide.inside(seed_center) ? max_distance : -max_distance;
+                distances_[seed_idx] = side;
+                stack.push_back(seed_idx);
+                while (! stack.empty())
+                {
+                    const size_t cell_idx = stack.back();
+                    stack.pop_back();
+                    const size_t x = cell_idx % width_;
+                    const size_t y = cell_idx / width_;
+                    for (const size_t neighbour_idx : { x > 0 ? cell_idx - 1 : cell_idx,
+                                                        x + 1 < width_ ? cell_idx + 1 : cell_idx,
+                                                        y > 0 ? cell_idx - width_ : cell_idx,
+                                                        y + 1 < height_ ? cell_idx + width_ : cell_idx })
+                    {
+                        if (distances_[neighbour_idx] == unknown)
+                        {
+                            distances_[neighbour_idx] = side;
+                            stack.push_back(neighbour_idx);
+                        }
+                    }
+                }
+            }
+
+            // Chamfer distance transform with all eight neighbours at distance one, which gives the Chebyshev distance. A neighbour on the other side counts
+            // as a border cell, in case the border only touches the corner of a cell.
+            const auto relax = [this](const size_t cell_idx, const size_t neighbour_idx)
+            {
+                int8_t& distance = distances_[cell_idx];
+                const int8_t neighbour_distance = distances_[neighbour_idx];
+                if (distance > 0)
+                {
+                    distance = static_cast<int8_t>(std::min(int(distance), std::max(int(neighbour_distance), 0) + 1));
+                }
+                else if (distance < 0)
+                {
+                    distance = static_cast<int8_t>(std::max(int(distance), std::min(int(neighbour_distance), 0) - 1));
+                }
+            };
+            for (size_t y = 0; y < height_; ++y)
+            {
+                for (size_t x = 0; x < width_; ++x)
+                {
+                    const size_t cell_idx = y * width_ + x;
+                    if (x > 0)
+                    {
+                        relax(cell_idx, cell_idx - 1);
+                    }
+                    if (y > 0)
+                    {
+                        relax(cell_idx, cell_idx - width_);
+                        if (x > 0)
+                        {
+                            relax(cell_idx, cell_idx - width_ - 1);
+                        }
+                        if (x + 1 < width_)
+                        {
+                            relax(cell_idx, cell_idx - width_ + 1);
+                        }
+                    }
+                }
+            }
+            for (size_t y = height_; y-- > 0;)
+            {
+                for (size_t x = width_; x-- > 0;)
+                {
+                    const size_t cell_idx = y * width_ + x;
+                    if (x + 1 < width_)
+                    {
+                        relax(cell_idx, cell_idx + 1);
+                    }
+                    if (y + 1 < height_)
+                    {
+                        relax(cell_idx, cell_idx + width_);
+                        if (x + 1 < width_)
+                        {
+                            relax(cell_idx, cell_idx + width_ + 1);
+                        }
+                        if (x > 0)
+                        {
+                            relax(cell_idx, cell_idx + width_ - 1);
+                        }
+                    }
+                }
+            }
+        }
+
+        /*!
+         * Get a lower bound of the distance from a point to the border, and whether the point is inside.
+         * \return The lower bound and whether the point is inside, or nothing if the point is too close to the border to tell.
+         */
+        std::optional<std::pair<coord_t, bool>> lowerBound(const Point2LL& location) const
+        {
+            if (distances_.empty())
+            {
+                return std::nullopt;
+            }
+            // Leave some room for the rounding of the closest point on the border.
+            constexpr coord_t rounding_margin = 2;
+            const Point2LL relative = location - origin_;
+            const coord_t grid_width = static_cast<coord_t>(width_) * cell_size_;
+            const coord_t grid_height = static_cast<coord_t>(height_) * cell_size_;
+            if (relative.X < 0 || relative.Y < 0 || relative.X >= grid_width || relative.Y >= grid_height) // Outside of the bounding box.
+            {
+                const coord_t dx = std::max({ coord_t(0), -relative.X, relative.X - grid_width });
+                const coord_t dy = std::max({ coord_t(0), -relative.Y, relative.Y - grid_height });
+                return std::make_pair(std::max(std::max(dx, dy) - rounding_margin, coord_t(0)), false);
+            }
+            const int8_t distance = distances_[(relative.Y / cell_size_) * width_ + relative.X / cell_size_];
+            if (std::abs(distance) <= 1)
+            {
+                return std::nullopt;
+            }
+            // The location can be anywhere in its cell and the border anywhere in the nearest border cell.
+            return std::make_pair(std::max((std::abs(distance) - 1) * cell_size_ - rounding_margin, coord_t(0)), distance > 0);
+        }
+
+    private:
+        static constexpr coord_t max_cells = 128; //!< the largest number of cells along a side of the bounding box, limiting the memory used per layer
+        static constexpr int8_t max_distance = std::numeric_limits<int8_t>::max(); //!< distances saturate at this value
+
+        Point2LL origin_; //!< lower corner of the grid
+        coord_t cell_size_{ 1 };
+        size_t width_{ 0 };
+        size_t height_{ 0 };
+        std::vector<int8_t> distances_; //!< signed distances of the cells, row by row, or empty if the layer has no infill area
+    };
+
+    /*!
+     * Finds the distance to the infill border at the specified layer from the specified point.
+     * \param layer_nr the number of the specified layer
+     * \param location the location of the specified point
+     * \param min_distance2 distances of which the square is at least this value don't need to be computed exactly
+     * \param[out] distance2 the squared distance to the infill border, or a lower bound of it of at least \p min_distance2
+     * \return Code 0: outside, 1: inside, 2: boundary does not exist at specified layer
+     */
+    int distanceFromPointToMesh(const LayerIndex layer_nr, const Point2LL& location, const coord_t min_distance2, coord_t* distance2) const
+    {
+        if (layer_nr < 0 || static_cast<size_t>(layer_nr) >= collide_per_layer_.size()) //!< this layer is outside of valid range
+        {
+            return 2;
+        }
+        if (const auto lower_bound = distance_field_per_layer_[layer_nr].lowerBound(location); lower_bound && square(lower_bound->first) >= min_distance2)
+        {
+            *distance2 = square(lower_bound->first);
+            return lower_bound->second ? 1 : 0;
+        }
+
+        const Shape& collide = collide_per_layer_[layer_nr];
+        Point2LL centerpoint = location;
+        bool inside = collide.inside(centerpoint);
+        ClosestPointPolygon border_point = PolygonUtils::moveInside2(collide, centerpoint);
+        Point2LL diff = border_point.location_ - location;
+        *distance2 = vSize2(diff);
+        if (inside)
+        {
+            return 1;
+        }
+        return 0;
+    }
+
+    coord_t layer_height_;
+    std::vector<Shape> collide_per_layer_; //!< the infill areas of all parts of each layer
+    std::vector<DistanceField> distance_field_per_layer_;
+};
 
 void SubDivCube::precomputeOctree(SliceMeshStorage& mesh, const Point2LL& infill_origin)
 {
-    radius_addition_ = mesh.settings.get<coord_t>("sub_div_rad_add");
+    const auto properties = std::make_shared<OctreeProperties>();
+    properties->radius_addition = mesh.settings.get<coord_t>("sub_div_rad_add");
 
     // if infill_angles is not empty use the first value, otherwise use 0
     const std::vector<AngleDegrees> infill_angles = mesh.settings.get<std::vector<AngleDegrees>>("infill_angles");
@@ -44,8 +345,7 @@ void SubDivCube::precomputeOctree(SliceMeshStorage& mesh, const Point2LL& infill
     {
         for (coord_t curr_side_length = infill_line_distance * 2; curr_side_length < max_side_length * 2; curr_side_length *= 2)
         {
-            cube_properties_per_recursion_step_.emplace_back();
-            CubeProperties& cube_properties_here = cube_properties_per_recursion_step_.back();
+            OctreeProperties::CubeProperties& cube_properties_here = properties->cube_properties_per_recursion_step.emplace_back();
             cube_properties_here.side_length = curr_side_length;
             cube_properties_here.height = sqrt(3) * curr_side_length;
             cube_properties_here.square_height = sqrt(2) * curr_side_length;
@@ -78,20 +378,94 @@ void SubDivCube::precomputeOctree(SliceMeshStorage& mesh, const Point2LL& infill
     tilt.matrix[7] = ONE_OVER_SQRT_3;
     tilt.matrix[8] = ONE_OVER_SQRT_3;
 
-    infill_rotation_matrix_ = PointMatrix(infill_angle);
-    Point3Matrix infill_angle_mat(infill_rotation_matrix_);
+    properties->infill_rotation_matrix = PointMatrix(infill_angle);
+    Point3Matrix infill_angle_mat(properties->infill_rotation_matrix);
 
-    rotation_matrix_ = infill_angle_mat.compose(tilt);
+    properties->rotation_matrix = infill_angle_mat.compose(tilt);
+
+    mesh.base_subdiv_cube = std::make_shared<SubDivCube>(properties, center, curr_recursion_depth - 1);
+    mesh.base_subdiv_cube->line_cache_ = std::make_unique<LineCache>();
+    if (properties->cube_properties_per_recursion_step.empty()) // Infill is set to 0%.
+    {
+        return;
+    }
 
-    mesh.base_subdiv_cube = std::make_shared<SubDivCube>(mesh, center, curr_recursion_depth - 1);
+    // Subdivide level by level, so that all cubes of a level can be subdivided in parallel.
+    const Builder builder(mesh, infill_line_distance / 2);
+    std::vector<SubDivCube*> cubes_to_subdivide{ mesh.base_subdiv_cube.get() };
+    while (! cubes_to_subdivide.empty())
+    {
+        cura::parallel_for<size_t>(
+            0,
+            cubes_to_subdivide.size(),
+            [&cubes_to_subdivide, &builder](const size_t cube_idx)
+            {
+                cubes_to_subdivide[cube_idx]->subdivide(builder);
+            });
+        std::vector<SubDivCube*> children;
+        for (const SubDivCube* cube : cubes_to_subdivide)
+        {
+            for (const std::shared_ptr<SubDivCube>& child : cube->children_)
+            {
+                if (child != nullptr)
+                {
+                    children.push_back(child.get());
+                }
+            }
+        }
+        cubes_to_subdivide = std::move(children);
+    }
 }
 
-void SubDivCube::generateSubdivisionLines(const coord_t z, OpenLinesSet& result)
+void SubDivCube::generateSubdivisionLines(const coord_t z, OpenLinesSet& result) const
 {
-    if (cube_properties_per_recursion_step_.empty()) // Infill is set to 0%.
+    if (properties_->cube_properties_per_recursion_step.empty()) // Infill is set to 0%.
     {
         return;
     }
+    if (! line_cache_)
+    {
+        generateUncachedSubdivisionLines(z, result);
+        return;
+    }
+
+    std::shared_ptr<const OpenLinesSet> lines;
+    {
+        std::lock_guard<std::mutex> lock(line_cache_->mutex);
+        const auto cached = std::find_if(
+            line_cache_->lines_per_z.begin(),
+            line_cache_->lines_per_z.end(),
+            [z](const auto& cached_lines)
+            {
+                return cached_lines.first == z;
+            });
+        if (cached != line_cache_->lines_per_z.end())
+        {
+            lines = cached->second;
+        }
+    }
+    if (! lines)
+    {
+        // Generated outside of the lock, so that other layers don't wait for this one.
+        auto generated_lines = std::make_shared<OpenLinesSet>();
+        generateUncachedSubdivisionLines(z, *generated_lines);
+        lines = generated_lines;
+
+        // Each thread works on a different layer, so the cache holds a few layers per thread.
+        const ThreadPool* thread_pool = Application::getInstance().thread_pool_;
+        const size_t max_cached_layers = 2 * ((thread_pool != nullptr ? thread_pool->thread_count() : 0) + 1);
+        std::lock_guard<std::mutex> lock(line_cache_->mutex);
+        line_cache_->lines_per_z.emplace_back(z, lines);
+        while (line_cache_->lines_per_z.size() > max_cached_layers)
+        {
+            line_cache_->lines_per_z.pop_front();
+        }
+    }
+    result.push_back(*lines);
+}
+
+void SubDivCube::generateUncachedSubdivisionLines(const coord_t z, OpenLinesSet& result) const
+{
     OpenLinesSet directional_line_groups[3];
 
     generateSubdivisionLines(z, directional_line_groups);
@@ -106,9 +480,9 @@ void SubDivCube::generateSubdivisionLines(const coord_t z, OpenLinesSet& result)
     }
 }
 
-void SubDivCube::generateSubdivisionLines(const coord_t z, OpenLinesSet (&directional_line_groups)[3])
+void SubDivCube::generateSubdivisionLines(const coord_t z, OpenLinesSet (&directional_line_groups)[3]) const
 {
-    CubeProperties cube_properties = cube_properties_per_recursion_step_[depth_];
+    const OctreeProperties::CubeProperties& cube_properties = properties_->cube_properties_per_recursion_step[depth_];
 
     const coord_t z_diff = std::abs(z - center_.z_); //!< the difference between the cube center and the target layer.
     if (z_diff > cube_properties.height / 2) //!< this cube does not touch the target layer. Early exit.
@@ -148,22 +522,27 @@ void SubDivCube::generateSubdivisionLines(const coord_t z, OpenLinesSet (&direct
     }
 }
 
-SubDivCube::SubDivCube(SliceMeshStorage& mesh, Point3LL& center, size_t depth)
-    : depth_(depth)
+SubDivCube::SubDivCube(std::shared_ptr<const OctreeProperties> properties, const Point3LL& center, size_t depth)
+    : properties_(std::move(properties))
+    , depth_(depth)
     , center_(center)
+{
+}
+
+void SubDivCube::subdivide(const Builder& builder)
 {
     if (depth_ == 0) // lowest layer, no need for subdivision, exit.
     {
         return;
     }
-    if (depth_ >= cube_properties_per_recursion_step_.size()) // Depth is out of bounds of what we pre-computed.
+    if (depth_ >= properties_->cube_properties_per_recursion_step.size()) // Depth is out of bounds of what we pre-computed.
     {
         return;
     }
 
-    CubeProperties cube_properties = cube_properties_per_recursion_step_[depth];
+    const OctreeProperties::CubeProperties& cube_properties = properties_->cube_properties_per_recursion_step[depth_];
     Point3LL child_center;
-    coord_t radius = double(cube_properties.height) / 4.0 + radius_addition_;
+    coord_t radius = double(cube_properties.height) / 4.0 + properties_->radius_addition;
 
     int child_nr = 0;
     std::vector<Point3LL> rel_child_centers;
@@ -177,82 +556,18 @@ SubDivCube::SubDivCube(SliceMeshStorage& mesh, Point3LL& center, size_t depth)
     rel_child_centers.emplace_back(-1, -1, 1);
     for (Point3LL rel_child_center : rel_child_centers)
     {
-        child_center = center + rotation_matrix_.apply(rel_child_center * int32_t(cube_properties.side_length / 4));
-        if (isValidSubdivision(mesh, child_center, radius))
+        child_center = center_ + properties_->rotation_matrix.apply(rel_child_center * int32_t(cube_properties.side_length / 4));
+        if (builder.isValidSubdivision(child_center, radius))
         {
-            children_[child_nr] = std::make_shared<SubDivCube>(mesh, child_center, depth - 1);
+            children_[child_nr] = std::make_shared<SubDivCube>(properties_, child_center, depth_ - 1);
             child_nr++;
         }
     }
 }
 
-bool SubDivCube::isValidSubdivision(SliceMeshStorage& mesh, Point3LL& center, coord_t radius)
-{
-    coord_t distance2 = 0;
-    coord_t sphere_slice_radius2; //!< squared radius of bounding sphere slice on target layer
-    bool inside_somewhere = false;
-    bool outside_somewhere = false;
-    int inside;
-    Ratio part_dist; // what percentage of the radius the target layer is away from the center along the z axis. 0 - 1
-    const coord_t layer_height = mesh.settings.get<coord_t>("layer_height");
-    int bottom_layer = (center.z_ - radius) / layer_height;
-    int top_layer = (center.z_ + radius) / layer_height;
-    for (int test_layer = bottom_layer; test_layer <= top_layer; test_layer += 3) // steps of three. Low-hanging speed gain.
-    {
-        part_dist = Ratio{ static_cast<Ratio::value_type>(test_layer * layer_height - center.z_) } / radius;
-        sphere_slice_radius2 = radius * radius * (1.0 - (part_dist * part_dist));
-        Point2LL loc(center.x_, center.y_);
-
-        inside = distanceFromPointToMesh(mesh, test_layer, loc, &distance2);
-        if (inside == 1)
-        {
-            inside_somewhere = true;
-        }
-        else
-        {
-            outside_somewhere = true;
-        }
-        if (outside_somewhere && inside_somewhere)
-        {
-            return true;
-        }
-        if ((inside != 2) && distance2 < sphere_slice_radius2)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-coord_t SubDivCube::distanceFromPointToMesh(SliceMeshStorage& mesh, const LayerIndex layer_nr, Point2LL& location, coord_t* distance2)
-{
-    if (layer_nr < 0 || (unsigned int)layer_nr >= mesh.layers.size()) //!< this layer is outside of valid range
-    {
-        return 2;
-        *distance2 = 0;
-    }
-    Shape collide;
-    for (const SliceLayerPart& part : mesh.layers[layer_nr].parts)
-    {
-        collide.push_back(part.infill_area);
-    }
-
-    Point2LL centerpoint = location;
-    bool inside = collide.inside(centerpoint);
-    ClosestPointPolygon border_point = PolygonUtils::moveInside2(collide, centerpoint);
-    Point2LL diff = border_point.location_ - location;
-    *distance2 = vSize2(diff);
-    if (inside)
-    {
-        return 1;
-    }
-    return 0;
-}
-
-
-void SubDivCube::rotatePointInitial(Point2LL& target)
+void SubDivCube::rotatePointInitial(Point2LL& target) const
 {
-    target = infill_rotation_matrix_.apply(target);
+    target = properties_->infill_rotation_matrix.apply(target);
 }
 
 void SubDivCube::rotatePoint120(Point2LL& target)
@@ -3,6 +3,10 @@
 
 #include "layerPart.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
 #include "geometry/OpenPolyline.h"
 #include "progress/Progress.h"
 #include "settings/EnumSettings.h" //For ESurfaceMode.
@@ -28,14 +32,37 @@ It's also the first step that stores the result in the "data storage" so all oth
 namespace cura
 {
 
-void createLayerWithParts(const Settings& settings, SliceLayer& storageLayer, SlicerLayer* layer)
+namespace
+{
+
+/*!
+ * The settings of a mesh that determine how its layers are split into parts, looked up once per mesh rather than for every layer.
+ */
+struct LayerPartSettings
+{
+    explicit LayerPartSettings(const Settings& settings)
+        : max_stitch_distance(settings.get<coord_t>("wall_line_width_0"))
+        , simplifier(settings)
+        , union_all_remove_holes(settings.get<bool>("meshfix_union_all_remove_holes"))
+        , union_layers(settings.get<bool>("meshfix_union_all"))
+        , surface_only(settings.get<ESurfaceMode>("magic_mesh_surface_mode"))
+    {
+    }
+
+    coord_t max_stitch_distance;
+    Simplify simplifier;
+    bool union_all_remove_holes;
+    bool union_layers;
+    ESurfaceMode surface_only;
+};
+
+void createLayerWithParts(const LayerPartSettings& settings, SliceLayer& storageLayer, SlicerLayer* layer)
 {
-    OpenPolylineStitcher::stitch(layer->open_polylines_, storageLayer.open_polylines, layer->polygons_, settings.get<coord_t>("wall_line_width_0"));
+    OpenPolylineStitcher::stitch(layer->open_polylines_, storageLayer.open_polylines, layer->polygons_, settings.max_stitch_distance);
 
-    storageLayer.open_polylines = Simplify(settings).polyline(storageLayer.open_polylines);
+    storageLayer.open_polylines = settings.simplifier.polyline(storageLayer.open_polylines);
 
-    const bool union_all_remove_holes = settings.get<bool>("meshfix_union_all_remove_holes");
-    if (union_all_remove_holes)
+    if (settings.union_all_remove_holes)
     {
         for (unsigned int i = 0; i < layer->polygons_.size(); i++)
         {
@@ -45,9 +72,7 @@ void createLayerWithParts(const Settings& settings, SliceLayer& storageLayer, Sl
     }
 
     std::vector<SingleShape> result;
-    const bool union_layers = settings.get<bool>("meshfix_union_all");
-    const ESurfaceMode surface_only = settings.get<ESurfaceMode>("magic_mesh_surface_mode");
-    if (surface_only == ESurfaceMode::SURFACE && ! union_layers)
+    if (settings.surface_only == ESurfaceMode::SURFACE && ! settings.union_layers)
     { // Don't do anything with overlapping areas; no union nor xor
         result.reserve(layer->polygons_.size());
         for (const Polygon& poly : layer->polygons_)
@@ -62,7 +87,7 @@ void createLayerWithParts(const Settings& settings, SliceLayer& storageLayer, Sl
     }
     else
     {
-        result = layer->polygons_.splitIntoParts(union_layers || union_all_remove_holes);
+        result = layer->polygons_.splitIntoParts(settings.union_layers || settings.union_all_remove_holes);
     }
 
     for (auto& part : result)
@@ -81,28 +106,74 @@ void createLayerWithParts(const Settings& settings, SliceLayer& storageLayer, Sl
     }
 }
 
+} // namespace
+
+void createLayerWithParts(const Settings& settings, SliceLayer& storageLayer, SlicerLayer* layer)
+{
+    createLayerWithParts(LayerPartSettings(settings), storageLayer, layer);
+}
+
 void createLayerParts(SliceMeshStorage& mesh, Slicer* slicer)
 {
-    const auto total_layers = slicer->layers.size();
-    assert(mesh.layers.size() == total_layers);
+    createLayerParts({ &mesh }, { slicer });
+}
+
+void createLayerParts(const std::vector<SliceMeshStorage*>& meshes, const std::vector<Slicer*>& slicers)
+{
+    assert(meshes.size() == slicers.size());
+
+    // The layers of all meshes are processed as one range, so that the workers don't wait for the last layers of one mesh before starting on the next.
+    std::vector<LayerPartSettings> settings_per_mesh;
+    settings_per_mesh.reserve(meshes.size());
+    std::vector<size_t> first_task_of_mesh{ 0 };
+    for (size_t mesh_idx = 0; mesh_idx < meshes.size(); mesh_idx++)
+    {
+        assert(meshes[mesh_idx]->layers.size() == slicers[mesh_idx]->layers.size());
+        settings_per_mesh.emplace_back(meshes[mesh_idx]->settings);
+        first_task_of_mesh.push_back(first_task_of_mesh.back() + slicers[mesh_idx]->layers.size());
+    }
+    const auto mesh_of_task = [&first_task_of_mesh](const size_t task)
+    {
+        return static_cast<size_t>(std::upper_bound(first_task_of_mesh.begin(), first_task_of_mesh.end(), task) - first_task_of_mesh.begin()) - 1;
+    };
+    std::mutex progress_mutex;
+    std::atomic<size_t> completed_task_count = 0;
 
     cura::parallel_for<size_t>(
         0,
-        total_layers,
-        [slicer, &mesh](size_t layer_nr)
+        first_task_of_mesh.back(),
+        [&](const size_t task)
         {
-            SliceLayer& layer_storage = mesh.layers[layer_nr];
-            SlicerLayer& slice_layer = slicer->layers[layer_nr];
-            createLayerWithParts(mesh.settings, layer_storage, &slice_layer);
+            const size_t mesh_idx = mesh_of_task(task);
+            const SlicerLayer& slice_layer = slicers[mesh_idx]->layers[task - first_task_of_mesh[mesh_idx]];
+            return slice_layer.polygons_.pointCount() + slice_layer.open_polylines_.pointCount();
+        },
+        [&](const size_t task)
+        {
+            const size_t mesh_idx = mesh_of_task(task);
+            const size_t layer_nr = task - first_task_of_mesh[mesh_idx];
+            createLayerWithParts(settings_per_mesh[mesh_idx], meshes[mesh_idx]->layers[layer_nr], &slicers[mesh_idx]->layers[layer_nr]);
+
+            const size_t completed_tasks = completed_task_count.fetch_add(1, std::memory_order_relaxed) + 1;
+            std::unique_lock<std::mutex> lock(progress_mutex, std::try_to_lock);
+            if (lock)
+            { // progress is messaged from only one thread at a time
+                Progress::messageProgress(Progress::Stage::PARTS, static_cast<int>(completed_tasks), static_cast<int>(first_task_of_mesh.back()));
+            }
         });
 
-    for (LayerIndex layer_nr = total_layers - 1; layer_nr >= 0; layer_nr--)
+    for (size_t mesh_idx = 0; mesh_idx < meshes.size(); mesh_idx++)
     {
-        SliceLayer& layer_storage = mesh.layers[layer_nr];
-        if (layer_storage.parts.size() > 0 || (mesh.settings.get<ESurfaceMode>("magic_mesh_surface_mode") != ESurfaceMode::NORMAL && layer_storage.open_polylines.size() > 0))
+        SliceMeshStorage& mesh = *meshes[mesh_idx];
+        const bool surface_mode = settings_per_mesh[mesh_idx].surface_only != ESurfaceMode::NORMAL;
+        for (LayerIndex layer_nr = mesh.layers.size() - 1; layer_nr >= 0; layer_nr--)
         {
-            mesh.layer_nr_max_filled_layer = layer_nr; // last set by the highest non-empty layer
-            break;
+            SliceLayer& layer_storage = mesh.layers[layer_nr];
+            if (layer_storage.parts.size() > 0 || (surface_mode && layer_storage.open_polylines.size() > 0))
+            {
+                mesh.layer_nr_max_filled_layer = layer_nr; // last set by the highest non-empty layer
+                break;
+            }
         }
     }
 }
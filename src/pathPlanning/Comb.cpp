@@ -57,11 +57,95 @@ LocToLineGrid& Comb::getModelBoundaryLocToLine(const ExtruderTrain& train)
     return *model_boundary_loc_to_line_[train.extruder_nr_];
 }
 
+Comb::InsideBoundary::InsideBoundary(const Shape& boundary)
+    : boundary_(boundary) // copy the boundary, because the parts_view will reorder the polygons
+    , parts_view_(boundary_.splitIntoPartsView()) // WARNING !! changes the order of boundary_ !!
+{
+}
+
+Comb::InsideBoundary& Comb::getInsideMinimum()
+{
+    if (inside_minimum_ == nullptr)
+    {
+        inside_minimum_ = std::make_unique<InsideBoundary>(boundary_inside_minimum_provider_());
+    }
+    return *inside_minimum_;
+}
+
+Comb::InsideBoundary& Comb::getInsideOptimal()
+{
+    if (inside_optimal_ == nullptr)
+    {
+        inside_optimal_ = std::make_unique<InsideBoundary>(boundary_inside_optimal_provider_());
+    }
+    return *inside_optimal_;
+}
+
+LocToLineGrid& Comb::getInsideLocToLine(InsideBoundary& inside)
+{
+    if (inside.loc_to_line_ == nullptr)
+    {
+        inside.loc_to_line_ = PolygonUtils::createLocToLineGrid(inside.boundary_, offset_from_outlines_);
+        ++inside_grids_built_;
+    }
+    return *inside.loc_to_line_;
+}
+
+const CombVisibilityGraph& Comb::getVisibilityGraph(InsideBoundary& inside, const size_t part_idx)
+{
+    std::unique_ptr<CombVisibilityGraph>& graph = inside.visibility_graphs_[part_idx];
+    if (graph == nullptr)
+    {
+        graph = std::make_unique<CombVisibilityGraph>(inside.parts_view_.assemblePart(part_idx), getInsideLocToLine(inside), -offset_dist_to_get_from_on_the_polygon_to_outside_);
+    }
+    return *graph;
+}
+
+bool Comb::combWithinPart(
+    InsideBoundary& inside,
+    const size_t part_idx,
+    const SingleShape& part,
+    Point2LL start_point,
+    Point2LL end_point,
+    CombPath& comb_path,
+    coord_t max_comb_distance_ignored,
+    bool fail_on_unavoidable_obstacles)
+{
+    if (combing_engine_ == CombingEngine::VISIBILITY_GRAPH)
+    {
+        // Same as when following the crossings: short travels go straight, and travels that can't stay within the part fail if they should.
+        if (shorterThen(end_point - start_point, max_comb_distance_ignored))
+        {
+            comb_path.push_back(start_point);
+            comb_path.push_back(end_point);
+            return true;
+        }
+        if (fail_on_unavoidable_obstacles && LinePolygonsCrossings::hasUnavoidableObstacles(part, getInsideLocToLine(inside), start_point, end_point))
+        {
+            return false;
+        }
+        if (getVisibilityGraph(inside, part_idx).route(start_point, end_point, comb_path))
+        {
+            return true;
+        }
+    }
+    // Fall back to following the crossings when the part was too detailed for a graph, or the graph found no route.
+    return LinePolygonsCrossings::comb(
+        part,
+        getInsideLocToLine(inside),
+        start_point,
+        end_point,
+        comb_path,
+        -offset_dist_to_get_from_on_the_polygon_to_outside_,
+        max_comb_distance_ignored,
+        fail_on_unavoidable_obstacles);
+}
+
 Comb::Comb(
     const SliceDataStorage& storage,
     const LayerIndex layer_nr,
-    const Shape& comb_boundary_inside_minimum,
-    const Shape& comb_boundary_inside_optimal,
+    BoundaryProvider comb_boundary_inside_minimum,
+    BoundaryProvider comb_boundary_inside_optimal,
     coord_t comb_boundary_offset,
     coord_t travel_avoid_distance,
     coord_t move_inside_distance)
@@ -75,14 +159,44 @@ Comb::Comb(
     , max_crossing_dist2_(
           offset_from_inside_to_outside_ * offset_from_inside_to_outside_
           * 2) // so max_crossing_dist = offset_from_inside_to_outside * sqrt(2) =approx 1.5 to allow for slightly diagonal crossings and slightly inaccurate crossing computation
-    , boundary_inside_minimum_(comb_boundary_inside_minimum) // copy the boundary, because the partsView_inside will reorder the polygons
-    , boundary_inside_optimal_(comb_boundary_inside_optimal) // copy the boundary, because the partsView_inside will reorder the polygons
-    , parts_view_inside_minimum_(boundary_inside_minimum_.splitIntoPartsView()) // WARNING !! changes the order of boundary_inside !!
-    , parts_view_inside_optimal_(boundary_inside_optimal_.splitIntoPartsView()) // WARNING !! changes the order of boundary_inside !!
-    , inside_loc_to_line_minimum_(PolygonUtils::createLocToLineGrid(boundary_inside_minimum_, comb_boundary_offset))
-    , inside_loc_to_line_optimal_(PolygonUtils::createLocToLineGrid(boundary_inside_optimal_, comb_boundary_offset))
+    , boundary_inside_minimum_provider_(std::move(comb_boundary_inside_minimum))
+    , boundary_inside_optimal_provider_(std::move(comb_boundary_inside_optimal))
     , move_inside_distance_(move_inside_distance)
 {
+    const Settings& mesh_group_settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
+    combing_engine_ = mesh_group_settings.has("retraction_combing_engine") ? mesh_group_settings.get<CombingEngine>("retraction_combing_engine") : CombingEngine::CROSSINGS;
+    inside_grids_available_ += 2;
+}
+
+Comb::Comb(
+    const SliceDataStorage& storage,
+    const LayerIndex layer_nr,
+    Shape comb_boundary_inside_minimum,
+    Shape comb_boundary_inside_optimal,
+    coord_t comb_boundary_offset,
+    coord_t travel_avoid_distance,
+    coord_t move_inside_distance)
+    : Comb(
+        storage,
+        layer_nr,
+        // Shared, so that the reference stays valid when the provider is copied or moved.
+        [boundary = std::make_shared<const Shape>(std::move(comb_boundary_inside_minimum))]() -> const Shape&
+        {
+            return *boundary;
+        },
+        [boundary = std::make_shared<const Shape>(std::move(comb_boundary_inside_optimal))]() -> const Shape&
+        {
+            return *boundary;
+        },
+        comb_boundary_offset,
+        travel_avoid_distance,
+        move_inside_distance)
+{
+}
+
+Comb::GridStatistics Comb::getGridStatistics()
+{
+    return GridStatistics{ .inside_grids_built = inside_grids_built_, .inside_grids_available = inside_grids_available_ };
 }
 
 bool Comb::calc(
@@ -103,34 +217,28 @@ bool Comb::calc(
         return true;
     }
     const Point2LL travel_end_point_before_combing = end_point;
+    InsideBoundary& optimal = getInsideOptimal();
     // Move start and end point inside the optimal comb boundary
     size_t start_inside_poly = NO_INDEX;
-    const bool start_inside = moveInside(boundary_inside_optimal_, _start_inside, inside_loc_to_line_optimal_.get(), start_point, start_inside_poly);
+    const bool start_inside = moveInside(optimal.boundary_, _start_inside, &getInsideLocToLine(optimal), start_point, start_inside_poly);
 
     size_t end_inside_poly = NO_INDEX;
-    const bool end_inside = moveInside(boundary_inside_optimal_, _end_inside, inside_loc_to_line_optimal_.get(), end_point, end_inside_poly);
+    const bool end_inside = moveInside(optimal.boundary_, _end_inside, &getInsideLocToLine(optimal), end_point, end_inside_poly);
 
     size_t start_part_boundary_poly_idx = NO_INDEX; // Added initial value to stop MSVC throwing an exception in debug mode
     size_t end_part_boundary_poly_idx = NO_INDEX;
-    size_t start_part_idx = (start_inside_poly == NO_INDEX) ? NO_INDEX : parts_view_inside_optimal_.getPartContaining(start_inside_poly, &start_part_boundary_poly_idx);
-    size_t end_part_idx = (end_inside_poly == NO_INDEX) ? NO_INDEX : parts_view_inside_optimal_.getPartContaining(end_inside_poly, &end_part_boundary_poly_idx);
+    size_t start_part_idx = (start_inside_poly == NO_INDEX) ? NO_INDEX : optimal.parts_view_.getPartContaining(start_inside_poly, &start_part_boundary_poly_idx);
+    size_t end_part_idx = (end_inside_poly == NO_INDEX) ? NO_INDEX : optimal.parts_view_.getPartContaining(end_inside_poly, &end_part_boundary_poly_idx);
 
     const bool fail_on_unavoidable_obstacles = perform_z_hops && perform_z_hops_only_when_collides;
 
     // normal combing within part using optimal comb boundary
     if (start_inside && end_inside && start_part_idx == end_part_idx)
     {
-        SingleShape part = parts_view_inside_optimal_.assemblePart(start_part_idx);
+        SingleShape part = optimal.parts_view_.assemblePart(start_part_idx);
         comb_paths.emplace_back();
-        const bool combing_succeeded = LinePolygonsCrossings::comb(
-            part,
-            *inside_loc_to_line_optimal_,
-            start_point,
-            end_point,
-            comb_paths.back(),
-            -offset_dist_to_get_from_on_the_polygon_to_outside_,
-            max_comb_distance_ignored,
-            fail_on_unavoidable_obstacles);
+        const bool combing_succeeded
+            = combWithinPart(optimal, start_part_idx, part, start_point, end_point, comb_paths.back(), max_comb_distance_ignored, fail_on_unavoidable_obstacles);
         // If the endpoint of the travel path changes with combing, then it means that we are moving to an outer wall
         // and we should unretract before the last travel move when travelling to that outer wall
         unretract_before_last_travel_move = combing_succeeded && end_point != travel_end_point_before_combing;
@@ -141,37 +249,29 @@ bool Comb::calc(
     // Give more tolerancy when calculating move inside positions, because the target points in this case will be on the borders
     size_t start_inside_poly_optimal = NO_INDEX;
     const bool start_inside_optimal
-        = moveInside(boundary_inside_optimal_, _start_inside, inside_loc_to_line_optimal_.get(), start_point, start_inside_poly_optimal, max_move_inside_distance_enlarged2_);
+        = moveInside(optimal.boundary_, _start_inside, &getInsideLocToLine(optimal), start_point, start_inside_poly_optimal, max_move_inside_distance_enlarged2_);
 
     size_t end_inside_poly_optimal = NO_INDEX;
     const bool end_inside_optimal
-        = moveInside(boundary_inside_optimal_, _end_inside, inside_loc_to_line_optimal_.get(), end_point, end_inside_poly_optimal, max_move_inside_distance_enlarged2_);
+        = moveInside(optimal.boundary_, _end_inside, &getInsideLocToLine(optimal), end_point, end_inside_poly_optimal, max_move_inside_distance_enlarged2_);
 
     size_t start_part_boundary_poly_idx_optimal{};
     size_t end_part_boundary_poly_idx_optimal{};
     size_t start_part_idx_optimal
-        = (start_inside_poly_optimal == NO_INDEX) ? NO_INDEX : parts_view_inside_optimal_.getPartContaining(start_inside_poly_optimal, &start_part_boundary_poly_idx_optimal);
+        = (start_inside_poly_optimal == NO_INDEX) ? NO_INDEX : optimal.parts_view_.getPartContaining(start_inside_poly_optimal, &start_part_boundary_poly_idx_optimal);
     size_t end_part_idx_optimal
-        = (end_inside_poly_optimal == NO_INDEX) ? NO_INDEX : parts_view_inside_optimal_.getPartContaining(end_inside_poly_optimal, &end_part_boundary_poly_idx_optimal);
+        = (end_inside_poly_optimal == NO_INDEX) ? NO_INDEX : optimal.parts_view_.getPartContaining(end_inside_poly_optimal, &end_part_boundary_poly_idx_optimal);
 
     CombPath result_path;
     bool comb_result;
 
     if (start_inside_optimal && end_inside_optimal && start_part_idx_optimal == end_part_idx_optimal)
     {
-        SingleShape part = parts_view_inside_optimal_.assemblePart(start_part_idx_optimal);
+        SingleShape part = optimal.parts_view_.assemblePart(start_part_idx_optimal);
         comb_paths.emplace_back();
 
-        comb_result = LinePolygonsCrossings::comb(
-            part,
-            *inside_loc_to_line_optimal_,
-            start_point,
-            end_point,
-            result_path,
-            -offset_dist_to_get_from_on_the_polygon_to_outside_,
-            max_comb_distance_ignored,
-            fail_on_unavoidable_obstacles);
-        Comb::moveCombPathInside(boundary_inside_minimum_, boundary_inside_optimal_, result_path, comb_paths.back()); // add altered result_path to combPaths.back()
+        comb_result = combWithinPart(optimal, start_part_idx_optimal, part, start_point, end_point, result_path, max_comb_distance_ignored, fail_on_unavoidable_obstacles);
+        Comb::moveCombPathInside(getInsideMinimum().boundary_, optimal.boundary_, result_path, comb_paths.back()); // add altered result_path to combPaths.back()
         // If the endpoint of the travel path changes with combing, then it means that we are moving to an outer wall
         // and we should unretract before the last travel move when travelling to that outer wall
         unretract_before_last_travel_move = comb_result && end_point != travel_end_point_before_combing;
@@ -179,34 +279,27 @@ bool Comb::calc(
     }
 
     // Move start and end point inside the minimum comb boundary
+    InsideBoundary& minimum = getInsideMinimum();
     size_t start_inside_poly_min = NO_INDEX;
-    const bool start_inside_min = moveInside(boundary_inside_minimum_, _start_inside, inside_loc_to_line_minimum_.get(), start_point, start_inside_poly_min);
+    const bool start_inside_min = moveInside(minimum.boundary_, _start_inside, &getInsideLocToLine(minimum), start_point, start_inside_poly_min);
 
     size_t end_inside_poly_min = NO_INDEX;
-    const bool end_inside_min = moveInside(boundary_inside_minimum_, _end_inside, inside_loc_to_line_minimum_.get(), end_point, end_inside_poly_min);
+    const bool end_inside_min = moveInside(minimum.boundary_, _end_inside, &getInsideLocToLine(minimum), end_point, end_inside_poly_min);
 
     size_t start_part_boundary_poly_idx_min{};
     size_t end_part_boundary_poly_idx_min{};
     size_t start_part_idx_min
-        = (start_inside_poly_min == NO_INDEX) ? NO_INDEX : parts_view_inside_minimum_.getPartContaining(start_inside_poly_min, &start_part_boundary_poly_idx_min);
-    size_t end_part_idx_min = (end_inside_poly_min == NO_INDEX) ? NO_INDEX : parts_view_inside_minimum_.getPartContaining(end_inside_poly_min, &end_part_boundary_poly_idx_min);
+        = (start_inside_poly_min == NO_INDEX) ? NO_INDEX : minimum.parts_view_.getPartContaining(start_inside_poly_min, &start_part_boundary_poly_idx_min);
+    size_t end_part_idx_min = (end_inside_poly_min == NO_INDEX) ? NO_INDEX : minimum.parts_view_.getPartContaining(end_inside_poly_min, &end_part_boundary_poly_idx_min);
 
     // normal combing within part using minimum comb boundary
     if (start_inside_min && end_inside_min && start_part_idx_min == end_part_idx_min)
     {
-        SingleShape part = parts_view_inside_minimum_.assemblePart(start_part_idx_min);
+        SingleShape part = minimum.parts_view_.assemblePart(start_part_idx_min);
         comb_paths.emplace_back();
 
-        comb_result = LinePolygonsCrossings::comb(
-            part,
-            *inside_loc_to_line_minimum_,
-            start_point,
-            end_point,
-            result_path,
-            -offset_dist_to_get_from_on_the_polygon_to_outside_,
-            max_comb_distance_ignored,
-            fail_on_unavoidable_obstacles);
-        Comb::moveCombPathInside(boundary_inside_minimum_, boundary_inside_optimal_, result_path, comb_paths.back()); // add altered result_path to combPaths.back()
+        comb_result = combWithinPart(minimum, start_part_idx_min, part, start_point, end_point, result_path, max_comb_distance_ignored, fail_on_unavoidable_obstacles);
+        Comb::moveCombPathInside(minimum.boundary_, optimal.boundary_, result_path, comb_paths.back()); // add altered result_path to combPaths.back()
         // If the endpoint of the travel path changes with combing, then it means that we are moving to an outer wall
         // and we should unretract before the last travel move when travelling to that outer wall
         unretract_before_last_travel_move = comb_result && end_point != travel_end_point_before_combing;
@@ -229,12 +322,12 @@ bool Comb::calc(
 
     // Find the crossings using the minimum comb boundary, since it's guaranteed to be as close as we can get to the destination.
     // Getting as close as possible prevents exiting the polygon in the wrong direction (e.g. into a hole instead of to the outside).
-    Crossing start_crossing(start_point, start_inside_min, start_part_idx_min, start_part_boundary_poly_idx_min, boundary_inside_minimum_, *inside_loc_to_line_minimum_);
-    Crossing end_crossing(end_point, end_inside_min, end_part_idx_min, end_part_boundary_poly_idx_min, boundary_inside_minimum_, *inside_loc_to_line_minimum_);
+    Crossing start_crossing(start_point, start_inside_min, start_part_idx_min, start_part_boundary_poly_idx_min, minimum.boundary_, getInsideLocToLine(minimum));
+    Crossing end_crossing(end_point, end_inside_min, end_part_idx_min, end_part_boundary_poly_idx_min, minimum.boundary_, getInsideLocToLine(minimum));
 
     { // find crossing over the in-between area between inside and outside
-        start_crossing.findCrossingInOrMid(parts_view_inside_minimum_, end_point);
-        end_crossing.findCrossingInOrMid(parts_view_inside_minimum_, start_crossing.in_or_mid_);
+        start_crossing.findCrossingInOrMid(minimum.parts_view_, end_point);
+        end_crossing.findCrossingInOrMid(minimum.parts_view_, start_crossing.in_or_mid_);
     }
 
     bool skip_avoid_other_parts_path = false;
@@ -271,8 +364,8 @@ bool Comb::calc(
         constexpr bool fail_for_optimum_bound = true;
         bool combing_succeeded = start_inside
                               && LinePolygonsCrossings::comb(
-                                     boundary_inside_optimal_,
-                                     *inside_loc_to_line_optimal_,
+                                     optimal.boundary_,
+                                     getInsideLocToLine(optimal),
                                      start_point,
                                      start_crossing.in_or_mid_,
                                      comb_paths.back(),
@@ -283,7 +376,7 @@ bool Comb::calc(
         {
             combing_succeeded = LinePolygonsCrossings::comb(
                 start_crossing.dest_part_,
-                *inside_loc_to_line_minimum_,
+                getInsideLocToLine(minimum),
                 start_point,
                 start_crossing.in_or_mid_,
                 comb_paths.back(),
@@ -359,7 +452,7 @@ bool Comb::calc(
         {
             if (start_inside)
             { // both start and end are inside
-                comb_paths.back().cross_boundary = PolygonUtils::polygonCollidesWithLineSegment(start_point, end_point, *inside_loc_to_line_optimal_);
+                comb_paths.back().cross_boundary = PolygonUtils::polygonCollidesWithLineSegment(start_point, end_point, getInsideLocToLine(optimal));
             }
             else
             { // both start and end are outside
@@ -381,8 +474,8 @@ bool Comb::calc(
         constexpr bool fail_for_optimum_bound = true;
         bool combing_succeeded = end_inside
                               && LinePolygonsCrossings::comb(
-                                     boundary_inside_optimal_,
-                                     *inside_loc_to_line_optimal_,
+                                     optimal.boundary_,
+                                     getInsideLocToLine(optimal),
                                      end_crossing.in_or_mid_,
                                      end_point,
                                      comb_paths.back(),
@@ -393,7 +486,7 @@ bool Comb::calc(
         {
             combing_succeeded = LinePolygonsCrossings::comb(
                 end_crossing.dest_part_,
-                *inside_loc_to_line_minimum_,
+                getInsideLocToLine(minimum),
                 end_crossing.in_or_mid_,
                 end_point,
                 comb_paths.back(),
@@ -516,8 +609,7 @@ void Comb::Crossing::findCrossingInOrMid(const PartsView& partsView_inside, cons
                 dest_part_poly_indices.emplace(poly_idx);
             }
             coord_t dist2_score = std::numeric_limits<coord_t>::max();
-            std::function<bool(const PolygonsPointIndex&)> line_processor
-                = [close_to, _dest_point, &boundary_crossing_point, &dist2_score, &dest_part_poly_indices](const PolygonsPointIndex& boundary_segment)
+            const auto line_processor = [close_to, _dest_point, &boundary_crossing_point, &dist2_score, &dest_part_poly_indices](const PolygonsPointIndex& boundary_segment)
             {
                 if (dest_part_poly_indices.find(boundary_segment.poly_idx_) == dest_part_poly_indices.end())
                 { // we're not looking at a polygon from the dest_part
@@ -0,0 +1,170 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "pathPlanning/CombVisibilityGraph.h"
+
+namespace cura
+{
+
+CombVisibilityGraph::CombVisibilityGraph(const Shape& part, const LocToLineGrid& loc_to_line_grid, const coord_t dist_to_move_boundary_point_outside)
+    : loc_to_line_grid_(loc_to_line_grid)
+    , valid_(true)
+{
+    for (const Polygon& poly : part)
+    {
+        const size_t poly_size = poly.size();
+        if (poly_size < 3)
+        {
+            continue;
+        }
+        for (size_t point_idx = 0; point_idx < poly_size; ++point_idx)
+        {
+            const Point2LL& prev = poly[(point_idx + poly_size - 1) % poly_size];
+            const Point2LL& here = poly[point_idx];
+            const Point2LL& next = poly[(point_idx + 1) % poly_size];
+            // The inside of the part is to the left of every polygon (outlines are counter-clockwise, holes clockwise).
+            // Only the corners where the boundary turns right can be on a shortest path.
+            if (cross(here - prev, next - here) >= 0)
+            {
+                continue;
+            }
+            if (nodes_.size() == max_nodes_)
+            {
+                valid_ = false;
+                nodes_.clear();
+                return;
+            }
+            nodes_.push_back(PolygonUtils::getBoundaryPointWithOffset(poly, point_idx, dist_to_move_boundary_point_outside));
+        }
+    }
+    computeRoutes();
+}
+
+bool CombVisibilityGraph::isValid() const
+{
+    return valid_;
+}
+
+bool CombVisibilityGraph::isVisible(const Point2LL& from, const Point2LL& to) const
+{
+    return ! PolygonUtils::polygonCollidesWithLineSegment(from, to, loc_to_line_grid_);
+}
+
+std::vector<size_t> CombVisibilityGraph::getVisibleNodes(const Point2LL& point) const
+{
+    std::vector<size_t> visible_nodes;
+    for (size_t node_idx = 0; node_idx < nodes_.size(); ++node_idx)
+    {
+        if (isVisible(point, nodes_[node_idx]))
+        {
+            visible_nodes.push_back(node_idx);
+        }
+    }
+    return visible_nodes;
+}
+
+void CombVisibilityGraph::computeRoutes()
+{
+    const size_t node_count = nodes_.size();
+    distances_.assign(node_count * node_count, no_route_);
+    next_.assign(node_count * node_count, no_node_);
+
+    for (size_t from = 0; from < node_count; ++from)
+    {
+        distances_[from * node_count + from] = 0;
+        next_[from * node_count + from] = from;
+        for (size_t to = from + 1; to < node_count; ++to)
+        {
+            if (isVisible(nodes_[from], nodes_[to]))
+            {
+                const coord_t distance = vSize(nodes_[to] - nodes_[from]);
+                distances_[from * node_count + to] = distance;
+                distances_[to * node_count + from] = distance;
+                next_[from * node_count + to] = to;
+                next_[to * node_count + from] = from;
+            }
+        }
+    }
+
+    // Floyd-Warshall, so that every query only has to look up the routes between the nodes it can see.
+    for (size_t via = 0; via < node_count; ++via)
+    {
+        for (size_t from = 0; from < node_count; ++from)
+        {
+            const coord_t to_via = distances_[from * node_count + via];
+            if (to_via == no_route_)
+            {
+                continue;
+            }
+            for (size_t to = 0; to < node_count; ++to)
+            {
+                const coord_t from_via = distances_[via * node_count + to];
+                if (from_via == no_route_)
+                {
+                    continue;
+                }
+                if (to_via + from_via < distances_[from * node_count + to])
+                {
+                    distances_[from * node_count + to] = to_via + from_via;
+                    next_[from * node_count + to] = next_[from * node_count + via];
+                }
+            }
+        }
+    }
+}
+
+bool CombVisibilityGraph::route(const Point2LL& start_point, const Point2LL& end_point, CombPath& comb_path) const
+{
+    if (! valid_)
+    {
+        return false;
+    }
+    if (isVisible(start_point, end_point))
+    {
+        comb_path.push_back(start_point);
+        comb_path.push_back(end_point);
+        return true;
+    }
+
+    const std::vector<size_t> start_nodes = getVisibleNodes(start_point);
+    const std::vector<size_t> end_nodes = getVisibleNodes(end_point);
+    const size_t node_count = nodes_.size();
+
+    coord_t best_distance = no_route_;
+    size_t best_start = no_node_;
+    size_t best_end = no_node_;
+    for (const size_t start_node : start_nodes)
+    {
+        const coord_t to_start_node = vSize(nodes_[start_node] - start_point);
+        for (const size_t end_node : end_nodes)
+        {
+            const coord_t between = distances_[start_node * node_count + end_node];
+            if (between == no_route_)
+            {
+                continue;
+            }
+            const coord_t distance = to_start_node + between + vSize(end_point - nodes_[end_node]);
+            if (distance < best_distance)
+            {
+                best_distance = distance;
+                best_start = start_node;
+                best_end = end_node;
+            }
+        }
+    }
+    if (best_start == no_node_)
+    {
+        return false;
+    }
+
+    comb_path.push_back(start_point);
+    for (size_t node = best_start; node != best_end; node = next_[node * node_count + best_end])
+    {
+        comb_path.push_back(nodes_[node]);
+    }
+    comb_path.push_back(nodes_[best_end]);
+    comb_path.push_back(end_point);
+    return true;
+}
+
+} // namespace cura
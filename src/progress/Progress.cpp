@@ -19,6 +19,8 @@ namespace cura
 std::array<double, N_PROGRESS_STAGES> Progress::accumulated_times = { -1 };
 double Progress::total_timing = -1;
 std::optional<LayerIndex> Progress::first_skipped_layer{};
+std::vector<Progress::StageTime> Progress::stage_times{};
+std::map<std::string, double> Progress::layer_stage_times{};
 
 double Progress::calcOverallProgress(Stage stage, double stage_progress)
 {
@@ -35,6 +37,8 @@ void Progress::init()
         accumulated_time += times.at(static_cast<size_t>(stage));
     }
     total_timing = accumulated_time;
+    stage_times.clear();
+    layer_stage_times.clear();
 }
 
 void Progress::messageProgress(Progress::Stage stage, int progress_in_stage, int progress_in_stage_max)
@@ -49,7 +53,11 @@ void Progress::messageProgressStage(Progress::Stage stage, TimeKeeper* time_keep
     {
         if (static_cast<int>(stage) > 0)
         {
-            spdlog::info("Progress: {} accomplished in {:03.3f}s", names.at(static_cast<size_t>(stage) - 1), time_keeper->restart());
+            const std::string_view accomplished_stage = names.at(static_cast<size_t>(stage) - 1);
+            const double cpu_time = time_keeper->cpuTime();
+            const double wall_time = time_keeper->restart();
+            stage_times.push_back(StageTime{ accomplished_stage, wall_time, cpu_time });
+            spdlog::info("Progress: {} accomplished in {:03.3f}s", accomplished_stage, wall_time);
         }
         else
         {
@@ -65,6 +73,11 @@ void Progress::messageProgressStage(Progress::Stage stage, TimeKeeper* time_keep
 
 void Progress::messageProgressLayer(LayerIndex layer_nr, size_t total_layers, double total_time, const TimeKeeper::RegisteredTimes& stages, double skip_threshold)
 {
+    for (const TimeKeeper::RegisteredTime& time : stages)
+    {
+        layer_stage_times[time.stage] += time.duration;
+    }
+
     if (total_time < skip_threshold)
     {
         if (! first_skipped_layer)
@@ -104,4 +117,14 @@ void Progress::messageProgressLayer(LayerIndex layer_nr, size_t total_layers, do
     }
 }
 
+const std::vector<Progress::StageTime>& Progress::getStageTimes()
+{
+    return stage_times;
+}
+
+const std::map<std::string, double>& Progress::getLayerStageTimes()
+{
+    return layer_stage_times;
+}
+
 } // namespace cura
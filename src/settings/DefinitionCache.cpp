@@ -0,0 +1,400 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "settings/DefinitionCache.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#ifndef _WIN32
+#include <sys/stat.h> //To check who owns the cache.
+#include <unistd.h> //For geteuid.
+#endif
+
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <fmt/format.h>
+#include <spdlog/details/os.h>
+#include <spdlog/spdlog.h>
+
+#include "settings/Settings.h" // For CURA_ENGINE_VERSION.
+
+namespace cura
+{
+
+void FlattenedDefinition::addFile(const std::filesystem::path& file)
+{
+    std::error_code error;
+    const std::filesystem::path absolute_file = std::filesystem::absolute(file, error);
+    const auto modified = std::filesystem::last_write_time(file, error);
+    const auto size = std::filesystem::file_size(file, error);
+    if (error)
+    {
+        complete = false;
+        return;
+    }
+    dependencies.push_back(Dependency{ absolute_file.generic_string(), static_cast<int64_t>(modified.time_since_epoch().count()), size });
+    search_directories.push_back(file.parent_path().generic_string());
+}
+
+void FlattenedDefinition::addSetting(const std::string& key, const std::string& value)
+{
+    if (steps.empty() || steps.back().extruder_nr.has_value())
+    {
+        steps.emplace_back();
+    }
+    steps.back().settings.emplace_back(key, value);
+}
+
+void FlattenedDefinition::addExtruder(const size_t extruder_nr, const std::string& extruder_file)
+{
+    steps.push_back(Step{ .settings = {}, .extruder_nr = extruder_nr, .extruder_file = extruder_file });
+}
+
+void FlattenedDefinition::append(const FlattenedDefinition& other)
+{
+    dependencies.insert(dependencies.end(), other.dependencies.begin(), other.dependencies.end());
+    search_directories.insert(search_directories.end(), other.search_directories.begin(), other.search_directories.end());
+    steps.insert(steps.end(), other.steps.begin(), other.steps.end());
+    complete = complete && other.complete;
+}
+
+namespace DefinitionCache
+{
+
+/*!
+ * Identifies the file format. Change the last character when the format changes, so that old cache files are not read.
+ */
+constexpr std::string_view magic = "CURADEF1";
+
+/*!
+ * Reads the values from a memory mapped cache file, checking that they stay within the file.
+ */
+class Reader
+{
+public:
+    Reader(const char* data, const size_t size)
+        : position_(data)
+        , end_(data + size)
+    {
+    }
+
+    bool ok() const
+    {
+        return ok_;
+    }
+
+    template<typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        if (! ok_ || static_cast<size_t>(end_ - position_) < sizeof(T))
+        {
+            ok_ = false;
+            return value;
+        }
+        std::memcpy(&value, position_, sizeof(T));
+        position_ += sizeof(T);
+        return value;
+    }
+
+    std::string readString()
+    {
+        const auto length = read<uint64_t>();
+        if (! ok_ || static_cast<uint64_t>(end_ - position_) < length)
+        {
+            ok_ = false;
+            return {};
+        }
+        std::string result(position_, length);
+        position_ += length;
+        return result;
+    }
+
+    std::string_view readBytes(const size_t length)
+    {
+        if (! ok_ || static_cast<size_t>(end_ - position_) < length)
+        {
+            ok_ = false;
+            return {};
+        }
+        const std::string_view result(position_, length);
+        position_ += length;
+        return result;
+    }
+
+private:
+    const char* position_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+/*!
+ * Writes values to a cache file.
+ */
+class Writer
+{
+public:
+    explicit Writer(std::ofstream& file)
+        : file_(file)
+    {
+    }
+
+    template<typename T>
+    void write(const T value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        file_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeString(const std::string_view value)
+    {
+        write<uint64_t>(value.size());
+        file_.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+private:
+    std::ofstream& file_;
+};
+
+/*!
+ * Whether only the current user can change a file or directory.
+ *
+ * The flattened definitions are trusted like the JSON files they were made from, so a cache that someone else can write to could be used to inject settings
+ * such as the start g-code. Symbolic links are not followed, since they could point anywhere.
+ * \param path The file or directory to check.
+ * \param directory Whether it must be a directory rather than a regular file.
+ */
+bool isPrivate(const std::filesystem::path& path, const bool directory)
+{
+#ifdef _WIN32
+    // The temporary directory is in the profile of the user on Windows.
+    std::error_code error;
+    return directory ? std::filesystem::is_directory(path, error) : std::filesystem::is_regular_file(path, error);
+#else
+    struct stat status;
+    if (::lstat(path.c_str(), &status) != 0)
+    {
+        return false;
+    }
+    if (directory ? ! S_ISDIR(status.st_mode) : ! S_ISREG(status.st_mode))
+    {
+        return false;
+    }
+    return status.st_uid == ::geteuid() && (status.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#endif
+}
+
+std::filesystem::path defaultDirectory()
+{
+    if (const std::string directory = spdlog::details::os::getenv("CURA_ENGINE_DEFINITION_CACHE"); ! directory.empty())
+    {
+        return directory == "none" ? std::filesystem::path() : std::filesystem::path(directory);
+    }
+#ifndef _WIN32
+    // Not in the temporary directory, which is shared with all other users.
+    if (const std::string cache_home = spdlog::details::os::getenv("XDG_CACHE_HOME"); ! cache_home.empty())
+    {
+        return std::filesystem::path(cache_home) / "cura_engine" / "definitions";
+    }
+    if (const std::string home = spdlog::details::os::getenv("HOME"); ! home.empty())
+    {
+        return std::filesystem::path(home) / ".cache" / "cura_engine" / "definitions";
+    }
+#endif
+    std::error_code error;
+    const std::filesystem::path temporary_directory = std::filesystem::temp_directory_path(error);
+    if (error)
+    {
+        return {};
+    }
+#ifdef _WIN32
+    return temporary_directory / "cura_engine_definition_cache";
+#else
+    return temporary_directory / fmt::format("cura_engine_definition_cache-{}", ::geteuid());
+#endif
+}
+
+std::filesystem::path
+    cacheFile(const std::filesystem::path& directory, const std::filesystem::path& definition_file, const std::vector<std::filesystem::path>& search_directories, bool force_read_parent)
+{
+    // Relative paths are relative to the working directory, which may differ between slices.
+    const auto absolute = [](const std::filesystem::path& path)
+    {
+        std::error_code error;
+        const std::filesystem::path absolute_path = std::filesystem::absolute(path, error);
+        return (error ? path : absolute_path).generic_string();
+    };
+    std::string key = fmt::format("{}|{}|{}", CURA_ENGINE_VERSION, force_read_parent, absolute(definition_file));
+    for (const std::filesystem::path& search_directory : search_directories)
+    {
+        key += "|" + absolute(search_directory);
+    }
+    return directory / fmt::format("{}-{:016x}.bin", definition_file.stem().string(), std::hash<std::string>{}(key));
+}
+
+std::optional<FlattenedDefinition> read(const std::filesystem::path& cache_file)
+{
+    std::error_code error;
+    if (! std::filesystem::exists(cache_file, error))
+    {
+        return std::nullopt;
+    }
+    if (! isPrivate(cache_file.parent_path(), true) || ! isPrivate(cache_file, false))
+    {
+        spdlog::warn("Ignoring definition cache file {}, since other users can change it", cache_file.string());
+        return std::nullopt;
+    }
+
+    try
+    {
+        const boost::interprocess::file_mapping mapping(cache_file.string().c_str(), boost::interprocess::read_only);
+        const boost::interprocess::mapped_region region(mapping, boost::interprocess::read_only);
+        Reader reader(static_cast<const char*>(region.get_address()), region.get_size());
+        if (reader.readBytes(magic.size()) != magic)
+        {
+            return std::nullopt;
+        }
+
+        FlattenedDefinition definition;
+        const auto dependency_count = reader.read<uint64_t>();
+        for (uint64_t dependency_idx = 0; dependency_idx < dependency_count && reader.ok(); ++dependency_idx)
+        {
+            FlattenedDefinition::Dependency dependency;
+            dependency.path = reader.readString();
+            dependency.modified = reader.read<int64_t>();
+            dependency.size = reader.read<uint64_t>();
+
+            // The cache is only valid as long as all the files it was made from are unchanged.
+            const auto modified = std::filesystem::last_write_time(dependency.path, error);
+            if (error || static_cast<int64_t>(modified.time_since_epoch().count()) != dependency.modified || std::filesystem::file_size(dependency.path, error) != dependency.size)
+            {
+                return std::nullopt;
+            }
+            definition.dependencies.push_back(std::move(dependency));
+        }
+        const auto directory_count = reader.read<uint64_t>();
+        for (uint64_t directory_idx = 0; directory_idx < directory_count && reader.ok(); ++directory_idx)
+        {
+            definition.search_directories.push_back(reader.readString());
+        }
+        const auto step_count = reader.read<uint64_t>();
+        for (uint64_t step_idx = 0; step_idx < step_count && reader.ok(); ++step_idx)
+        {
+            FlattenedDefinition::Step& step = definition.steps.emplace_back();
+            if (reader.read<uint8_t>() == 1)
+            {
+                step.extruder_nr = reader.read<uint64_t>();
+                step.extruder_file = reader.readString();
+                continue;
+            }
+            const auto setting_count = reader.read<uint64_t>();
+            for (uint64_t setting_idx = 0; setting_idx < setting_count && reader.ok(); ++setting_idx)
+            {
+                std::string key = reader.readString();
+                step.settings.emplace_back(std::move(key), reader.readString());
+            }
+        }
+        if (! reader.ok())
+        {
+            spdlog::warn("Ignoring damaged definition cache file {}", cache_file.string());
+            return std::nullopt;
+        }
+        return definition;
+    }
+    catch (const boost::interprocess::interprocess_exception& exception)
+    {
+        spdlog::warn("Couldn't map definition cache file {}: {}", cache_file.string(), exception.what());
+        return std::nullopt;
+    }
+}
+
+bool write(const std::filesystem::path& cache_file, const FlattenedDefinition& definition)
+{
+    std::error_code error;
+    const std::filesystem::path directory = cache_file.parent_path();
+    if (std::filesystem::create_directories(directory, error))
+    {
+        std::filesystem::permissions(directory, std::filesystem::perms::owner_all, error);
+    }
+    if (! isPrivate(directory, true))
+    {
+        spdlog::warn("Not writing to definition cache {}, since other users can change it", directory.string());
+        return false;
+    }
+    const std::filesystem::path temporary_file = fmt::format("{}.{}.tmp", cache_file.string(), std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream file(temporary_file, std::ios::binary);
+        if (! file)
+        {
+            spdlog::debug("Couldn't write definition cache file {}", temporary_file.string());
+            return false;
+        }
+        Writer writer(file);
+        file.write(magic.data(), static_cast<std::streamsize>(magic.size()));
+        writer.write<uint64_t>(definition.dependencies.size());
+        for (const FlattenedDefinition::Dependency& dependency : definition.dependencies)
+        {
+            writer.writeString(dependency.path);
+            writer.write<int64_t>(dependency.modified);
+            writer.write<uint64_t>(dependency.size);
+        }
+        writer.write<uint64_t>(definition.search_directories.size());
+        for (const std::string& directory : definition.search_directories)
+        {
+            writer.writeString(directory);
+        }
+        writer.write<uint64_t>(definition.steps.size());
+        for (const FlattenedDefinition::Step& step : definition.steps)
+        {
+            if (step.extruder_nr.has_value())
+            {
+                writer.write<uint8_t>(1);
+                writer.write<uint64_t>(step.extruder_nr.value());
+                writer.writeString(step.extruder_file);
+                continue;
+            }
+            writer.write<uint8_t>(0);
+
+            // Only the last value of every setting in a block matters, which drops most of the defaults.
+            std::unordered_map<std::string_view, size_t> last_index;
+            for (size_t setting_idx = 0; setting_idx < step.settings.size(); ++setting_idx)
+            {
+                last_index[step.settings[setting_idx].first] = setting_idx;
+            }
+            writer.write<uint64_t>(last_index.size());
+            for (size_t setting_idx = 0; setting_idx < step.settings.size(); ++setting_idx)
+            {
+                if (last_index[step.settings[setting_idx].first] == setting_idx)
+                {
+                    writer.writeString(step.settings[setting_idx].first);
+                    writer.writeString(step.settings[setting_idx].second);
+                }
+            }
+        }
+        if (! file)
+        {
+            file.close();
+            std::filesystem::remove(temporary_file, error);
+            return false;
+        }
+    }
+    std::filesystem::permissions(temporary_file, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write, error);
+    std::filesystem::rename(temporary_file, cache_file, error);
+    if (error)
+    {
+        std::filesystem::remove(temporary_file, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace DefinitionCache
+
+} // namespace cura
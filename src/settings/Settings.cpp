@@ -53,6 +53,15 @@ void Settings::add(const std::string& key, const std::string& value)
     }
 }
 
+void Settings::add(const std::vector<std::pair<std::string, std::string>>& key_values)
+{
+    settings.reserve(settings.size() + key_values.size());
+    for (const auto& [key, value] : key_values)
+    {
+        settings.insert_or_assign(key, value);
+    }
+}
+
 void Settings::remove(const std::string& key)
 {
     const auto iterator = settings.find(key);
@@ -635,6 +644,21 @@ CombingMode Settings::get<CombingMode>(const std::string& key) const
     }
 }
 
+template<>
+CombingEngine Settings::get<CombingEngine>(const std::string& key) const
+{
+    const std::string& value = get<std::string>(key);
+    using namespace cura::utils;
+    switch (hash_enum(value))
+    {
+    case "visibility_graph"_sw:
+        return CombingEngine::VISIBILITY_GRAPH;
+    case "crossings"_sw:
+    default:
+        return CombingEngine::CROSSINGS;
+    }
+}
+
 template<>
 SupportDistPriority Settings::get<SupportDistPriority>(const std::string& key) const
 {
@@ -19,6 +19,7 @@
 #include "infill/SubDivCube.h" // For the destructor
 #include "raft.h"
 #include "utils/ExtrusionLine.h"
+#include "utils/ThreadPool.h"
 #include "utils/math.h" //For PI.
 
 namespace cura
@@ -94,6 +95,16 @@ void SliceLayer::getOutlines(Shape& result, bool external_polys_only) const
     }
 }
 
+size_t SliceLayer::pointCount() const
+{
+    size_t result = 0;
+    for (const SliceLayerPart& part : parts)
+    {
+        result += part.outline.pointCount();
+    }
+    return result;
+}
+
 SliceMeshStorage::SliceMeshStorage(Mesh* mesh, const size_t slice_layer_count)
     : settings(mesh->settings_)
     , mesh_name(mesh->mesh_name_)
@@ -361,19 +372,14 @@ Shape SliceDataStorage::getLayerOutlines(
         Shape total;
         if (include_models && layer_nr >= 0)
         {
-            for (const std::shared_ptr<SliceMeshStorage>& mesh : meshes)
+            if (extruder_nr == -1 && ! external_polys_only)
             {
-                if (mesh->settings.get<bool>("infill_mesh") || mesh->settings.get<bool>("anti_overhang_mesh")
-                    || (extruder_nr != -1 && extruder_nr != int(mesh->settings.get<ExtruderTrain&>("wall_0_extruder_nr").extruder_nr_)))
-                {
-                    continue;
-                }
-                const SliceLayer& layer = mesh->layers[layer_nr];
-                layer.getOutlines(total, external_polys_only);
-                if (mesh->settings.get<ESurfaceMode>("magic_mesh_surface_mode") != ESurfaceMode::NORMAL)
-                {
-                    total = total.unionPolygons(layer.open_polylines.offset(MM2INT(0.1)));
-                }
+                total = static_cast<size_t>(layer_nr) < model_outlines_per_layer_.size() ? model_outlines_per_layer_[layer_nr]
+                                                                                         : collectModelOutlines(layer_nr, external_polys_only, extruder_nr).unionPolygons();
+            }
+            else
+            {
+                total = collectModelOutlines(layer_nr, external_polys_only, extruder_nr);
             }
         }
         if (include_support && (extruder_nr == -1 || extruder_nr == int(mesh_group_settings.get<ExtruderTrain&>("support_infill_extruder_nr").extruder_nr_)))
@@ -401,6 +407,42 @@ Shape SliceDataStorage::getLayerOutlines(
     }
 }
 
+void SliceDataStorage::cacheModelOutlines()
+{
+    model_outlines_per_layer_.clear();
+    std::vector<Shape> model_outlines_per_layer(print_layer_count);
+    cura::parallel_for<size_t>(
+        0,
+        print_layer_count,
+        [&](const size_t layer_nr)
+        {
+            constexpr bool external_polys_only = false;
+            constexpr int all_extruders = -1;
+            model_outlines_per_layer[layer_nr] = collectModelOutlines(layer_nr, external_polys_only, all_extruders).unionPolygons();
+        });
+    model_outlines_per_layer_ = std::move(model_outlines_per_layer);
+}
+
+Shape SliceDataStorage::collectModelOutlines(const LayerIndex layer_nr, const bool external_polys_only, const int extruder_nr) const
+{
+    Shape total;
+    for (const std::shared_ptr<SliceMeshStorage>& mesh : meshes)
+    {
+        if (mesh->settings.get<bool>("infill_mesh") || mesh->settings.get<bool>("anti_overhang_mesh")
+            || (extruder_nr != -1 && extruder_nr != int(mesh->settings.get<ExtruderTrain&>("wall_0_extruder_nr").extruder_nr_)))
+        {
+            continue;
+        }
+        const SliceLayer& layer = mesh->layers[layer_nr];
+        layer.getOutlines(total, external_polys_only);
+        if (mesh->settings.get<ESurfaceMode>("magic_mesh_surface_mode") != ESurfaceMode::NORMAL)
+        {
+            total = total.unionPolygons(layer.open_polylines.offset(MM2INT(0.1)));
+        }
+    }
+    return total;
+}
+
 AABB3D SliceDataStorage::getModelBoundingBox() const
 {
     AABB3D bounding_box;
@@ -4,8 +4,10 @@
 #include "slicer.h"
 
 #include <algorithm> // remove_if
+#include <array>
 #include <cstdio>
 #include <numbers>
+#include <numeric>
 
 #include <scripta/logger.h>
 #include <spdlog/spdlog.h>
@@ -20,9 +22,9 @@
 #include "settings/AdaptiveLayerHeights.h"
 #include "settings/EnumSettings.h"
 #include "settings/types/LayerIndex.h"
+#include "utils/FlatSparseGrid.h"
 #include "utils/Point3D.h"
 #include "utils/Simplify.h"
-#include "utils/SparsePointGridInclusive.h"
 #include "utils/ThreadPool.h"
 #include "utils/gettime.h"
 #include "utils/polygonUtils.h"
@@ -35,6 +37,80 @@ constexpr int largest_neglected_gap_first_phase = MM2INT(0.01); //!< distance be
 constexpr int largest_neglected_gap_second_phase = MM2INT(0.02); //!< distance between two line segments regarded as connected
 constexpr int max_stitch1 = MM2INT(10.0); //!< maximal distance stitched between open polylines to form polygons
 
+/*!
+ * How a triangle crosses a layer, given whether each of its corners is below, on or above the layer.
+ */
+struct TriangleCrossing
+{
+    bool crosses = false; //!< Whether the triangle creates a segment on the layer.
+    std::array<size_t, 3> order{}; //!< The corners in the order to project them in: the corner alone on one side of the layer first.
+    size_t end_edge_idx = 0; //!< The edge of the face at the end of the segment.
+    int end_vertex_idx = -1; //!< The corner at the end of the segment if that is on the layer, or -1.
+};
+
+/*!
+ * How a triangle crosses a layer, indexed by s0 + 3 * s1 + 9 * s2, where si is 0, 1 or 2 if corner i is below, on or above the layer.
+ * Looking the crossing up saves testing each of the cases in turn for every triangle on every layer.
+ */
+constexpr std::array<TriangleCrossing, 27> triangle_crossings = []()
+{
+    /*
+        Edge cases are important here:
+        - If all three vertices of the triangle are exactly on the layer,
+          don't count the triangle at all, because if the model is
+          watertight, there will be adjacent triangles on all 3 sides that
+          are not flat on the layer.
+        - If two of the vertices are exactly on the layer, only count the
+          triangle if the last vertex is going up. We can't count both
+          upwards and downwards triangles here, because if the model is
+          manifold there will always be an adjacent triangle that is going
+          the other way and you'd get double edges. You would also get one
+          layer too many if the total model height is an exact multiple of
+          the layer thickness. Between going up and going down, we need to
+          choose the triangles going up, because otherwise the first layer
+          of where the model starts will be empty and the model will float
+          in mid-air. We'd much rather let the last layer be empty in that
+          case.
+        - If only one of the vertices is exactly on the layer, the
+          intersection between the triangle and the plane would be a point.
+          We can't print points and with a manifold model there would be
+          line segments adjacent to the point on both sides anyway, so we
+          need to discard this 0-length line segment then.
+        - Vertices in ccw order if look from outside.
+    */
+    std::array<TriangleCrossing, 27> crossings{};
+    for (size_t crossing_idx = 0; crossing_idx < crossings.size(); ++crossing_idx)
+    {
+        const std::array<size_t, 3> side{ crossing_idx % 3, crossing_idx / 3 % 3, crossing_idx / 9 };
+        for (size_t alone = 0; alone < 3; ++alone)
+        {
+            const size_t next = (alone + 1) % 3;
+            const size_t previous = (alone + 2) % 3;
+            TriangleCrossing& crossing = crossings[crossing_idx];
+            if (side[alone] == 0 && side[next] == 2 && side[previous] == 2)
+            {
+                // next_______previous
+                //   \     /
+                // ------------- z
+                //     \ /
+                //    alone
+                crossing = TriangleCrossing{ .crosses = true, .order = { alone, previous, next }, .end_edge_idx = alone, .end_vertex_idx = -1 };
+            }
+            else if (side[alone] == 2 && side[next] < 2 && side[previous] < 2)
+            {
+                //    alone
+                //     / \      .
+                // ------------- z
+                //   /     \    .
+                // next_______previous
+                const int end_vertex_idx = side[previous] == 1 ? static_cast<int>(previous) : -1;
+                crossing = TriangleCrossing{ .crosses = true, .order = { alone, next, previous }, .end_edge_idx = previous, .end_vertex_idx = end_vertex_idx };
+            }
+        }
+    }
+    return crossings;
+}();
+
 void SlicerLayer::makeBasicPolygonLoops(OpenLinesSet& open_polylines)
 {
     for (size_t start_segment_idx = 0; start_segment_idx < segments_.size(); start_segment_idx++)
@@ -165,6 +241,10 @@ bool SlicerLayer::PossibleStitch::operator<(const PossibleStitch& other) const
     {
         return true;
     }
+    else if (in_order() && ! other.in_order())
+    {
+        return false;
+    }
 
     // better if lower Terminus::Index for terminus_0
     // This just defines a more total order and isn't strictly necessary.
@@ -192,157 +272,106 @@ bool SlicerLayer::PossibleStitch::operator<(const PossibleStitch& other) const
     return false;
 }
 
-std::priority_queue<SlicerLayer::PossibleStitch>
+std::vector<SlicerLayer::PossibleStitch>
     SlicerLayer::findPossibleStitches(const OpenLinesSet& open_polylines, coord_t max_dist, coord_t cell_size, bool allow_reverse) const
 {
-    std::priority_queue<PossibleStitch> stitch_queue;
+    std::vector<PossibleStitch> stitches;
 
     // maximum distance squared
     int64_t max_dist2 = max_dist * max_dist;
 
-    // Represents a terminal point of a polyline in open_polylines.
-    struct StitchGridVal
-    {
-        unsigned int polyline_idx;
-        // Depending on the SparsePointGridInclusive, either the start point or the
-        // end point of the polyline
-        Point2LL polyline_term_pt;
-    };
-
-    struct StitchGridValLocator
-    {
-        Point2LL operator()(const StitchGridVal& val) const
-        {
-            return val.polyline_term_pt;
-        }
-    };
-
+    // The end points don't move while searching, so the grids are built once and then only queried.
     // Used to find nearby end points within a fixed maximum radius
-    SparsePointGrid<StitchGridVal, StitchGridValLocator> grid_ends(cell_size);
+    FlatSparseGrid<size_t> grid_ends(cell_size, open_polylines.size());
     // Used to find nearby start points within a fixed maximum radius
-    SparsePointGrid<StitchGridVal, StitchGridValLocator> grid_starts(cell_size);
+    FlatSparseGrid<size_t> grid_starts(cell_size, allow_reverse ? open_polylines.size() : 0);
 
     // populate grids
-
-    // Inserts the ends of all polylines into the grid (does not
-    //   insert the starts of the polylines).
-    for (unsigned int polyline_0_idx = 0; polyline_0_idx < open_polylines.size(); polyline_0_idx++)
+    for (size_t polyline_0_idx = 0; polyline_0_idx < open_polylines.size(); polyline_0_idx++)
     {
         const OpenPolyline& polyline_0 = open_polylines[polyline_0_idx];
 
         if (polyline_0.size() < 1)
             continue;
 
-        StitchGridVal grid_val;
-        grid_val.polyline_idx = polyline_0_idx;
-        grid_val.polyline_term_pt = polyline_0.back();
-        grid_ends.insert(grid_val);
-    }
-
-    // Inserts the start of all polylines into the grid.
-    if (allow_reverse)
-    {
-        for (unsigned int polyline_0_idx = 0; polyline_0_idx < open_polylines.size(); polyline_0_idx++)
+        grid_ends.insertPoint(polyline_0.back(), polyline_0_idx);
+        if (allow_reverse)
         {
-            const OpenPolyline& polyline_0 = open_polylines[polyline_0_idx];
-
-            if (polyline_0.size() < 1)
-                continue;
-
-            StitchGridVal grid_val;
-            grid_val.polyline_idx = polyline_0_idx;
-            grid_val.polyline_term_pt = polyline_0[0];
-            grid_starts.insert(grid_val);
+            grid_starts.insertPoint(polyline_0[0], polyline_0_idx);
         }
     }
+    grid_ends.build();
+    grid_starts.build();
 
-    // search for nearby end points
-    for (unsigned int polyline_1_idx = 0; polyline_1_idx < open_polylines.size(); polyline_1_idx++)
+    // Adds the stitches from the terminus of polyline_1 to the nearby terminus of other polylines in the grid.
+    const auto find_nearby = [&](const FlatSparseGrid<size_t>& grid, const bool is_end_0, const size_t polyline_1_idx, const bool is_end_1)
     {
         const OpenPolyline& polyline_1 = open_polylines[polyline_1_idx];
+        const Point2LL point_1 = is_end_1 ? polyline_1.back() : polyline_1[0];
+        grid.processNearby(
+            point_1,
+            max_dist,
+            [&](const size_t polyline_0_idx)
+            {
+                // Disallow stitching with self with same end point
+                if (polyline_0_idx == polyline_1_idx && is_end_0 == is_end_1)
+                {
+                    return true;
+                }
 
-        if (polyline_1.size() < 1)
-            continue;
+                const OpenPolyline& polyline_0 = open_polylines[polyline_0_idx];
+                Point2LL diff = (is_end_0 ? polyline_0.back() : polyline_0[0]) - point_1;
+                int64_t dist2 = vSize2(diff);
+                if (dist2 < max_dist2)
+                {
+                    PossibleStitch poss_stitch;
+                    poss_stitch.dist2 = dist2;
+                    poss_stitch.terminus_0 = Terminus{ polyline_0_idx, is_end_0 };
+                    poss_stitch.terminus_1 = Terminus{ polyline_1_idx, is_end_1 };
+                    stitches.push_back(poss_stitch);
+                }
+                return true;
+            });
+    };
 
-        std::vector<StitchGridVal> nearby_ends;
+    // search for nearby end points
+    for (size_t polyline_1_idx = 0; polyline_1_idx < open_polylines.size(); polyline_1_idx++)
+    {
+        if (open_polylines[polyline_1_idx].size() < 1)
+            continue;
 
         // Check for stitches that append polyline_1 onto polyline_0
         // in natural order.  These are stitches that use the end of
         // polyline_0 and the start of polyline_1.
-        nearby_ends = grid_ends.getNearby(polyline_1[0], max_dist);
-        for (const auto& nearby_end : nearby_ends)
-        {
-            Point2LL diff = nearby_end.polyline_term_pt - polyline_1[0];
-            int64_t dist2 = vSize2(diff);
-            if (dist2 < max_dist2)
-            {
-                PossibleStitch poss_stitch;
-                poss_stitch.dist2 = dist2;
-                poss_stitch.terminus_0 = Terminus{ nearby_end.polyline_idx, true };
-                poss_stitch.terminus_1 = Terminus{ polyline_1_idx, false };
-                stitch_queue.push(poss_stitch);
-            }
-        }
+        find_nearby(grid_ends, true, polyline_1_idx, false);
 
         if (allow_reverse)
         {
             // Check for stitches that append polyline_1 onto polyline_0
             // by reversing order of polyline_1.  These are stitches that
             // use the end of polyline_0 and the end of polyline_1.
-            nearby_ends = grid_ends.getNearby(polyline_1.back(), max_dist);
-            for (const auto& nearby_end : nearby_ends)
-            {
-                // Disallow stitching with self with same end point
-                if (nearby_end.polyline_idx == polyline_1_idx)
-                {
-                    continue;
-                }
-
-                Point2LL diff = nearby_end.polyline_term_pt - polyline_1.back();
-                int64_t dist2 = vSize2(diff);
-                if (dist2 < max_dist2)
-                {
-                    PossibleStitch poss_stitch;
-                    poss_stitch.dist2 = dist2;
-                    poss_stitch.terminus_0 = Terminus{ nearby_end.polyline_idx, true };
-                    poss_stitch.terminus_1 = Terminus{ polyline_1_idx, true };
-                    stitch_queue.push(poss_stitch);
-                }
-            }
+            find_nearby(grid_ends, true, polyline_1_idx, true);
 
             // Check for stitches that append polyline_1 onto polyline_0
             // by reversing order of polyline_0.  These are stitches that
             // use the start of polyline_0 and the start of polyline_1.
-            std::vector<StitchGridVal> nearby_starts = grid_starts.getNearby(polyline_1[0], max_dist);
-            for (const auto& nearby_start : nearby_starts)
-            {
-                // Disallow stitching with self with same end point
-                if (nearby_start.polyline_idx == polyline_1_idx)
-                {
-                    continue;
-                }
-
-                Point2LL diff = nearby_start.polyline_term_pt - polyline_1[0];
-                int64_t dist2 = vSize2(diff);
-                if (dist2 < max_dist2)
-                {
-                    PossibleStitch poss_stitch;
-                    poss_stitch.dist2 = dist2;
-                    poss_stitch.terminus_0 = Terminus{ nearby_start.polyline_idx, false };
-                    poss_stitch.terminus_1 = Terminus{ polyline_1_idx, false };
-                    stitch_queue.push(poss_stitch);
-                }
-            }
+            find_nearby(grid_starts, false, polyline_1_idx, false);
         }
     }
 
-    return stitch_queue;
+    // best first
+    std::sort(
+        stitches.begin(),
+        stitches.end(),
+        [](const PossibleStitch& a, const PossibleStitch& b)
+        {
+            return b < a;
+        });
+    return stitches;
 }
 
-void SlicerLayer::planPolylineStitch(const OpenLinesSet& open_polylines, Terminus& terminus_0, Terminus& terminus_1, bool reverse[2]) const
+void SlicerLayer::planPolylineStitch(size_t size_0, size_t size_1, Terminus& terminus_0, Terminus& terminus_1, bool reverse[2])
 {
-    size_t polyline_0_idx = terminus_0.getPolylineIdx();
-    size_t polyline_1_idx = terminus_1.getPolylineIdx();
     bool back_0 = terminus_0.isEnd();
     bool back_1 = terminus_1.isEnd();
     reverse[0] = false;
@@ -354,7 +383,7 @@ void SlicerLayer::planPolylineStitch(const OpenLinesSet& open_polylines, Terminu
             // back of both polylines
             // we can reverse either one and then append onto the other
             // reverse the smaller polyline
-            if (open_polylines[polyline_0_idx].size() < open_polylines[polyline_1_idx].size())
+            if (size_0 < size_1)
             {
                 std::swap(terminus_0, terminus_1);
             }
@@ -379,7 +408,7 @@ void SlicerLayer::planPolylineStitch(const OpenLinesSet& open_polylines, Terminu
             // front of both polylines
             // we can reverse either one and then prepend to the other
             // reverse the smaller polyline
-            if (open_polylines[polyline_0_idx].size() > open_polylines[polyline_1_idx].size())
+            if (size_0 > size_1)
             {
                 std::swap(terminus_0, terminus_1);
             }
@@ -388,152 +417,158 @@ void SlicerLayer::planPolylineStitch(const OpenLinesSet& open_polylines, Terminu
     }
 }
 
-void SlicerLayer::joinPolylines(OpenPolyline& polyline_0, OpenPolyline& polyline_1, const bool reverse[2])
+void SlicerLayer::connectOpenPolylinesImpl(OpenLinesSet& open_polylines, coord_t max_dist, coord_t cell_size, bool allow_reverse)
 {
-    if (reverse[0])
-    {
-        // reverse polyline_0
-        size_t size_0 = polyline_0.size();
-        for (size_t idx = 0U; idx != size_0 / 2; ++idx)
-        {
-            std::swap(polyline_0[idx], polyline_0[size_0 - 1 - idx]);
-        }
-    }
-    if (reverse[1])
-    {
-        // reverse polyline_1 by adding in reverse order
-        for (int poly_idx = polyline_1.size() - 1; poly_idx >= 0; poly_idx--)
-            polyline_0.push_back(polyline_1[poly_idx]);
-    }
-    else
-    {
-        // append polyline_1 onto polyline_0
-        for (Point2LL& p : polyline_1)
-            polyline_0.push_back(p);
-    }
-    polyline_1.clear();
-}
+    // below code closes smallest gaps first
 
-SlicerLayer::TerminusTrackingMap::TerminusTrackingMap(Terminus::Index end_idx)
-    : m_terminus_old_to_cur_map(end_idx)
-{
-    // Initialize map to everything points to itself since nothing has moved yet.
-    for (size_t idx = 0U; idx != end_idx; ++idx)
-    {
-        m_terminus_old_to_cur_map[idx] = Terminus{ idx };
-    }
-    m_terminus_cur_to_old_map = m_terminus_old_to_cur_map;
-}
+    const std::vector<PossibleStitch> stitches = findPossibleStitches(open_polylines, max_dist, cell_size, allow_reverse);
 
-void SlicerLayer::TerminusTrackingMap::updateMap(
-    size_t num_terms,
-    const Terminus* cur_terms,
-    const Terminus* next_terms,
-    size_t num_removed_terms,
-    const Terminus* removed_cur_terms)
-{
-    // save old locations
-    std::vector<Terminus> old_terms(num_terms);
-    for (size_t idx = 0U; idx != num_terms; ++idx)
+    // The polylines aren't joined while stitching, since that would copy the vertices of a long polyline again every time something is appended
+    // to it. Instead, each joined polyline is kept as a chain of the original polylines, linked through their ends, and the vertices are only
+    // copied once it is known what it ends up as.
+    struct Chain
     {
-        old_terms[idx] = getOldFromCur(cur_terms[idx]);
+        size_t member_count = 1; //!< The number of original polylines in the chain.
+        size_t point_count = 0;
+        size_t polyline_idx = 0; //!< Where in open_polylines the joined polyline is stored.
+        Terminus front; //!< The original Terminus at the start of the polyline.
+        Terminus back; //!< The original Terminus at the end of the polyline.
+    };
+    std::vector<Chain> chains(open_polylines.size());
+    std::vector<size_t> chain_of_polyline(open_polylines.size());
+    for (size_t polyline_idx = 0; polyline_idx < open_polylines.size(); ++polyline_idx)
+    {
+        chains[polyline_idx].point_count = open_polylines[polyline_idx].size();
+        chains[polyline_idx].polyline_idx = polyline_idx;
+        chains[polyline_idx].front = Terminus{ polyline_idx, false };
+        chains[polyline_idx].back = Terminus{ polyline_idx, true };
+        chain_of_polyline[polyline_idx] = polyline_idx;
     }
-    // update using maps old <-> cur and cur <-> next
-    for (size_t idx = 0U; idx != num_terms; ++idx)
+    const Terminus::Index terminus_end_idx = Terminus::endIndexFromPolylineEndIndex(open_polylines.size());
+    // Whether the original end point is no longer the end of a polyline.
+    std::vector<bool> terminus_used(terminus_end_idx, false);
+    // For each original end point, the original end point of the polyline that it is joined to. This links the members of a chain both ways, so
+    // which way is next only follows from the end the chain is walked from. Reversing a chain is then only swapping its front and back.
+    std::vector<Terminus> linked_terminus(terminus_end_idx, Terminus::INVALID_TERMINUS);
+
+    // Call a function with each original polyline of a chain in order, and whether it is reversed in there.
+    const auto for_each_member = [&linked_terminus](const Chain& chain, auto&& member_func)
     {
-        m_terminus_old_to_cur_map[old_terms[idx].asIndex()] = next_terms[idx];
-        Terminus next_term = next_terms[idx];
-        if (next_term != Terminus::INVALID_TERMINUS)
+        for (Terminus terminus = chain.front; terminus != Terminus::INVALID_TERMINUS;)
         {
-            m_terminus_cur_to_old_map[next_term.asIndex()] = old_terms[idx];
+            member_func(terminus.getPolylineIdx(), terminus.isEnd());
+            terminus = linked_terminus[Terminus{ terminus.getPolylineIdx(), ! terminus.isEnd() }.asIndex()];
         }
-    }
-    // remove next locations that no longer exist
-    for (size_t rem_idx = 0U; rem_idx != num_removed_terms; ++rem_idx)
+    };
+    const auto get_points = [&open_polylines, &for_each_member](const Chain& chain)
     {
-        m_terminus_cur_to_old_map[removed_cur_terms[rem_idx].asIndex()] = Terminus::INVALID_TERMINUS;
-    }
-}
-
-void SlicerLayer::connectOpenPolylinesImpl(OpenLinesSet& open_polylines, coord_t max_dist, coord_t cell_size, bool allow_reverse)
-{
-    // below code closes smallest gaps first
-
-    std::priority_queue<PossibleStitch> stitch_queue = findPossibleStitches(open_polylines, max_dist, cell_size, allow_reverse);
-
-    static const Terminus INVALID_TERMINUS = Terminus::INVALID_TERMINUS;
-    Terminus::Index terminus_end_idx = Terminus::endIndexFromPolylineEndIndex(open_polylines.size());
-    // Keeps track of how polyline end point locations move around
-    TerminusTrackingMap terminus_tracking_map(terminus_end_idx);
+        ClipperLib::Path points;
+        points.reserve(chain.point_count);
+        for_each_member(
+            chain,
+            [&open_polylines, &points](const size_t polyline_idx, const bool reversed)
+            {
+                const ClipperLib::Path& polyline = open_polylines[polyline_idx].getPoints();
+                if (reversed)
+                {
+                    points.insert(points.end(), polyline.rbegin(), polyline.rend());
+                }
+                else
+                {
+                    points.insert(points.end(), polyline.begin(), polyline.end());
+                }
+            });
+        return points;
+    };
+    const auto clear_members = [&open_polylines, &for_each_member](const Chain& chain)
+    {
+        for_each_member(
+            chain,
+            [&open_polylines](const size_t polyline_idx, const bool)
+            {
+                open_polylines[polyline_idx].clear();
+            });
+    };
 
-    while (! stitch_queue.empty())
+    for (const PossibleStitch& next_stitch : stitches)
     {
-        // Get the next best stitch
-        PossibleStitch next_stitch;
-        next_stitch = stitch_queue.top();
-        stitch_queue.pop();
         Terminus old_terminus_0 = next_stitch.terminus_0;
-        Terminus terminus_0 = terminus_tracking_map.getCurFromOld(old_terminus_0);
-        if (terminus_0 == INVALID_TERMINUS)
-        {
-            // if we already used this terminus, then this stitch is no longer usable
-            continue;
-        }
         Terminus old_terminus_1 = next_stitch.terminus_1;
-        Terminus terminus_1 = terminus_tracking_map.getCurFromOld(old_terminus_1);
-        if (terminus_1 == INVALID_TERMINUS)
+        if (terminus_used[old_terminus_0.asIndex()] || terminus_used[old_terminus_1.asIndex()])
         {
             // if we already used this terminus, then this stitch is no longer usable
             continue;
         }
 
-        size_t best_polyline_0_idx = terminus_0.getPolylineIdx();
-        size_t best_polyline_1_idx = terminus_1.getPolylineIdx();
+        size_t chain_0_idx = chain_of_polyline[old_terminus_0.getPolylineIdx()];
+        size_t chain_1_idx = chain_of_polyline[old_terminus_1.getPolylineIdx()];
 
         // check to see if this completes a polygon
-        bool completed_poly = best_polyline_0_idx == best_polyline_1_idx;
-        if (completed_poly)
+        if (chain_0_idx == chain_1_idx)
         {
             // finished polygon
-            OpenPolyline& polyline_0 = open_polylines[best_polyline_0_idx];
-            polygons_.push_back(Polygon(std::move(polyline_0.getPoints()), true)); // Will also clear the polyline
-            Terminus cur_terms[2] = { { best_polyline_0_idx, false }, { best_polyline_0_idx, true } };
-            for (size_t idx = 0U; idx != 2U; ++idx)
-            {
-                terminus_tracking_map.markRemoved(cur_terms[idx]);
-            }
+            Chain& chain = chains[chain_0_idx];
+            polygons_.push_back(Polygon(get_points(chain), true));
+            clear_members(chain);
+            chain.member_count = 0;
+            terminus_used[chain.front.asIndex()] = true;
+            terminus_used[chain.back.asIndex()] = true;
             continue;
         }
 
         // we need to join these polylines
 
         // plan how to join polylines
+        Terminus terminus_0{ chain_0_idx, old_terminus_0 == chains[chain_0_idx].back };
+        Terminus terminus_1{ chain_1_idx, old_terminus_1 == chains[chain_1_idx].back };
         bool reverse[2];
-        planPolylineStitch(open_polylines, terminus_0, terminus_1, reverse);
+        planPolylineStitch(chains[chain_0_idx].point_count, chains[chain_1_idx].point_count, terminus_0, terminus_1, reverse);
+        terminus_used[old_terminus_0.asIndex()] = true;
+        terminus_used[old_terminus_1.asIndex()] = true;
 
         // need to reread since planPolylineStitch can swap terminus_0/1
-        best_polyline_0_idx = terminus_0.getPolylineIdx();
-        best_polyline_1_idx = terminus_1.getPolylineIdx();
-        OpenPolyline& polyline_0 = open_polylines[best_polyline_0_idx];
-        OpenPolyline& polyline_1 = open_polylines[best_polyline_1_idx];
-
-        // join polylines according to plan
-        joinPolylines(polyline_0, polyline_1, reverse);
-
-        // update terminus_tracking_map
-        Terminus cur_terms[4] = { { best_polyline_0_idx, false }, { best_polyline_0_idx, true }, { best_polyline_1_idx, false }, { best_polyline_1_idx, true } };
-        Terminus next_terms[4] = { { best_polyline_0_idx, false }, INVALID_TERMINUS, INVALID_TERMINUS, { best_polyline_0_idx, true } };
+        chain_0_idx = terminus_0.getPolylineIdx();
+        chain_1_idx = terminus_1.getPolylineIdx();
+        Chain& chain_0 = chains[chain_0_idx];
+        Chain& chain_1 = chains[chain_1_idx];
         if (reverse[0])
         {
-            std::swap(next_terms[0], next_terms[1]);
+            std::swap(chain_0.front, chain_0.back);
         }
         if (reverse[1])
         {
-            std::swap(next_terms[2], next_terms[3]);
+            std::swap(chain_1.front, chain_1.back);
+        }
+
+        // Only the members of the shorter chain need to be told which chain they are in now, like a union by size. This walks until the end of the
+        // shorter chain, so it is done before that end is linked to the other chain.
+        const bool keep_chain_0 = chain_0.member_count >= chain_1.member_count;
+        const size_t joined_chain_idx = keep_chain_0 ? chain_0_idx : chain_1_idx;
+        for_each_member(
+            keep_chain_0 ? chain_1 : chain_0,
+            [&chain_of_polyline, joined_chain_idx](const size_t polyline_idx, const bool)
+            {
+                chain_of_polyline[polyline_idx] = joined_chain_idx;
+            });
+
+        // join polylines according to plan: chain_1 goes after chain_0
+        linked_terminus[chain_0.back.asIndex()] = chain_1.front;
+        linked_terminus[chain_1.front.asIndex()] = chain_0.back;
+        const Chain joined{ chain_0.member_count + chain_1.member_count, chain_0.point_count + chain_1.point_count, chain_0.polyline_idx, chain_0.front, chain_1.back };
+        (keep_chain_0 ? chain_1 : chain_0).member_count = 0;
+        chains[joined_chain_idx] = joined;
+    }
+
+    // Only now copy the joined polylines into place.
+    for (const Chain& chain : chains)
+    {
+        if (chain.member_count < 2)
+        {
+            continue;
         }
-        // cur_terms -> next_terms has movement map
-        // best_polyline_1 is always removed
-        terminus_tracking_map.updateMap(4U, cur_terms, next_terms, 2U, &cur_terms[2]);
+        ClipperLib::Path points = get_points(chain);
+        clear_members(chain);
+        open_polylines[chain.polyline_idx].getPoints() = std::move(points);
     }
 }
 
@@ -544,40 +579,97 @@ void SlicerLayer::stitch_extensive(OpenLinesSet& open_polylines)
     //  And generate a path over this shortest bit to link up the 2 open polygons.
     //  (If these 2 open polygons are the same polygon, then the final result is a closed polyon)
 
+    // Where the ends of a polyline touch the polygons only changes when the polyline does, so that is looked up once per end rather than for
+    // every pair of polylines. The polygons made here are added after the existing ones, which don't change. So an end that touched none of the
+    // polygons only needs to be checked against the new ones.
+    struct EndOnPolygon
+    {
+        std::optional<ClosePolygonResult> closest;
+        size_t searched_polygon_count = 0;
+    };
+    std::vector<EndOnPolygon> starts_on_polygon(open_polylines.size());
+    std::vector<EndOnPolygon> ends_on_polygon(open_polylines.size());
+    const auto update_end_on_polygon = [this](EndOnPolygon& end_on_polygon, const Point2LL& point)
+    {
+        if (! end_on_polygon.closest && end_on_polygon.searched_polygon_count < polygons_.size())
+        {
+            end_on_polygon.closest = findPolygonPointClosestTo(point, end_on_polygon.searched_polygon_count);
+            end_on_polygon.searched_polygon_count = polygons_.size();
+        }
+    };
+    // For each polygon the length along it up to each vertex, to get the length of any part of it at once.
+    std::vector<std::vector<coord_t>> cumulative_lengths;
+    // For each polygon the polylines that end on it, in order.
+    std::vector<std::vector<size_t>> polylines_ending_on_polygon;
+
     while (1)
     {
+        for (size_t polygon_idx = cumulative_lengths.size(); polygon_idx < polygons_.size(); polygon_idx++)
+        {
+            const Polygon& polygon = polygons_[polygon_idx];
+            std::vector<coord_t>& cumulative_length = cumulative_lengths.emplace_back(1, 0);
+            for (size_t point_idx = 1; point_idx < polygon.size(); point_idx++)
+            {
+                cumulative_length.push_back(cumulative_length.back() + vSize(polygon[point_idx] - polygon[point_idx - 1]));
+            }
+            if (! polygon.empty())
+            {
+                cumulative_length.push_back(cumulative_length.back() + vSize(polygon[0] - polygon.back()));
+            }
+        }
+        polylines_ending_on_polygon.resize(polygons_.size());
+        for (std::vector<size_t>& polylines : polylines_ending_on_polygon)
+        {
+            polylines.clear();
+        }
+        for (size_t polyline_idx = 0; polyline_idx < open_polylines.size(); polyline_idx++)
+        {
+            const OpenPolyline& polyline = open_polylines[polyline_idx];
+            if (polyline.size() < 1)
+                continue;
+
+            update_end_on_polygon(starts_on_polygon[polyline_idx], polyline[0]);
+            update_end_on_polygon(ends_on_polygon[polyline_idx], polyline.back());
+            if (ends_on_polygon[polyline_idx].closest)
+            {
+                polylines_ending_on_polygon[ends_on_polygon[polyline_idx].closest->polygonIdx].push_back(polyline_idx);
+            }
+        }
+
         unsigned int best_polyline_1_idx = -1;
         unsigned int best_polyline_2_idx = -1;
         std::optional<GapCloserResult> best_result;
 
-        for (unsigned int polyline_1_idx = 0; polyline_1_idx < open_polylines.size(); polyline_1_idx++)
+        // Only polylines that start and end on the same polygon can be connected over it.
+        const auto try_connect = [&](const size_t polyline_1_idx, const size_t polyline_2_idx)
+        {
+            const ClosePolygonResult& close_1 = *starts_on_polygon[polyline_1_idx].closest;
+            const ClosePolygonResult& close_2 = *ends_on_polygon[polyline_2_idx].closest;
+            const GapCloserResult res
+                = findPolygonGapCloser(open_polylines[polyline_1_idx][0], open_polylines[polyline_2_idx].back(), close_1, close_2, cumulative_lengths[close_1.polygonIdx]);
+            if (! best_result || res.len < best_result->len)
+            {
+                best_polyline_1_idx = polyline_1_idx;
+                best_polyline_2_idx = polyline_2_idx;
+                best_result = res;
+            }
+        };
+        for (size_t polyline_1_idx = 0; polyline_1_idx < open_polylines.size(); polyline_1_idx++)
         {
-            OpenPolyline& polyline_1 = open_polylines[polyline_1_idx];
-            if (polyline_1.size() < 1)
+            if (open_polylines[polyline_1_idx].size() < 1 || ! starts_on_polygon[polyline_1_idx].closest)
                 continue;
 
+            const size_t polygon_idx = starts_on_polygon[polyline_1_idx].closest->polygonIdx;
+            if (ends_on_polygon[polyline_1_idx].closest && ends_on_polygon[polyline_1_idx].closest->polygonIdx == polygon_idx)
             {
-                std::optional<GapCloserResult> res = findPolygonGapCloser(polyline_1[0], polyline_1.back());
-                if (res && (! best_result || res->len < best_result->len))
-                {
-                    best_polyline_1_idx = polyline_1_idx;
-                    best_polyline_2_idx = polyline_1_idx;
-                    best_result = res;
-                }
+                try_connect(polyline_1_idx, polyline_1_idx);
             }
 
-            for (unsigned int polyline_2_idx = 0; polyline_2_idx < open_polylines.size(); polyline_2_idx++)
+            for (const size_t polyline_2_idx : polylines_ending_on_polygon[polygon_idx])
             {
-                OpenPolyline& polyline_2 = open_polylines[polyline_2_idx];
-                if (polyline_2.size() < 1 || polyline_1_idx == polyline_2_idx)
-                    continue;
-
-                std::optional<GapCloserResult> res = findPolygonGapCloser(polyline_1[0], polyline_2.back());
-                if (res && (! best_result || res->len < best_result->len))
+                if (polyline_1_idx != polyline_2_idx)
                 {
-                    best_polyline_1_idx = polyline_1_idx;
-                    best_polyline_2_idx = polyline_2_idx;
-                    best_result = res;
+                    try_connect(polyline_1_idx, polyline_2_idx);
                 }
             }
         }
@@ -636,6 +728,8 @@ void SlicerLayer::stitch_extensive(OpenLinesSet& open_polylines)
                         open_polylines[best_polyline_2_idx].push_back(open_polylines[best_polyline_1_idx][n]);
                     open_polylines[best_polyline_1_idx].clear();
                 }
+                // The end of polyline 2 moved.
+                ends_on_polygon[best_polyline_2_idx] = EndOnPolygon{};
             }
         }
         else
@@ -645,19 +739,17 @@ void SlicerLayer::stitch_extensive(OpenLinesSet& open_polylines)
     }
 }
 
-std::optional<GapCloserResult> SlicerLayer::findPolygonGapCloser(Point2LL ip0, Point2LL ip1)
+GapCloserResult SlicerLayer::findPolygonGapCloser(
+    Point2LL ip0,
+    Point2LL ip1,
+    const ClosePolygonResult& close_0,
+    const ClosePolygonResult& close_1,
+    const std::vector<coord_t>& cumulative_length) const
 {
-    std::optional<ClosePolygonResult> c1 = findPolygonPointClosestTo(ip0);
-    std::optional<ClosePolygonResult> c2 = findPolygonPointClosestTo(ip1);
-    if (! c1 || ! c2 || c1->polygonIdx != c2->polygonIdx)
-    {
-        return std::nullopt;
-    }
-
     GapCloserResult ret;
-    ret.polygonIdx = c1->polygonIdx;
-    ret.pointIdxA = c1->pointIdx;
-    ret.pointIdxB = c2->pointIdx;
+    ret.polygonIdx = close_0.polygonIdx;
+    ret.pointIdxA = close_0.pointIdx;
+    ret.pointIdxB = close_1.pointIdx;
     ret.AtoB = true;
 
     if (ret.pointIdxA == ret.pointIdxB)
@@ -668,25 +760,17 @@ std::optional<GapCloserResult> SlicerLayer::findPolygonGapCloser(Point2LL ip0, P
     else
     {
         // Find out if we have should go from A to B or the other way around.
-        Point2LL p0 = polygons_[ret.polygonIdx][ret.pointIdxA];
-        int64_t lenA = vSize(p0 - ip0);
-        for (unsigned int i = ret.pointIdxA; i != ret.pointIdxB; i = (i + 1) % polygons_[ret.polygonIdx].size())
-        {
-            Point2LL p1 = polygons_[ret.polygonIdx][i];
-            lenA += vSize(p0 - p1);
-            p0 = p1;
-        }
-        lenA += vSize(p0 - ip1);
-
-        p0 = polygons_[ret.polygonIdx][ret.pointIdxB];
-        int64_t lenB = vSize(p0 - ip1);
-        for (unsigned int i = ret.pointIdxB; i != ret.pointIdxA; i = (i + 1) % polygons_[ret.polygonIdx].size())
+        const Polygon& polygon = polygons_[ret.polygonIdx];
+        const size_t size = polygon.size();
+        // The length along the polygon from one vertex forward to another.
+        const auto length_between = [&cumulative_length, size](const size_t from, const size_t to)
         {
-            Point2LL p1 = polygons_[ret.polygonIdx][i];
-            lenB += vSize(p0 - p1);
-            p0 = p1;
-        }
-        lenB += vSize(p0 - ip0);
+            return to >= from ? cumulative_length[to] - cumulative_length[from] : cumulative_length[size] - cumulative_length[from] + cumulative_length[to];
+        };
+        const size_t before_a = (ret.pointIdxA + size - 1) % size;
+        const size_t before_b = (ret.pointIdxB + size - 1) % size;
+        const int64_t lenA = vSize(polygon[ret.pointIdxA] - ip0) + length_between(ret.pointIdxA, before_b) + vSize(polygon[before_b] - ip1);
+        const int64_t lenB = vSize(polygon[ret.pointIdxB] - ip1) + length_between(ret.pointIdxB, before_a) + vSize(polygon[before_a] - ip0);
 
         if (lenA < lenB)
         {
@@ -702,9 +786,9 @@ std::optional<GapCloserResult> SlicerLayer::findPolygonGapCloser(Point2LL ip0, P
     return ret;
 }
 
-std::optional<ClosePolygonResult> SlicerLayer::findPolygonPointClosestTo(Point2LL input)
+std::optional<ClosePolygonResult> SlicerLayer::findPolygonPointClosestTo(Point2LL input, size_t first_polygon_idx) const
 {
-    for (size_t n = 0; n < polygons_.size(); n++)
+    for (size_t n = first_polygon_idx; n < polygons_.size(); n++)
     {
         Point2LL p0 = polygons_[n][polygons_[n].size() - 1];
         for (size_t i = 0; i < polygons_[n].size(); i++)
@@ -831,9 +915,9 @@ Slicer::Slicer(
         mesh->settings_.get<coord_t>("layer_0_z_overlap"),
         Raft::getFillerLayerCount());
 
-    std::vector<std::pair<int32_t, int32_t>> zbbox = buildZHeightsForFaces(*mesh);
+    const TriangleBuffer triangles = buildTriangleBuffer(*mesh);
 
-    buildSegments(*mesh, zbbox, slicing_tolerance, layers);
+    buildSegments(*mesh, triangles, slicing_tolerance, layers);
 
     spdlog::info("Slice of mesh took {:03.3f} seconds", slice_timer.restart());
 
@@ -842,135 +926,107 @@ Slicer::Slicer(
     spdlog::info("Make polygons took {:03.3f} seconds", slice_timer.restart());
 }
 
-void Slicer::buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t, int32_t>>& zbbox, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers)
+void Slicer::buildSegments(const Mesh& mesh, const TriangleBuffer& triangles, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers)
 {
-    cura::parallel_for(
-        layers,
-        [&](auto layer_it)
+    // Rather than checking every triangle against every layer, find the range of layers that each triangle crosses by its Z extents, and group
+    // the triangles per layer. Within a layer they stay in the order of the faces.
+    std::vector<size_t> layers_by_z(layers.size());
+    std::iota(layers_by_z.begin(), layers_by_z.end(), 0);
+    std::stable_sort(
+        layers_by_z.begin(),
+        layers_by_z.end(),
+        [&layers](const size_t a, const size_t b)
         {
-            SlicerLayer& layer = *layer_it;
+            return layers[a].z_ < layers[b].z_;
+        });
+    std::vector<coord_t> sorted_z(layers.size());
+    for (size_t position = 0; position < layers.size(); ++position)
+    {
+        sorted_z[position] = layers[layers_by_z[position]].z_;
+    }
+    std::vector<std::pair<size_t, size_t>> face_layer_ranges(triangles.z_extents.size());
+    std::vector<size_t> face_starts(layers.size() + 1, 0); // Where the faces of each layer start in the faces of all layers.
+    for (size_t face_idx = 0; face_idx < triangles.z_extents.size(); ++face_idx)
+    {
+        const auto [min_z, max_z] = triangles.z_extents[face_idx];
+        const size_t first = std::lower_bound(sorted_z.begin(), sorted_z.end(), min_z) - sorted_z.begin();
+        const size_t last = std::upper_bound(sorted_z.begin() + first, sorted_z.end(), max_z) - sorted_z.begin();
+        face_layer_ranges[face_idx] = { first, last };
+        for (size_t position = first; position < last; ++position)
+        {
+            face_starts[layers_by_z[position] + 1]++;
+        }
+    }
+    std::partial_sum(face_starts.begin(), face_starts.end(), face_starts.begin());
+    std::vector<uint32_t> faces_per_layer(face_starts.back());
+    std::vector<size_t> next_face = face_starts;
+    for (size_t face_idx = 0; face_idx < face_layer_ranges.size(); ++face_idx)
+    {
+        for (size_t position = face_layer_ranges[face_idx].first; position < face_layer_ranges[face_idx].second; ++position)
+        {
+            faces_per_layer[next_face[layers_by_z[position]]++] = static_cast<uint32_t>(face_idx);
+        }
+    }
+
+    const bool has_uv_coordinates = ! triangles.uv_coordinates.empty();
+    cura::parallel_for<size_t>(
+        0,
+        layers.size(),
+        [&](const size_t layer_idx)
+        {
+            SlicerLayer& layer = layers[layer_idx];
             const int32_t& z = layer.z_;
-            layer.segments_.reserve(100);
+            layer.segments_.reserve(face_starts[layer_idx + 1] - face_starts[layer_idx]);
 
-            // loop over all mesh faces
-            for (unsigned int face_idx = 0; face_idx < mesh.faces_.size(); face_idx++)
+            // loop over the mesh faces that cross this layer
+            for (size_t face_position = face_starts[layer_idx]; face_position < face_starts[layer_idx + 1]; face_position++)
             {
-                if ((z < zbbox[face_idx].first) || (z > zbbox[face_idx].second))
-                {
-                    continue;
-                }
-
-                // get all vertices per face
-                const MeshFace& face = mesh.faces_[face_idx];
-                const MeshVertex& v0 = mesh.vertices_[face.vertex_index_[0]];
-                const MeshVertex& v1 = mesh.vertices_[face.vertex_index_[1]];
-                const MeshVertex& v2 = mesh.vertices_[face.vertex_index_[2]];
-                const std::optional<Point2F> uv0 = face.uv_coordinates_[0];
-                const std::optional<Point2F> uv1 = face.uv_coordinates_[1];
-                const std::optional<Point2F> uv2 = face.uv_coordinates_[2];
+                const uint32_t face_idx = faces_per_layer[face_position];
 
                 // get all vertices represented as 3D point
-                Point3LL p0 = v0.p_;
-                Point3LL p1 = v1.p_;
-                Point3LL p2 = v2.p_;
+                std::array<Point3LL, 3> p = triangles.corners[face_idx];
 
                 // Compensate for points exactly on the slice-boundary, except for 'inclusive', which already handles this correctly.
                 if (slicing_tolerance != SlicingTolerance::INCLUSIVE)
                 {
-                    p0.z_ += static_cast<int>(p0.z_ == z) * -static_cast<int>(p0.z_ < 1);
-                    p1.z_ += static_cast<int>(p1.z_ == z) * -static_cast<int>(p1.z_ < 1);
-                    p2.z_ += static_cast<int>(p2.z_ == z) * -static_cast<int>(p2.z_ < 1);
-                }
-
-                SlicerSegment s;
-                s.endVertex = nullptr;
-                int end_edge_idx = -1;
-
-                /*
-                Now see if the triangle intersects the layer, and if so, where.
-
-                Edge cases are important here:
-                - If all three vertices of the triangle are exactly on the layer,
-                  don't count the triangle at all, because if the model is
-                  watertight, there will be adjacent triangles on all 3 sides that
-                  are not flat on the layer.
-                - If two of the vertices are exactly on the layer, only count the
-                  triangle if the last vertex is going up. We can't count both
-                  upwards and downwards triangles here, because if the model is
-                  manifold there will always be an adjacent triangle that is going
-                  the other way and you'd get double edges. You would also get one
-                  layer too many if the total model height is an exact multiple of
-                  the layer thickness. Between going up and going down, we need to
-                  choose the triangles going up, because otherwise the first layer
-                  of where the model starts will be empty and the model will float
-                  in mid-air. We'd much rather let the last layer be empty in that
-                  case.
-                - If only one of the vertices is exactly on the layer, the
-                  intersection between the triangle and the plane would be a point.
-                  We can't print points and with a manifold model there would be
-                  line segments adjacent to the point on both sides anyway, so we
-                  need to discard this 0-length line segment then.
-                - Vertices in ccw order if look from outside.
-                */
-
-                if (p0.z_ < z && p1.z_ > z && p2.z_ > z) //  1_______2
-                { //   \     /
-                    s = project2D(p0, p2, p1, uv0, uv2, uv1, z); //------------- z
-                    end_edge_idx = 0; //     \ /
-                } //      0
-
-                else if (p0.z_ > z && p1.z_ <= z && p2.z_ <= z) //      0
-                { //     / \      .
-                    s = project2D(p0, p1, p2, uv0, uv1, uv2, z); //------------- z
-                    end_edge_idx = 2; //   /     \    .
-                    if (p2.z_ == z) //  1_______2
-                    {
-                        s.endVertex = &v2;
-                    }
-                }
-
-                else if (p1.z_ < z && p0.z_ > z && p2.z_ > z) //  0_______2
-                { //   \     /
-                    s = project2D(p1, p0, p2, uv1, uv0, uv2, z); //------------- z
-                    end_edge_idx = 1; //     \ /
-                } //      1
-
-                else if (p1.z_ > z && p0.z_ <= z && p2.z_ <= z) //      1
-                { //     / \      .
-                    s = project2D(p1, p2, p0, uv1, uv2, uv0, z); //------------- z
-                    end_edge_idx = 0; //   /     \    .
-                    if (p0.z_ == z) //  0_______2
+                    for (Point3LL& corner : p)
                     {
-                        s.endVertex = &v0;
+                        corner.z_ += static_cast<int>(corner.z_ == z) * -static_cast<int>(corner.z_ < 1);
                     }
                 }
 
-                else if (p2.z_ < z && p1.z_ > z && p0.z_ > z) //  0_______1
-                { //   \     /
-                    s = project2D(p2, p1, p0, uv2, uv1, uv0, z); //------------- z
-                    end_edge_idx = 2; //     \ /
-                } //      2
-
-                else if (p2.z_ > z && p1.z_ <= z && p0.z_ <= z) //      2
-                { //     / \      .
-                    s = project2D(p2, p0, p1, uv2, uv0, uv1, z); //------------- z
-                    end_edge_idx = 1; //   /     \    .
-                    if (p1.z_ == z) //  0_______1
-                    {
-                        s.endVertex = &v1;
-                    }
+                // Whether each corner is below, on or above the layer decides how the triangle crosses it.
+                size_t crossing_idx = 0;
+                for (size_t corner_idx = 3; corner_idx-- > 0;)
+                {
+                    crossing_idx = crossing_idx * 3 + static_cast<size_t>(p[corner_idx].z_ >= z) + static_cast<size_t>(p[corner_idx].z_ > z);
                 }
-                else
+                const TriangleCrossing& crossing = triangle_crossings[crossing_idx];
+                if (! crossing.crosses)
                 {
                     // Not all cases create a segment, because a point of a face could create just a dot, and two touching faces
                     //   on the slice would create two segments
                     continue;
                 }
 
+                const auto [idx_0, idx_1, idx_2] = crossing.order;
+                SlicerSegment s;
+                if (has_uv_coordinates)
+                {
+                    const std::array<std::optional<Point2F>, 3>& uv = triangles.uv_coordinates[face_idx];
+                    s = project2D(p[idx_0], p[idx_1], p[idx_2], uv[idx_0], uv[idx_1], uv[idx_2], z);
+                }
+                else
+                {
+                    s = project2D(p[idx_0], p[idx_1], p[idx_2], z);
+                }
+                const MeshFace& face = mesh.faces_[face_idx];
+                s.endVertex = crossing.end_vertex_idx >= 0 ? &mesh.vertices_[face.vertex_index_[crossing.end_vertex_idx]] : nullptr;
+
                 // store the segments per layer
                 layer.face_idx_to_segment_idx_.insert(std::make_pair(face_idx, layer.segments_.size()));
                 s.faceIndex = face_idx;
-                s.endOtherFaceIdx = face.connected_face_index_[end_edge_idx];
+                s.endOtherFaceIdx = face.connected_face_index_[crossing.end_edge_idx];
                 s.addedToPolygon = false;
                 layer.segments_.push_back(s);
             }
@@ -1118,47 +1174,41 @@ void Slicer::makePolygons(Mesh& mesh, SlicingTolerance slicing_tolerance, std::v
 }
 
 
-std::vector<std::pair<int32_t, int32_t>> Slicer::buildZHeightsForFaces(const Mesh& mesh)
+Slicer::TriangleBuffer Slicer::buildTriangleBuffer(const Mesh& mesh)
 {
-    std::vector<std::pair<int32_t, int32_t>> zHeights;
-    zHeights.reserve(mesh.faces_.size());
-    for (const auto& face : mesh.faces_)
+    TriangleBuffer triangles;
+    triangles.z_extents.reserve(mesh.faces_.size());
+    triangles.corners.reserve(mesh.faces_.size());
+    const bool has_uv_coordinates = std::any_of(
+        mesh.faces_.begin(),
+        mesh.faces_.end(),
+        [](const MeshFace& face)
+        {
+            return face.uv_coordinates_[0].has_value() || face.uv_coordinates_[1].has_value() || face.uv_coordinates_[2].has_value();
+        });
+    if (has_uv_coordinates)
     {
-        // const MeshFace& face = mesh.faces[mesh_idx];
-        const MeshVertex& v0 = mesh.vertices_[face.vertex_index_[0]];
-        const MeshVertex& v1 = mesh.vertices_[face.vertex_index_[1]];
-        const MeshVertex& v2 = mesh.vertices_[face.vertex_index_[2]];
+        triangles.uv_coordinates.reserve(mesh.faces_.size());
+    }
 
+    for (const MeshFace& face : mesh.faces_)
+    {
         // get all vertices represented as 3D point
-        Point3LL p0 = v0.p_;
-        Point3LL p1 = v1.p_;
-        Point3LL p2 = v2.p_;
+        const std::array<Point3LL, 3>& corners = triangles.corners.emplace_back(
+            std::array<Point3LL, 3>{ mesh.vertices_[face.vertex_index_[0]].p_, mesh.vertices_[face.vertex_index_[1]].p_, mesh.vertices_[face.vertex_index_[2]].p_ });
 
         // find the minimum and maximum z point
-        int32_t minZ = p0.z_;
-        if (p1.z_ < minZ)
-        {
-            minZ = p1.z_;
-        }
-        if (p2.z_ < minZ)
-        {
-            minZ = p2.z_;
-        }
+        const int32_t min_z = static_cast<int32_t>(std::min({ corners[0].z_, corners[1].z_, corners[2].z_ }));
+        const int32_t max_z = static_cast<int32_t>(std::max({ corners[0].z_, corners[1].z_, corners[2].z_ }));
+        triangles.z_extents.emplace_back(min_z, max_z);
 
-        int32_t maxZ = p0.z_;
-        if (p1.z_ > maxZ)
-        {
-            maxZ = p1.z_;
-        }
-        if (p2.z_ > maxZ)
+        if (has_uv_coordinates)
         {
-            maxZ = p2.z_;
+            triangles.uv_coordinates.push_back({ face.uv_coordinates_[0], face.uv_coordinates_[1], face.uv_coordinates_[2] });
         }
-
-        zHeights.emplace_back(std::make_pair(minZ, maxZ));
     }
 
-    return zHeights;
+    return triangles;
 }
 
 SlicerSegment Slicer::project2D(
@@ -1170,12 +1220,7 @@ SlicerSegment Slicer::project2D(
     const std::optional<Point2F>& uv2,
     const coord_t z)
 {
-    SlicerSegment seg;
-
-    seg.start.X = interpolate(z, p0.z_, p1.z_, p0.x_, p1.x_);
-    seg.start.Y = interpolate(z, p0.z_, p1.z_, p0.y_, p1.y_);
-    seg.end.X = interpolate(z, p0.z_, p2.z_, p0.x_, p2.x_);
-    seg.end.Y = interpolate(z, p0.z_, p2.z_, p0.y_, p2.y_);
+    SlicerSegment seg = project2D(p0, p1, p2, z);
 
     if (uv0.has_value() && uv1.has_value() && uv2.has_value())
     {
@@ -1192,6 +1237,18 @@ SlicerSegment Slicer::project2D(
     return seg;
 }
 
+SlicerSegment Slicer::project2D(const Point3LL& p0, const Point3LL& p1, const Point3LL& p2, const coord_t z)
+{
+    SlicerSegment seg;
+
+    seg.start.X = interpolate(z, p0.z_, p1.z_, p0.x_, p1.x_);
+    seg.start.Y = interpolate(z, p0.z_, p1.z_, p0.y_, p1.y_);
+    seg.end.X = interpolate(z, p0.z_, p2.z_, p0.x_, p2.x_);
+    seg.end.Y = interpolate(z, p0.z_, p2.z_, p0.y_, p2.y_);
+
+    return seg;
+}
+
 std::optional<Point3D> Slicer::getBarycentricCoordinates(const Point3LL& point, const Point3LL& p0, const Point3LL& p1, const Point3LL& p2)
 {
     // Calculate vectors from p0 to p1 and p0 to p2
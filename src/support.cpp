@@ -805,6 +805,10 @@ void AreaSupport::generateOverhangAreasForMesh(SliceDataStorage& storage, SliceM
     cura::parallel_for<size_t>(
         1,
         storage.print_layer_count,
+        [&mesh](const size_t layer_idx)
+        {
+            return mesh.layers[layer_idx].pointCount();
+        },
         [&](const size_t layer_idx)
         {
             std::pair<Shape, Shape> basic_and_full_overhang = computeBasicAndFullOverhang(storage, mesh, layer_idx);
@@ -60,6 +60,15 @@ void TimeEstimateCalculator::reset()
     blocks.clear();
 }
 
+TimeEstimateCalculator TimeEstimateCalculator::detachPlan()
+{
+    TimeEstimateCalculator detached;
+    detached.blocks = std::move(blocks);
+    detached.extra_time = extra_time;
+    reset();
+    return detached;
+}
+
 // Calculates the maximum allowable speed at this point when you must be able to reach target_velocity using the
 // acceleration within the allotted distance.
 static inline Velocity maxAllowableSpeed(const Acceleration& acceleration, const Velocity& target_velocity, double distance)
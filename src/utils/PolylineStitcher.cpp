@@ -146,71 +146,70 @@ void PolylineStitcher<InputPaths, OutputPaths, Path, Junction>::stitch(
                 grid.processNearby(
                     from,
                     max_stitch_distance,
-                    std::function<bool(const PathsPointIndex<InputPaths>&)>(
-                        [from,
-                         &chain,
-                         &closest,
-                         &closest_is_closing_polygon,
-                         &closest_distance,
-                         &processed,
-                         &chain_length,
-                         go_in_reverse_direction,
-                         max_stitch_distance,
-                         snap_distance,
-                         should_close](const PathsPointIndex<InputPaths>& nearby) -> bool
+                    [from,
+                     &chain,
+                     &closest,
+                     &closest_is_closing_polygon,
+                     &closest_distance,
+                     &processed,
+                     &chain_length,
+                     go_in_reverse_direction,
+                     max_stitch_distance,
+                     snap_distance,
+                     should_close](const PathsPointIndex<InputPaths>& nearby) -> bool
+                    {
+                        bool is_closing_segment = false;
+                        coord_t dist = vSize(nearby.p() - from);
+                        if (dist > max_stitch_distance)
+                        {
+                            return true; // keep looking
+                        }
+                        if (vSize2(nearby.p() - make_point(chain.front())) < snap_distance * snap_distance)
                         {
-                            bool is_closing_segment = false;
-                            coord_t dist = vSize(nearby.p() - from);
-                            if (dist > max_stitch_distance)
+                            if (chain_length + dist < 3 * max_stitch_distance // prevent closing of small poly, cause it might be able to continue making a larger polyline
+                                || chain.size() <= 2) // don't make 2 vert polygons
                             {
-                                return true; // keep looking
+                                return true; // look for a better next line
                             }
-                            if (vSize2(nearby.p() - make_point(chain.front())) < snap_distance * snap_distance)
+                            is_closing_segment = true;
+                            if (! should_close)
                             {
-                                if (chain_length + dist < 3 * max_stitch_distance // prevent closing of small poly, cause it might be able to continue making a larger polyline
-                                    || chain.size() <= 2) // don't make 2 vert polygons
-                                {
-                                    return true; // look for a better next line
-                                }
-                                is_closing_segment = true;
-                                if (! should_close)
-                                {
-                                    dist += 10; // prefer continuing polyline over closing a polygon; avoids closed zigzags from being printed separately
-                                    // continue to see if closing segment is also the closest
-                                    // there might be a segment smaller than [max_stitch_distance] which closes the polygon better
-                                }
-                                else
-                                {
-                                    dist -= 10; // Prefer closing the polygon if it's 100% even lines. Used to create closed contours.
-                                    // Continue to see if closing segment is also the closest.
-                                }
-                            }
-                            else if (processed[nearby.poly_idx_])
-                            { // it was already moved to output
-                                return true; // keep looking for a connection
+                                dist += 10; // prefer continuing polyline over closing a polygon; avoids closed zigzags from being printed separately
+                                // continue to see if closing segment is also the closest
+                                // there might be a segment smaller than [max_stitch_distance] which closes the polygon better
                             }
-                            bool nearby_would_be_reversed = nearby.point_idx_ != 0;
-                            nearby_would_be_reversed = nearby_would_be_reversed != go_in_reverse_direction; // flip nearby_would_be_reversed when searching in the reverse direction
-                            if (! canReverse(nearby) && nearby_would_be_reversed)
-                            { // connecting the segment would reverse the polygon direction
-                                return true; // keep looking for a connection
-                            }
-                            if (! canConnect(chain, (*nearby.polygons_)[nearby.poly_idx_]))
+                            else
                             {
-                                return true; // keep looking for a connection
+                                dist -= 10; // Prefer closing the polygon if it's 100% even lines. Used to create closed contours.
+                                // Continue to see if closing segment is also the closest.
                             }
-                            if (dist < closest_distance)
-                            {
-                                closest_distance = dist;
-                                closest = nearby;
-                                closest_is_closing_polygon = is_closing_segment;
-                            }
-                            if (dist < snap_distance)
-                            { // we have found a good enough next line
-                                return false; // stop looking for alternatives
-                            }
-                            return true; // keep processing elements
-                        }));
+                        }
+                        else if (processed[nearby.poly_idx_])
+                        { // it was already moved to output
+                            return true; // keep looking for a connection
+                        }
+                        bool nearby_would_be_reversed = nearby.point_idx_ != 0;
+                        nearby_would_be_reversed = nearby_would_be_reversed != go_in_reverse_direction; // flip nearby_would_be_reversed when searching in the reverse direction
+                        if (! canReverse(nearby) && nearby_would_be_reversed)
+                        { // connecting the segment would reverse the polygon direction
+                            return true; // keep looking for a connection
+                        }
+                        if (! canConnect(chain, (*nearby.polygons_)[nearby.poly_idx_]))
+                        {
+                            return true; // keep looking for a connection
+                        }
+                        if (dist < closest_distance)
+                        {
+                            closest_distance = dist;
+                            closest = nearby;
+                            closest_is_closing_polygon = is_closing_segment;
+                        }
+                        if (dist < snap_distance)
+                        { // we have found a good enough next line
+                            return false; // stop looking for alternatives
+                        }
+                        return true; // keep processing elements
+                    });
 
                 if (! closest.initialized() // we couldn't find any next line
                     || closest_is_closing_polygon // we closed the polygon
@@ -0,0 +1,205 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "utils/ShapeSegmentGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "geometry/Polygon.h"
+#include "geometry/Shape.h"
+#include "utils/linearAlg2D.h"
+
+namespace cura
+{
+
+/*!
+ * How far segments are put in the cells around them, so that intersections which are only found because of rounding are not missed.
+ */
+constexpr coord_t rounding_margin = 10;
+
+/*!
+ * The contribution of a single polygon edge to a point-in-polygon test with a ray in positive X direction, as done by ClipperLib::PointInPolygon.
+ * \return -1 if the point is on the edge, 1 if the ray crosses the edge and 0 otherwise.
+ */
+static int pointCrossing(const Point2LL& p, const Point2LL& ip, const Point2LL& ip_next)
+{
+    if (ip_next.Y == p.Y)
+    {
+        if (ip_next.X == p.X || (ip.Y == p.Y && ((ip_next.X > p.X) == (ip.X < p.X))))
+        {
+            return -1;
+        }
+    }
+    if ((ip.Y < p.Y) == (ip_next.Y < p.Y))
+    {
+        return 0;
+    }
+    if (ip.X >= p.X && ip_next.X > p.X)
+    {
+        return 1;
+    }
+    if (ip.X < p.X && ip_next.X <= p.X)
+    {
+        return 0;
+    }
+    const double d = static_cast<double>(ip.X - p.X) * static_cast<double>(ip_next.Y - p.Y) - static_cast<double>(ip_next.X - p.X) * static_cast<double>(ip.Y - p.Y);
+    if (d == 0.0)
+    {
+        return -1;
+    }
+    return (d > 0) == (ip_next.Y > ip.Y) ? 1 : 0;
+}
+
+ShapeSegmentGrid::ShapeSegmentGrid(const Shape& shape)
+{
+    for (const Polygon& polygon : shape)
+    {
+        // Just like ClipperLib::PointInPolygon, ignore degenerate polygons when locating points. Shape::intersectionsWithSegment does use their segments.
+        const bool encloses = polygon.size() >= 3;
+        for (auto iterator = polygon.beginSegments(); iterator != polygon.endSegments(); ++iterator)
+        {
+            segments_.push_back(Segment{ (*iterator).start, (*iterator).end, encloses });
+            bounding_box_.include((*iterator).start);
+            bounding_box_.include((*iterator).end);
+        }
+    }
+    if (segments_.empty())
+    {
+        return;
+    }
+    bounding_box_.expand(rounding_margin);
+
+    // About as many cells as there are segments, so that a typical cell holds a few of them.
+    const double width = static_cast<double>(bounding_box_.max_.X - bounding_box_.min_.X + 1);
+    const double height = static_cast<double>(bounding_box_.max_.Y - bounding_box_.min_.Y + 1);
+    cell_size_ = std::max(coord_t(1), static_cast<coord_t>(std::ceil(std::sqrt(width * height / static_cast<double>(segments_.size())))));
+    columns_ = static_cast<coord_t>(width) / cell_size_ + 1;
+    rows_ = static_cast<coord_t>(height) / cell_size_ + 1;
+
+    // Fill both bucketings with a counting sort: first count the segments per bucket, then put them at their place.
+    row_starts_.assign(rows_ + 1, 0);
+    cell_starts_.assign(rows_ * columns_ + 1, 0);
+    const auto for_each_bucket = [this](const Segment& segment, auto&& row_func, auto&& cell_func)
+    {
+        const coord_t min_y = std::min(segment.start.Y, segment.end.Y);
+        const coord_t max_y = std::max(segment.start.Y, segment.end.Y);
+        if (segment.encloses)
+        {
+            for (coord_t row = toRow(min_y); row <= toRow(max_y); ++row)
+            {
+                row_func(row);
+            }
+        }
+        const coord_t min_column = toColumn(std::min(segment.start.X, segment.end.X) - rounding_margin);
+        const coord_t max_column = toColumn(std::max(segment.start.X, segment.end.X) + rounding_margin);
+        for (coord_t row = toRow(min_y - rounding_margin); row <= toRow(max_y + rounding_margin); ++row)
+        {
+            for (coord_t column = min_column; column <= max_column; ++column)
+            {
+                cell_func(row * columns_ + column);
+            }
+        }
+    };
+    for (const Segment& segment : segments_)
+    {
+        for_each_bucket(
+            segment,
+            [this](const coord_t row)
+            {
+                row_starts_[row + 1]++;
+            },
+            [this](const coord_t cell)
+            {
+                cell_starts_[cell + 1]++;
+            });
+    }
+    std::partial_sum(row_starts_.begin(), row_starts_.end(), row_starts_.begin());
+    std::partial_sum(cell_starts_.begin(), cell_starts_.end(), cell_starts_.begin());
+
+    row_segments_.resize(row_starts_.back());
+    cell_segments_.resize(cell_starts_.back());
+    std::vector<size_t> row_fill(row_starts_.begin(), row_starts_.end() - 1);
+    std::vector<size_t> cell_fill(cell_starts_.begin(), cell_starts_.end() - 1);
+    for (size_t segment_idx = 0; segment_idx < segments_.size(); ++segment_idx)
+    {
+        for_each_bucket(
+            segments_[segment_idx],
+            [this, &row_fill, segment_idx](const coord_t row)
+            {
+                row_segments_[row_fill[row]++] = segment_idx;
+            },
+            [this, &cell_fill, segment_idx](const coord_t cell)
+            {
+                cell_segments_[cell_fill[cell]++] = segment_idx;
+            });
+    }
+}
+
+coord_t ShapeSegmentGrid::toRow(const coord_t y) const
+{
+    return std::clamp((y - bounding_box_.min_.Y) / cell_size_, coord_t(0), rows_ - 1);
+}
+
+coord_t ShapeSegmentGrid::toColumn(const coord_t x) const
+{
+    return std::clamp((x - bounding_box_.min_.X) / cell_size_, coord_t(0), columns_ - 1);
+}
+
+bool ShapeSegmentGrid::inside(const Point2LL& p, bool border_result) const
+{
+    if (segments_.empty() || ! bounding_box_.contains(p))
+    {
+        return false;
+    }
+
+    // The horizontal ray can only cross or touch the segments that overlap the row of the point vertically.
+    const coord_t row = toRow(p.Y);
+    bool is_inside = false;
+    for (size_t index = row_starts_[row]; index < row_starts_[row + 1]; ++index)
+    {
+        const Segment& segment = segments_[row_segments_[index]];
+        const int crossing = pointCrossing(p, segment.start, segment.end);
+        if (crossing == -1)
+        {
+            return border_result;
+        }
+        is_inside ^= crossing == 1;
+    }
+    return is_inside;
+}
+
+std::vector<float> ShapeSegmentGrid::intersectionsWithSegment(const Point2LL& start, const Point2LL& end) const
+{
+    std::vector<float> result;
+    const AABB query_box{ start, end };
+    if (segments_.empty() || ! bounding_box_.hit(query_box))
+    {
+        return result;
+    }
+
+    std::vector<size_t> candidates;
+    const coord_t min_column = toColumn(query_box.min_.X);
+    const coord_t max_column = toColumn(query_box.max_.X);
+    for (coord_t row = toRow(query_box.min_.Y); row <= toRow(query_box.max_.Y); ++row)
+    {
+        const size_t row_offset = row * columns_;
+        candidates.insert(candidates.end(), cell_segments_.begin() + cell_starts_[row_offset + min_column], cell_segments_.begin() + cell_starts_[row_offset + max_column + 1]);
+    }
+    // Segments can be in multiple cells, but should only be reported once.
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for (const size_t segment_idx : candidates)
+    {
+        float t, u;
+        if (LinearAlg2D::segmentSegmentIntersection(start, end, segments_[segment_idx].start, segments_[segment_idx].end, t, u))
+        {
+            result.push_back(t);
+        }
+    }
+    return result;
+}
+
+} // namespace cura
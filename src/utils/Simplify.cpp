@@ -97,22 +97,59 @@ ExtrusionLine Simplify::polyline(const ExtrusionLine& polyline) const
     return simplify(polyline, is_closed);
 }
 
-size_t Simplify::nextNotDeleted(size_t index, const std::vector<bool>& to_delete) const
+Simplify::RemainingVertices::RemainingVertices(const size_t size)
+    : next_(size)
+    , previous_(size)
+    , deleted_(size, false)
 {
-    const size_t size = to_delete.size();
-    for (index = (index + 1) % size; to_delete[index]; index = (index + 1) % size)
-        ; // Changes the index variable in-place until we found one that is not deleted.
+    for (size_t index = 0; index < size; ++index)
+    {
+        next_[index] = (index + 1) % size;
+        previous_[index] = (index + size - 1) % size;
+    }
+}
+
+bool Simplify::RemainingVertices::isDeleted(const size_t index) const
+{
+    return deleted_[index];
+}
+
+void Simplify::RemainingVertices::remove(const size_t index)
+{
+    if (deleted_[index])
+    {
+        return;
+    }
+    deleted_[index] = true;
+    next_[previous_[index]] = next_[index];
+    previous_[next_[index]] = previous_[index];
+}
+
+size_t Simplify::RemainingVertices::next(size_t index) const
+{
+    // The vertex that followed a deleted vertex may have been deleted later on. Its own next vertex is then further along, never before it.
+    for (index = next_[index]; deleted_[index]; index = next_[index])
+        ;
     return index;
 }
 
-size_t Simplify::previousNotDeleted(size_t index, const std::vector<bool>& to_delete) const
+size_t Simplify::RemainingVertices::previous(size_t index) const
 {
-    const size_t size = to_delete.size();
-    for (index = (index + size - 1) % size; to_delete[index]; index = (index + size - 1) % size)
-        ; // Changes the index variable in-place until we found one that is not deleted.
+    for (index = previous_[index]; deleted_[index]; index = previous_[index])
+        ;
     return index;
 }
 
+size_t Simplify::nextNotDeleted(size_t index, const RemainingVertices& to_delete) const
+{
+    return to_delete.next(index);
+}
+
+size_t Simplify::previousNotDeleted(size_t index, const RemainingVertices& to_delete) const
+{
+    return to_delete.previous(index);
+}
+
 template<>
 ExtrusionLine Simplify::createEmpty(const ExtrusionLine& original)
 {
@@ -242,7 +279,7 @@ Polygonal Simplify::simplify(const Polygonal& polygon, const bool is_closed) con
         return polygon;
     }
 
-    std::vector<bool> to_delete(polygon.size(), false);
+    RemainingVertices to_delete(polygon.size());
     auto comparator = [](const std::pair<size_t, coord_t>& vertex_a, const std::pair<size_t, coord_t>& vertex_b)
     {
         return vertex_a.second > vertex_b.second || (vertex_a.second == vertex_b.second && vertex_a.first > vertex_b.first);
@@ -257,7 +294,7 @@ Polygonal Simplify::simplify(const Polygonal& polygon, const bool is_closed) con
         // Add the initial points.
         for (size_t i = 0; i < result.size(); ++i)
         {
-            if (to_delete[i])
+            if (to_delete.isDeleted(i))
             {
                 continue;
             }
@@ -291,7 +328,7 @@ Polygonal Simplify::simplify(const Polygonal& polygon, const bool is_closed) con
     Polygonal filtered = createEmpty(polygon);
     for (size_t i = 0; i < result.size(); ++i)
     {
-        if (! to_delete[i])
+        if (! to_delete.isDeleted(i))
         {
             appendVertex(filtered, result[i]);
         }
@@ -305,7 +342,7 @@ Polygonal Simplify::simplify(const Polygonal& polygon, const bool is_closed) con
 }
 
 template<typename Polygonal>
-coord_t Simplify::importance(const Polygonal& polygon, const std::vector<bool>& to_delete, const size_t index, const bool is_closed) const
+coord_t Simplify::importance(const Polygonal& polygon, const RemainingVertices& to_delete, const size_t index, const bool is_closed) const
 {
     const size_t poly_size = polygon.size();
     if (! is_closed && (index == 0 || index == poly_size - 1))
@@ -339,13 +376,13 @@ coord_t Simplify::importance(const Polygonal& polygon, const std::vector<bool>&
 }
 
 template<typename Polygonal>
-bool Simplify::remove(Polygonal& polygon, std::vector<bool>& to_delete, const size_t vertex, const coord_t deviation2, const bool is_closed) const
+bool Simplify::remove(Polygonal& polygon, RemainingVertices& to_delete, const size_t vertex, const coord_t deviation2, const bool is_closed) const
 {
     if (deviation2 <= min_resolution * min_resolution)
     {
         // At less than the minimum resolution we're always allowed to delete the vertex.
         // Even if the adjacent line segments are very long.
-        to_delete[vertex] = true;
+        to_delete.remove(vertex);
         return true;
     }
 
@@ -360,7 +397,7 @@ bool Simplify::remove(Polygonal& polygon, std::vector<bool>& to_delete, const si
     if (length2_before <= max_resolution_ * max_resolution_ && length2_after <= max_resolution_ * max_resolution_) // Both adjacent line segments are short.
     {
         // Removing this vertex does little harm. No long lines will be shifted.
-        to_delete[vertex] = true;
+        to_delete.remove(vertex);
         return true;
     }
 
@@ -401,7 +438,7 @@ bool Simplify::remove(Polygonal& polygon, std::vector<bool>& to_delete, const si
     const coord_t intersection_deviation = LinearAlg2D::getDist2FromLineSegment(before_to, intersection, after_from);
     if (intersection_deviation <= max_deviation_ * max_deviation_) // Intersection point doesn't deviate too much. Use it!
     {
-        to_delete[vertex] = true;
+        to_delete.remove(vertex);
         polygon[length2_before <= length2_after ? before : after] = createIntersection(polygon[before], intersection, polygon[after]);
         return true;
     }
@@ -0,0 +1,241 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "utils/Tracing.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/writer.h>
+#include <spdlog/spdlog.h>
+
+namespace cura::tracing
+{
+
+std::atomic<bool> enabled{ false };
+
+namespace
+{
+
+struct Event
+{
+    const char* name;
+    int64_t argument;
+    int64_t begin_ns; //!< Since the epoch of the steady clock
+    int64_t duration_ns;
+};
+
+constexpr size_t buffer_capacity = 1 << 16; //!< Number of events kept per thread.
+
+/*!
+ * The ring buffer of one thread. Only that thread writes to it.
+ */
+struct ThreadBuffer
+{
+    explicit ThreadBuffer(const size_t index)
+        : thread_index(index)
+        , events(buffer_capacity)
+    {
+    }
+
+    size_t thread_index;
+    std::vector<Event> events;
+    std::atomic<size_t> written{ 0 }; //!< Total number of events recorded, including the overwritten ones.
+};
+
+struct CallSiteLoad
+{
+    size_t calls = 0;
+    std::chrono::steady_clock::duration busy_time{}; //!< Summed over all workers.
+    std::chrono::steady_clock::duration available_time{}; //!< Wall time times the number of workers.
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers; //!< Kept after their thread ends, so that its spans are still written.
+    std::filesystem::path trace_file;
+    int64_t origin_ns = 0; //!< When recording started, since the epoch of the steady clock
+    std::map<std::pair<std::string_view, uint_least32_t>, CallSiteLoad> parallel_for_loads; //!< Per file and line.
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+int64_t toNanoseconds(const std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+ThreadBuffer& threadBuffer()
+{
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr)
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.buffers.push_back(std::make_unique<ThreadBuffer>(reg.buffers.size()));
+        buffer = reg.buffers.back().get();
+    }
+    return *buffer;
+}
+
+void logParallelForLoads(const Registry& reg)
+{
+    std::vector<std::pair<std::pair<std::string_view, uint_least32_t>, CallSiteLoad>> loads(reg.parallel_for_loads.begin(), reg.parallel_for_loads.end());
+    const auto idle_time = [](const CallSiteLoad& load)
+    {
+        return load.available_time - load.busy_time;
+    };
+    std::sort(
+        loads.begin(),
+        loads.end(),
+        [&idle_time](const auto& a, const auto& b)
+        {
+            return idle_time(a.second) > idle_time(b.second);
+        });
+    for (const auto& [call_site, load] : loads)
+    {
+        const double available_seconds = std::chrono::duration<double>(load.available_time).count();
+        spdlog::info(
+            "parallel_for at {}:{} ran {} times, with the workers idle {:.3f}s ({:.0f}%) of the time",
+            call_site.first,
+            call_site.second,
+            load.calls,
+            std::chrono::duration<double>(idle_time(load)).count(),
+            available_seconds > 0.0 ? 100.0 * std::chrono::duration<double>(idle_time(load)).count() / available_seconds : 0.0);
+    }
+}
+
+} // namespace
+
+void start(const std::filesystem::path& trace_file)
+{
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (std::unique_ptr<ThreadBuffer>& buffer : reg.buffers)
+        {
+            buffer->written.store(0);
+        }
+        reg.parallel_for_loads.clear();
+        reg.trace_file = trace_file;
+        reg.origin_ns = toNanoseconds(std::chrono::steady_clock::now());
+    }
+#ifndef ENABLE_TRACING
+    spdlog::warn("This engine was built without ENABLE_TRACING, so the trace {} will be empty.", trace_file.string());
+#endif
+    enabled.store(true);
+}
+
+void finish()
+{
+    if (! enabled.exchange(false))
+    {
+        return;
+    }
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    logParallelForLoads(reg);
+
+    std::ofstream file(reg.trace_file);
+    if (! file)
+    {
+        spdlog::error("Couldn't write trace to {}", reg.trace_file.string());
+        return;
+    }
+    rapidjson::OStreamWrapper stream(file);
+    rapidjson::Writer<rapidjson::OStreamWrapper> writer(stream);
+    writer.StartObject();
+    writer.Key("traceEvents");
+    writer.StartArray();
+    size_t event_count = 0;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : reg.buffers)
+    {
+        const size_t written = buffer->written.load(std::memory_order_acquire);
+        if (written == 0)
+        {
+            continue;
+        }
+        writer.StartObject();
+        writer.Key("name");
+        writer.String("thread_name");
+        writer.Key("ph");
+        writer.String("M");
+        writer.Key("pid");
+        writer.Int(1);
+        writer.Key("tid");
+        writer.Uint64(buffer->thread_index);
+        writer.Key("args");
+        writer.StartObject();
+        writer.Key("name");
+        const std::string thread_name = fmt::format("thread {}", buffer->thread_index);
+        writer.String(thread_name.c_str(), thread_name.size());
+        writer.EndObject();
+        writer.EndObject();
+
+        for (size_t event_idx = written > buffer_capacity ? written - buffer_capacity : 0; event_idx < written; ++event_idx)
+        {
+            const Event& event = buffer->events[event_idx % buffer_capacity];
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(event.name);
+            writer.Key("ph");
+            writer.String("X");
+            writer.Key("pid");
+            writer.Int(1);
+            writer.Key("tid");
+            writer.Uint64(buffer->thread_index);
+            writer.Key("ts");
+            writer.Double(static_cast<double>(event.begin_ns - reg.origin_ns) / 1000.0);
+            writer.Key("dur");
+            writer.Double(static_cast<double>(event.duration_ns) / 1000.0);
+            if (event.argument >= 0)
+            {
+                writer.Key("args");
+                writer.StartObject();
+                writer.Key("value");
+                writer.Int64(event.argument);
+                writer.EndObject();
+            }
+            writer.EndObject();
+        }
+        event_count += std::min(written, buffer_capacity);
+    }
+    writer.EndArray();
+    writer.EndObject();
+    spdlog::info("Wrote {} trace spans to {}", event_count, reg.trace_file.string());
+}
+
+void record(const char* name, const int64_t argument, const std::chrono::steady_clock::time_point begin, const std::chrono::steady_clock::time_point end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    const size_t written = buffer.written.load(std::memory_order_relaxed);
+    const int64_t begin_ns = toNanoseconds(begin);
+    buffer.events[written % buffer_capacity] = Event{ name, argument, begin_ns, toNanoseconds(end) - begin_ns };
+    buffer.written.store(written + 1, std::memory_order_release);
+}
+
+void recordParallelFor(const std::source_location& call_site, const std::chrono::steady_clock::duration busy_time, const std::chrono::steady_clock::duration wall_time, const size_t workers)
+{
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    CallSiteLoad& load = reg.parallel_for_loads[{ std::string_view(call_site.file_name()), call_site.line() }];
+    load.calls++;
+    load.busy_time += busy_time;
+    load.available_time += wall_time * static_cast<std::chrono::steady_clock::rep>(workers);
+}
+
+} // namespace cura::tracing
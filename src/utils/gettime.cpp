@@ -9,6 +9,7 @@ namespace cura
 {
 
 TimeKeeper::TimeKeeper()
+    : cpu_start(std::clock())
 {
 }
 
@@ -16,9 +17,15 @@ double TimeKeeper::restart()
 {
     double ret = watch.elapsed().count();
     watch.reset();
+    cpu_start = std::clock();
     return ret;
 }
 
+double TimeKeeper::cpuTime() const
+{
+    return static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+}
+
 void TimeKeeper::registerTime(const std::string& stage, double threshold)
 {
     double duration = restart();
@@ -871,6 +871,7 @@ std::unique_ptr<LocToLineGrid> PolygonUtils::createLocToLineGrid(const Shape& po
             ret->insert(PolygonsPointIndex(&polygons, poly_idx, point_idx));
         }
     }
+    ret->build();
     return ret;
 }
 
@@ -1121,8 +1122,7 @@ bool PolygonUtils::polygonCollidesWithLineSegment(const Point2LL from, const Poi
 
     PolygonsPointIndex result;
 
-    std::function<bool(const PolygonsPointIndex&)> process_elem_func
-        = [transformed_from, transformed_to, &transformation_matrix, &result, &ret](const PolygonsPointIndex& line_start)
+    const auto process_elem_func = [transformed_from, transformed_to, &transformation_matrix, &result, &ret](const PolygonsPointIndex& line_start)
     {
         Point2LL p0 = transformation_matrix.apply(line_start.p());
         Point2LL p1 = transformation_matrix.apply(line_start.next().p());
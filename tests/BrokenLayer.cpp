@@ -0,0 +1,79 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "BrokenLayer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+#include "geometry/OpenPolyline.h"
+
+// NOTE: See the documentation in the header-file for a description of the generated layer.
+
+namespace cura
+{
+void makeBrokenLayer(const size_t circle_count, const coord_t size, OpenLinesSet& broken_polylines, Shape& intact_polygons)
+{
+    uint64_t random = 12345;
+    const auto next_random = [&random](const uint64_t max)
+    {
+        random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (random >> 33) % max;
+    };
+    broken_polylines.clear();
+    intact_polygons.clear();
+    for (size_t circle_idx = 0; circle_idx < circle_count; ++circle_idx)
+    {
+        const Point2LL center(static_cast<coord_t>(next_random(size)), static_cast<coord_t>(next_random(size)));
+        const double radius = static_cast<double>(MM2INT(2) + next_random(MM2INT(20)));
+        const size_t point_count = 16 + next_random(64);
+        std::vector<Point2LL> circle;
+        for (size_t point_idx = 0; point_idx < point_count; ++point_idx)
+        {
+            const double angle = 2.0 * std::numbers::pi * static_cast<double>(point_idx) / static_cast<double>(point_count);
+            circle.emplace_back(center.X + std::llrint(radius * std::cos(angle)), center.Y + std::llrint(radius * std::sin(angle)));
+        }
+
+        if (circle_idx % 2 == 0)
+        {
+            for (size_t piece_idx = 0; piece_idx < 2; ++piece_idx)
+            {
+                const size_t start = next_random(point_count);
+                OpenPolyline& piece = broken_polylines.newLine();
+                for (size_t point_idx = start; point_idx < start + 3; ++point_idx)
+                {
+                    piece.push_back(circle[point_idx % point_count] + Point2LL(15, -10));
+                }
+            }
+            intact_polygons.emplace_back(ClipperLib::Path(circle.begin(), circle.end()), true);
+            continue;
+        }
+        for (size_t start = 0; start < point_count;)
+        {
+            const size_t end = std::min(start + 1 + next_random(6), point_count);
+            OpenPolyline& piece = broken_polylines.newLine();
+            for (size_t point_idx = start; point_idx <= end; ++point_idx)
+            {
+                piece.push_back(circle[point_idx % point_count]);
+            }
+            if (start > 0)
+            {
+                piece[0] += Point2LL(static_cast<coord_t>(next_random(30)), static_cast<coord_t>(next_random(30)));
+            }
+            if (next_random(2) == 0)
+            {
+                piece.reverse();
+            }
+            start = end;
+        }
+    }
+    for (size_t polyline_idx = broken_polylines.size(); polyline_idx > 1; --polyline_idx)
+    {
+        std::swap(broken_polylines[polyline_idx - 1], broken_polylines[next_random(polyline_idx)]);
+    }
+}
+} // namespace cura
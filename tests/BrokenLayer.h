@@ -0,0 +1,26 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#ifndef BROKEN_LAYER_H
+#define BROKEN_LAYER_H
+
+#include "geometry/OpenLinesSet.h"
+#include "geometry/Shape.h"
+#include "utils/Coord_t.h"
+
+/* A generator for the open polylines of a layer of a broken mesh, to test and benchmark the stitching of SlicerLayer with.
+ *
+ * The layer is made of circles with random centers, radii and numbers of vertices:
+ *  - every other circle is cut into pieces that are shuffled, partly reversed and moved apart a bit at their start, as if the triangles between them were
+ *    missing or didn't quite line up;
+ *  - the other circles stay intact, with a couple of loose pieces next to them for the extensive stitching to connect.
+ *
+ * The generator is seeded with a fixed value, so the same circle count always gives the same layer.
+ */
+
+namespace cura
+{
+void makeBrokenLayer(const size_t circle_count, const coord_t size, OpenLinesSet& broken_polylines, Shape& intact_polygons);
+} // namespace cura
+
+#endif // BROKEN_LAYER_H
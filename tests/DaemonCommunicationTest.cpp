@@ -0,0 +1,136 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "communication/DaemonCommunication.h"
+
+#include <filesystem>
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include "MeshGroup.h"
+#include "settings/Settings.h"
+#include "utils/Matrix4x3D.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * Exposes how the daemon loads models, so that it can be checked without slicing.
+ */
+class TestDaemonCommunication : public DaemonCommunication
+{
+public:
+    using DaemonCommunication::DaemonCommunication;
+    using DaemonCommunication::forgetUnusedMeshes;
+    using DaemonCommunication::loadMesh;
+    using DaemonCommunication::loaded_meshes_;
+};
+
+/*
+ * Parse the replies that the daemon wrote, one per line.
+ */
+std::vector<rapidjson::Document> readReplies(const std::string& output)
+{
+    std::vector<rapidjson::Document> replies;
+    std::istringstream lines(output);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        replies.emplace_back();
+        replies.back().Parse(line.c_str());
+    }
+    return replies;
+}
+
+TEST(DaemonCommunicationTest, RejectsInvalidJobs)
+{
+    std::istringstream input("not json\n\n[\"-l\", 5]\n[\"-l\", \"model.stl\"]\n");
+    std::ostringstream output;
+    DaemonCommunication daemon(input, output);
+    while (daemon.hasSlice())
+    {
+        daemon.sliceNext();
+    }
+
+    const std::vector<rapidjson::Document> replies = readReplies(output.str());
+    ASSERT_EQ(replies.size(), 3) << "Every job but the empty line must get a reply.";
+    for (size_t job = 0; job < replies.size(); job++)
+    {
+        ASSERT_TRUE(replies[job].IsObject());
+        EXPECT_EQ(replies[job]["job"].GetUint64(), job + 1);
+        EXPECT_FALSE(replies[job]["succeeded"].GetBool());
+        EXPECT_TRUE(replies[job].HasMember("error"));
+    }
+}
+
+TEST(DaemonCommunicationTest, ReusesLoadedModels)
+{
+    std::istringstream input;
+    std::ostringstream output;
+    TestDaemonCommunication daemon(input, output);
+    const std::string filename = std::filesystem::path(__FILE__).parent_path().append("integration/resources/cube.stl").string();
+    const Matrix4x3D transformation;
+
+    Settings first_parent;
+    MeshGroup first_group;
+    ASSERT_TRUE(daemon.loadMesh(&first_group, filename, transformation, first_parent));
+    Settings second_parent;
+    second_parent.add("extruder_nr", "1");
+    MeshGroup second_group;
+    ASSERT_TRUE(daemon.loadMesh(&second_group, filename, transformation, second_parent));
+
+    ASSERT_EQ(first_group.meshes.size(), 1);
+    ASSERT_EQ(second_group.meshes.size(), 1);
+    EXPECT_EQ(second_group.meshes[0].vertices_.size(), first_group.meshes[0].vertices_.size());
+    EXPECT_EQ(second_group.meshes[0].faces_.size(), first_group.meshes[0].faces_.size());
+    EXPECT_EQ(second_group.meshes[0].settings_.get<size_t>("extruder_nr"), 1) << "A reused model must inherit from the settings of the new job.";
+
+    MeshGroup missing_group;
+    EXPECT_FALSE(daemon.loadMesh(&missing_group, "does_not_exist.stl", transformation, first_parent));
+}
+
+TEST(DaemonCommunicationTest, ReloadsChangedModels)
+{
+    std::istringstream input;
+    std::ostringstream output;
+    TestDaemonCommunication daemon(input, output);
+    const std::filesystem::path resources = std::filesystem::path(__FILE__).parent_path().append("integration/resources");
+    const std::filesystem::path filename = std::filesystem::temp_directory_path() / "cura_engine_daemon_test_model.stl";
+    std::filesystem::copy_file(resources / "cube.stl", filename, std::filesystem::copy_options::overwrite_existing);
+    const Matrix4x3D transformation;
+    Settings parent;
+
+    MeshGroup cube_group;
+    ASSERT_TRUE(daemon.loadMesh(&cube_group, filename.string(), transformation, parent));
+    std::filesystem::copy_file(resources / "cylinder1000.stl", filename, std::filesystem::copy_options::overwrite_existing);
+    MeshGroup cylinder_group;
+    ASSERT_TRUE(daemon.loadMesh(&cylinder_group, filename.string(), transformation, parent));
+    std::filesystem::remove(filename);
+
+    ASSERT_EQ(cube_group.meshes.size(), 1);
+    ASSERT_EQ(cylinder_group.meshes.size(), 1);
+    EXPECT_NE(cylinder_group.meshes[0].faces_.size(), cube_group.meshes[0].faces_.size()) << "A model file that changed must be loaded again.";
+}
+
+TEST(DaemonCommunicationTest, ForgetsModelsOfEarlierJobs)
+{
+    std::istringstream input;
+    std::ostringstream output;
+    TestDaemonCommunication daemon(input, output);
+    const std::string filename = std::filesystem::path(__FILE__).parent_path().append("integration/resources/cube.stl").string();
+    const Matrix4x3D transformation;
+    Settings parent;
+
+    MeshGroup group;
+    ASSERT_TRUE(daemon.loadMesh(&group, filename, transformation, parent));
+    daemon.forgetUnusedMeshes();
+    EXPECT_EQ(daemon.loaded_meshes_.size(), 1) << "The model of the job that just ended is kept for the next job.";
+    daemon.forgetUnusedMeshes();
+    EXPECT_TRUE(daemon.loaded_meshes_.empty()) << "A job that didn't use the model ended, so it is forgotten.";
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
@@ -143,6 +143,25 @@ TEST_F(GCodeExportTest, CommentTimeFloatRoundingError)
     EXPECT_EQ(std::string(";TIME_ELAPSED:0.300000\n"), output.str()) << "Don't output up to the precision of rounding errors.";
 }
 
+TEST_F(GCodeExportTest, CommentTimeOfLayer)
+{
+    gcode.estimate_calculator_.addTime(2.5);
+    gcode.updateTotalPrintTime();
+    EXPECT_EQ(std::string(""), output.str()) << "The estimate is calculated in the background.";
+
+    gcode.writePendingTimeEstimate();
+    EXPECT_EQ(std::string(";TIME_ELAPSED:2.500000\n"), output.str());
+    gcode.writePendingTimeEstimate();
+    EXPECT_EQ(std::string(";TIME_ELAPSED:2.500000\n"), output.str()) << "Each estimate is only written once.";
+
+    gcode.estimate_calculator_.addTime(1.0);
+    gcode.updateTotalPrintTime();
+    gcode.estimate_calculator_.addTime(1.0);
+    gcode.updateTotalPrintTime(); // Writes the estimate of the previous layer first.
+    gcode.writePendingTimeEstimate();
+    EXPECT_EQ(std::string(";TIME_ELAPSED:2.500000\n;TIME_ELAPSED:3.500000\n;TIME_ELAPSED:4.500000\n"), output.str());
+}
+
 TEST_F(GCodeExportTest, CommentTypeAllTypesCovered)
 {
     for (auto type = static_cast<PrintFeatureType>(0); type < PrintFeatureType::NumPrintFeatureTypes; type = static_cast<PrintFeatureType>(static_cast<size_t>(type) + 1))
@@ -3,8 +3,11 @@
 
 #include "infill.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include <fmt/format.h>
 #include <scripta/logger.h>
@@ -13,7 +16,9 @@
 
 #include "ReadTestPolygons.h"
 #include "geometry/OpenPolyline.h"
+#include "geometry/PointMatrix.h"
 #include "slicer.h"
+#include "utils/AABB.h"
 #include "utils/Coord_t.h"
 
 // #define TEST_INFILL_SVG_OUTPUT
@@ -243,6 +248,192 @@ std::vector<InfillTestParameters> generateInfillTests()
 
 class InfillTest : public testing::TestWithParam<InfillTestParameters>
 {
+public:
+    /*!
+     * An infill line between two crossings with the outline, with the polygon and the segment of the outline that each end lies on.
+     */
+    struct CrossingLine
+    {
+        Point2LL start;
+        size_t start_segment;
+        size_t start_polygon;
+        Point2LL end;
+        size_t end_segment;
+        size_t end_polygon;
+
+        bool operator==(const CrossingLine& other) const = default;
+    };
+
+    using CrossingsOnLine = std::vector<std::vector<std::vector<CrossingLine>>>; //!< For each segment of each polygon the infill lines that end on it.
+
+    /*!
+     * Generate lines infill inside the outline. If the lines are to be connected, they are given per segment of the outline instead of as lines.
+     */
+    static void generateLines(
+        const Shape& outline,
+        const coord_t line_distance,
+        const double angle,
+        const coord_t shift,
+        const bool connect_lines,
+        OpenLinesSet& result_lines,
+        CrossingsOnLine& crossings_on_line)
+    {
+        Infill infill(
+            EFillMethod::LINES,
+            false,
+            false,
+            outline,
+            INFILL_LINE_WIDTH,
+            line_distance,
+            INFILL_OVERLAP,
+            INFILL_MULTIPLIER,
+            angle,
+            Z,
+            shift,
+            MAX_RESOLUTION,
+            MAX_DEVIATION);
+        infill.inner_contour_ = outline;
+        infill.connect_lines_ = connect_lines;
+        constexpr coord_t extra_shift = 0;
+        infill.generateLineInfill(result_lines, line_distance, angle, extra_shift);
+
+        std::unordered_set<Infill::InfillLineSegment*> segments;
+        crossings_on_line.clear();
+        for (const std::vector<std::vector<Infill::InfillLineSegment*>>& crossings_on_polygon : infill.crossings_on_line_)
+        {
+            std::vector<std::vector<CrossingLine>>& polygon_result = crossings_on_line.emplace_back();
+            for (const std::vector<Infill::InfillLineSegment*>& crossings_on_segment : crossings_on_polygon)
+            {
+                std::vector<CrossingLine>& segment_result = polygon_result.emplace_back();
+                for (Infill::InfillLineSegment* segment : crossings_on_segment)
+                {
+                    segment_result.push_back(
+                        CrossingLine{ segment->start_, segment->start_segment_, segment->start_polygon_, segment->end_, segment->end_segment_, segment->end_polygon_ });
+                    segments.insert(segment);
+                }
+            }
+        }
+        for (Infill::InfillLineSegment* segment : segments) // The lines aren't connected, which would clean them up.
+        {
+            delete segment;
+        }
+    }
+
+    /*!
+     * Generate the same lines, keeping the crossings of each scanline in a vector of their own, like before they were all bucketed in one buffer.
+     */
+    static void generateLinesPerScanline(
+        const Shape& outline,
+        const coord_t line_distance,
+        const double angle,
+        coord_t shift,
+        const bool connect_lines,
+        OpenLinesSet& result_lines,
+        CrossingsOnLine& crossings_on_line)
+    {
+        const auto scan_segment_idx = [line_distance](const coord_t x)
+        {
+            return x < 0 ? static_cast<int>((x + 1) / line_distance - 1) : static_cast<int>(x / line_distance);
+        };
+        const PointMatrix rotation_matrix(angle);
+        Shape rotated = outline;
+        rotated.applyMatrix(rotation_matrix);
+        shift = shift < 0 ? line_distance - (-shift) % line_distance : shift % line_distance;
+        const AABB boundary(rotated);
+        const int scanline_min_idx = scan_segment_idx(boundary.min_.X - shift);
+        const int line_count = scan_segment_idx(boundary.max_.X - shift) + 1 - scanline_min_idx;
+
+        struct Crossing
+        {
+            Point2LL coordinate;
+            size_t polygon_idx;
+            size_t vertex_idx;
+        };
+        std::vector<std::vector<Crossing>> crossings_per_scanline(line_count);
+        for (size_t poly_idx = 0; poly_idx < rotated.size(); poly_idx++)
+        {
+            const Polygon& poly = rotated[poly_idx];
+            Point2LL p0 = poly.back();
+            for (size_t point_idx = 0; point_idx < poly.size(); point_idx++)
+            {
+                const Point2LL p1 = poly[point_idx];
+                if (p1.X == p0.X)
+                {
+                    p0 = p1;
+                    continue;
+                }
+                int scanline_idx0 = scan_segment_idx(p0.X - shift) + 1;
+                int scanline_idx1 = scan_segment_idx(p1.X - shift);
+                int direction = 1;
+                if (p0.X > p1.X)
+                {
+                    direction = -1;
+                    scanline_idx0 = scan_segment_idx(p0.X - shift);
+                    scanline_idx1 = scan_segment_idx(p1.X - shift) + 1;
+                }
+                for (int scanline_idx = scanline_idx0; scanline_idx != scanline_idx1 + direction; scanline_idx += direction)
+                {
+                    const int x = scanline_idx * line_distance + shift;
+                    const int y = p1.Y + (p0.Y - p1.Y) * (x - p1.X) / (p0.X - p1.X);
+                    crossings_per_scanline[scanline_idx - scanline_min_idx].push_back(Crossing{ Point2LL(x, y), poly_idx, point_idx });
+                }
+                p0 = p1;
+            }
+        }
+        for (std::vector<Crossing>& crossings : crossings_per_scanline)
+        {
+            std::stable_sort(
+                crossings.begin(),
+                crossings.end(),
+                [](const Crossing& a, const Crossing& b)
+                {
+                    return a.coordinate.Y < b.coordinate.Y;
+                });
+        }
+
+        crossings_on_line.clear();
+        if (connect_lines)
+        {
+            for (const Polygon& poly : outline)
+            {
+                crossings_on_line.emplace_back(poly.size());
+            }
+            for (const std::vector<Crossing>& crossings : crossings_per_scanline)
+            {
+                for (size_t crossing_idx = 0; crossing_idx + 1 < crossings.size(); crossing_idx += 2)
+                {
+                    const Crossing& first = crossings[crossing_idx];
+                    const Crossing& second = crossings[crossing_idx + 1];
+                    const Point2LL unrotated_first = rotation_matrix.unapply(first.coordinate);
+                    const Point2LL unrotated_second = rotation_matrix.unapply(second.coordinate);
+                    if (unrotated_first == unrotated_second)
+                    {
+                        continue;
+                    }
+                    const CrossingLine line{ unrotated_first, first.vertex_idx, first.polygon_idx, unrotated_second, second.vertex_idx, second.polygon_idx };
+                    crossings_on_line[first.polygon_idx][first.vertex_idx].push_back(line);
+                    crossings_on_line[second.polygon_idx][second.vertex_idx].push_back(line);
+                }
+            }
+            return;
+        }
+        size_t scanline_idx = 0;
+        for (coord_t x = scanline_min_idx * line_distance + shift; x < boundary.max_.X && scanline_idx < crossings_per_scanline.size(); x += line_distance)
+        {
+            const std::vector<Crossing>& crossings = crossings_per_scanline[scanline_idx];
+            for (size_t crossing_idx = 0; crossing_idx + 1 < crossings.size(); crossing_idx += 2)
+            {
+                if (crossings[crossing_idx + 1].coordinate.Y - crossings[crossing_idx].coordinate.Y < INFILL_LINE_WIDTH / 5)
+                {
+                    continue;
+                }
+                result_lines.addSegment(
+                    rotation_matrix.unapply(Point2LL(x, crossings[crossing_idx].coordinate.Y)),
+                    rotation_matrix.unapply(Point2LL(x, crossings[crossing_idx + 1].coordinate.Y)));
+            }
+            scanline_idx++;
+        }
+    }
 };
 
 INSTANTIATE_TEST_SUITE_P(
@@ -297,5 +488,57 @@ TEST_P(InfillTest, TestInfillSanity)
         << "Infill (lines) should not be outside target polygon.";
 }
 
+TEST(InfillCrossingsTest, SameAsPerScanline)
+{
+    std::vector<Shape> shapes;
+    ASSERT_TRUE(readTestPolygons(POLYGON_FILENAMES, shapes));
+    for (size_t shape_idx = 0; shape_idx < shapes.size(); shape_idx++)
+    {
+        for (const coord_t line_distance : { 350, 800, 1200 })
+        {
+            for (const double angle : { 0.0, 30.0, 45.0, 90.0, 137.0 })
+            {
+                for (const coord_t shift : { 0, 170, -400 })
+                {
+                    for (const bool connect_lines : { false, true })
+                    {
+                        SCOPED_TRACE(fmt::format("Shape {} with line distance {}, angle {}, shift {} and connect {}.", shape_idx, line_distance, angle, shift, connect_lines));
+                        OpenLinesSet result_lines;
+                        InfillTest::CrossingsOnLine result_crossings;
+                        InfillTest::generateLines(shapes[shape_idx], line_distance, angle, shift, connect_lines, result_lines, result_crossings);
+                        OpenLinesSet expected_lines;
+                        InfillTest::CrossingsOnLine expected_crossings;
+                        InfillTest::generateLinesPerScanline(shapes[shape_idx], line_distance, angle, shift, connect_lines, expected_lines, expected_crossings);
+
+                        ASSERT_EQ(result_lines.size(), expected_lines.size());
+                        for (size_t line_idx = 0; line_idx < expected_lines.size(); line_idx++)
+                        {
+                            EXPECT_EQ(
+                                std::vector<Point2LL>(result_lines[line_idx].begin(), result_lines[line_idx].end()),
+                                std::vector<Point2LL>(expected_lines[line_idx].begin(), expected_lines[line_idx].end()))
+                                << "Line " << line_idx << ".";
+                        }
+                        EXPECT_EQ(result_crossings, expected_crossings);
+                        if (! connect_lines)
+                        {
+                            EXPECT_FALSE(expected_lines.empty()) << "The test must generate lines.";
+                        }
+                        else
+                        {
+                            EXPECT_TRUE(std::ranges::any_of(
+                                expected_crossings,
+                                [](const std::vector<std::vector<InfillTest::CrossingLine>>& crossings_on_polygon)
+                                {
+                                    return std::ranges::any_of(crossings_on_polygon, [](const std::vector<InfillTest::CrossingLine>& crossings) { return ! crossings.empty(); });
+                                }))
+                                << "The test must generate crossings.";
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 } // namespace cura
 // NOLINTEND(*-magic-numbers)
@@ -402,8 +402,8 @@ public:
             layer_plan.comb_ = new Comb(
                 *storage,
                 100, // layer_nr
-                layer_plan.comb_boundary_minimum_,
-                layer_plan.comb_boundary_preferred_,
+                *layer_plan.comb_boundary_minimum_,
+                *layer_plan.comb_boundary_preferred_,
                 20, // comb_boundary_offset
                 5000, // travel_avoid_distance
                 10 // comb_move_inside_distance
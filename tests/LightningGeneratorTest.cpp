@@ -0,0 +1,194 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "infill/LightningGenerator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Application.h" // The regions are found on the thread pool.
+#include "geometry/Polygon.h"
+#include "geometry/Shape.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * Exposes the grouping of the parts into regions, which is otherwise only done when generating the trees of a mesh.
+ */
+class RegionsLightningGenerator : public LightningGenerator
+{
+public:
+    using LightningGenerator::findRegions;
+    using LightningGenerator::Region;
+};
+
+/*
+ * Each layer is a row of rectangles, given as the ranges of columns that they cover. Rectangles in adjacent layers overlap if their column ranges
+ * overlap, and are 2mm apart if their ranges only touch.
+ */
+class LightningGeneratorRegionsTest : public testing::Test
+{
+public:
+    static constexpr coord_t COLUMN_WIDTH = MM2INT(10);
+    static constexpr coord_t CONNECTION_DISTANCE = MM2INT(0.2);
+
+    using Columns = std::vector<std::pair<coord_t, coord_t>>;
+
+    void SetUp() override
+    {
+        Application::getInstance().startThreadPool();
+    }
+
+    static std::vector<std::vector<Shape>> makeParts(const std::vector<Columns>& layers)
+    {
+        std::vector<std::vector<Shape>> parts_per_layer;
+        for (const Columns& layer : layers)
+        {
+            std::vector<Shape>& parts = parts_per_layer.emplace_back();
+            for (const auto& [first_column, last_column] : layer)
+            {
+                Polygon rectangle;
+                rectangle.emplace_back(first_column * COLUMN_WIDTH + MM2INT(1), 0);
+                rectangle.emplace_back(last_column * COLUMN_WIDTH - MM2INT(1), 0);
+                rectangle.emplace_back(last_column * COLUMN_WIDTH - MM2INT(1), COLUMN_WIDTH);
+                rectangle.emplace_back(first_column * COLUMN_WIDTH + MM2INT(1), COLUMN_WIDTH);
+                parts.emplace_back().push_back(rectangle);
+            }
+        }
+        return parts_per_layer;
+    }
+
+    /*
+     * Check that the regions contain every part once, on consecutive layers, and that exactly the parts that are connected through the layers share a
+     * region.
+     */
+    static void checkRegions(const std::vector<Columns>& layers)
+    {
+        const std::vector<std::vector<Shape>> parts = makeParts(layers);
+        const std::vector<RegionsLightningGenerator::Region> regions = RegionsLightningGenerator::findRegions(parts, CONNECTION_DISTANCE);
+
+        std::vector<std::vector<size_t>> region_of_part(layers.size());
+        for (size_t layer_nr = 0; layer_nr < layers.size(); layer_nr++)
+        {
+            region_of_part[layer_nr].resize(layers[layer_nr].size(), regions.size());
+        }
+        for (size_t region_idx = 0; region_idx < regions.size(); region_idx++)
+        {
+            const RegionsLightningGenerator::Region& region = regions[region_idx];
+            ASSERT_LE(region.parts_per_layer.size(), region.top_layer + 1) << "A region can't reach below the bottom layer.";
+            for (size_t layer_idx = 0; layer_idx < region.parts_per_layer.size(); layer_idx++)
+            {
+                EXPECT_FALSE(region.parts_per_layer[layer_idx].empty()) << "Region " << region_idx << " skips layer " << region.top_layer - layer_idx << ".";
+                const size_t layer_nr = region.top_layer - layer_idx;
+                for (const size_t part_idx : region.parts_per_layer[layer_idx])
+                {
+                    ASSERT_LT(part_idx, layers[layer_nr].size());
+                    EXPECT_EQ(region_of_part[layer_nr][part_idx], regions.size()) << "Every part must be in only one region.";
+                    region_of_part[layer_nr][part_idx] = region_idx;
+                }
+            }
+        }
+
+        // Find the connected parts the slow way, by growing each region from one part until nothing touches it anymore.
+        std::vector<std::vector<size_t>> component_of_part(layers.size());
+        for (size_t layer_nr = 0; layer_nr < layers.size(); layer_nr++)
+        {
+            component_of_part[layer_nr].resize(layers[layer_nr].size());
+            std::iota(component_of_part[layer_nr].begin(), component_of_part[layer_nr].end(), layer_nr * 1000);
+        }
+        const auto overlaps = [](const std::pair<coord_t, coord_t>& a, const std::pair<coord_t, coord_t>& b)
+        {
+            return a.first < b.second && b.first < a.second;
+        };
+        for (bool changed = true; changed;)
+        {
+            changed = false;
+            for (size_t layer_nr = 1; layer_nr < layers.size(); layer_nr++)
+            {
+                for (size_t part_idx = 0; part_idx < layers[layer_nr].size(); part_idx++)
+                {
+                    for (size_t part_below_idx = 0; part_below_idx < layers[layer_nr - 1].size(); part_below_idx++)
+                    {
+                        size_t& component = component_of_part[layer_nr][part_idx];
+                        size_t& component_below = component_of_part[layer_nr - 1][part_below_idx];
+                        if (overlaps(layers[layer_nr][part_idx], layers[layer_nr - 1][part_below_idx]) && component != component_below)
+                        {
+                            component = component_below = std::min(component, component_below);
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        for (size_t layer_nr = 0; layer_nr < layers.size(); layer_nr++)
+        {
+            for (size_t part_idx = 0; part_idx < layers[layer_nr].size(); part_idx++)
+            {
+                ASSERT_LT(region_of_part[layer_nr][part_idx], regions.size()) << "Part " << part_idx << " of layer " << layer_nr << " is in no region.";
+                for (size_t other_layer_nr = 0; other_layer_nr < layers.size(); other_layer_nr++)
+                {
+                    for (size_t other_part_idx = 0; other_part_idx < layers[other_layer_nr].size(); other_part_idx++)
+                    {
+                        EXPECT_EQ(
+                            component_of_part[layer_nr][part_idx] == component_of_part[other_layer_nr][other_part_idx],
+                            region_of_part[layer_nr][part_idx] == region_of_part[other_layer_nr][other_part_idx])
+                            << "Parts must share a region exactly if they are connected, for part " << part_idx << " of layer " << layer_nr << " and part "
+                            << other_part_idx << " of layer " << other_layer_nr << ".";
+                    }
+                }
+            }
+        }
+    }
+};
+
+TEST_F(LightningGeneratorRegionsTest, SeparateColumns)
+{
+    checkRegions({ { { 0, 2 }, { 3, 5 } }, { { 0, 2 }, { 3, 5 } }, { { 0, 2 }, { 3, 5 } } });
+}
+
+TEST_F(LightningGeneratorRegionsTest, BridgedColumns)
+{
+    // Two columns that are joined by a bridge at the top, and a third column that only starts higher up.
+    checkRegions({ { { 0, 2 }, { 3, 5 } }, { { 0, 2 }, { 3, 5 } }, { { 0, 5 }, { 6, 8 } }, { { 6, 8 } } });
+}
+
+TEST_F(LightningGeneratorRegionsTest, BridgeOverMergedParts)
+{
+    // The second layer connects to the top through a part that was already merged with another one, from below.
+    checkRegions({ { { 1, 4 } }, { { 0, 1 }, { 3, 9 } }, { { 0, 2 }, { 4, 8 } }, { { 1, 9 } } });
+}
+
+TEST_F(LightningGeneratorRegionsTest, RandomBridges)
+{
+    uint64_t random = 12345;
+    const auto next_random = [&random](const uint64_t max)
+    {
+        random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<coord_t>((random >> 33) % max);
+    };
+    for (size_t test_idx = 0; test_idx < 200; test_idx++)
+    {
+        std::vector<Columns> layers(2 + next_random(5));
+        for (Columns& layer : layers)
+        {
+            for (coord_t column = next_random(3); column < 12; column += 1 + next_random(3))
+            {
+                const coord_t last_column = column + 1 + next_random(4);
+                layer.emplace_back(column, last_column);
+                column = last_column;
+            }
+        }
+        checkRegions(layers);
+    }
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
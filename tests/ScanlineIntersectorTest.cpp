@@ -0,0 +1,131 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "bridge/ScanlineIntersector.h"
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bridge/TransformedSegment.h"
+#include "bridge/TransformedShape.h"
+#include "geometry/PointMatrix.h"
+#include "geometry/Polygon.h"
+#include "geometry/Shape.h"
+#include "utils/linearAlg2D.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class ScanlineIntersectorTest : public testing::Test
+{
+public:
+    static Polygon rectangle(const coord_t min_x, const coord_t min_y, const coord_t max_x, const coord_t max_y)
+    {
+        Polygon result;
+        result.emplace_back(min_x, min_y);
+        result.emplace_back(max_x, min_y);
+        result.emplace_back(max_x, max_y);
+        result.emplace_back(min_x, max_y);
+        return result;
+    }
+
+    /*
+     * Intersect the shape with all segments for each line, like the bridging lines used to be evaluated before the sweep.
+     */
+    static std::vector<coord_t> allSegmentsIntersections(const coord_t line_y, const TransformedShape& transformed_shape)
+    {
+        std::vector<coord_t> intersections;
+        for (const TransformedSegment& transformed_segment : transformed_shape.getSegments())
+        {
+            if (transformed_segment.minY() > line_y || transformed_segment.maxY() < line_y)
+            {
+                continue;
+            }
+            const std::optional<coord_t> intersection = LinearAlg2D::lineHorizontalLineIntersection(transformed_segment.getStart(), transformed_segment.getEnd(), line_y);
+            if (intersection.has_value())
+            {
+                intersections.push_back(intersection.value());
+            }
+        }
+        return intersections;
+    }
+
+    /*
+     * Check that the sweep finds the same intersections as testing all segments, at every angle that bridges are evaluated at. The lines are spaced like
+     * bridging lines, and also go through each vertex of the shape, where segments start and end.
+     */
+    static void checkIntersections(const Shape& shape, const coord_t line_width)
+    {
+        for (int angle = 0; angle < 180; angle++)
+        {
+            const TransformedShape transformed_shape(shape, PointMatrix(angle));
+            ASSERT_LT(transformed_shape.minY(), transformed_shape.maxY());
+
+            std::vector<coord_t> lines_y;
+            for (coord_t line_y = transformed_shape.minY() + line_width / 2; line_y < transformed_shape.maxY(); line_y += line_width)
+            {
+                lines_y.push_back(line_y);
+            }
+            for (const TransformedSegment& transformed_segment : transformed_shape.getSegments())
+            {
+                lines_y.push_back(transformed_segment.minY());
+                lines_y.push_back(transformed_segment.maxY());
+            }
+            std::sort(lines_y.begin(), lines_y.end());
+
+            ScanlineIntersector intersector(transformed_shape);
+            for (const coord_t line_y : lines_y)
+            {
+                std::vector<coord_t> intersections = intersector.intersections(line_y);
+                std::vector<coord_t> expected_intersections = allSegmentsIntersections(line_y, transformed_shape);
+                std::sort(intersections.begin(), intersections.end());
+                std::sort(expected_intersections.begin(), expected_intersections.end());
+                EXPECT_EQ(intersections, expected_intersections) << "At angle " << angle << " and line " << line_y << ".";
+            }
+        }
+    }
+};
+
+TEST_F(ScanlineIntersectorTest, NarrowStrip)
+{
+    Shape strip;
+    strip.push_back(rectangle(0, 0, MM2INT(50), MM2INT(1.2)));
+    checkIntersections(strip, MM2INT(0.4));
+}
+
+TEST_F(ScanlineIntersectorTest, LShape)
+{
+    Polygon l_shape;
+    l_shape.emplace_back(0, 0);
+    l_shape.emplace_back(MM2INT(30), 0);
+    l_shape.emplace_back(MM2INT(30), MM2INT(8));
+    l_shape.emplace_back(MM2INT(8), MM2INT(8));
+    l_shape.emplace_back(MM2INT(8), MM2INT(30));
+    l_shape.emplace_back(0, MM2INT(30));
+    Shape shape;
+    shape.push_back(l_shape);
+    checkIntersections(shape, MM2INT(0.4));
+}
+
+TEST_F(ScanlineIntersectorTest, ManyHoles)
+{
+    Shape shape;
+    shape.push_back(rectangle(0, 0, MM2INT(40), MM2INT(40)));
+    for (coord_t x = MM2INT(2); x < MM2INT(38); x += MM2INT(6))
+    {
+        for (coord_t y = MM2INT(2); y < MM2INT(38); y += MM2INT(6))
+        {
+            Polygon hole = rectangle(x, y, x + MM2INT(3), y + MM2INT(3));
+            hole.reverse();
+            shape.push_back(hole);
+        }
+    }
+    checkIntersections(shape, MM2INT(0.4));
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
@@ -0,0 +1,227 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "SkirtBrim.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Application.h" // The clusters are generated on the thread pool.
+#include "Slice.h"
+#include "geometry/MixedLinesSet.h"
+#include "geometry/Polygon.h"
+#include "geometry/Shape.h"
+#include "settings/Settings.h"
+#include "sliceDataStorage.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * The brim of every cluster of parts must be the same as the brim generated for the whole layer at once.
+ */
+class SkirtBrimClusterTest : public testing::Test
+{
+public:
+    static constexpr size_t EXTRUDER_COUNT = 2;
+
+    /*
+     * The brim lines and the areas that are left, after generating the primary brim.
+     */
+    struct Brim
+    {
+        size_t cluster_count = 1;
+        std::vector<coord_t> length_per_offset;
+        std::vector<std::vector<MixedLinesSet>> lines_per_extruder;
+        Shape covered_area;
+        std::vector<Shape> allowed_areas_per_extruder;
+    };
+
+    Shape bed;
+    std::vector<Shape> parts_per_extruder;
+
+    void SetUp() override
+    {
+        Application::getInstance().startThreadPool();
+
+        constexpr size_t num_mesh_groups = 1;
+        Application::getInstance().current_slice_ = std::make_shared<Slice>(num_mesh_groups);
+        Settings& settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
+        settings.add("adhesion_type", "brim");
+        settings.add("skirt_brim_extruder_nr", "-1");
+        settings.add("machine_width", "300");
+        settings.add("machine_depth", "300");
+        settings.add("machine_height", "300");
+        settings.add("machine_center_is_zero", "false");
+        settings.add("meshfix_maximum_resolution", "0.5");
+        settings.add("meshfix_maximum_deviation", "0.025");
+        settings.add("meshfix_maximum_extrusion_area_deviation", "50000");
+        for (size_t extruder_nr = 0; extruder_nr < EXTRUDER_COUNT; extruder_nr++)
+        {
+            Application::getInstance().current_slice_->scene.extruders.emplace_back(extruder_nr, &settings);
+        }
+
+        bed.push_back(rectangle(0, 0, 300, 300));
+
+        // Two parts of different extruders that touch, two parts of different extruders whose brims meet, a ring with a brim inside of its hole and
+        // separate parts of both extruders.
+        parts_per_extruder.resize(EXTRUDER_COUNT);
+        parts_per_extruder[0].push_back(rectangle(20, 20, 40, 40));
+        parts_per_extruder[1].push_back(rectangle(40, 20, 60, 40));
+        parts_per_extruder[0].push_back(rectangle(120, 120, 140, 140));
+        parts_per_extruder[1].push_back(rectangle(143, 120, 163, 140));
+        parts_per_extruder[0].push_back(rectangle(20, 200, 60, 240));
+        Polygon hole = rectangle(30, 210, 50, 230);
+        hole.reverse();
+        parts_per_extruder[0].push_back(hole);
+        parts_per_extruder[0].push_back(rectangle(120, 20, 140, 40));
+        parts_per_extruder[1].push_back(rectangle(20, 120, 40, 140));
+    }
+
+    static Polygon rectangle(const double min_x, const double min_y, const double max_x, const double max_y)
+    {
+        Polygon result;
+        result.emplace_back(MM2INT(min_x), MM2INT(min_y));
+        result.emplace_back(MM2INT(max_x), MM2INT(min_y));
+        result.emplace_back(MM2INT(max_x), MM2INT(max_y));
+        result.emplace_back(MM2INT(min_x), MM2INT(max_y));
+        return result;
+    }
+
+    /*
+     * Generate the primary brim around the parts, either for the whole layer at once or per cluster of parts.
+     *
+     * The offsets are planned like generateBrimOffsetPlan does, which would take the outlines from the meshes instead.
+     */
+    Brim generateBrim(const bool clustered) const
+    {
+        SliceDataStorage storage;
+        SkirtBrim skirt_brim(storage);
+        skirt_brim.skirt_brim_extruder_nr_ = -1;
+        skirt_brim.first_used_extruder_nr_ = 0;
+        skirt_brim.extruders_configs_[0] = SkirtBrim::ExtruderConfig{
+            .extruder_is_used_ = true, .outside_polys_ = true, .inside_polys_ = true, .line_width_ = 400, .skirt_brim_minimal_length_ = 0, .line_count_ = 5, .gap_ = 100
+        };
+        skirt_brim.extruders_configs_[1] = SkirtBrim::ExtruderConfig{
+            .extruder_is_used_ = true, .outside_polys_ = true, .inside_polys_ = false, .line_width_ = 500, .skirt_brim_minimal_length_ = 0, .line_count_ = 4, .gap_ = 0
+        };
+
+        std::vector<SkirtBrim::Outline> starting_outlines(EXTRUDER_COUNT);
+        std::vector<SkirtBrim::Offset> offsets;
+        for (size_t extruder_nr = 0; extruder_nr < EXTRUDER_COUNT; extruder_nr++)
+        {
+            starting_outlines[extruder_nr].gapped = parts_per_extruder[extruder_nr];
+            const SkirtBrim::ExtruderConfig& config = skirt_brim.extruders_configs_[extruder_nr];
+            for (int line_idx = 0; line_idx < config.line_count_; line_idx++)
+            {
+                const bool is_last = line_idx == config.line_count_ - 1;
+                const coord_t offset_touching = config.line_width_ / 2 + config.line_width_ * line_idx;
+                const coord_t offset_gapped = offset_touching + config.gap_;
+                if (line_idx == 0)
+                {
+                    offsets.emplace_back(
+                        &starting_outlines[extruder_nr],
+                        config.outside_polys_,
+                        config.inside_polys_,
+                        offset_gapped,
+                        offset_touching,
+                        offset_gapped,
+                        line_idx,
+                        extruder_nr,
+                        is_last);
+                }
+                else
+                {
+                    offsets.emplace_back(
+                        line_idx - 1,
+                        config.outside_polys_,
+                        config.inside_polys_,
+                        config.line_width_,
+                        config.line_width_,
+                        offset_gapped,
+                        line_idx,
+                        extruder_nr,
+                        is_last);
+                }
+            }
+        }
+        std::stable_sort(offsets.begin(), offsets.end(), SkirtBrim::OffsetSorter);
+
+        Brim brim;
+        brim.covered_area = parts_per_extruder[0].unionPolygons(parts_per_extruder[1]);
+        brim.allowed_areas_per_extruder.resize(EXTRUDER_COUNT, bed.difference(brim.covered_area));
+        if (clustered)
+        {
+            std::vector<SkirtBrim::Cluster> clusters = skirt_brim.clusterStartingOutlines(offsets);
+            brim.cluster_count = clusters.size();
+            brim.length_per_offset = skirt_brim.generateClusteredBrim(offsets, clusters, brim.covered_area, brim.allowed_areas_per_extruder);
+        }
+        else
+        {
+            // What generatePrimaryBrim does when all parts are in a single cluster.
+            for (const SkirtBrim::Offset& offset : offsets)
+            {
+                std::vector<MixedLinesSet>& lines = storage.skirt_brim[offset.extruder_nr_];
+                if (lines.size() <= static_cast<size_t>(offset.inset_idx_))
+                {
+                    lines.resize(offset.inset_idx_ + 1);
+                }
+                brim.length_per_offset.push_back(skirt_brim.generateOffset(offset, lines, brim.covered_area, brim.allowed_areas_per_extruder, lines[offset.inset_idx_]));
+            }
+        }
+        for (size_t extruder_nr = 0; extruder_nr < EXTRUDER_COUNT; extruder_nr++)
+        {
+            brim.lines_per_extruder.push_back(storage.skirt_brim[extruder_nr]);
+        }
+        return brim;
+    }
+
+    /*
+     * Areas may only differ by rounding along their borders.
+     */
+    static void expectSameArea(const Shape& result, const Shape& expected, const std::string& name)
+    {
+        constexpr double allowed_difference = 400.0 * 400.0;
+        EXPECT_LT(result.xorPolygons(expected).area(), allowed_difference) << name << " must be the same.";
+    }
+};
+
+TEST_F(SkirtBrimClusterTest, ClusteredSameAsSequential)
+{
+    const Brim sequential = generateBrim(false);
+    const Brim clustered = generateBrim(true);
+
+    EXPECT_EQ(clustered.cluster_count, 5U) << "The touching parts, the parts whose brims meet and the ring with its hole each form one cluster.";
+
+    ASSERT_EQ(clustered.length_per_offset.size(), sequential.length_per_offset.size());
+    for (size_t offset_idx = 0; offset_idx < sequential.length_per_offset.size(); offset_idx++)
+    {
+        EXPECT_GT(sequential.length_per_offset[offset_idx], 0) << "Every offset must add brim lines, offset " << offset_idx << ".";
+        EXPECT_NEAR(clustered.length_per_offset[offset_idx], sequential.length_per_offset[offset_idx], 10) << "Length of offset " << offset_idx << ".";
+    }
+
+    for (size_t extruder_nr = 0; extruder_nr < EXTRUDER_COUNT; extruder_nr++)
+    {
+        const std::vector<MixedLinesSet>& expected_lines = sequential.lines_per_extruder[extruder_nr];
+        const std::vector<MixedLinesSet>& result_lines = clustered.lines_per_extruder[extruder_nr];
+        ASSERT_EQ(result_lines.size(), expected_lines.size()) << "Insets of extruder " << extruder_nr << ".";
+        for (size_t inset_idx = 0; inset_idx < expected_lines.size(); inset_idx++)
+        {
+            EXPECT_NEAR(result_lines[inset_idx].length(), expected_lines[inset_idx].length(), 10) << "Length of inset " << inset_idx << " of extruder " << extruder_nr << ".";
+            expectSameArea(
+                result_lines[inset_idx].offset(100, ClipperLib::jtRound),
+                expected_lines[inset_idx].offset(100, ClipperLib::jtRound),
+                "Lines of inset " + std::to_string(inset_idx) + " of extruder " + std::to_string(extruder_nr));
+        }
+        expectSameArea(clustered.allowed_areas_per_extruder[extruder_nr], sequential.allowed_areas_per_extruder[extruder_nr], "Allowed area of extruder " + std::to_string(extruder_nr));
+    }
+    expectSameArea(clustered.covered_area, sequential.covered_area, "Covered area");
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
@@ -0,0 +1,413 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "slicer.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "BrokenLayer.h"
+#include "geometry/OpenLinesSet.h"
+#include "geometry/OpenPolyline.h"
+#include "geometry/Polygon.h"
+#include "geometry/Shape.h"
+#include "mesh.h"
+#include "settings/EnumSettings.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * Exposes the stitching of a layer, which is otherwise only done as part of making its polygons.
+ */
+class StitchingSlicerLayer : public SlicerLayer
+{
+public:
+    using SlicerLayer::connectOpenPolylines;
+    using SlicerLayer::stitch;
+    using SlicerLayer::stitch_extensive;
+};
+
+class SlicerLayerStitchTest : public testing::Test
+{
+public:
+    static constexpr coord_t MAX_CONNECT_DISTANCE = MM2INT(0.02); // The largest gap that connectOpenPolylines closes.
+    static constexpr coord_t MAX_STITCH_DISTANCE = MM2INT(10.0); // The largest gap that stitch closes.
+
+    static OpenPolyline makePolyline(const std::vector<Point2LL>& points)
+    {
+        return OpenPolyline(ClipperLib::Path(points.begin(), points.end()));
+    }
+
+    /*
+     * Whether a closed polygon has the given vertices, starting anywhere along it and in either direction.
+     */
+    static bool isLoop(const Polygon& polygon, std::vector<Point2LL> expected)
+    {
+        if (polygon.size() != expected.size())
+        {
+            return false;
+        }
+        for (size_t direction = 0; direction < 2; ++direction)
+        {
+            for (size_t start = 0; start < expected.size(); ++start)
+            {
+                std::rotate(expected.begin(), expected.begin() + 1, expected.end());
+                if (std::equal(polygon.begin(), polygon.end(), expected.begin()))
+                {
+                    return true;
+                }
+            }
+            std::reverse(expected.begin(), expected.end());
+        }
+        return false;
+    }
+
+    static std::map<std::pair<coord_t, coord_t>, int> countVertices(const OpenLinesSet& polylines)
+    {
+        std::map<std::pair<coord_t, coord_t>, int> vertex_count;
+        for (const OpenPolyline& polyline : polylines)
+        {
+            for (const Point2LL& point : polyline)
+            {
+                vertex_count[{ point.X, point.Y }]++;
+            }
+        }
+        return vertex_count;
+    }
+
+    /*
+     * Check that stitching only joined the polylines: every vertex ends up in exactly one polygon or polyline. Also check that none of the open
+     * polylines that are left could have been joined, i.e. that no ends are left that are closer than the given distance.
+     */
+    static void checkStitched(
+        const std::map<std::pair<coord_t, coord_t>, int>& vertex_count_before,
+        const StitchingSlicerLayer& layer,
+        const OpenLinesSet& open_polylines,
+        const coord_t max_dist,
+        const bool allow_reverse)
+    {
+        std::map<std::pair<coord_t, coord_t>, int> vertex_count = countVertices(open_polylines);
+        for (const Polygon& polygon : layer.polygons_)
+        {
+            for (const Point2LL& point : polygon)
+            {
+                vertex_count[{ point.X, point.Y }]++;
+            }
+        }
+        EXPECT_EQ(vertex_count, vertex_count_before) << "Stitching must keep all vertices, and not add any.";
+
+        for (const OpenPolyline& polyline_0 : open_polylines)
+        {
+            for (const OpenPolyline& polyline_1 : open_polylines)
+            {
+                if (polyline_0.empty() || polyline_1.empty())
+                {
+                    continue;
+                }
+                EXPECT_FALSE(shorterThen(polyline_0.back() - polyline_1.front(), max_dist)) << "The end of a polyline is left near the start of another.";
+                if (allow_reverse && &polyline_0 != &polyline_1)
+                {
+                    EXPECT_FALSE(shorterThen(polyline_0.front() - polyline_1.front(), max_dist)) << "The starts of two polylines are left near each other.";
+                    EXPECT_FALSE(shorterThen(polyline_0.back() - polyline_1.back(), max_dist)) << "The ends of two polylines are left near each other.";
+                }
+            }
+        }
+    }
+};
+
+TEST_F(SlicerLayerStitchTest, StitchClosesSquare)
+{
+    // A square whose sides don't quite touch, shuffled and partly reversed.
+    const std::vector<Point2LL> side_0 = { Point2LL(0, 0), Point2LL(20000, 0) };
+    const std::vector<Point2LL> side_1 = { Point2LL(20003, 4), Point2LL(20000, 20000) };
+    const std::vector<Point2LL> side_2_reversed = { Point2LL(0, 20000), Point2LL(19996, 20003) };
+    const std::vector<Point2LL> side_3 = { Point2LL(-3, 20004), Point2LL(0, 3) };
+    OpenLinesSet open_polylines;
+    open_polylines.push_back(makePolyline(side_2_reversed));
+    open_polylines.push_back(makePolyline(side_0));
+    open_polylines.push_back(makePolyline(side_3));
+    open_polylines.push_back(makePolyline(side_1));
+
+    StitchingSlicerLayer layer;
+    layer.stitch(open_polylines);
+
+    ASSERT_EQ(layer.polygons_.size(), 1);
+    EXPECT_TRUE(isLoop(
+        layer.polygons_[0],
+        { Point2LL(0, 0), Point2LL(20000, 0), Point2LL(20003, 4), Point2LL(20000, 20000), Point2LL(19996, 20003), Point2LL(0, 20000), Point2LL(-3, 20004), Point2LL(0, 3) }))
+        << "The sides must be joined in the order of the square.";
+    for (const OpenPolyline& polyline : open_polylines)
+    {
+        EXPECT_TRUE(polyline.empty()) << "All sides are used for the square.";
+    }
+}
+
+TEST_F(SlicerLayerStitchTest, ConnectOpenPolylinesOnlyInOrder)
+{
+    OpenLinesSet open_polylines;
+    open_polylines.push_back(makePolyline({ Point2LL(0, 0), Point2LL(20000, 0) }));
+    open_polylines.push_back(makePolyline({ Point2LL(20005, 0), Point2LL(20005, 20000) })); // Starts where the first ends.
+    open_polylines.push_back(makePolyline({ Point2LL(50000, 0), Point2LL(70000, 0) }));
+    open_polylines.push_back(makePolyline({ Point2LL(70000, 20000), Point2LL(70005, 0) })); // Ends where the third ends.
+
+    StitchingSlicerLayer layer;
+    layer.connectOpenPolylines(open_polylines);
+    std::vector<ClipperLib::Path> connected;
+    for (const OpenPolyline& polyline : open_polylines)
+    {
+        if (! polyline.empty())
+        {
+            connected.push_back(polyline.getPoints());
+        }
+    }
+    ASSERT_EQ(connected.size(), 3) << "Only the polylines that are in order are connected.";
+    EXPECT_EQ(connected[0], ClipperLib::Path({ Point2LL(0, 0), Point2LL(20000, 0), Point2LL(20005, 0), Point2LL(20005, 20000) }));
+
+    layer.stitch(open_polylines);
+    size_t open_count = 0;
+    for (const OpenPolyline& polyline : open_polylines)
+    {
+        open_count += polyline.empty() ? 0 : 1;
+    }
+    EXPECT_EQ(open_count, 2) << "Stitching may reverse a polyline to join it.";
+    EXPECT_TRUE(layer.polygons_.empty());
+}
+
+TEST_F(SlicerLayerStitchTest, StitchPrefersInOrderOnEqualDistance)
+{
+    // The end of the first polyline is as far from the start of the second as from the end of the third. Joining the first two doesn't need
+    // either of them to be reversed, so that stitch wins, whatever the order of the polylines is.
+    const std::array<std::vector<Point2LL>, 3> polylines = { std::vector<Point2LL>{ Point2LL(-50000, 0), Point2LL(0, 0) },
+                                                             std::vector<Point2LL>{ Point2LL(100, 0), Point2LL(50000, 0) },
+                                                             std::vector<Point2LL>{ Point2LL(0, 50000), Point2LL(0, 100) } };
+    std::array<size_t, 3> order = { 0, 1, 2 };
+    do
+    {
+        OpenLinesSet open_polylines;
+        for (const size_t polyline_idx : order)
+        {
+            open_polylines.push_back(makePolyline(polylines[polyline_idx]));
+        }
+
+        StitchingSlicerLayer layer;
+        layer.stitch(open_polylines);
+
+        std::vector<ClipperLib::Path> stitched;
+        for (const OpenPolyline& polyline : open_polylines)
+        {
+            if (! polyline.empty())
+            {
+                stitched.push_back(polyline.getPoints());
+            }
+        }
+        std::sort(stitched.begin(), stitched.end(), [](const ClipperLib::Path& a, const ClipperLib::Path& b) { return a.size() > b.size(); });
+        ASSERT_EQ(stitched.size(), 2);
+        EXPECT_EQ(stitched[0], ClipperLib::Path({ Point2LL(-50000, 0), Point2LL(0, 0), Point2LL(100, 0), Point2LL(50000, 0) }))
+            << "For order " << order[0] << ", " << order[1] << ", " << order[2] << ".";
+        EXPECT_EQ(stitched[1], ClipperLib::Path(polylines[2].begin(), polylines[2].end())) << "For order " << order[0] << ", " << order[1] << ", " << order[2] << ".";
+    } while (std::next_permutation(order.begin(), order.end()));
+}
+
+TEST_F(SlicerLayerStitchTest, BrokenLayerKeepsAllVertices)
+{
+    OpenLinesSet open_polylines;
+    Shape intact_polygons;
+    makeBrokenLayer(100, MM2INT(200), open_polylines, intact_polygons);
+    const std::map<std::pair<coord_t, coord_t>, int> vertex_count = countVertices(open_polylines);
+
+    StitchingSlicerLayer layer;
+    layer.connectOpenPolylines(open_polylines);
+    checkStitched(vertex_count, layer, open_polylines, MAX_CONNECT_DISTANCE, false);
+
+    layer.stitch(open_polylines);
+    checkStitched(vertex_count, layer, open_polylines, MAX_STITCH_DISTANCE, true);
+    EXPECT_GE(layer.polygons_.size(), 50) << "Each of the broken circles can be closed.";
+}
+
+TEST_F(SlicerLayerStitchTest, StitchExtensiveKeepsPolygons)
+{
+    OpenLinesSet open_polylines;
+    Shape intact_polygons;
+    makeBrokenLayer(100, MM2INT(200), open_polylines, intact_polygons);
+    const size_t open_count_before = open_polylines.size();
+
+    StitchingSlicerLayer layer;
+    layer.polygons_ = intact_polygons;
+    layer.stitch_extensive(open_polylines);
+
+    ASSERT_GE(layer.polygons_.size(), intact_polygons.size());
+    for (size_t polygon_idx = 0; polygon_idx < intact_polygons.size(); ++polygon_idx)
+    {
+        EXPECT_EQ(layer.polygons_[polygon_idx].getPoints(), intact_polygons[polygon_idx].getPoints()) << "The polygons that were already closed don't change.";
+    }
+    size_t open_count = 0;
+    for (const OpenPolyline& polyline : open_polylines)
+    {
+        open_count += polyline.empty() ? 0 : 1;
+    }
+    EXPECT_LT(open_count, open_count_before) << "The loose pieces along the polygons are connected.";
+}
+
+/*
+ * Slices single triangles, with each corner below, on or above the layer, and compares the segments with the cases that the crossing table replaced.
+ */
+class SlicerSegmentsTest : public testing::Test
+{
+public:
+    enum class Side
+    {
+        BELOW,
+        ON,
+        ABOVE,
+    };
+
+    struct Crossing
+    {
+        std::array<size_t, 3> order; //!< The corners in the order to project them in.
+        size_t end_edge_idx;
+        std::optional<size_t> end_vertex_idx;
+    };
+
+    /*
+     * How a triangle crosses the layer, as the six cases that slicing used to test in turn. Corners that are on the layer are already moved according
+     * to the slicing tolerance.
+     */
+    static std::optional<Crossing> expectedCrossing(const std::array<Point3LL, 3>& p, const coord_t z)
+    {
+        if (p[0].z_ < z && p[1].z_ > z && p[2].z_ > z)
+        {
+            return Crossing{ { 0, 2, 1 }, 0, std::nullopt };
+        }
+        if (p[0].z_ > z && p[1].z_ <= z && p[2].z_ <= z)
+        {
+            return Crossing{ { 0, 1, 2 }, 2, p[2].z_ == z ? std::optional<size_t>(2) : std::nullopt };
+        }
+        if (p[1].z_ < z && p[0].z_ > z && p[2].z_ > z)
+        {
+            return Crossing{ { 1, 0, 2 }, 1, std::nullopt };
+        }
+        if (p[1].z_ > z && p[0].z_ <= z && p[2].z_ <= z)
+        {
+            return Crossing{ { 1, 2, 0 }, 0, p[0].z_ == z ? std::optional<size_t>(0) : std::nullopt };
+        }
+        if (p[2].z_ < z && p[1].z_ > z && p[0].z_ > z)
+        {
+            return Crossing{ { 2, 1, 0 }, 2, std::nullopt };
+        }
+        if (p[2].z_ > z && p[1].z_ <= z && p[0].z_ <= z)
+        {
+            return Crossing{ { 2, 0, 1 }, 1, p[1].z_ == z ? std::optional<size_t>(1) : std::nullopt };
+        }
+        return std::nullopt;
+    }
+
+    /*
+     * Slice a triangle with its corners on the given sides of a layer at height z, and check its segment. Returns whether it has one.
+     */
+    static bool checkTriangle(const std::array<Side, 3>& sides, const coord_t z, const SlicingTolerance slicing_tolerance, const bool with_uv_coordinates)
+    {
+        const std::array<Point2LL, 3> corners_2d = { Point2LL(0, 0), Point2LL(10000, 1000), Point2LL(2000, 9000) };
+        const std::array<coord_t, 3> offsets = { 300, 700, 500 }; // Different for each corner, so that the segment depends on the corners used.
+        std::array<Point3LL, 3> corners;
+        std::array<std::optional<Point2F>, 3> uv_coordinates;
+        for (size_t corner_idx = 0; corner_idx < 3; ++corner_idx)
+        {
+            const coord_t offset = sides[corner_idx] == Side::BELOW ? -offsets[corner_idx] : (sides[corner_idx] == Side::ABOVE ? offsets[corner_idx] : 0);
+            corners[corner_idx] = Point3LL(corners_2d[corner_idx].X, corners_2d[corner_idx].Y, z + offset);
+            if (with_uv_coordinates)
+            {
+                uv_coordinates[corner_idx] = Point2F(0.1F * static_cast<float>(corner_idx + 1), 0.9F - 0.2F * static_cast<float>(corner_idx));
+            }
+        }
+
+        Mesh mesh;
+        mesh.addFace(corners[0], corners[1], corners[2], uv_coordinates[0], uv_coordinates[1], uv_coordinates[2]);
+        mesh.finish();
+        // Tell the edges apart, to check which edge the segment ends on.
+        mesh.faces_[0].connected_face_index_[0] = 10;
+        mesh.faces_[0].connected_face_index_[1] = 11;
+        mesh.faces_[0].connected_face_index_[2] = 12;
+
+        std::vector<SlicerLayer> layers(1);
+        layers[0].z_ = static_cast<int>(z);
+        Slicer::buildSegments(mesh, Slicer::buildTriangleBuffer(mesh), slicing_tolerance, layers);
+
+        // Compensate for corners exactly on the layer like slicing does, except for 'inclusive'.
+        std::array<Point3LL, 3> p = corners;
+        if (slicing_tolerance != SlicingTolerance::INCLUSIVE)
+        {
+            for (Point3LL& corner : p)
+            {
+                corner.z_ += static_cast<int>(corner.z_ == z) * -static_cast<int>(corner.z_ < 1);
+            }
+        }
+        const std::optional<Crossing> crossing = expectedCrossing(p, z);
+        const std::vector<SlicerSegment>& segments = layers[0].segments_;
+        if (! crossing.has_value())
+        {
+            EXPECT_TRUE(segments.empty());
+            return false;
+        }
+        EXPECT_EQ(segments.size(), 1);
+        if (segments.size() != 1)
+        {
+            return true;
+        }
+
+        const auto [idx_0, idx_1, idx_2] = crossing->order;
+        const SlicerSegment expected = with_uv_coordinates
+                                         ? Slicer::project2D(p[idx_0], p[idx_1], p[idx_2], uv_coordinates[idx_0], uv_coordinates[idx_1], uv_coordinates[idx_2], z)
+                                         : Slicer::project2D(p[idx_0], p[idx_1], p[idx_2], z);
+        const SlicerSegment& segment = segments[0];
+        EXPECT_EQ(segment.start, expected.start);
+        EXPECT_EQ(segment.end, expected.end);
+        EXPECT_EQ(segment.uv_start, expected.uv_start);
+        EXPECT_EQ(segment.uv_end, expected.uv_end);
+        EXPECT_EQ(segment.faceIndex, 0);
+        EXPECT_EQ(segment.endOtherFaceIdx, 10 + static_cast<int>(crossing->end_edge_idx));
+        EXPECT_EQ(segment.endVertex, crossing->end_vertex_idx.has_value() ? &mesh.vertices_[mesh.faces_[0].vertex_index_[*crossing->end_vertex_idx]] : nullptr);
+        EXPECT_FALSE(segment.addedToPolygon);
+        EXPECT_EQ(layers[0].face_idx_to_segment_idx_.count(0), 1);
+        return true;
+    }
+};
+
+TEST_F(SlicerSegmentsTest, EveryCrossing)
+{
+    // All 27 combinations of the corners being below, on or above the layer. On the first layer, the slicing tolerance moves corners that are on the
+    // layer down, except when it is inclusive.
+    for (const coord_t z : { coord_t(0), coord_t(1000) })
+    {
+        for (const SlicingTolerance slicing_tolerance : { SlicingTolerance::MIDDLE, SlicingTolerance::INCLUSIVE, SlicingTolerance::EXCLUSIVE })
+        {
+            for (const bool with_uv_coordinates : { false, true })
+            {
+                size_t crossing_count = 0;
+                for (size_t crossing_idx = 0; crossing_idx < 27; ++crossing_idx)
+                {
+                    const std::array<Side, 3> sides = { static_cast<Side>(crossing_idx % 3), static_cast<Side>(crossing_idx / 3 % 3), static_cast<Side>(crossing_idx / 9) };
+                    SCOPED_TRACE(
+                        "Corners " + std::to_string(crossing_idx % 3) + std::to_string(crossing_idx / 3 % 3) + std::to_string(crossing_idx / 9) + " at layer "
+                        + std::to_string(z) + ", tolerance " + std::to_string(static_cast<int>(slicing_tolerance)) + (with_uv_coordinates ? ", with UV" : ""));
+                    crossing_count += checkTriangle(sides, z, slicing_tolerance, with_uv_coordinates) ? 1 : 0;
+                }
+                // One corner above and the others not, or one corner below and the others above. With corners on the first layer moved down, those
+                // that only touch the layer from above cross it too.
+                const bool moves_corners_down = z == 0 && slicing_tolerance != SlicingTolerance::INCLUSIVE;
+                EXPECT_EQ(crossing_count, moves_corners_down ? 18 : 15);
+            }
+        }
+    }
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
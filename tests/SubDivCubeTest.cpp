@@ -0,0 +1,201 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "infill/SubDivCube.h"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Application.h" // The octree is built on the thread pool.
+#include "geometry/Polygon.h"
+#include "geometry/Shape.h"
+#include "mesh.h"
+#include "settings/Settings.h"
+#include "settings/types/Ratio.h"
+#include "sliceDataStorage.h"
+#include "utils/math.h"
+#include "utils/polygonUtils.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * The octree built with the distance fields of the layers must be the same as the octree that is built by computing every distance exactly.
+ */
+class SubDivCubeTest : public testing::Test
+{
+public:
+    static constexpr size_t LAYER_COUNT = 50;
+
+    Settings settings;
+    std::unique_ptr<Mesh> mesh;
+    std::unique_ptr<SliceMeshStorage> mesh_storage;
+    size_t subdivided_count = 0; //!< How many cubes are subdivided in the expected octree.
+    size_t rejected_count = 0; //!< How many children aren't added to the expected octree.
+
+    void SetUp() override
+    {
+        Application::getInstance().startThreadPool();
+
+        settings.add("infill_line_distance", "2");
+        settings.add("layer_height", "0.2");
+        settings.add("machine_width", "40");
+        settings.add("machine_depth", "40");
+        settings.add("machine_height", "10");
+        settings.add("sub_div_rad_add", "0.4");
+    }
+
+    static Polygon rectangle(const double min_x, const double min_y, const double max_x, const double max_y)
+    {
+        Polygon result;
+        result.emplace_back(MM2INT(min_x), MM2INT(min_y));
+        result.emplace_back(MM2INT(max_x), MM2INT(min_y));
+        result.emplace_back(MM2INT(max_x), MM2INT(max_y));
+        result.emplace_back(MM2INT(min_x), MM2INT(max_y));
+        return result;
+    }
+
+    /*
+     * A block that narrows towards the top, with a hole through its middle layers, a triangular part next to it and a single small part high above.
+     */
+    void makeLayers()
+    {
+        mesh = std::make_unique<Mesh>(settings);
+        mesh_storage = std::make_unique<SliceMeshStorage>(mesh.get(), LAYER_COUNT);
+        for (size_t layer_nr = 0; layer_nr < LAYER_COUNT; layer_nr++)
+        {
+            std::vector<SliceLayerPart>& parts = mesh_storage->layers[layer_nr].parts;
+            if (layer_nr < 30)
+            {
+                Shape& block = parts.emplace_back().infill_area;
+                block.push_back(rectangle(4 + 0.2 * layer_nr, 4, 24, 24 - 0.1 * layer_nr));
+                if (layer_nr >= 12 && layer_nr < 24)
+                {
+                    Polygon hole = rectangle(12, 10, 16, 14);
+                    hole.reverse();
+                    block.push_back(hole);
+                }
+            }
+            if (layer_nr >= 10 && layer_nr < 35)
+            {
+                Polygon triangle;
+                triangle.emplace_back(MM2INT(28), MM2INT(26));
+                triangle.emplace_back(MM2INT(37), MM2INT(27));
+                triangle.emplace_back(MM2INT(31), MM2INT(36));
+                parts.emplace_back().infill_area.push_back(triangle);
+            }
+            if (layer_nr == 44)
+            {
+                parts.emplace_back().infill_area.push_back(rectangle(18, 30, 19, 31));
+            }
+        }
+    }
+
+    /*
+     * Whether a cube should be subdivided, computing the distance to the infill area of every layer exactly, like the octree was built before the
+     * distance fields were added.
+     */
+    bool isValidSubdivisionExact(const Point3LL& center, const coord_t radius) const
+    {
+        const coord_t layer_height = settings.get<coord_t>("layer_height");
+        bool inside_somewhere = false;
+        bool outside_somewhere = false;
+        const int bottom_layer = (center.z_ - radius) / layer_height;
+        const int top_layer = (center.z_ + radius) / layer_height;
+        for (int test_layer = bottom_layer; test_layer <= top_layer; test_layer += 3)
+        {
+            const Ratio part_dist = Ratio{ static_cast<Ratio::value_type>(test_layer * layer_height - center.z_) } / radius;
+            const coord_t sphere_slice_radius2 = radius * radius * (1.0 - (part_dist * part_dist));
+            if (test_layer < 0 || static_cast<size_t>(test_layer) >= LAYER_COUNT)
+            {
+                outside_somewhere = true;
+                if (inside_somewhere)
+                {
+                    return true;
+                }
+                continue;
+            }
+            Shape collide;
+            for (const SliceLayerPart& part : mesh_storage->layers[test_layer].parts)
+            {
+                collide.push_back(part.infill_area);
+            }
+            Point2LL location(center.x_, center.y_);
+            const bool inside = collide.inside(location);
+            const ClosestPointPolygon border_point = PolygonUtils::moveInside2(collide, location);
+            const coord_t distance2 = vSize2(border_point.location_ - Point2LL(center.x_, center.y_));
+            (inside ? inside_somewhere : outside_somewhere) = true;
+            if ((outside_somewhere && inside_somewhere) || distance2 < sphere_slice_radius2)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Check that the cube has exactly the children that the exact computation subdivides it into, in the same order, and check those children too.
+     */
+    void checkSubdivision(const SubDivCube& cube)
+    {
+        const SubDivCube::OctreeProperties& properties = *cube.properties_;
+        size_t child_nr = 0;
+        if (cube.depth_ > 0 && cube.depth_ < properties.cube_properties_per_recursion_step.size())
+        {
+            const SubDivCube::OctreeProperties::CubeProperties& cube_properties = properties.cube_properties_per_recursion_step[cube.depth_];
+            const coord_t radius = double(cube_properties.height) / 4.0 + properties.radius_addition;
+            for (const Point3LL& rel_child_center :
+                 { Point3LL(1, 1, 1), Point3LL(-1, 1, 1), Point3LL(1, -1, 1), Point3LL(1, 1, -1), Point3LL(-1, -1, -1), Point3LL(1, -1, -1), Point3LL(-1, 1, -1), Point3LL(-1, -1, 1) })
+            {
+                const Point3LL child_center = cube.center_ + properties.rotation_matrix.apply(rel_child_center * int32_t(cube_properties.side_length / 4));
+                if (! isValidSubdivisionExact(child_center, radius))
+                {
+                    rejected_count++;
+                    continue;
+                }
+                ASSERT_NE(cube.children_[child_nr], nullptr) << "Cube at " << cube.center_ << " misses child " << child_nr << " at " << child_center << ".";
+                const SubDivCube& child = *cube.children_[child_nr];
+                EXPECT_EQ(child.center_, child_center) << "Child " << child_nr << " of cube at " << cube.center_ << ".";
+                EXPECT_EQ(child.depth_, cube.depth_ - 1);
+                EXPECT_EQ(child.properties_.get(), cube.properties_.get()) << "All cubes of an octree share its properties.";
+                checkSubdivision(child);
+                child_nr++;
+            }
+            if (child_nr > 0)
+            {
+                subdivided_count++;
+            }
+        }
+        for (; child_nr < cube.children_.size(); child_nr++)
+        {
+            EXPECT_EQ(cube.children_[child_nr], nullptr) << "Cube at " << cube.center_ << " has too many children.";
+        }
+    }
+
+    void checkOctree(const std::string& infill_angles)
+    {
+        settings.add("infill_angles", infill_angles);
+        makeLayers();
+        SubDivCube::precomputeOctree(*mesh_storage, Point2LL(MM2INT(20), MM2INT(20)));
+        ASSERT_NE(mesh_storage->base_subdiv_cube, nullptr);
+        checkSubdivision(*mesh_storage->base_subdiv_cube);
+        EXPECT_GT(subdivided_count, 10U) << "The test must subdivide several levels of cubes.";
+        EXPECT_GT(rejected_count, 0U) << "The test must leave out some cubes.";
+    }
+};
+
+TEST_F(SubDivCubeTest, SameAsExact)
+{
+    checkOctree("[]");
+}
+
+TEST_F(SubDivCubeTest, RotatedSameAsExact)
+{
+    checkOctree("[30]");
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
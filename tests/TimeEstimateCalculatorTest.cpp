@@ -430,4 +430,42 @@ TEST_F(TimeEstimateCalculatorTest, StraightAnglePartialJerk)
     EXPECT_NEAR(Duration(first_accelerate_t + first_cruise_distance / 50.0 + first_decelerate_t + second_accelerate_t + second_cruise_distance / 50.0 + second_decelerate_t), result[static_cast<size_t>(PrintFeatureType::Infill)], EPSILON);
 }
 
+TEST_F(TimeEstimateCalculatorTest, DetachPlan)
+{
+    // Two layers with a corner between them, so the junction speed at the start of the second layer matters.
+    const std::vector<TimeEstimateCalculator::Position> first_layer = { TimeEstimateCalculator::Position(1000, 0, 0, 0), TimeEstimateCalculator::Position(1000, 1000, 0, 10) };
+    const std::vector<TimeEstimateCalculator::Position> second_layer = { TimeEstimateCalculator::Position(0, 1000, 0.2, 20), TimeEstimateCalculator::Position(0, 0, 0.2, 30) };
+
+    TimeEstimateCalculator detaching = calculator;
+    std::vector<Duration> serial(static_cast<size_t>(PrintFeatureType::NumPrintFeatureTypes), 0.0);
+    std::vector<Duration> detached(static_cast<size_t>(PrintFeatureType::NumPrintFeatureTypes), 0.0);
+    for (const std::vector<TimeEstimateCalculator::Position>& layer : { first_layer, second_layer })
+    {
+        for (const TimeEstimateCalculator::Position& position : layer)
+        {
+            calculator.plan(position, 50.0, PrintFeatureType::OuterWall);
+            detaching.plan(position, 50.0, PrintFeatureType::OuterWall);
+        }
+        calculator.addTime(1.0);
+        detaching.addTime(1.0);
+
+        const std::vector<Duration> serial_layer = calculator.calculate();
+        calculator.reset();
+        TimeEstimateCalculator layer_calculator = detaching.detachPlan();
+        const std::vector<Duration> detached_layer = layer_calculator.calculate();
+        for (size_t feature = 0; feature < serial.size(); ++feature)
+        {
+            serial[feature] += serial_layer[feature];
+            detached[feature] += detached_layer[feature];
+        }
+    }
+
+    for (size_t feature = 0; feature < serial.size(); ++feature)
+    {
+        EXPECT_NEAR(serial[feature], detached[feature], EPSILON) << "The detached plans should add up to the same estimate as calculating in place.";
+    }
+    EXPECT_GT(detached[static_cast<size_t>(PrintFeatureType::OuterWall)], 0.0);
+    EXPECT_DOUBLE_EQ(detaching.calculate()[static_cast<size_t>(PrintFeatureType::NoneType)], 0.0) << "Detaching should leave no extra time behind.";
+}
+
 } // namespace cura
\ No newline at end of file
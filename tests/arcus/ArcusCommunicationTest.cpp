@@ -9,6 +9,7 @@
 
 #include "FffProcessor.h"
 #include "MockSocket.h" //To mock out the communication with the front-end.
+#include "PrintFeature.h"
 #include "communication/ArcusCommunicationPrivate.h" //To access the private fields of this communication class.
 #include "geometry/Polygon.h" //Create test shapes to send over the socket.
 #include "geometry/Shape.h"
@@ -160,6 +161,39 @@ TEST_F(ArcusCommunicationTest, SendLayerComplete)
     EXPECT_EQ(static_cast<float>(layer_thickness), message->thickness());
 }
 
+TEST_F(ArcusCommunicationTest, SendLinesTo)
+{
+    const std::vector<Point3LL> to{ Point3LL(1000, 0, 200), Point3LL(1000, 0, 200), Point3LL(1000, 1000, 200), Point3LL(0, 1000, 200) };
+    const std::vector<coord_t> line_widths{ 400, 400, 380, 350 };
+    const std::vector<coord_t> line_thicknesses{ 200, 200, 200, 100 };
+    const std::vector<Velocity> velocities{ 30, 30, 35, 40 };
+
+    // Send the same lines to two layers, one line at a time and all at once.
+    ac->setLayerForSend(0);
+    ac->sendCurrentPosition(Point3LL(0, 0, 200));
+    for (size_t line_idx = 0; line_idx < to.size(); line_idx++)
+    {
+        ac->sendLineTo(PrintFeatureType::OuterWall, to[line_idx], line_widths[line_idx], line_thicknesses[line_idx], velocities[line_idx]);
+    }
+    ac->setLayerForSend(1);
+    ac->sendCurrentPosition(Point3LL(0, 0, 200));
+    ac->sendLinesTo(PrintFeatureType::OuterWall, to, line_widths, line_thicknesses, velocities);
+    ac->setLayerForSend(2); // Flushes the lines of layer 1.
+
+    const std::shared_ptr<proto::LayerOptimized> one_by_one = ac->private_data->getOptimizedLayerById(0);
+    const std::shared_ptr<proto::LayerOptimized> at_once = ac->private_data->getOptimizedLayerById(1);
+    ASSERT_EQ(one_by_one->path_segment_size(), 1);
+    ASSERT_EQ(at_once->path_segment_size(), 1);
+    const proto::PathSegment& expected = one_by_one->path_segment(0);
+    const proto::PathSegment& segment = at_once->path_segment(0);
+    EXPECT_EQ(segment.line_type().size(), 3) << "The line to the point it already was at must be skipped.";
+    EXPECT_EQ(segment.line_type(), expected.line_type());
+    EXPECT_EQ(segment.points(), expected.points());
+    EXPECT_EQ(segment.line_width(), expected.line_width());
+    EXPECT_EQ(segment.line_thickness(), expected.line_thickness());
+    EXPECT_EQ(segment.line_feedrate(), expected.line_feedrate());
+}
+
 TEST_F(ArcusCommunicationTest, SendProgress)
 {
     ac->private_data->object_count = 2; // If there are two objects, all progress should get halved.
@@ -0,0 +1,300 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "pathPlanning/CombVisibilityGraph.h" // The class under test.
+
+#include <cmath>
+#include <memory>
+#include <numbers>
+
+#include <gtest/gtest.h>
+
+#include "Application.h" // To provide settings for the combing.
+#include "Slice.h" // To provide settings for the combing.
+#include "geometry/Point2LL.h"
+#include "geometry/Polygon.h"
+#include "geometry/Shape.h"
+#include "pathPlanning/Comb.h" // To compare with combing along the crossings.
+#include "pathPlanning/CombPath.h"
+#include "pathPlanning/CombPaths.h"
+#include "sliceDataStorage.h" // The comb needs a storage, though combing within a part doesn't use it.
+#include "utils/Coord_t.h"
+#include "utils/polygonUtils.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * Fixture with a square part with a hole in it, off-centre so that one way around the hole is clearly the shortest, and a second square part next to it.
+ * Travels from the left to the right of the square have to go around the hole.
+ */
+class CombVisibilityGraphTest : public testing::Test
+{
+public:
+    static constexpr coord_t offset_from_outlines = 200;
+    static constexpr coord_t offset_from_boundary = -40; // As Comb moves the corners off the boundary.
+
+    Shape part_with_hole;
+    Shape two_parts;
+    std::unique_ptr<SliceDataStorage> storage;
+    Settings* settings;
+
+    void SetUp() override
+    {
+        Application::getInstance().current_slice_ = std::make_shared<Slice>(1);
+        settings = &Application::getInstance().current_slice_->scene.current_mesh_group->settings;
+        settings->add("machine_width", "1000");
+        settings->add("machine_depth", "1000");
+        settings->add("machine_height", "1000");
+        settings->add("machine_center_is_zero", "false");
+        Application::getInstance().current_slice_->scene.extruders.emplace_back(0, settings);
+        storage = std::make_unique<SliceDataStorage>();
+
+        part_with_hole.push_back(square(0, 0, 10000));
+        Polygon hole = square(3000, 4000, 4000);
+        hole.reverse();
+        part_with_hole.push_back(hole);
+
+        two_parts = part_with_hole;
+        two_parts.push_back(square(12000, 0, 10000));
+    }
+
+    static Polygon square(const coord_t min_x, const coord_t min_y, const coord_t size)
+    {
+        Polygon result;
+        result.emplace_back(min_x, min_y);
+        result.emplace_back(min_x + size, min_y);
+        result.emplace_back(min_x + size, min_y + size);
+        result.emplace_back(min_x, min_y + size);
+        return result;
+    }
+
+    /*
+     * A hole shaped like a star with more tips than a visibility graph is built for. Each tip is a corner of the part which the inside turns around.
+     */
+    static Polygon starHole(const size_t tips)
+    {
+        Polygon result;
+        const Point2LL center(5000, 5000);
+        for (size_t vertex_idx = 0; vertex_idx < tips * 2; ++vertex_idx)
+        {
+            const double angle = -2.0 * std::numbers::pi * static_cast<double>(vertex_idx) / static_cast<double>(tips * 2); // Clockwise, as holes are.
+            const double radius = (vertex_idx % 2 == 0) ? 2000.0 : 1500.0;
+            result.emplace_back(center.X + std::llrint(radius * std::cos(angle)), center.Y + std::llrint(radius * std::sin(angle)));
+        }
+        return result;
+    }
+
+    static coord_t length(const CombPath& path)
+    {
+        coord_t result = 0;
+        for (size_t point_idx = 1; point_idx < path.size(); ++point_idx)
+        {
+            result += vSize(path[point_idx] - path[point_idx - 1]);
+        }
+        return result;
+    }
+
+    static coord_t length(const CombPaths& paths)
+    {
+        coord_t result = 0;
+        for (const CombPath& path : paths)
+        {
+            result += length(path);
+        }
+        return result;
+    }
+
+    /*
+     * Whether the path stays within the boundary, checked on the geometry itself rather than with the grid that the graph uses.
+     */
+    static bool staysInside(const CombPath& path, const Shape& boundary)
+    {
+        for (size_t point_idx = 1; point_idx < path.size(); ++point_idx)
+        {
+            const Point2LL& from = path[point_idx - 1];
+            const Point2LL& to = path[point_idx];
+            if (PolygonUtils::polygonCollidesWithLineSegment(boundary, from, to))
+            {
+                return false;
+            }
+            constexpr coord_t samples = 16;
+            for (coord_t sample = 0; sample <= samples; ++sample)
+            {
+                if (! boundary.inside(from + (to - from) * sample / samples, true))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::unique_ptr<Comb> makeComb(const Shape& boundary, const std::string& combing_engine) const
+    {
+        settings->add("retraction_combing_engine", combing_engine);
+        return std::make_unique<Comb>(*storage, 0, boundary, boundary, offset_from_outlines, 5000, 10);
+    }
+
+    /*
+     * Comb within the boundary with z hops over printed parts, so that combing through the air fails right away instead of needing the layer outlines.
+     */
+    static bool calc(Comb& comb, const Point2LL& start, const Point2LL& end, CombPaths& comb_paths)
+    {
+        const ExtruderTrain& train = Application::getInstance().current_slice_->scene.extruders[0];
+        bool unretract_before_last_travel_move = false;
+        bool do_retracted_move = false;
+        return comb.calc(true, false, train, start, end, comb_paths, true, true, 0, unretract_before_last_travel_move, do_retracted_move);
+    }
+
+    static size_t graphCount(Comb& comb)
+    {
+        return comb.getInsideOptimal().visibility_graphs_.size();
+    }
+
+    static const CombVisibilityGraph* graph(Comb& comb, const size_t part_idx)
+    {
+        return comb.getInsideOptimal().visibility_graphs_.at(part_idx).get();
+    }
+};
+
+TEST_F(CombVisibilityGraphTest, RouteAroundHoleStaysInside)
+{
+    const std::unique_ptr<LocToLineGrid> loc_to_line = PolygonUtils::createLocToLineGrid(part_with_hole, offset_from_outlines);
+    const CombVisibilityGraph graph(part_with_hole, *loc_to_line, offset_from_boundary);
+    ASSERT_TRUE(graph.isValid());
+
+    const Point2LL start(1000, 5000);
+    const Point2LL end(9000, 5000);
+    CombPath path;
+    ASSERT_TRUE(graph.route(start, end, path));
+
+    ASSERT_GE(path.size(), 4U) << "The route has to go around two corners of the hole.";
+    EXPECT_EQ(path.front(), start);
+    EXPECT_EQ(path.back(), end);
+    EXPECT_TRUE(staysInside(path, part_with_hole));
+    EXPECT_LT(path[1].Y, 4000) << "Going below the hole is the shortest way.";
+}
+
+TEST_F(CombVisibilityGraphTest, StraightWhenVisible)
+{
+    const std::unique_ptr<LocToLineGrid> loc_to_line = PolygonUtils::createLocToLineGrid(part_with_hole, offset_from_outlines);
+    const CombVisibilityGraph graph(part_with_hole, *loc_to_line, offset_from_boundary);
+
+    const Point2LL start(1000, 1000);
+    const Point2LL end(9000, 2000);
+    CombPath path;
+    ASSERT_TRUE(graph.route(start, end, path));
+    ASSERT_EQ(path.size(), 2U);
+    EXPECT_EQ(path.front(), start);
+    EXPECT_EQ(path.back(), end);
+}
+
+TEST_F(CombVisibilityGraphTest, NotLongerThanCrossings)
+{
+    const std::unique_ptr<Comb> graph_comb = makeComb(part_with_hole, "visibility_graph");
+    const std::unique_ptr<Comb> crossings_comb = makeComb(part_with_hole, "crossings");
+
+    for (const auto& [start, end] : { std::pair{ Point2LL(1000, 5000), Point2LL(9000, 5000) },
+                                      std::pair{ Point2LL(5000, 9500), Point2LL(5000, 500) },
+                                      std::pair{ Point2LL(2000, 9000), Point2LL(8000, 3000) },
+                                      std::pair{ Point2LL(-100, 5000), Point2LL(10100, 5000) } }) // Just outside, to be moved inside first.
+    {
+        CombPaths graph_paths;
+        CombPaths crossings_paths;
+        ASSERT_TRUE(calc(*graph_comb, start, end, graph_paths));
+        ASSERT_TRUE(calc(*crossings_comb, start, end, crossings_paths));
+
+        ASSERT_EQ(graph_paths.size(), 1U);
+        ASSERT_EQ(crossings_paths.size(), 1U);
+        EXPECT_TRUE(staysInside(graph_paths.front(), part_with_hole));
+        EXPECT_EQ(graph_paths.front().front(), crossings_paths.front().front()) << "Both engines move the start point inside the same way.";
+        EXPECT_EQ(graph_paths.front().back(), crossings_paths.front().back()) << "Both engines move the end point inside the same way.";
+        EXPECT_LE(length(graph_paths), length(crossings_paths));
+    }
+}
+
+TEST_F(CombVisibilityGraphTest, UnreachableFails)
+{
+    const std::unique_ptr<LocToLineGrid> loc_to_line = PolygonUtils::createLocToLineGrid(two_parts, offset_from_outlines);
+    const CombVisibilityGraph graph(part_with_hole, *loc_to_line, offset_from_boundary);
+    ASSERT_TRUE(graph.isValid());
+
+    CombPath path;
+    EXPECT_FALSE(graph.route(Point2LL(1000, 6000), Point2LL(17000, 5000), path)) << "The end is in another part.";
+    EXPECT_TRUE(path.empty()) << "A failed route leaves the path untouched.";
+}
+
+TEST_F(CombVisibilityGraphTest, FallsBackLikeCrossings)
+{
+    const std::unique_ptr<Comb> graph_comb = makeComb(two_parts, "visibility_graph");
+    const std::unique_ptr<Comb> crossings_comb = makeComb(two_parts, "crossings");
+
+    for (const auto& [start, end] : { std::pair{ Point2LL(-5000, 6000), Point2LL(9000, 6000) }, // Start far outside the boundary.
+                                      std::pair{ Point2LL(1000, 6000), Point2LL(9000, 15000) }, // End far outside the boundary.
+                                      std::pair{ Point2LL(1000, 6000), Point2LL(17000, 5000) } }) // End in another part.
+    {
+        CombPaths graph_paths;
+        CombPaths crossings_paths;
+        const bool graph_result = calc(*graph_comb, start, end, graph_paths);
+        const bool crossings_result = calc(*crossings_comb, start, end, crossings_paths);
+        EXPECT_FALSE(graph_result) << "Combing through the air fails when z hopping over printed parts.";
+        EXPECT_EQ(graph_result, crossings_result);
+        EXPECT_EQ(graph_paths.size(), crossings_paths.size());
+    }
+    EXPECT_EQ(graphCount(*graph_comb), 0U) << "No graph is built for travels that leave the part.";
+}
+
+TEST_F(CombVisibilityGraphTest, TooDetailedFallsBackToCrossings)
+{
+    Shape part_with_star;
+    part_with_star.push_back(square(0, 0, 10000));
+    part_with_star.push_back(starHole(CombVisibilityGraph::max_nodes_ + 44));
+
+    const std::unique_ptr<Comb> graph_comb = makeComb(part_with_star, "visibility_graph");
+    const std::unique_ptr<Comb> crossings_comb = makeComb(part_with_star, "crossings");
+
+    const Point2LL start(1000, 5000);
+    const Point2LL end(9000, 5000);
+    CombPaths graph_paths;
+    CombPaths crossings_paths;
+    ASSERT_TRUE(calc(*graph_comb, start, end, graph_paths));
+    ASSERT_TRUE(calc(*crossings_comb, start, end, crossings_paths));
+
+    ASSERT_EQ(graphCount(*graph_comb), 1U);
+    EXPECT_FALSE(graph(*graph_comb, 0)->isValid());
+    ASSERT_EQ(graph_paths.size(), crossings_paths.size());
+    for (size_t path_idx = 0; path_idx < graph_paths.size(); ++path_idx)
+    {
+        EXPECT_EQ(static_cast<std::vector<Point2LL>>(graph_paths[path_idx]), static_cast<std::vector<Point2LL>>(crossings_paths[path_idx]))
+            << "Without a graph, the combing follows the crossings.";
+    }
+}
+
+TEST_F(CombVisibilityGraphTest, RepeatedQueriesUseCachedGraph)
+{
+    const std::unique_ptr<Comb> comb = makeComb(part_with_hole, "visibility_graph");
+
+    const Point2LL start(1000, 5000);
+    const Point2LL end(9000, 5000);
+    CombPaths first_paths;
+    ASSERT_TRUE(calc(*comb, start, end, first_paths));
+    ASSERT_EQ(graphCount(*comb), 1U);
+    const CombVisibilityGraph* const first_graph = graph(*comb, 0);
+    const size_t grids_built = Comb::getGridStatistics().inside_grids_built;
+
+    for (int repetition = 0; repetition < 3; ++repetition)
+    {
+        CombPaths paths;
+        ASSERT_TRUE(calc(*comb, start, end, paths));
+        ASSERT_EQ(paths.size(), first_paths.size());
+        EXPECT_EQ(static_cast<std::vector<Point2LL>>(paths.front()), static_cast<std::vector<Point2LL>>(first_paths.front()));
+    }
+    EXPECT_EQ(graphCount(*comb), 1U);
+    EXPECT_EQ(graph(*comb, 0), first_graph) << "The graph of the part is built once and then reused.";
+    EXPECT_EQ(Comb::getGridStatistics().inside_grids_built, grids_built) << "Neither is the grid it tests visibility with rebuilt.";
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
@@ -0,0 +1,221 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <gtest/gtest.h>
+
+#include "cura/plugins/slots/handshake/v0/handshake.grpc.pb.h"
+#include "cura/plugins/slots/postprocess/v0/modify.grpc.pb.h"
+#include "plugins/converters.h"
+#include "plugins/pluginproxy.h"
+#include "plugins/slots.h"
+#include "plugins/validator.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * Stand-in for a plugin, accepting the handshake.
+ */
+class HandshakeStandIn : public plugins::slots::handshake::v0::HandshakeService::Service
+{
+public:
+    grpc::Status Call(grpc::ServerContext*, const plugins::slots::handshake::v0::CallRequest*, plugins::slots::handshake::v0::CallResponse* response) override
+    {
+        response->set_plugin_name("stand_in");
+        response->set_plugin_version("1.0.0");
+        response->set_slot_version_range(">=0.1.0-alpha");
+        return grpc::Status::OK;
+    }
+};
+
+/*
+ * Stand-in for a post-processing plugin, which appends a comment and keeps track of how many requests it was handling at the same time.
+ */
+class PostprocessStandIn : public plugins::slots::postprocess::v0::modify::PostprocessModifyService::Service
+{
+public:
+    std::atomic<size_t> in_flight = 0;
+    std::atomic<size_t> max_in_flight = 0;
+    std::atomic<size_t> calls = 0;
+
+    grpc::Status Call(grpc::ServerContext*, const plugins::slots::postprocess::v0::modify::CallRequest* request, plugins::slots::postprocess::v0::modify::CallResponse* response)
+        override
+    {
+        const size_t now_in_flight = ++in_flight;
+        size_t previous_max = max_in_flight.load();
+        while (previous_max < now_in_flight && ! max_in_flight.compare_exchange_weak(previous_max, now_in_flight))
+        {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        response->set_gcode_word(request->gcode_word() + ";POSTPROCESSED");
+        ++calls;
+        --in_flight;
+        return grpc::Status::OK;
+    }
+};
+
+/*
+ * The threads that converted requests and responses of the post-processing slot.
+ */
+class ConversionThreads
+{
+public:
+    static void record()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.push_back(std::this_thread::get_id());
+    }
+
+    static inline std::mutex mutex;
+    static inline std::vector<std::thread::id> threads;
+};
+
+struct recording_postprocess_request : public plugins::postprocess_request
+{
+    value_type operator()(const native_value_type& gcode) const
+    {
+        ConversionThreads::record();
+        return plugins::postprocess_request::operator()(gcode);
+    }
+};
+
+struct recording_postprocess_response : public plugins::postprocess_response
+{
+    native_value_type operator()(const native_value_type& original_value, const value_type& message) const
+    {
+        ConversionThreads::record();
+        return plugins::postprocess_response::operator()(original_value, message);
+    }
+};
+
+using recording_postprocess_proxy = plugins::PluginProxy<
+    plugins::v0::SlotID::POSTPROCESS_MODIFY,
+    "0.1.0-alpha",
+    plugins::slots::postprocess::v0::modify::PostprocessModifyService::Stub,
+    plugins::Validator,
+    recording_postprocess_request,
+    recording_postprocess_response>;
+
+/*
+ * Runs the stand-in plugin in this process and connects the post-processing slot to it.
+ */
+class PluginProxyTest : public testing::Test
+{
+public:
+    HandshakeStandIn handshake_service;
+    PostprocessStandIn postprocess_service;
+    std::unique_ptr<grpc::Server> server;
+    plugins::slot_postprocess slot;
+
+    void SetUp() override
+    {
+        grpc::ServerBuilder builder;
+        builder.RegisterService(&handshake_service);
+        builder.RegisterService(&postprocess_service);
+        server = builder.BuildAndStart();
+        ASSERT_NE(server, nullptr);
+        slot.addPlugin("stand_in", "1.0.0", server->InProcessChannel(grpc::ChannelArguments{}));
+    }
+
+    void TearDown() override
+    {
+        slot = plugins::slot_postprocess{};
+        server->Shutdown();
+    }
+};
+
+TEST_F(PluginProxyTest, ModifyReturnsPluginResult)
+{
+    std::string gcode = "G0 X10";
+    EXPECT_EQ(slot.modify(gcode), "G0 X10;POSTPROCESSED");
+    EXPECT_EQ(gcode, "G0 X10") << "The original value must not be changed.";
+
+    // The connection is kept, so the next call must work the same.
+    std::string gcode_2 = "G1 X20";
+    EXPECT_EQ(slot.modify(gcode_2), "G1 X20;POSTPROCESSED");
+    EXPECT_EQ(postprocess_service.calls.load(), 2);
+}
+
+/*
+ * Calls from several threads at once, like layers being processed in parallel. The calls all go through the same gRPC context of the plugin, but must not wait
+ * for each other.
+ */
+TEST_F(PluginProxyTest, ConcurrentCallsArePipelined)
+{
+    constexpr size_t thread_count = 8;
+    std::vector<std::string> results(thread_count);
+    std::vector<std::thread> threads;
+    for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx)
+    {
+        threads.emplace_back(
+            [this, &results, thread_idx]()
+            {
+                std::string gcode = ";LAYER:" + std::to_string(thread_idx);
+                results[thread_idx] = slot.modify(gcode);
+            });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx)
+    {
+        EXPECT_EQ(results[thread_idx], ";LAYER:" + std::to_string(thread_idx) + ";POSTPROCESSED") << "Each thread must get the response to its own request.";
+    }
+    EXPECT_EQ(postprocess_service.calls.load(), thread_count);
+    EXPECT_GT(postprocess_service.max_in_flight.load(), 1) << "Requests from different threads must be in flight at the same time.";
+}
+
+/*
+ * Converting the requests and responses may take long, for instance for the paths of a whole layer. So they must be converted by the threads that make the
+ * calls, in parallel, rather than by the one thread of the gRPC context.
+ */
+TEST_F(PluginProxyTest, ConversionsRunOnCallingThreads)
+{
+    recording_postprocess_proxy proxy("stand_in", "1.0.0", server->InProcessChannel(grpc::ChannelArguments{}));
+    ConversionThreads::threads.clear();
+
+    constexpr size_t thread_count = 4;
+    std::vector<std::thread::id> calling_threads(thread_count);
+    std::vector<std::thread> threads;
+    for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx)
+    {
+        threads.emplace_back(
+            [&proxy, &calling_threads, thread_idx]()
+            {
+                calling_threads[thread_idx] = std::this_thread::get_id();
+                std::string gcode = ";LAYER:" + std::to_string(thread_idx);
+                EXPECT_EQ(proxy.modify(gcode), gcode + ";POSTPROCESSED");
+            });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(ConversionThreads::threads.size(), 2 * thread_count) << "Every call converts one request and one response.";
+    const std::set<std::thread::id> expected(calling_threads.begin(), calling_threads.end());
+    const std::set<std::thread::id> result(ConversionThreads::threads.begin(), ConversionThreads::threads.end());
+    EXPECT_EQ(result, expected) << "Every request and response must be converted by the thread that made the call.";
+    for (const std::thread::id& calling_thread : calling_threads)
+    {
+        EXPECT_EQ(std::count(ConversionThreads::threads.begin(), ConversionThreads::threads.end(), calling_thread), 2);
+    }
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
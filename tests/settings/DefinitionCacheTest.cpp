@@ -0,0 +1,184 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "settings/DefinitionCache.h" //The class under test.
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "Application.h"
+#include "ExtruderTrain.h"
+#include "Slice.h"
+#include "communication/CommandLine.h"
+#include "settings/Settings.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * A test fixture with a printer definition that inherits from a base definition and has an extruder definition, in a temporary directory.
+ */
+class DefinitionCacheTest : public testing::Test
+{
+public:
+    std::filesystem::path definitions_directory;
+    std::filesystem::path cache_directory;
+
+    void SetUp() override
+    {
+        Application::getInstance().current_slice_ = std::make_shared<Slice>(1);
+
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / "DefinitionCacheTest";
+        std::filesystem::remove_all(directory);
+        definitions_directory = directory / "definitions";
+        cache_directory = directory / "cache";
+        std::filesystem::create_directories(definitions_directory);
+
+        writeFile(
+            "base.def.json",
+            R"({"settings": {"machine_settings": {"children": {"machine_width": {"default_value": 200}, "machine_depth": {"default_value": 150}}},)"
+            R"( "layer_height": {"default_value": 0.2}, "machine_name": {"default_value": "Base"}}})");
+        writeFile("extruder.def.json", R"({"settings": {"machine_nozzle_size": {"default_value": 0.4}}, "overrides": {"machine_nozzle_size": {"default_value": 0.6}}})");
+        writeFile(
+            "printer.def.json",
+            R"({"inherits": "base", "metadata": {"machine_extruder_trains": {"0": "extruder"}}, "overrides": {"machine_width": {"default_value": 300}, "machine_name": {"default_value": "Printer"}}})");
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(definitions_directory.parent_path());
+        Application::getInstance().current_slice_ = nullptr;
+    }
+
+    void writeFile(const std::string& filename, const std::string& contents) const
+    {
+        std::ofstream file(definitions_directory / filename);
+        file << contents;
+    }
+
+    /*
+     * Load the printer definition into new global settings and extruders, as a new command line would.
+     * \param use_cache Whether to use the definition cache.
+     * \return The settings of the scene, and of the first extruder appended with a prefix.
+     */
+    std::unordered_map<std::string, std::string> load(const bool use_cache)
+    {
+        Application::getInstance().current_slice_ = std::make_shared<Slice>(1);
+        Scene& scene = Application::getInstance().current_slice_->scene;
+
+        CommandLine command_line(std::vector<std::string>{});
+        command_line.definition_cache_directory_ = use_cache ? cache_directory : std::filesystem::path();
+        command_line.search_directories_.clear();
+        EXPECT_EQ(command_line.loadJSON(definitions_directory / "printer.def.json", scene.settings), 0);
+
+        std::unordered_map<std::string, std::string> result = scene.settings.getFlattendSettings();
+        EXPECT_EQ(scene.extruders.size(), 1);
+        if (! scene.extruders.empty())
+        {
+            for (const auto& [key, value] : scene.extruders[0].settings_.getFlattendSettings())
+            {
+                result["extruder_0:" + key] = value;
+            }
+        }
+        return result;
+    }
+};
+
+TEST_F(DefinitionCacheTest, SameSettingsAsWithoutCache)
+{
+    const std::unordered_map<std::string, std::string> expected = load(false);
+    EXPECT_EQ(expected.at("machine_width"), "300.000000");
+    EXPECT_EQ(expected.at("machine_name"), "Printer");
+    EXPECT_EQ(expected.at("extruder_0:machine_nozzle_size"), "0.600000");
+    EXPECT_FALSE(expected.contains("machine_settings")) << "Only the leaf settings are read.";
+
+    EXPECT_EQ(load(true), expected) << "Flattening the definitions must not change the settings.";
+    ASSERT_FALSE(std::filesystem::is_empty(cache_directory));
+    EXPECT_EQ(load(true), expected) << "Loading from the cache must give the same settings.";
+}
+
+TEST_F(DefinitionCacheTest, ChangedFileIsReadAgain)
+{
+    load(true);
+    writeFile(
+        "base.def.json",
+        R"({"settings": {"machine_settings": {"children": {"machine_width": {"default_value": 200}, "machine_depth": {"default_value": 250}}},)"
+        R"( "layer_height": {"default_value": 0.1}, "machine_name": {"default_value": "Base"}}})");
+    // The file system may not tell the write apart from the first one by its time alone.
+    std::filesystem::last_write_time(definitions_directory / "base.def.json", std::filesystem::file_time_type::clock::now() + std::chrono::hours(1));
+
+    const std::unordered_map<std::string, std::string> settings = load(true);
+    EXPECT_EQ(settings.at("machine_depth"), "250.000000");
+    EXPECT_EQ(settings.at("layer_height"), "0.100000");
+    EXPECT_EQ(settings, load(false));
+}
+
+TEST_F(DefinitionCacheTest, DamagedCacheIsIgnored)
+{
+    const std::unordered_map<std::string, std::string> expected = load(true);
+    for (const std::filesystem::directory_entry& cache_file : std::filesystem::directory_iterator(cache_directory))
+    {
+        std::ofstream file(cache_file.path(), std::ios::binary | std::ios::trunc);
+        file << "CURADEF1 and then some garbage";
+    }
+    EXPECT_EQ(load(true), expected);
+}
+
+TEST_F(DefinitionCacheTest, WriteAndRead)
+{
+    FlattenedDefinition definition;
+    definition.addFile(definitions_directory / "printer.def.json");
+    definition.addSetting("machine_width", "200");
+    definition.addSetting("machine_width", "300");
+    definition.addExtruder(1, "extruder.def.json");
+    definition.addSetting("layer_height", "0.2");
+
+    const std::filesystem::path cache_file = DefinitionCache::cacheFile(cache_directory, definitions_directory / "printer.def.json", {}, false);
+    ASSERT_TRUE(DefinitionCache::write(cache_file, definition));
+    const std::optional<FlattenedDefinition> read = DefinitionCache::read(cache_file);
+    ASSERT_TRUE(read.has_value());
+
+    EXPECT_EQ(read->search_directories, definition.search_directories);
+    ASSERT_EQ(read->steps.size(), 3);
+    ASSERT_EQ(read->steps[0].settings.size(), 1) << "Only the last value of a setting is kept.";
+    EXPECT_EQ(read->steps[0].settings[0].second, "300");
+    EXPECT_EQ(read->steps[1].extruder_nr, 1);
+    EXPECT_EQ(read->steps[1].extruder_file, "extruder.def.json");
+    EXPECT_EQ(read->steps[2].settings[0].first, "layer_height");
+
+    EXPECT_NE(cache_file, DefinitionCache::cacheFile(cache_directory, definitions_directory / "printer.def.json", { definitions_directory }, false))
+        << "Other search directories may find other parents.";
+}
+
+#ifndef _WIN32
+TEST_F(DefinitionCacheTest, WritableByOthersIsIgnored)
+{
+    FlattenedDefinition definition;
+    definition.addSetting("machine_start_gcode", "G28");
+    const std::filesystem::path cache_file = DefinitionCache::cacheFile(cache_directory, definitions_directory / "printer.def.json", {}, false);
+    ASSERT_TRUE(DefinitionCache::write(cache_file, definition));
+    EXPECT_EQ(std::filesystem::status(cache_directory).permissions(), std::filesystem::perms::owner_all) << "A new cache directory is only accessible to its owner.";
+    ASSERT_TRUE(DefinitionCache::read(cache_file).has_value());
+
+    std::filesystem::permissions(cache_file, std::filesystem::perms::others_write, std::filesystem::perm_options::add);
+    EXPECT_FALSE(DefinitionCache::read(cache_file).has_value()) << "Anyone could have put the file there.";
+
+    std::filesystem::permissions(cache_file, std::filesystem::perms::others_write, std::filesystem::perm_options::remove);
+    std::filesystem::permissions(cache_directory, std::filesystem::perms::group_write, std::filesystem::perm_options::add);
+    EXPECT_FALSE(DefinitionCache::read(cache_file).has_value()) << "Anyone in the group could have replaced the file.";
+    EXPECT_FALSE(DefinitionCache::write(cache_file, definition));
+
+    const std::filesystem::path link = cache_directory.parent_path() / "link";
+    std::filesystem::permissions(cache_directory, std::filesystem::perms::group_write, std::filesystem::perm_options::remove);
+    std::filesystem::create_directory_symlink(cache_directory, link);
+    EXPECT_FALSE(DefinitionCache::read(link / cache_file.filename()).has_value()) << "The link could be replaced by someone else.";
+}
+#endif
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
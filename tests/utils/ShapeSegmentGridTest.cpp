@@ -0,0 +1,153 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/ShapeSegmentGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include <gtest/gtest.h>
+
+#include "geometry/Polygon.h"
+#include "geometry/Shape.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * The grid must give exactly the same answers as the shape itself, which checks all of its segments.
+ */
+class ShapeSegmentGridTest : public testing::Test
+{
+public:
+    Shape shape;
+
+    void SetUp() override
+    {
+        // A square with a square hole, and a star shaped polygon with many vertices next to it.
+        Polygon outer;
+        outer.emplace_back(0, 0);
+        outer.emplace_back(10000, 0);
+        outer.emplace_back(10000, 10000);
+        outer.emplace_back(0, 10000);
+        shape.push_back(outer);
+        Polygon hole;
+        hole.emplace_back(2000, 2000);
+        hole.emplace_back(2000, 8000);
+        hole.emplace_back(8000, 8000);
+        hole.emplace_back(8000, 2000);
+        shape.push_back(hole);
+
+        Polygon star;
+        constexpr size_t star_points = 200;
+        for (size_t point_idx = 0; point_idx < star_points; ++point_idx)
+        {
+            const double angle = 2.0 * std::numbers::pi * static_cast<double>(point_idx) / star_points;
+            const double radius = point_idx % 2 == 0 ? 6000.0 : 4000.0;
+            star.emplace_back(20000 + std::llround(std::cos(angle) * radius), 5000 + std::llround(std::sin(angle) * radius));
+        }
+        shape.push_back(star);
+    }
+};
+
+TEST_F(ShapeSegmentGridTest, InsideSameAsShape)
+{
+    const ShapeSegmentGrid grid(shape);
+    for (coord_t x = -1000; x <= 27000; x += 250)
+    {
+        for (coord_t y = -2000; y <= 12000; y += 250)
+        {
+            const Point2LL point(x, y);
+            EXPECT_EQ(grid.inside(point, true), shape.inside(point, true)) << "Point " << x << ", " << y << " with border result true.";
+            EXPECT_EQ(grid.inside(point, false), shape.inside(point, false)) << "Point " << x << ", " << y << " with border result false.";
+        }
+    }
+}
+
+TEST_F(ShapeSegmentGridTest, InsideOnVerticesSameAsShape)
+{
+    const ShapeSegmentGrid grid(shape);
+    for (const Polygon& polygon : shape)
+    {
+        for (const Point2LL& vertex : polygon)
+        {
+            EXPECT_TRUE(grid.inside(vertex, true)) << "Vertices are on the border.";
+            EXPECT_FALSE(grid.inside(vertex, false)) << "Vertices are on the border.";
+        }
+    }
+}
+
+TEST_F(ShapeSegmentGridTest, IntersectionsSameAsShape)
+{
+    const ShapeSegmentGrid grid(shape);
+    for (coord_t x = -1000; x <= 27000; x += 700)
+    {
+        for (coord_t y = -2000; y <= 12000; y += 700)
+        {
+            for (const Point2LL& offset : { Point2LL(1500, 300), Point2LL(-400, 2500), Point2LL(9000, -7000), Point2LL(0, 800) })
+            {
+                const Point2LL start(x, y);
+                const Point2LL end = start + offset;
+                std::vector<float> expected = shape.intersectionsWithSegment(start, end);
+                std::vector<float> result = grid.intersectionsWithSegment(start, end);
+                std::sort(expected.begin(), expected.end());
+                std::sort(result.begin(), result.end());
+                EXPECT_EQ(result, expected) << "Segment from " << x << ", " << y << " to " << end.X << ", " << end.Y << ".";
+            }
+        }
+    }
+}
+
+TEST(ShapeSegmentGridDegenerateTest, DegeneratePolygonsSameAsShape)
+{
+    // A square, crossed by a polygon of only two vertices, with a polygon of a single vertex inside it. Point location ignores the last two, while
+    // intersections with segments don't.
+    Shape shape;
+    Polygon square;
+    square.emplace_back(0, 0);
+    square.emplace_back(10000, 0);
+    square.emplace_back(10000, 10000);
+    square.emplace_back(0, 10000);
+    shape.push_back(square);
+    Polygon line;
+    line.emplace_back(-2000, 3000);
+    line.emplace_back(12000, 7000);
+    shape.push_back(line);
+    Polygon dot;
+    dot.emplace_back(5000, 5000);
+    shape.push_back(dot);
+
+    const ShapeSegmentGrid grid(shape);
+    for (coord_t x = -3000; x <= 13000; x += 250)
+    {
+        for (coord_t y = -1000; y <= 11000; y += 250)
+        {
+            const Point2LL point(x, y);
+            EXPECT_EQ(grid.inside(point, true), shape.inside(point, true)) << "Point " << x << ", " << y << " with border result true.";
+            EXPECT_EQ(grid.inside(point, false), shape.inside(point, false)) << "Point " << x << ", " << y << " with border result false.";
+            for (const Point2LL& offset : { Point2LL(0, 2500), Point2LL(1500, -300) })
+            {
+                const Point2LL end = point + offset;
+                std::vector<float> expected = shape.intersectionsWithSegment(point, end);
+                std::vector<float> result = grid.intersectionsWithSegment(point, end);
+                std::sort(expected.begin(), expected.end());
+                std::sort(result.begin(), result.end());
+                EXPECT_EQ(result, expected) << "Segment from " << x << ", " << y << " to " << end.X << ", " << end.Y << ".";
+            }
+        }
+    }
+    EXPECT_FALSE(shape.intersectionsWithSegment(Point2LL(-1000, 0), Point2LL(-1000, 6000)).empty()) << "The test must cross the two-vertex polygon outside the square.";
+    EXPECT_FALSE(grid.intersectionsWithSegment(Point2LL(-1000, 0), Point2LL(-1000, 6000)).empty()) << "Segments of degenerate polygons can be intersected.";
+}
+
+TEST(ShapeSegmentGridEmptyTest, Empty)
+{
+    const ShapeSegmentGrid grid{ Shape() };
+    EXPECT_FALSE(grid.inside(Point2LL(0, 0), true));
+    EXPECT_TRUE(grid.intersectionsWithSegment(Point2LL(0, 0), Point2LL(1000, 1000)).empty());
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
@@ -3,7 +3,10 @@
 
 #include "utils/Simplify.h" // The unit under test.
 
+#include <algorithm>
 #include <numbers>
+#include <numeric>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -405,5 +408,75 @@ TEST_F(SimplifyTest, ToDegenerate)
     EXPECT_EQ(segment.size(), 0) << "The segment got removed entirely, because simplification would reduce its vertices to less than 2, making it degenerate.";
 }
 
+/*!
+ * The list of remaining vertices must find the same neighbours as scanning past the deleted vertices, like simplification did before.
+ */
+class SimplifyRemainingVerticesTest : public testing::Test
+{
+public:
+    static size_t nextNotDeletedScan(size_t index, const std::vector<bool>& to_delete)
+    {
+        const size_t size = to_delete.size();
+        for (index = (index + 1) % size; to_delete[index]; index = (index + 1) % size)
+            ;
+        return index;
+    }
+
+    static size_t previousNotDeletedScan(size_t index, const std::vector<bool>& to_delete)
+    {
+        const size_t size = to_delete.size();
+        for (index = (index + size - 1) % size; to_delete[index]; index = (index + size - 1) % size)
+            ;
+        return index;
+    }
+
+    /*!
+     * Delete the vertices in the given order, and after each deletion compare the neighbours of every vertex, deleted or not.
+     *
+     * At least one vertex must remain, or scanning for the neighbours would never end.
+     */
+    static void checkDeletions(const size_t size, const std::vector<size_t>& deletion_order)
+    {
+        Simplify::RemainingVertices remaining(size);
+        std::vector<bool> to_delete(size, false);
+        for (const size_t vertex : deletion_order)
+        {
+            remaining.remove(vertex);
+            to_delete[vertex] = true;
+            ASSERT_TRUE(std::find(to_delete.begin(), to_delete.end(), false) != to_delete.end()) << "The test must leave a vertex.";
+            for (size_t index = 0; index < size; ++index)
+            {
+                EXPECT_EQ(remaining.isDeleted(index), to_delete[index]) << "Vertex " << index << " after deleting " << vertex << ".";
+                EXPECT_EQ(remaining.next(index), nextNotDeletedScan(index, to_delete)) << "Next of vertex " << index << " after deleting " << vertex << ".";
+                EXPECT_EQ(remaining.previous(index), previousNotDeletedScan(index, to_delete)) << "Previous of vertex " << index << " after deleting " << vertex << ".";
+            }
+        }
+    }
+};
+
+TEST_F(SimplifyRemainingVerticesTest, SameAsScan)
+{
+    checkDeletions(1, {}); // A single vertex is its own neighbour.
+    checkDeletions(2, { 0 });
+    checkDeletions(5, { 2, 1, 3 }); // Each deletion is next to the ones before it.
+    checkDeletions(5, { 0, 4, 3 }); // Around the start of the list.
+    checkDeletions(5, { 3, 3, 1 }); // Deleting a vertex twice.
+    checkDeletions(8, { 1, 3, 5, 7, 2, 6, 4 }); // First every other vertex, then the ones in between.
+    checkDeletions(10, { 5, 4, 6, 3, 7, 2, 8, 1, 9 }); // A gap that grows in both directions.
+    checkDeletions(10, { 9, 0, 1, 8, 2, 7 });
+}
+
+TEST_F(SimplifyRemainingVerticesTest, AllDeletionOrdersSameAsScan)
+{
+    // Delete all but one vertex of a hexagon, in every possible order.
+    constexpr size_t size = 6;
+    std::vector<size_t> vertices(size);
+    std::iota(vertices.begin(), vertices.end(), 0);
+    do
+    {
+        checkDeletions(size, std::vector<size_t>(vertices.begin(), vertices.end() - 1));
+    } while (std::next_permutation(vertices.begin(), vertices.end()));
+}
+
 } // namespace cura
 // NOLINTEND(*-magic-numbers)
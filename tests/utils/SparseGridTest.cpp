@@ -4,12 +4,17 @@
 #include "utils/SparseGrid.h"
 
 #include <algorithm>
+#include <tuple>
+#include <utility>
 #include <unordered_set>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include "utils/Coord_t.h"
+#include "utils/FlatSparseGrid.h"
+#include "utils/FlatSparseLineGrid.h"
+#include "utils/SparseLineGrid.h"
 #include "utils/SparsePointGridInclusive.h"
 
 namespace cura
@@ -300,4 +305,87 @@ TEST_F(GetNearestTest, Equal)
         << ")."; // FIXME: simplify once fmt or we use C++20 is added as a dependency
 }
 
+TEST(FlatSparseGridTest, SameAsSparseGrid)
+{
+    constexpr coord_t grid_size = 10;
+    SparsePointGridInclusive<Point2LL> sparse_grid(grid_size);
+    FlatSparseGrid<Point2LL> flat_grid(grid_size);
+    for (coord_t i = 0; i < 1000; i++)
+    {
+        const Point2LL point((i * 37) % 201 - 100, (i * 91) % 203 - 100); // Scatter points around the origin, also in negative cells.
+        sparse_grid.insert(point, point);
+        flat_grid.insertPoint(point, point);
+    }
+    flat_grid.build();
+    EXPECT_EQ(flat_grid.size(), 1000);
+
+    for (const Point2LL& target : { Point2LL(0, 0), Point2LL(-55, 73), Point2LL(99, -99), Point2LL(500, 500) })
+    {
+        std::vector<Point2LL> expected;
+        for (const auto& elem : sparse_grid.getNearby(target, grid_size * 2))
+        {
+            expected.push_back(elem.val);
+        }
+        std::vector<Point2LL> result = flat_grid.getNearby(target, grid_size * 2);
+
+        const auto point_order = [](const Point2LL& a, const Point2LL& b)
+        {
+            return a.X < b.X || (a.X == b.X && a.Y < b.Y);
+        };
+        std::sort(expected.begin(), expected.end(), point_order);
+        std::sort(result.begin(), result.end(), point_order);
+        EXPECT_EQ(result, expected) << "The flat grid must find the same elements as the sparse grid around " << target << ".";
+    }
+}
+
+TEST(FlatSparseGridTest, LinesSameAsSparseLineGrid)
+{
+    struct PairLocator
+    {
+        std::pair<Point2LL, Point2LL> operator()(const std::pair<Point2LL, Point2LL>& val) const
+        {
+            return val;
+        }
+    };
+    using Line = std::pair<Point2LL, Point2LL>;
+    constexpr coord_t grid_size = 10;
+    SparseLineGrid<Line, PairLocator> sparse_grid(grid_size);
+    FlatSparseLineGrid<Line, PairLocator> flat_grid(grid_size);
+    for (coord_t i = 0; i < 200; i++)
+    {
+        const Point2LL start((i * 37) % 201 - 100, (i * 91) % 203 - 100);
+        const Line line(start, start + Point2LL((i * 13) % 41 - 20, (i * 29) % 43 - 21)); // Also lines within a single cell, and with negative slopes.
+        sparse_grid.insert(line);
+        flat_grid.insert(line);
+    }
+    flat_grid.build();
+
+    const auto line_order = [](const Line& a, const Line& b)
+    {
+        return std::tie(a.first.X, a.first.Y, a.second.X, a.second.Y) < std::tie(b.first.X, b.first.Y, b.second.X, b.second.Y);
+    };
+    for (const Line& query : { Line(Point2LL(-100, -100), Point2LL(100, 100)), Line(Point2LL(55, -90), Point2LL(55, 90)), Line(Point2LL(-80, 3), Point2LL(70, 3)) })
+    {
+        std::vector<Line> expected;
+        sparse_grid.processLine(
+            query,
+            [&expected](const Line& line)
+            {
+                expected.push_back(line);
+                return true;
+            });
+        std::vector<Line> result;
+        flat_grid.processLine(
+            query,
+            [&result](const Line& line)
+            {
+                result.push_back(line);
+                return true;
+            });
+        std::sort(expected.begin(), expected.end(), line_order);
+        std::sort(result.begin(), result.end(), line_order);
+        EXPECT_EQ(result, expected) << "The flat grid must visit the same lines as the sparse grid, once for each cell they share with the query.";
+    }
+}
+
 } // namespace cura
@@ -0,0 +1,221 @@
+// Copyright (c) 2026 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/unordered/concurrent_flat_set.hpp>
+#include <gtest/gtest.h>
+
+#include "Application.h" //To start the thread pool.
+
+namespace cura
+{
+
+/*
+ * Fixture that starts a thread pool with a fixed amount of threads, as if the engine was started with -m4.
+ */
+class ThreadPoolTest : public testing::Test
+{
+public:
+    static constexpr int max_threads = 4;
+
+    void SetUp() override
+    {
+        Application::getInstance().startThreadPool(max_threads);
+    }
+};
+
+TEST_F(ThreadPoolTest, VisitAllVisitsEachElementOnce)
+{
+    boost::concurrent_flat_map<int, int> visit_counts;
+    for (int key = 0; key < 10000; key++)
+    {
+        visit_counts.emplace(key, 0);
+    }
+
+    parallel_visit_all(
+        visit_counts,
+        [](auto& element)
+        {
+            element.second++;
+        });
+
+    visit_counts.cvisit_all(
+        [](const auto& element)
+        {
+            EXPECT_EQ(element.second, 1) << "Element " << element.first << " must be visited exactly once.";
+        });
+}
+
+TEST_F(ThreadPoolTest, EraseIf)
+{
+    boost::concurrent_flat_set<int> numbers;
+    for (int number = 0; number < 10000; number++)
+    {
+        numbers.insert(number);
+    }
+
+    parallel_erase_if(
+        numbers,
+        [](const int number)
+        {
+            return number % 3 == 0;
+        });
+
+    EXPECT_EQ(numbers.size(), 6666) << "All multiples of 3 must have been erased.";
+    numbers.cvisit_all(
+        [](const int number)
+        {
+            EXPECT_NE(number % 3, 0) << "Only the multiples of 3 must have been erased.";
+        });
+}
+
+/*
+ * Nests container visitation, as done when splitting meshes by texture, inside regular parallel_for work. All of it must run on the same threads, so there may never be more
+ * loop bodies running at the same time than the amount of threads we were given.
+ */
+TEST_F(ThreadPoolTest, NestedWorkRespectsThreadLimit)
+{
+    std::atomic<size_t> running = 0;
+    std::atomic<size_t> max_running = 0;
+    const auto busy = [&running, &max_running]()
+    {
+        const size_t now_running = ++running;
+        size_t previous_max = max_running.load();
+        while (previous_max < now_running && ! max_running.compare_exchange_weak(previous_max, now_running))
+        {
+        }
+        const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(50);
+        while (std::chrono::steady_clock::now() < until)
+        {
+        }
+        --running;
+    };
+
+    boost::concurrent_flat_set<int> voxels;
+    for (int voxel = 0; voxel < 200; voxel++)
+    {
+        voxels.insert(voxel);
+    }
+
+    parallel_for<size_t>(
+        0,
+        64,
+        [&](const size_t)
+        {
+            busy();
+            parallel_visit_all(
+                voxels,
+                [&busy](const int)
+                {
+                    busy();
+                });
+        });
+
+    EXPECT_LE(max_running.load(), static_cast<size_t>(max_threads)) << "Nested parallel work may not use more threads than the thread pool has.";
+    EXPECT_GT(max_running.load(), 0);
+}
+
+TEST_F(ThreadPoolTest, ParallelForInProducers)
+{
+    // With a single slot per worker, the ring is full most of the time. A producer waiting in parallel_for must not pick up a worker that waits for it.
+    for (int repetition = 0; repetition < 50; repetition++)
+    {
+        std::vector<size_t> consumed;
+        run_multiple_producers_ordered_consumer(
+            0,
+            100,
+            [](const size_t item)
+            {
+                std::atomic<size_t> sum = 0;
+                parallel_for<size_t>(
+                    0,
+                    16,
+                    [&sum](const size_t i)
+                    {
+                        sum += i;
+                    });
+                EXPECT_EQ(sum.load(), 120U);
+                return std::optional<size_t>(item);
+            },
+            [&consumed](std::optional<size_t> item)
+            {
+                consumed.push_back(*item);
+            },
+            1);
+
+        ASSERT_EQ(consumed.size(), 100U);
+        for (size_t i = 0; i < consumed.size(); i++)
+        {
+            ASSERT_EQ(consumed[i], i) << "Items must be consumed in order.";
+        }
+    }
+}
+
+TEST_F(ThreadPoolTest, CostHintVisitsEachItemOnce)
+{
+    constexpr size_t item_count = 1000;
+    std::vector<std::atomic<int>> visit_counts(item_count);
+    parallel_for<size_t>(
+        0,
+        item_count,
+        [](const size_t item)
+        {
+            return item < 900 ? 0 : 10000; // Most of the work is at the end, like empty layers below a lot of support.
+        },
+        [&visit_counts](const size_t item)
+        {
+            visit_counts[item]++;
+        });
+
+    for (size_t item = 0; item < item_count; item++)
+    {
+        EXPECT_EQ(visit_counts[item].load(), 1) << "Item " << item << " must be visited exactly once.";
+    }
+}
+
+/*
+ * With the cost known, the expensive items must be spread over the workers, even when they are all at the end of the range.
+ */
+TEST_F(ThreadPoolTest, CostHintSplitsExpensiveItems)
+{
+    constexpr size_t item_count = 256;
+    constexpr size_t expensive_count = 8;
+    std::atomic<size_t> running = 0;
+    std::atomic<size_t> max_running_expensive = 0;
+    parallel_for<size_t>(
+        0,
+        item_count,
+        [](const size_t item)
+        {
+            return item < item_count - expensive_count ? 1 : 1000;
+        },
+        [&](const size_t item)
+        {
+            if (item < item_count - expensive_count)
+            {
+                return;
+            }
+            const size_t now_running = ++running;
+            size_t previous_max = max_running_expensive.load();
+            while (previous_max < now_running && ! max_running_expensive.compare_exchange_weak(previous_max, now_running))
+            {
+            }
+            const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+            while (std::chrono::steady_clock::now() < until)
+            {
+            }
+            --running;
+        });
+
+    EXPECT_GT(max_running_expensive.load(), 1) << "The expensive items at the end must not end up in a single chunk.";
+}
+
+} // namespace cura